@@ -8,6 +8,7 @@
 #include "agg_funcs.h"
 #include "../func_desc.h"
 #include "../../util/arr.h"
+#include "../../util/hll.h"
 
 //------------------------------------------------------------------------------
 // Count
@@ -35,6 +36,49 @@ AggregateCtx *Count_PrivateData(void)
 	return ctx;
 }
 
+//------------------------------------------------------------------------------
+// Approximate count distinct
+//------------------------------------------------------------------------------
+
+// distinct values are tracked by a HyperLogLog sketch
+// memory is bounded regardless of the number of distinct values
+AggregateResult AGG_APPROX_COUNT_DISTINCT(SIValue *argv, int argc,
+		void *private_data) {
+	AggregateCtx *ctx = private_data;
+
+	SIValue v = argv[0];
+	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
+
+	HLL_Add((HLL *)&ctx->private_data, SIValue_HashCode(v));
+
+	return AGGREGATE_OK;
+}
+
+void ApproxCountDistinctFinalize(void *ctx_ptr) {
+	AggregateCtx *ctx = ctx_ptr;
+	HLL hll = ctx->private_data;
+	if(hll == NULL) return;
+
+	Aggregate_SetResult(ctx, SI_LongVal(HLL_Count(hll)));
+}
+
+void ApproxCountDistinct_Free(void *pdata) {
+	ASSERT(pdata != NULL);
+
+	HLL hll = pdata;
+	HLL_Free(&hll);
+}
+
+AggregateCtx *ApproxCountDistinct_PrivateData(void)
+{
+	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
+
+	ctx->result = SI_LongVal(0);  // count default value is 0
+	ctx->private_data = HLL_New();
+
+	return ctx;
+}
+
 void Register_COUNT(void) {
 	SIType *types;
 	SIType ret_type;
@@ -46,5 +90,13 @@ void Register_COUNT(void) {
 	func_desc = AR_AggFuncDescNew("count", AGG_COUNT, 1, 1, types, ret_type,
 			NULL, NULL, Count_PrivateData);
 	AR_RegFunc(func_desc);
-}
 
+	types = array_new(SIType, 1);
+	array_append(types, SI_ALL);
+	ret_type = T_INT64;
+	func_desc = AR_AggFuncDescNew("approxCountDistinct",
+			AGG_APPROX_COUNT_DISTINCT, 1, 1, types, ret_type,
+			ApproxCountDistinct_Free, ApproxCountDistinctFinalize,
+			ApproxCountDistinct_PrivateData);
+	AR_RegFunc(func_desc);
+}
@@ -8,16 +8,59 @@
 #include "agg_funcs.h"
 #include "../func_desc.h"
 #include "../../util/arr.h"
+#include "../../util/tdigest.h"
 #include "../../errors/errors.h"
 #include <math.h>
 #include <stdlib.h>
 
-static inline int _cmp
+#define SWAP(a, b) { double t = (a); (a) = (b); (b) = t; }
+
+// partially order 'values' such that values[k] holds the k-th smallest value
+// all values to its left are <= values[k] and all values to its right >=
+// runs in expected O(n) as opposed to a full O(n log n) sort
+static double _select
 (
-	const double *a,
-	const double *b
+	double *values,  // values to select from
+	int64_t n,       // number of values
+	int64_t k        // position to select
 ) {
-	return *a - *b;
+	ASSERT(k >= 0 && k < n);
+
+	int64_t lo = 0;
+	int64_t hi = n - 1;
+
+	while(lo < hi) {
+		// median of three pivot
+		int64_t mid = lo + (hi - lo) / 2;
+		if(values[mid] < values[lo]) SWAP(values[mid], values[lo]);
+		if(values[hi]  < values[lo]) SWAP(values[hi],  values[lo]);
+		if(values[hi]  < values[mid]) SWAP(values[hi], values[mid]);
+		double pivot = values[mid];
+
+		// hoare partition
+		int64_t i = lo;
+		int64_t j = hi;
+		while(i <= j) {
+			while(values[i] < pivot) i++;
+			while(pivot < values[j]) j--;
+			if(i <= j) {
+				SWAP(values[i], values[j]);
+				i++;
+				j--;
+			}
+		}
+
+		// [lo..j] <= pivot <= [i..hi]
+		if(k <= j) {
+			hi = j;
+		} else if(k >= i) {
+			lo = i;
+		} else {
+			break;
+		}
+	}
+
+	return values[k];
 }
 
 //------------------------------------------------------------------------------
@@ -64,13 +107,10 @@ void PercDiscFinalize(void *ctx_ptr) {
 	if(count == 0) {
 		Aggregate_SetResult(ctx, SI_NullVal());
 	} else {
-		qsort(perc_ctx->values, count, sizeof(double),
-				(int(*)(const void*, const void*))_cmp);
-
 		// if perc_ctx->percentile == 0
 		// employing this formula would give an index of -1
 		int idx = perc_ctx->percentile > 0 ? ceil(perc_ctx->percentile * count) - 1 : 0;
-		double n = perc_ctx->values[idx];
+		double n = _select(perc_ctx->values, count, idx);
 		Aggregate_SetResult(ctx, SI_DoubleVal(n));
 	}
 }
@@ -84,28 +124,30 @@ void PercContFinalize(void *ctx_ptr) {
 	if(count == 0) {
 		Aggregate_SetResult(ctx, SI_NullVal());
 	} else {
-		qsort(perc_ctx->values, count, sizeof(double),
-				(int(*)(const void*, const void*))_cmp);
-
-		if(perc_ctx->percentile == 1.0 || count == 1) {
-			Aggregate_SetResult(ctx, SI_DoubleVal(perc_ctx->values[count - 1]));
-		}
-
 		double int_val, fraction_val;
 		double float_idx = perc_ctx->percentile * (count - 1);
 		// Split the temp value into its integer and fractional values
 		fraction_val = modf(float_idx, &int_val);
 		int index = int_val; // Casting the integral part of the value to an int for convenience
 
+		double v = _select(perc_ctx->values, count, index);
+
 		if(!fraction_val) {
 			// A valid index was requested, so we can directly return a value
-			Aggregate_SetResult(ctx, SI_DoubleVal(perc_ctx->values[index]));
+			Aggregate_SetResult(ctx, SI_DoubleVal(v));
 			return;
 		}
 
+		// values to the right of 'index' are all >= v
+		// the next value in order is the smallest among them
+		double next = perc_ctx->values[index + 1];
+		for(uint i = index + 2; i < count; i++) {
+			if(perc_ctx->values[i] < next) next = perc_ctx->values[i];
+		}
+
 		double lhs, rhs;
-		lhs = perc_ctx->values[index] * (1 - fraction_val);
-		rhs = perc_ctx->values[index + 1] * fraction_val;
+		lhs = v * (1 - fraction_val);
+		rhs = next * fraction_val;
 
 		Aggregate_SetResult(ctx, SI_DoubleVal(lhs + rhs));
 	}
@@ -121,6 +163,79 @@ void Percentile_Free(void *pdata) {
 	rm_free(ctx);
 }
 
+//------------------------------------------------------------------------------
+// Approximate precentile
+//------------------------------------------------------------------------------
+
+typedef struct {
+	double percentile;
+	TDigest digest;
+} _agg_PercApproxCtx;
+
+// summarize values using a t-digest, memory is bounded
+// regardless of the number of aggregated values
+AggregateResult AGG_PERC_APPROX(SIValue *argv, int argc, void *private_data) {
+	AggregateCtx *ctx = private_data;
+	_agg_PercApproxCtx *perc_ctx = ctx->private_data;
+
+	// on the first invocation, initialize the context
+	if(perc_ctx->digest == NULL) {
+		SIValue_ToDouble(&argv[1], &perc_ctx->percentile);
+		if(perc_ctx->percentile < 0 || perc_ctx->percentile > 1) {
+			ErrorCtx_SetError(EMSG_PREC_INPUT_RANGE, perc_ctx->percentile);
+		}
+		perc_ctx->digest = TDigest_New(TDIGEST_DEFAULT_COMPRESSION);
+	}
+
+	SIValue v = argv[0];
+	if(SI_TYPE(v) == T_NULL) return AGGREGATE_OK;
+
+	double n;
+	SIValue_ToDouble(&v, &n);
+	TDigest_Add(perc_ctx->digest, n);
+
+	return AGGREGATE_OK;
+}
+
+void PercApproxFinalize(void *ctx_ptr) {
+	AggregateCtx *ctx = ctx_ptr;
+	_agg_PercApproxCtx *perc_ctx = ctx->private_data;
+	if(perc_ctx == NULL) return;
+
+	if(perc_ctx->digest == NULL || TDigest_Count(perc_ctx->digest) == 0) {
+		Aggregate_SetResult(ctx, SI_NullVal());
+	} else {
+		double n = TDigest_Quantile(perc_ctx->digest, perc_ctx->percentile);
+		Aggregate_SetResult(ctx, SI_DoubleVal(n));
+	}
+}
+
+void PercentileApprox_Free(void *pdata) {
+	ASSERT(pdata != NULL);
+
+	_agg_PercApproxCtx *ctx = pdata;
+	if(ctx->digest != NULL) {
+		TDigest_Free(&ctx->digest);
+	}
+	rm_free(ctx);
+}
+
+AggregateCtx *PrecentileApprox_PrivateData(void)
+{
+	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
+
+	ctx->result = SI_NullVal();  // precentile default value is NULL
+
+	// initialize private data
+	_agg_PercApproxCtx *pdata = rm_calloc(1, sizeof(_agg_PercApproxCtx));
+	pdata->percentile = -1; // invalid precentile value
+	pdata->digest     = NULL;
+
+	ctx->private_data = pdata;
+
+	return ctx;
+}
+
 AggregateCtx *Precentile_PrivateData(void)
 {
 	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
@@ -157,5 +272,13 @@ void Register_PRECENTILE(void) {
 	func_desc = AR_AggFuncDescNew("percentileCont", AGG_PERC, 2, 2, types, ret_type,
 			Percentile_Free, PercContFinalize, Precentile_PrivateData);
 	AR_RegFunc(func_desc);
-}
 
+	types = array_new(SIType, 3);
+	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
+	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
+	ret_type = T_NULL | T_DOUBLE;
+	func_desc = AR_AggFuncDescNew("percentileApprox", AGG_PERC_APPROX, 2, 2,
+			types, ret_type, PercentileApprox_Free, PercApproxFinalize,
+			PrecentileApprox_PrivateData);
+	AR_RegFunc(func_desc);
+}
@@ -34,9 +34,10 @@ SIValue AR_LEFT(SIValue *argv, int argc, void *private_data) {
 		return SI_NullVal();
 	}
 
-	if(strlen(argv[0].stringval) <= newlen) {
+	size_t len = strlen(argv[0].stringval);
+	if(len <= newlen) {
 		// No need to truncate this string based on the requested length
-		return SI_DuplicateStringVal(argv[0].stringval);
+		return SI_TransientStringVal(argv[0].stringval, len);
 	}
 
 	// determine new string byte size
@@ -47,11 +48,7 @@ SIValue AR_LEFT(SIValue *argv, int argc, void *private_data) {
 		newlen_bytes += utf8proc_iterate((const utf8proc_uint8_t *)(str+newlen_bytes), -1, &c);
 	}
 
-	char *left_str = rm_malloc((newlen_bytes + 1) * sizeof(char));
- 	strncpy(left_str, str, newlen_bytes * sizeof(char));
- 	left_str[newlen_bytes] = '\0';
-
-	return SI_TransferStringVal(left_str);
+	return SI_TransientStringVal(str, newlen_bytes);
 }
 
 // returns the original string with leading whitespace removed.
@@ -64,7 +61,7 @@ SIValue AR_LTRIM(SIValue *argv, int argc, void *private_data) {
 		trimmed ++;
 	}
 
-	return SI_DuplicateStringVal(trimmed);
+	return SI_TransientStringVal(trimmed, strlen(trimmed));
 }
 
 // returns a string containing the specified number of rightmost characters of the original string.
@@ -85,7 +82,7 @@ SIValue AR_RIGHT(SIValue *argv, int argc, void *private_data) {
 
 	if(start <= 0) {
 		// No need to truncate this string based on the requested length
-		return SI_DuplicateStringVal(str);
+		return SI_TransientStringVal(str, strlen(str));
 	}
 
 	utf8proc_int32_t c;
@@ -94,7 +91,7 @@ SIValue AR_RIGHT(SIValue *argv, int argc, void *private_data) {
 		start_bytes += utf8proc_iterate((const utf8proc_uint8_t *)(str+start_bytes), -1, &c);
 	}
 
-	return SI_DuplicateStringVal(str + start_bytes);
+	return SI_TransientStringVal(str + start_bytes, strlen(str + start_bytes));
 }
 
 // returns the original string with trailing whitespace removed.
@@ -108,11 +105,7 @@ SIValue AR_RTRIM(SIValue *argv, int argc, void *private_data) {
 		i --;
 	}
 
-	char *trimmed = rm_malloc((i + 1) * sizeof(char));
-	strncpy(trimmed, str, i);
-	trimmed[i] = '\0';
-
-	return SI_TransferStringVal(trimmed);
+	return SI_TransientStringVal(str, i);
 }
 
 // incase the parameter type is 
@@ -126,7 +119,8 @@ SIValue AR_REVERSE(SIValue *argv, int argc, void *private_data) {
 		// string reverse
 		char *str = value.stringval;
 		size_t str_len = strlen(str);
-		char *reverse = rm_malloc((str_len + 1) * sizeof(char));
+		SIValue res = SI_TransientStringBuffer(str_len);
+		char *reverse = res.stringval;
 
 		char *reverse_i = reverse + str_len;
 		utf8proc_int32_t c;
@@ -138,7 +132,7 @@ SIValue AR_REVERSE(SIValue *argv, int argc, void *private_data) {
 			utf8proc_encode_char(c, (utf8proc_uint8_t *)reverse_i);
 		}
 		reverse[str_len] = '\0';
-		return SI_TransferStringVal(reverse);
+		return res;
 	} else {
 		SIValue reverse = SI_CloneValue(value);
 		array_reverse(reverse.array);
@@ -202,11 +196,7 @@ SIValue AR_SUBSTRING(SIValue *argv, int argc, void *private_data) {
 	}
 
 	int len = end_p - start_p;
-	char *substring = rm_malloc((len + 1) * sizeof(char));
-	strncpy(substring, start_p, len);
-	substring[len] = '\0';
-
-	return SI_TransferStringVal(substring);
+	return SI_TransientStringVal(start_p, len);
 }
 
 // given a list of strings and an optional delimiter
@@ -266,7 +256,8 @@ SIValue AR_JOIN(SIValue *argv, int argc, void *private_data) {
 
 	int l = 0;                       // current string length
 	int cur_len = 0;                 // offset into output string
-	char *res = rm_malloc(str_len);  // output string
+	SIValue out = SI_TransientStringBuffer(str_len - 1);
+	char *res = out.stringval;       // output string
 
 	for(uint i = 0; i < n - 1; i++) {
 		SIValue str = SIArray_Get(list, i);
@@ -286,7 +277,7 @@ SIValue AR_JOIN(SIValue *argv, int argc, void *private_data) {
 	// place null terminator
 	res[cur_len] = '\0';
 
-	return SI_TransferStringVal(res);
+	return out;
 }
 
 typedef struct {
@@ -692,10 +692,15 @@ const char *AST_ToString
 		} else if(t == CYPHER_AST_REL_PATTERN) {
 			ast_identifier = cypher_ast_rel_pattern_get_identifier(node);
 		} else {
+			// the AST of a parameterized query is parsed from its
+			// parameterized form
+			const char *q = (ctx->query_data.query_parameterized != NULL)
+				? ctx->query_data.query_parameterized
+				: ctx->query_data.query_no_params;
 			struct cypher_input_range range = cypher_astnode_range(node);
 			uint length = range.end.offset - range.start.offset + 1;
 			str = malloc(sizeof(char) * length);
-			strncpy(str, ctx->query_data.query_no_params + range.start.offset, length - 1);
+			strncpy(str, q + range.start.offset, length - 1);
 			str[length - 1] = '\0';
 		}
 		if(ast_identifier) {
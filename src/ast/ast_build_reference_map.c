@@ -138,6 +138,14 @@ static void _AST_MapMatchClauseReferences(AST *ast, const cypher_astnode_t *matc
 	// Where clause.
 	const cypher_astnode_t *predicate = cypher_ast_match_get_predicate(match_clause);
 	if(predicate) _AST_MapExpression(ast, predicate);
+
+	// planner hints
+	// hinted nodes must remain addressable by the plan builder
+	// rather than being folded into an algebraic expression
+	uint hint_count = cypher_ast_match_nhints(match_clause);
+	for(uint i = 0; i < hint_count; i++) {
+		_AST_MapExpression(ast, cypher_ast_match_get_hint(match_clause, i));
+	}
 }
 
 // Add referenced aliases from CREATE clause.
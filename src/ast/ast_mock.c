@@ -19,6 +19,8 @@ AST *AST_MockMatchClause(AST *master_ast, cypher_astnode_t *node, bool node_is_p
 	cypher_astnode_t *pattern;
 	struct cypher_input_range range = {0};
 	const cypher_astnode_t *predicate = NULL;
+	uint nhints = (node_is_path) ? 0 : cypher_ast_match_nhints(node);
+	cypher_astnode_t *hints[nhints + 1];
 	uint child_count = (node_is_path) ? 1 : cypher_astnode_nchildren(node);
 	cypher_astnode_t *children[child_count];
 
@@ -34,6 +36,11 @@ AST *AST_MockMatchClause(AST *master_ast, cypher_astnode_t *node, bool node_is_p
 		pattern = (cypher_astnode_t *)cypher_ast_match_get_pattern(node);
 		predicate = cypher_ast_match_get_predicate(node);
 
+		// retain planner hints
+		for(uint i = 0; i < nhints; i++) {
+			hints[i] = (cypher_astnode_t *)cypher_ast_match_get_hint(node, i);
+		}
+
 		// Explicitly collect all child nodes from the clause.
 		for(uint i = 0; i < child_count; i ++) {
 			children[i] = (cypher_astnode_t *)cypher_astnode_get_child(node, i);
@@ -41,7 +48,7 @@ AST *AST_MockMatchClause(AST *master_ast, cypher_astnode_t *node, bool node_is_p
 	}
 
 	// Build a new match clause that holds this pattern.
-	cypher_astnode_t *match_clause = cypher_ast_match(false, pattern, NULL, 0, predicate,
+	cypher_astnode_t *match_clause = cypher_ast_match(false, pattern, hints, nhints, predicate,
 													  children, child_count, range);
 
 	// Build a query node holding this clause.
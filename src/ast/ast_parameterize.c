@@ -0,0 +1,244 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ast_parameterize.h"
+#include "cypher-parser.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/sds/sds.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+// a literal to replace with a parameter
+typedef struct {
+	size_t start;  // literal's start offset within the query
+	size_t end;    // literal's end offset within the query
+	SIValue v;     // literal's value
+} Literal;
+
+// extract the value of a number or string literal
+// returns false if 'node' isn't such a literal or its value is invalid
+// invalid literals are left to the query's evaluation to report
+static bool _LiteralValue
+(
+	const cypher_astnode_t *node,  // AST node
+	SIValue *v                     // [output] literal value
+) {
+	cypher_astnode_type_t t = cypher_astnode_type(node);
+	char *end = NULL;
+	errno = 0;
+
+	if(t == CYPHER_AST_INTEGER) {
+		const char *s = cypher_ast_integer_get_valuestr(node);
+		int64_t l = strtol(s, &end, 0);
+		if(*end != '\0' || errno == ERANGE) return false;
+		*v = SI_LongVal(l);
+		return true;
+	}
+
+	if(t == CYPHER_AST_FLOAT) {
+		const char *s = cypher_ast_float_get_valuestr(node);
+		double d = strtod(s, &end);
+		if(*end != '\0' || errno == ERANGE) return false;
+		*v = SI_DoubleVal(d);
+		return true;
+	}
+
+	if(t == CYPHER_AST_STRING) {
+		*v = SI_TransferStringVal(rm_strdup(cypher_ast_string_get_value(node)));
+		return true;
+	}
+
+	return false;
+}
+
+// collect 'node' if it is a number or string literal, otherwise visit it
+static void _Visit
+(
+	const cypher_astnode_t *node,  // AST node
+	Literal **literals             // collected literals
+);
+
+static void _Replace
+(
+	const cypher_astnode_t *node,  // AST node
+	Literal **literals             // collected literals
+) {
+	if(node == NULL) return;
+
+	SIValue v;
+	if(!_LiteralValue(node, &v)) {
+		_Visit(node, literals);
+		return;
+	}
+
+	struct cypher_input_range range = cypher_astnode_range(node);
+	Literal l = {range.start.offset, range.end.offset, v};
+	array_append(*literals, l);
+}
+
+static inline bool _ComparisonOperator
+(
+	const cypher_operator_t *op  // operator
+) {
+	return op == CYPHER_OP_EQUAL || op == CYPHER_OP_NEQUAL ||
+		   op == CYPHER_OP_LT    || op == CYPHER_OP_GT     ||
+		   op == CYPHER_OP_LTE   || op == CYPHER_OP_GTE;
+}
+
+// collect the parameterizable literals within 'node'
+// only literals compared against, assigned or used as map values are
+// collected, literals which affect the plan's shape or the result's column
+// names, e.g. RETURN 1, LIMIT 10, [*1..3] are retained
+static void _Visit
+(
+	const cypher_astnode_t *node,  // AST node
+	Literal **literals             // collected literals
+) {
+	if(node == NULL) return;
+
+	cypher_astnode_type_t t = cypher_astnode_type(node);
+
+	// projections name their columns after the projected expression's text
+	// procedure calls and subqueries are left untouched
+	// as are variable length ranges
+	if(t == CYPHER_AST_RETURN        ||
+	   t == CYPHER_AST_CALL          ||
+	   t == CYPHER_AST_CALL_SUBQUERY ||
+	   t == CYPHER_AST_RANGE) {
+		return;
+	}
+
+	// WITH n WHERE n.v = 1
+	if(t == CYPHER_AST_WITH) {
+		_Visit(cypher_ast_with_get_predicate(node), literals);
+		return;
+	}
+
+	// n.v < 1 <= n.x
+	if(t == CYPHER_AST_COMPARISON) {
+		uint n = cypher_ast_comparison_get_length(node);
+		for(uint i = 0; i <= n; i++) {
+			_Replace(cypher_ast_comparison_get_argument(node, i), literals);
+		}
+		return;
+	}
+
+	// n.v = 1
+	if(t == CYPHER_AST_BINARY_OPERATOR &&
+	   _ComparisonOperator(cypher_ast_binary_operator_get_operator(node))) {
+		_Replace(cypher_ast_binary_operator_get_argument1(node), literals);
+		_Replace(cypher_ast_binary_operator_get_argument2(node), literals);
+		return;
+	}
+
+	// SET n.v = 1
+	if(t == CYPHER_AST_SET_PROPERTY) {
+		_Visit(cypher_ast_set_property_get_property(node), literals);
+		_Replace(cypher_ast_set_property_get_expression(node), literals);
+		return;
+	}
+
+	// {v: 1}
+	if(t == CYPHER_AST_MAP) {
+		uint n = cypher_ast_map_nentries(node);
+		for(uint i = 0; i < n; i++) {
+			_Replace(cypher_ast_map_get_value(node, i), literals);
+		}
+		return;
+	}
+
+	uint n = cypher_astnode_nchildren(node);
+	for(uint i = 0; i < n; i++) {
+		_Visit(cypher_astnode_get_child(node, i), literals);
+	}
+}
+
+static int _LiteralCmp
+(
+	const void *a,
+	const void *b
+) {
+	size_t x = ((const Literal *)a)->start;
+	size_t y = ((const Literal *)b)->start;
+	return (x > y) - (x < y);
+}
+
+// replace constant literals in 'query' with hidden parameters
+// such that queries which differ only by their literals share a plan
+char *AST_ParameterizeLiterals
+(
+	const char *query,  // query string excluding query parameters
+	SIValue **literals  // [output] replaced literals
+) {
+	ASSERT(query    != NULL);
+	ASSERT(literals != NULL);
+
+	// remove trailing semicolons, as parse_query does
+	size_t len = strlen(query);
+	while(len > 0 && query[len - 1] == ';') len--;
+
+	cypher_parse_result_t *result = cypher_uparse(query, len, NULL, NULL,
+			CYPHER_PARSE_SINGLE);
+	if(result == NULL) return NULL;
+
+	// leave invalid queries to the parser to report
+	if(cypher_parse_result_nerrors(result) > 0) {
+		cypher_parse_result_free(result);
+		return NULL;
+	}
+
+	// locate the statement, skipping comments
+	const cypher_astnode_t *statement = NULL;
+	uint nroots = cypher_parse_result_nroots(result);
+	for(uint i = 0; i < nroots && statement == NULL; i++) {
+		const cypher_astnode_t *root = cypher_parse_result_get_root(result, i);
+		if(cypher_astnode_type(root) == CYPHER_AST_STATEMENT) {
+			statement = root;
+		}
+	}
+
+	// index statements evaluate their literals when parsed
+	const cypher_astnode_t *body = (statement == NULL)
+		? NULL
+		: cypher_ast_statement_get_body(statement);
+	if(body == NULL || cypher_astnode_type(body) != CYPHER_AST_QUERY) {
+		cypher_parse_result_free(result);
+		return NULL;
+	}
+
+	Literal *lits = array_new(Literal, 0);
+	_Visit(body, &lits);
+	cypher_parse_result_free(result);
+
+	uint n = array_len(lits);
+	if(n == 0) {
+		array_free(lits);
+		return NULL;
+	}
+
+	// parameters are numbered by their position within the query
+	qsort(lits, n, sizeof(Literal), _LiteralCmp);
+
+	sds out = sdsempty();  // parameterized query
+	size_t copied = 0;     // length of query copied to 'out'
+	SIValue *values = array_new(SIValue, n);
+
+	for(uint i = 0; i < n; i++) {
+		out = sdscatlen(out, query + copied, lits[i].start - copied);
+		out = sdscatprintf(out, "$" LITERAL_PARAM_PREFIX "%u", i);
+		array_append(values, lits[i].v);
+		copied = lits[i].end;
+	}
+
+	out = sdscatlen(out, query + copied, strlen(query) - copied);
+	array_free(lits);
+
+	*literals = values;
+	return out;
+}
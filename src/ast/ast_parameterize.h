@@ -0,0 +1,32 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../value.h"
+
+// prefix of parameters introduced by literal parameterization
+// the i'th replaced literal is bound to parameter LITERAL_PARAM_PREFIX<i>
+#define LITERAL_PARAM_PREFIX "__lit"
+
+// replace constant literals in 'query' with hidden parameters
+// such that queries which differ only by their literals share a plan
+//
+// the query is parsed and its AST is searched for number and string
+// literals which are compared against, assigned or used as map values
+// e.g. WHERE n.v = 42, SET n.v = 1, MATCH (n {name: 'a'})
+// literals which affect the plan's shape or the result's column names
+// e.g. LIMIT 10, RETURN 1, [*1..3] are retained
+//
+// returns NULL if the query is invalid or no literal was replaced
+// otherwise the parameterized query string, which the caller should free
+// with sdsfree
+// 'literals' [output] is set to an array of replaced literal values
+// in parameter order, the caller owns both the array and its values
+char *AST_ParameterizeLiterals
+(
+	const char *query,  // query string excluding query parameters
+	SIValue **literals  // [output] replaced literals
+);
@@ -1942,6 +1942,120 @@ static VISITOR_STRATEGY _Validate_RETURN_Clause
 	return !ErrorCtx_EncounteredError() ? VISITOR_CONTINUE : VISITOR_BREAK;
 }
 
+// checks whether 'pattern' declares node 'alias'
+// sets 'labeled' if any of the node's declarations is labeled 'label'
+static bool _PatternDeclaresNode
+(
+	const cypher_astnode_t *pattern,  // MATCH pattern
+	const char *alias,                // node alias
+	const char *label,                // [optional] label
+	bool *labeled                     // [output] node is labeled 'label'
+) {
+	bool found = false;
+	*labeled = false;
+
+	uint npaths = cypher_ast_pattern_npaths(pattern);
+	for(uint i = 0; i < npaths; i++) {
+		const cypher_astnode_t *path = cypher_ast_pattern_get_path(pattern, i);
+		uint nelements = cypher_ast_pattern_path_nelements(path);
+
+		// nodes are in even positions
+		for(uint j = 0; j < nelements; j += 2) {
+			const cypher_astnode_t *node =
+				cypher_ast_pattern_path_get_element(path, j);
+			const cypher_astnode_t *identifier =
+				cypher_ast_node_pattern_get_identifier(node);
+			if(identifier == NULL ||
+			   strcmp(cypher_ast_identifier_get_name(identifier), alias) != 0) {
+				continue;
+			}
+
+			found = true;
+			if(label == NULL) {
+				continue;
+			}
+
+			uint nlabels = cypher_ast_node_pattern_nlabels(node);
+			for(uint k = 0; k < nlabels; k++) {
+				const cypher_astnode_t *l =
+					cypher_ast_node_pattern_get_label(node, k);
+				if(strcmp(cypher_ast_label_get_name(l), label) == 0) {
+					*labeled = true;
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+// validate a single planner hint against its node
+static AST_Validation _ValidateHintNode
+(
+	const cypher_astnode_t *pattern,     // MATCH pattern
+	const char *hint,                    // hint name
+	const cypher_astnode_t *identifier,  // hinted identifier
+	const cypher_astnode_t *label        // [optional] hinted label
+) {
+	const char *alias = cypher_ast_identifier_get_name(identifier);
+	const char *label_name = (label) ? cypher_ast_label_get_name(label) : NULL;
+
+	bool labeled;
+	if(!_PatternDeclaresNode(pattern, alias, label_name, &labeled)) {
+		ErrorCtx_SetError(EMSG_HINT_NOT_A_NODE, hint, alias);
+		return AST_INVALID;
+	}
+
+	if(label_name != NULL && !labeled) {
+		ErrorCtx_SetError(EMSG_HINT_MISSING_LABEL, hint, alias, label_name);
+		return AST_INVALID;
+	}
+
+	return AST_VALID;
+}
+
+// validate MATCH planner hints
+// USING INDEX n:L(v), USING SCAN n:L and USING JOIN ON n
+// must refer to a node of the clause's pattern, labeled as hinted
+static AST_Validation _ValidateMatchHints
+(
+	const cypher_astnode_t *n  // MATCH clause
+) {
+	const cypher_astnode_t *pattern = cypher_ast_match_get_pattern(n);
+
+	uint nhints = cypher_ast_match_nhints(n);
+	for(uint i = 0; i < nhints; i++) {
+		AST_Validation res = AST_VALID;
+		const cypher_astnode_t *hint = cypher_ast_match_get_hint(n, i);
+		cypher_astnode_type_t t = cypher_astnode_type(hint);
+
+		if(t == CYPHER_AST_USING_INDEX) {
+			res = _ValidateHintNode(pattern, "index",
+					cypher_ast_using_index_get_identifier(hint),
+					cypher_ast_using_index_get_label(hint));
+		} else if(t == CYPHER_AST_USING_SCAN) {
+			res = _ValidateHintNode(pattern, "scan",
+					cypher_ast_using_scan_get_identifier(hint),
+					cypher_ast_using_scan_get_label(hint));
+		} else if(t == CYPHER_AST_USING_JOIN) {
+			uint nids = cypher_ast_using_join_nidentifiers(hint);
+			for(uint j = 0; j < nids && res == AST_VALID; j++) {
+				res = _ValidateHintNode(pattern, "join",
+						cypher_ast_using_join_get_identifier(hint, j), NULL);
+			}
+		} else {
+			ErrorCtx_SetError(EMSG_NOT_SUPPORTED, "Hint");
+			res = AST_INVALID;
+		}
+
+		if(res != AST_VALID) {
+			return res;
+		}
+	}
+
+	return AST_VALID;
+}
+
 // validate a MATCH clause
 static VISITOR_STRATEGY _Validate_MATCH_Clause
 (
@@ -1956,6 +2070,11 @@ static VISITOR_STRATEGY _Validate_MATCH_Clause
 	}
 
 	vctx->clause = cypher_astnode_type(n);
+
+	if(_ValidateMatchHints(n) != AST_VALID) {
+		return VISITOR_BREAK;
+	}
+
 	return VISITOR_RECURSE;
 }
 
@@ -2182,6 +2301,16 @@ static VISITOR_STRATEGY _visit_break
 	return VISITOR_BREAK;
 }
 
+// skip a node's children, the node is validated by its parent
+static VISITOR_STRATEGY _visit_skip
+(
+	const cypher_astnode_t *n,  // ast-node
+	bool start,                 // first traversal
+	ast_visitor *visitor        // visitor
+) {
+	return VISITOR_CONTINUE;
+}
+
 // visit a binary operator, break if it is unsupported
 static VISITOR_STRATEGY _visit_binary_op
 (
@@ -2271,6 +2400,11 @@ bool AST_ValidationsMappingInit(void) {
 	validations_mapping[CYPHER_AST_DROP_PATTERN_PROPS_INDEX]   = _Validate_index_deletion;	
 	validations_mapping[CYPHER_AST_CREATE_PATTERN_PROPS_INDEX] = _Validate_index_creation;
 
+	// planner hints are validated by their MATCH clause
+	validations_mapping[CYPHER_AST_USING_JOIN]                 = _visit_skip;
+	validations_mapping[CYPHER_AST_USING_SCAN]                 = _visit_skip;
+	validations_mapping[CYPHER_AST_USING_INDEX]                = _visit_skip;
+
 	//--------------------------------------------------------------------------
 	// register unsupported types
 	//--------------------------------------------------------------------------
@@ -2281,12 +2415,9 @@ bool AST_ValidationsMappingInit(void) {
 	validations_mapping[CYPHER_AST_COMMAND]                     = _visit_break;
 	validations_mapping[CYPHER_AST_LOAD_CSV]                    = _visit_break;
 	validations_mapping[CYPHER_AST_MATCH_HINT]                  = _visit_break;
-	validations_mapping[CYPHER_AST_USING_JOIN]                  = _visit_break;
-	validations_mapping[CYPHER_AST_USING_SCAN]                  = _visit_break;
 	validations_mapping[CYPHER_AST_INDEX_NAME]                  = _visit_break;
 	validations_mapping[CYPHER_AST_REL_ID_LOOKUP]               = _visit_break;
 	validations_mapping[CYPHER_AST_ALL_RELS_SCAN]               = _visit_break;
-	validations_mapping[CYPHER_AST_USING_INDEX]                 = _visit_break;
 	validations_mapping[CYPHER_AST_START_POINT]                 = _visit_break;
 	validations_mapping[CYPHER_AST_REMOVE_ITEM]                 = _visit_break;
 	validations_mapping[CYPHER_AST_QUERY_OPTION]                = _visit_break;
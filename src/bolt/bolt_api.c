@@ -16,6 +16,23 @@ rax *clients;
 RedisModuleString *BOLT;
 RedisModuleString *COMMAND;
 
+// guards clients, accessed by all I/O threads
+static pthread_mutex_t clients_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// remove client from the connected clients and free it
+static void free_client
+(
+	bolt_client_t *client  // the client to free
+) {
+	ASSERT(client != NULL);
+
+	pthread_mutex_lock(&clients_lock);
+	raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
+	pthread_mutex_unlock(&clients_lock);
+
+	bolt_client_free(client);
+}
+
 // handle the HELLO message
 static void BoltHelloCommand
 (
@@ -67,9 +84,11 @@ static bool is_authenticated
 
 	if(auth_size < 3) {
 		// if no password provided check we can call PING
+		RedisModule_ThreadSafeContextLock(client->ctx);
 		RedisModuleCallReply *reply = RedisModule_Call(client->ctx, "PING", "");
 		bool res = RedisModule_CallReplyType(reply) != REDISMODULE_REPLY_ERROR;
 		RedisModule_FreeCallReply(reply);
+		RedisModule_ThreadSafeContextUnlock(client->ctx);
 		return res;
 	}
 
@@ -118,9 +137,11 @@ static bool is_authenticated
 	bolt_read_string_size(&client->msg_buf.read, &len);
 	char credentials[len];
 	bolt_read_string(&client->msg_buf.read, credentials);
+	RedisModule_ThreadSafeContextLock(client->ctx);
 	RedisModuleCallReply *reply = RedisModule_Call(client->ctx, "AUTH", "b", credentials, len);
 	bool res = RedisModule_CallReplyType(reply) != REDISMODULE_REPLY_ERROR;
 	RedisModule_FreeCallReply(reply);
+	RedisModule_ThreadSafeContextUnlock(client->ctx);
 	return res;
 }
 
@@ -376,21 +397,77 @@ void BoltRunCommand
 		bolt_client_end_message(client);
 		bolt_client_finish_write(client);
 	} else {
+		// records are sent once pulled
+		client->discard = false;
+		client->pull_n  = 0;
+
 		args[0] = COMMAND;
 		args[1] = graph_name;
 		args[2] = query;
 		args[3] = BOLT;
 		args[4] = (RedisModuleString *)client;
 
+		// dispatch accesses the keyspace, acquire Redis GIL
+		// message decoding above and the reply are handled by the I/O thread
+		RedisModule_ThreadSafeContextLock(ctx);
 		CommandDispatch(ctx, args, 5);
+		RedisModule_ThreadSafeContextUnlock(ctx);
 	}
 
 	RedisModule_FreeString(ctx, query);
 	RedisModule_FreeString(ctx, graph_name);
 }
 
+// read an integer value from the message buffer
+static int64_t read_int
+(
+	bolt_client_t *client  // the client that sent the message
+) {
+	ASSERT(client != NULL);
+
+	switch(bolt_read_type(client->msg_buf.read)) {
+		case BVT_INT8:
+			return bolt_read_int8(&client->msg_buf.read);
+		case BVT_INT16:
+			return bolt_read_int16(&client->msg_buf.read);
+		case BVT_INT32:
+			return bolt_read_int32(&client->msg_buf.read);
+		case BVT_INT64:
+			return bolt_read_int64(&client->msg_buf.read);
+		default:
+			ASSERT(false);
+			return -1;
+	}
+}
+
+// read the number of records requested by a PULL or DISCARD message
+// -1 stands for all remaining records
+static int64_t get_fetch_size
+(
+	bolt_client_t *client  // the client that sent the message
+) {
+	ASSERT(client != NULL);
+
+	int64_t n = -1;
+	uint32_t size = bolt_read_map_size(&client->msg_buf.read);
+	for(uint32_t i = 0; i < size; i++) {
+		uint32_t key_len;
+		bolt_read_string_size(&client->msg_buf.read, &key_len);
+		char key[key_len];
+		bolt_read_string(&client->msg_buf.read, key);
+
+		int64_t v = read_int(client);
+		if(key_len == 1 && key[0] == 'n') {
+			n = v;
+		}
+	}
+
+	return n;
+}
+
 // handle the PULL message
-void BoltPullCommand
+// returns true if a suspended query was resumed to reply
+static bool BoltPullCommand
 (
 	bolt_client_t *client  // the client that sent the message
 ) {
@@ -402,6 +479,36 @@ void BoltPullCommand
 	// }
 
 	ASSERT(client != NULL);
+
+	// a query which emitted a full batch is suspended awaiting this PULL
+	// otherwise the whole result stream was already replied
+	int64_t n = get_fetch_size(client);
+	return bolt_client_resume(client, n, false);
+}
+
+// handle the DISCARD message
+static void BoltDiscardCommand
+(
+	bolt_client_t *client  // the client that sent the message
+) {
+	// The DISCARD message requests that the remainder of the result stream should be thrown away
+	// input:
+	// extra::Dictionary{
+	//   n::Integer,
+	//   qid::Integer,
+	// }
+
+	ASSERT(client != NULL);
+
+	// a suspended query stops producing records and replies on its own
+	if(bolt_client_resume(client, 0, true)) {
+		return;
+	}
+
+	bolt_client_reply_for(client, BST_DISCARD, BST_SUCCESS, 1);
+	bolt_reply_map(client, 0);
+	bolt_client_end_message(client);
+	bolt_client_finish_write(client);
 }
 
 // handle the BEGIN message
@@ -526,9 +633,14 @@ void BoltRequestHandler
 ) {
 	ASSERT(client != NULL);
 
-	// if there is a message already in process or
 	// not enough data to read the message
-	if(client->processing || buffer_index_length(&client->read_buf.read) <= 2) {
+	if(buffer_index_length(&client->read_buf.read) <= 2) {
+		return;
+	}
+
+	// there is a message already in process, e.g. by a query
+	// which took back the client once its PULL wait expired
+	if(!bolt_client_claim(client)) {
 		return;
 	}
 
@@ -543,7 +655,11 @@ void BoltRequestHandler
 	uint16_t size = ntohs(buffer_read_uint16(&current_read));
 	ASSERT(size > 0);
 	while(size > 0) {
-		if(buffer_index_length(&current_read) < size) return;
+		if(buffer_index_length(&current_read) < size) {
+			// wait for the rest of the message
+			bolt_client_release(client);
+			return;
+		}
 		buffer_read(&current_read, &client->msg_buf.write, size);
 		size = ntohs(buffer_read_uint16(&current_read));
 	}
@@ -554,8 +670,6 @@ void BoltRequestHandler
 		client->ws_frame = client->read_buf.read;
 	}
 
-	client->processing = true;
-
 	switch (bolt_read_structure_type(&client->msg_buf.read))
 	{
 		case BST_HELLO:
@@ -567,18 +681,20 @@ void BoltRequestHandler
 		case BST_LOGOFF:
 			break;
 		case BST_GOODBYE:
-			client->processing = false;
-			raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
-			bolt_client_free(client);
+			bolt_client_release(client);
+			BoltIO_Del(client->loop, client->socket, BOLT_IO_READABLE);
+			if(!bolt_client_shutdown(client)) free_client(client);
 			break;
 		case BST_RUN:
 			BoltRunCommand(client);
 			break;
 		case BST_DISCARD:
+			BoltDiscardCommand(client);
 			break;
 		case BST_PULL:
-			BoltPullCommand(client);
-			client->processing = false;
+			// the resumed query replies once its next batch is ready
+			if(BoltPullCommand(client)) break;
+			bolt_client_release(client);
 			BoltRequestHandler(client);
 			break;
 		case BST_BEGIN:
@@ -611,13 +727,11 @@ void BoltReadHandler
 	bolt_client_t *client = (bolt_client_t*)user_data;
 	if(!buffer_socket_read(&client->read_buf, client->socket)) {
 		// client disconnected
-		RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_READABLE);
-		if(client->processing) {
-			client->shutdown = true;
-			return;
-		}
-		raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
-		bolt_client_free(client);
+		BoltIO_Del(client->loop, fd, BOLT_IO_READABLE);
+		// a suspended query is resumed to discard its remaining records
+		// the client is freed once the query concludes
+		if(bolt_client_shutdown(client)) return;
+		free_client(client);
 		return;
 	}
 
@@ -638,7 +752,11 @@ void BoltReadHandler
 			memmove(dst, src, size);
 			current_read.offset -= 6;
 			client->read_buf.write.offset -= 6;
-			bolt_client_finish_write(client);
+			// a suspended query discards its remaining records
+			// its final flush replies to the RESET
+			if(!bolt_client_resume(client, 0, true)) {
+				bolt_client_finish_write(client);
+			}
 		} else {
 			size = ntohs(buffer_read_uint16(&current_read));
 			while(size > 0) {
@@ -663,16 +781,14 @@ void BoltHandshakeHandler
 	bolt_client_t *client = (bolt_client_t *)user_data;
 	if(!buffer_socket_read(&client->read_buf, client->socket)) {
 		// client disconnected
-		RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_READABLE);
-		raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
-		bolt_client_free(client);
+		BoltIO_Del(client->loop, fd, BOLT_IO_READABLE);
+		free_client(client);
 		return;
 	}
 
 	if(client->ws && ws_read_frame(&client->read_buf.read) != 20) {
-		RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_READABLE);
-		raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
-		bolt_client_free(client);
+		BoltIO_Del(client->loop, fd, BOLT_IO_READABLE);
+		free_client(client);
 		return;
 	}
 
@@ -682,9 +798,8 @@ void BoltHandshakeHandler
 		buffer_index_t start = write;
 		buffer_index_set(&client->read_buf.read, &client->read_buf, 0);
 		if(!ws_handshake(&client->read_buf.read, &write)) {
-			RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_READABLE);
-			raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
-			bolt_client_free(client);
+			BoltIO_Del(client->loop, fd, BOLT_IO_READABLE);
+			free_client(client);
 			return;
 		}
 		buffer_socket_write(&start, &write, client->socket);
@@ -697,9 +812,8 @@ void BoltHandshakeHandler
 
 	bolt_version_t version = bolt_read_supported_version(client);
 	if(version.major != 5 || version.minor < 1) {
-		RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_READABLE);
-		raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
-		bolt_client_free(client);
+		BoltIO_Del(client->loop, fd, BOLT_IO_READABLE);
+		free_client(client);
 		return;
 	}
 
@@ -716,8 +830,8 @@ void BoltHandshakeHandler
 	buffer_index_set(&client->read_buf.read, &client->read_buf, 0);
 	buffer_index_set(&client->read_buf.write, &client->read_buf, 0);
 
-	RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_READABLE);
-	RedisModule_EventLoopAdd(fd, REDISMODULE_EVENTLOOP_READABLE, BoltReadHandler, client);
+	BoltIO_Del(client->loop, fd, BOLT_IO_READABLE);
+	BoltIO_Add(client->loop, fd, BOLT_IO_READABLE, BoltReadHandler, client);
 }
 
 // write data from client buffer to socket
@@ -732,17 +846,29 @@ void BoltResponseHandler
 
 	bolt_client_t *client = (bolt_client_t*)user_data;
 
-	if(client->shutdown) {
-		RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_READABLE);
-		raxRemove(clients, (unsigned char *)&client->socket, sizeof(client->socket), NULL);
-		bolt_client_free(client);
+	bolt_send_status status = client->shutdown
+		? BOLT_SEND_FAILED
+		: bolt_client_send(client);
+
+	// the socket's send buffer is full, the write handler remains
+	// registered and resumes sending once the socket is writable
+	if(status == BOLT_SEND_PENDING) return;
+
+	if(status == BOLT_SEND_FAILED) {
+		// client disconnected or its connection broke
+		// a query suspended by this flush is resumed to discard its
+		// remaining records, the client is freed once it flushes again
+		bolt_client_shutdown(client);
+		BoltIO_Del(client->loop, fd, BOLT_IO_READABLE | BOLT_IO_WRITABLE);
+		if(bolt_client_resume(client, 0, true)) return;
+		free_client(client);
 		return;
 	}
 
-	bolt_client_send(client);
-	client->processing = false;
-
-	RedisModule_EventLoopDel(fd, REDISMODULE_EVENTLOOP_WRITABLE);
+	// stop monitoring writability ahead of releasing the client
+	// a query taking back the client might flush right away
+	BoltIO_Del(client->loop, fd, BOLT_IO_WRITABLE);
+	bolt_client_release(client);
 
 	BoltRequestHandler(client);
 }
@@ -767,9 +893,15 @@ void BoltAcceptHandler
 		return;
 	}
 
-	bolt_client_t *client = bolt_client_new(socket, global_ctx, BoltResponseHandler);
+	// spread clients across I/O threads
+	bolt_io_loop *loop = BoltIO_Next();
+	bolt_client_t *client = bolt_client_new(socket, loop, global_ctx, BoltResponseHandler);
+
+	pthread_mutex_lock(&clients_lock);
 	raxInsert(clients, (unsigned char *)&socket, sizeof(socket), client, NULL);
-	RedisModule_EventLoopAdd(socket, REDISMODULE_EVENTLOOP_READABLE, BoltHandshakeHandler, client);
+	pthread_mutex_unlock(&clients_lock);
+
+	BoltIO_Add(loop, socket, BOLT_IO_READABLE, BoltHandshakeHandler, client);
 }
 
 
@@ -819,16 +951,25 @@ int BoltApi_Register
 
 	RedisModuleCtx *global_ctx = RedisModule_GetDetachedThreadSafeContext(ctx);
 
-	if(RedisModule_EventLoopAdd(bolt, REDISMODULE_EVENTLOOP_READABLE, BoltAcceptHandler, global_ctx) == REDISMODULE_ERR) {
-		RedisModule_Log(ctx, "warning", "Failed to register socket accept handler");
-		return REDISMODULE_ERR;
-	}
-	RedisModule_Log(NULL, "notice", "Bolt protocol initialized. Port: %d", port);
-
 	COMMAND = RedisModule_CreateString(global_ctx, "graph.QUERY", 11);
 	BOLT = RedisModule_CreateString(global_ctx, "--bolt", 6);
 	clients = raxNew();
 
+	// bolt sockets are served by dedicated I/O threads
+	// keeping the Redis main thread free for RESP clients
+	uint io_threads;
+	Config_Option_get(Config_BOLT_IO_THREADS, &io_threads);
+	if(!BoltIO_Start(io_threads)) {
+		RedisModule_Log(ctx, "warning", "Failed to start bolt I/O threads");
+		return REDISMODULE_ERR;
+	}
+
+	if(!BoltIO_Add(BoltIO_Next(), bolt, BOLT_IO_READABLE, BoltAcceptHandler, global_ctx)) {
+		RedisModule_Log(ctx, "warning", "Failed to register socket accept handler");
+		return REDISMODULE_ERR;
+	}
+	RedisModule_Log(NULL, "notice", "Bolt protocol initialized. Port: %d, I/O threads: %u", port, io_threads);
+
     return REDISMODULE_OK;
 }
 
@@ -842,6 +983,9 @@ void BoltApi_Unregister
 
 	ASSERT(clients != NULL);
 
+	// no handler runs once I/O threads are stopped
+	BoltIO_Stop();
+
 	raxIterator iter;
 	raxStart(&iter, clients);
 	raxSeek(&iter, "^", NULL, 0);
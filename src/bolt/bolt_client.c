@@ -8,34 +8,58 @@
 #include "bolt.h"
 #include "util/arr.h"
 #include "bolt_client.h"
+#include "cron/cron.h"
 #include "util/rmalloc.h"
+#include "util/thpool/pools.h"
+#include <errno.h>
 #include <arpa/inet.h>
 
+// number of queries suspended awaiting a PULL, across all clients
+// each occupies the reader thread executing it and holds a read lock
+static uint32_t _suspended_count = 0;
+
 // create a new bolt client
 bolt_client_t *bolt_client_new
 (
-	socket_t socket,                   // the socket file descriptor
-	RedisModuleCtx *ctx,               // the redis module context
-	RedisModuleEventLoopFunc on_write  // the write callback
+	socket_t socket,           // the socket file descriptor
+	bolt_io_loop *loop,        // the I/O loop serving the client
+	RedisModuleCtx *ctx,       // the redis module context
+	bolt_io_handler on_write   // the write callback
 ) {
 	ASSERT(socket > 0);
 	ASSERT(ctx != NULL);
+	ASSERT(loop != NULL);
 	ASSERT(on_write != NULL);
 
 	bolt_client_t *client = rm_malloc(sizeof(bolt_client_t));
 	client->ws         = false;
 	client->ctx        = ctx;
+	client->loop       = loop;
 	client->state      = BS_NEGOTIATION;
 	client->reset      = false;
 	client->socket     = socket;
 	client->on_write   = on_write;
 	client->shutdown   = false;
 	client->processing = false;
+	client->suspended  = false;
+	client->discard    = false;
+	client->pull_n     = -1;
 	client->write_messages = array_new(bolt_message_t, 1);
+	client->write_iov        = NULL;
+	client->write_iov_offset = 0;
 	buffer_new(&client->msg_buf);
 	buffer_new(&client->read_buf);
 	buffer_new(&client->write_buf);
 	buffer_index_set(&client->ws_frame, &client->read_buf, 0);
+	pthread_mutex_init(&client->pull_lock, NULL);
+
+	// suspended queries wait on the monotonic clock, see Cron_Now
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&client->pull_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
 	return client;
 }
 
@@ -536,18 +560,13 @@ void bolt_change_client_state
 }
 
 
-// reply the response type
-// and change the client state according to the request and response type
-void bolt_client_reply_for
+// prepare for the next message
+static void bolt_client_begin_message
 (
-	bolt_client_t *client,              // the client
-	bolt_structure_type request_type,   // the request type
-	bolt_structure_type response_type,  // the response type
-	uint32_t size                       // the size of the response structure
+	bolt_client_t *client  // the client
 ) {
 	ASSERT(client != NULL);
 
-	// prepare for the current message
 	bolt_message_t msg;
 	if(client->ws) {
 		msg.ws_header = client->write_buf.write;
@@ -558,7 +577,20 @@ void bolt_client_reply_for
 	msg.start = client->write_buf.write;
 	msg.end = client->write_buf.write;
 	array_append(client->write_messages, msg);
+}
+
+// reply the response type
+// and change the client state according to the request and response type
+void bolt_client_reply_for
+(
+	bolt_client_t *client,              // the client
+	bolt_structure_type request_type,   // the request type
+	bolt_structure_type response_type,  // the response type
+	uint32_t size                       // the size of the response structure
+) {
+	ASSERT(client != NULL);
 
+	bolt_client_begin_message(client);
 	bolt_reply_structure(client, response_type, size);
 	bolt_change_client_state(client, request_type, response_type);
 }
@@ -585,75 +617,264 @@ void bolt_client_end_message
 	msg->end = client->write_buf.write;
 }
 
-// write all messages to the socket on the main thread
+// write all messages to the socket on the client's I/O thread
 void bolt_client_finish_write
 (
 	bolt_client_t *client  // the client
 ) {
 	ASSERT(client != NULL);
 
-	RedisModule_EventLoopAdd(client->socket, REDISMODULE_EVENTLOOP_WRITABLE, client->on_write, client);
+	BoltIO_Add(client->loop, client->socket, BOLT_IO_WRITABLE,
+			client->on_write, client);
 }
 
-// write all messages to the socket
-void bolt_client_send
+// reply to the current PULL, flush and suspend the calling query thread
+// until the client either pulls more records or discards the stream
+// the wait is bounded by 'deadline' and BOLT_PULL_TIMEOUT, once expired
+// the remainder of the stream should be discarded
+bolt_pull_status bolt_client_await_pull
+(
+	bolt_client_t *client,  // the client
+	bool has_more,          // reply to the current PULL with has_more
+	uint64_t deadline       // query deadline, ms on Cron_Now's clock, 0 if none
+) {
+	ASSERT(client != NULL);
+
+	// keep a reader thread available to other queries
+	// once exhausted, the remainder of the stream is sent without suspending
+	uint32_t readers = ThreadPools_ReadersCount();
+	uint32_t max_suspended = readers > 1 ? readers - 1 : 1;
+	if(__atomic_add_fetch(&_suspended_count, 1, __ATOMIC_RELAXED) >
+	   max_suspended) {
+		__atomic_sub_fetch(&_suspended_count, 1, __ATOMIC_RELAXED);
+		client->pull_n = -1;
+		return BOLT_PULL_RESUMED;
+	}
+
+	if(has_more) {
+		// the stream remains open, retain the streaming state
+		bolt_client_state state = client->state;
+		bolt_client_reply_for(client, BST_PULL, BST_SUCCESS, 1);
+		client->state = state;
+		bolt_reply_map(client, 1);
+		bolt_reply_string(client, "has_more", 8);
+		bolt_reply_bool(client, true);
+		bolt_client_end_message(client);
+	}
+
+	// mark the query as suspended before flushing
+	// the main thread resumes it once the flushed messages are sent
+	// and the next PULL or DISCARD is processed
+	pthread_mutex_lock(&client->pull_lock);
+	client->suspended = true;
+	pthread_mutex_unlock(&client->pull_lock);
+
+	bolt_client_finish_write(client);
+
+	uint64_t due = Cron_Now() + BOLT_PULL_TIMEOUT;
+	if(deadline != 0 && deadline < due) due = deadline;
+
+	struct timespec ts;
+	ts.tv_sec  = due / 1000;
+	ts.tv_nsec = (due % 1000) * 1000000;
+
+	bool expired = false;
+	bolt_pull_status status = BOLT_PULL_RESUMED;
+
+	pthread_mutex_lock(&client->pull_lock);
+	while(client->suspended) {
+		if(!expired) {
+			expired = pthread_cond_timedwait(&client->pull_cond,
+					&client->pull_lock, &ts) == ETIMEDOUT;
+		} else {
+			// the I/O thread is busy with the client
+			// wait for it to either release or resume us
+			pthread_cond_wait(&client->pull_cond, &client->pull_lock);
+		}
+
+		if(expired && client->suspended && !client->processing) {
+			// abandoned stream, the query takes back the idle client
+			// to fail the stream and release its read lock
+			client->processing = true;
+			client->suspended  = false;
+			status = BOLT_PULL_EXPIRED;
+		}
+	}
+	if(status != BOLT_PULL_EXPIRED && client->discard) {
+		status = BOLT_PULL_DISCARDED;
+	}
+	pthread_mutex_unlock(&client->pull_lock);
+
+	__atomic_sub_fetch(&_suspended_count, 1, __ATOMIC_RELAXED);
+
+	return status;
+}
+
+// claim the client for processing its next message
+// returns false if the client is already being processed
+bool bolt_client_claim
 (
 	bolt_client_t *client  // the client
 ) {
 	ASSERT(client != NULL);
 
+	pthread_mutex_lock(&client->pull_lock);
+
+	bool claimed = !client->processing;
+	client->processing = true;
+
+	pthread_mutex_unlock(&client->pull_lock);
+
+	return claimed;
+}
+
+// release the client once its message was processed and replied
+// a suspended query waiting for the client to be released is notified
+void bolt_client_release
+(
+	bolt_client_t *client  // the client
+) {
+	ASSERT(client != NULL);
+
+	pthread_mutex_lock(&client->pull_lock);
+
+	client->processing = false;
+	pthread_cond_signal(&client->pull_cond);
+
+	pthread_mutex_unlock(&client->pull_lock);
+}
+
+// mark a disconnected client for shutdown
+// an idle suspended query is resumed to discard the remainder of its stream
+// returns false if the client isn't in use and can be freed right away
+// otherwise the client is freed once its last reply is flushed
+bool bolt_client_shutdown
+(
+	bolt_client_t *client  // the client
+) {
+	ASSERT(client != NULL);
+
+	pthread_mutex_lock(&client->pull_lock);
+
+	bool in_use = client->processing || client->suspended;
+	if(in_use) client->shutdown = true;
+
+	if(client->suspended && !client->processing) {
+		client->processing = true;
+		client->suspended  = false;
+		client->discard    = true;
+		client->pull_n     = 0;
+		pthread_cond_signal(&client->pull_cond);
+	}
+
+	pthread_mutex_unlock(&client->pull_lock);
+
+	return in_use;
+}
+
+// resume a query suspended by bolt_client_await_pull
+// returns false if there's no suspended query
+bool bolt_client_resume
+(
+	bolt_client_t *client,  // the client
+	int64_t n,              // number of records to send, -1 for all
+	bool discard            // discard the remainder of the result stream
+) {
+	ASSERT(client != NULL);
+
+	pthread_mutex_lock(&client->pull_lock);
+
+	bool suspended = client->suspended;
+	if(suspended) {
+		// the resumed query owns the client until it flushes again
+		client->processing = true;
+		client->suspended  = false;
+		client->discard    = discard;
+		client->pull_n     = n;
+		pthread_cond_signal(&client->pull_cond);
+	}
+
+	pthread_mutex_unlock(&client->pull_lock);
+
+	return suspended;
+}
+
+// write the unsent remainder of the flushed messages
+static bolt_send_status bolt_client_send_pending
+(
+	bolt_client_t *client  // the client
+) {
+	ASSERT(client != NULL);
+	ASSERT(client->write_iov != NULL);
+
+	struct iovec *iov = client->write_iov + client->write_iov_offset;
+	int iovcnt = array_len(client->write_iov) - client->write_iov_offset;
+
+	bool res = socket_writev(client->socket, &iov, &iovcnt);
+	client->write_iov_offset = iov - client->write_iov;
+
+	if(res && iovcnt > 0) return BOLT_SEND_PENDING;
+
+	// either done or failed, drop the flushed messages
+	array_free(client->write_iov);
+	client->write_iov        = NULL;
+	client->write_iov_offset = 0;
+	array_clear(client->write_messages);
+	buffer_index_set(&client->write_buf.write, &client->write_buf, 0);
+
+	return res ? BOLT_SEND_DONE : BOLT_SEND_FAILED;
+}
+
+// write all messages to the socket without blocking
+// once the socket isn't writable the unsent remainder is kept
+// and BOLT_SEND_PENDING is returned, the next call resumes writing it
+bolt_send_status bolt_client_send
+(
+	bolt_client_t *client  // the client
+) {
+	ASSERT(client != NULL);
+
+	// messages flushed by a previous call come first
+	if(client->write_iov != NULL) {
+		bolt_send_status status = bolt_client_send_pending(client);
+		if(status != BOLT_SEND_DONE) return status;
+	}
+
 	if(client->reset) {
+		// replace the pending messages with the replies to RESET
 		array_clear(client->write_messages);
 		buffer_index_set(&client->write_buf.write, &client->write_buf, 0);
-		array_append(client->write_messages, (bolt_message_t){0});
-		bolt_message_t *msg = client->write_messages;
-		msg->bolt_header = client->write_buf.write;
-		buffer_write_uint16(&client->write_buf.write, 0x0000);
-		msg->start = client->write_buf.write;
-		msg->end = client->write_buf.write;
-		if(client->state != BS_FAILED) {
-			bolt_reply_structure(client, BST_SUCCESS, 1);
-			bolt_reply_map(client, 0);
+
+		if(client->state == BS_FAILED) {
+			bolt_client_begin_message(client);
+			bolt_reply_structure(client, BST_IGNORED, 0);
 			bolt_client_end_message(client);
-			buffer_socket_write(&msg->bolt_header, &msg->end, client->socket);
-			array_clear(client->write_messages);
-			client->reset = false;
-			return;
+			client->state = BS_READY;
 		}
 
-		bolt_reply_structure(client, BST_IGNORED, 0);
-		bolt_client_end_message(client);
-		buffer_socket_write(&msg->bolt_header, &msg->end, client->socket);
-
-		buffer_index_set(&client->write_buf.write, &client->write_buf, 0);
-		msg->bolt_header = client->write_buf.write;
-		buffer_write_uint16(&client->write_buf.write, 0x0000);
-		msg->start = client->write_buf.write;
-		msg->end = client->write_buf.write;
-
+		bolt_client_begin_message(client);
 		bolt_reply_structure(client, BST_SUCCESS, 1);
 		bolt_reply_map(client, 0);
 		bolt_client_end_message(client);
-		buffer_socket_write(&msg->bolt_header, &msg->end, client->socket);
-		array_clear(client->write_messages);
 		client->reset = false;
-		client->state = BS_READY;
-		return;
 	}
 
+	if(array_len(client->write_messages) == 0) return BOLT_SEND_DONE;
+
+	// gather all pending messages and write them at once
+	client->write_iov = array_new(struct iovec, 4);
 	if(client->ws) {
 		for(int i = 0; i < array_len(client->write_messages); i++) {
 			bolt_message_t *msg = client->write_messages + i;
-			buffer_socket_write(&msg->ws_header, &msg->end, client->socket);
+			buffer_iovec_append(&msg->ws_header, &msg->end, &client->write_iov);
 		}
 	} else {
 		bolt_message_t *first_msg = client->write_messages;
 		bolt_message_t *last_msg = client->write_messages + array_len(client->write_messages) - 1;
-		buffer_socket_write(&first_msg->bolt_header, &last_msg->end, client->socket);
+		buffer_iovec_append(&first_msg->bolt_header, &last_msg->end, &client->write_iov);
 	}
 
-	array_clear(client->write_messages);
-	buffer_index_set(&client->write_buf.write, &client->write_buf, 0);
+	return bolt_client_send_pending(client);
 }
 
 // validate bolt handshake
@@ -688,11 +909,15 @@ void bolt_client_free
 ) {
 	ASSERT(client != NULL);
 
-	RedisModule_EventLoopDel(client->socket, REDISMODULE_EVENTLOOP_WRITABLE);
+	BoltIO_Del(client->loop, client->socket,
+			BOLT_IO_READABLE | BOLT_IO_WRITABLE);
 	socket_close(client->socket);
 	buffer_free(&client->read_buf);
 	buffer_free(&client->write_buf);
 	buffer_free(&client->msg_buf);
 	array_free(client->write_messages);
+	if(client->write_iov != NULL) array_free(client->write_iov);
+	pthread_cond_destroy(&client->pull_cond);
+	pthread_mutex_destroy(&client->pull_lock);
 	rm_free(client);
 }
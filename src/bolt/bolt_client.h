@@ -7,8 +7,15 @@
 
 #include "buffer.h"
 #include "socket.h"
+#include "bolt_io.h"
 #include "../redismodule.h"
 
+#include <pthread.h>
+
+// longest a query remains suspended awaiting the client's next PULL, in ms
+// unless the query's deadline is due sooner
+#define BOLT_PULL_TIMEOUT 30000
+
 typedef enum bolt_structure_type bolt_structure_type;
 
 typedef enum bolt_client_state {
@@ -23,6 +30,18 @@ typedef enum bolt_client_state {
 	BS_DEFUNCT,
 } bolt_client_state;
 
+typedef enum bolt_pull_status {
+	BOLT_PULL_RESUMED,    // the client pulled more records
+	BOLT_PULL_DISCARDED,  // the client discarded the remainder of the stream
+	BOLT_PULL_EXPIRED,    // the client didn't pull in time
+} bolt_pull_status;
+
+typedef enum bolt_send_status {
+	BOLT_SEND_DONE,     // all messages were written
+	BOLT_SEND_PENDING,  // the socket isn't writable, resume once it is
+	BOLT_SEND_FAILED,   // the socket failed, the client should be closed
+} bolt_send_status;
+
 typedef struct bolt_message_t {
 	buffer_index_t ws_header; // the websocket header
 	buffer_index_t bolt_header; // the bolt header
@@ -41,9 +60,17 @@ typedef struct bolt_client_t {
 	buffer_t read_buf;                  // the read buffer
 	buffer_t write_buf;                 // the write buffer
 	bolt_message_t *write_messages;     // the messages to write
+	struct iovec *write_iov;            // flushed messages, NULL if none
+	int write_iov_offset;               // first unsent entry of write_iov
 	buffer_index_t ws_frame;            // last websocket frame index
 	RedisModuleCtx *ctx;                // the redis module context
-	RedisModuleEventLoopFunc on_write;  // the write callback
+	bolt_io_loop *loop;                 // the I/O loop serving the client
+	bolt_io_handler on_write;           // the write callback
+	pthread_mutex_t pull_lock;          // guards the pull state
+	pthread_cond_t pull_cond;           // signaled when a suspended query resumes
+	bool suspended;                     // is a query waiting for the next PULL
+	bool discard;                       // discard the remainder of the result stream
+	int64_t pull_n;                     // records left to send, -1 for all
 } bolt_client_t;
 
 typedef struct bolt_version_t {
@@ -54,9 +81,10 @@ typedef struct bolt_version_t {
 // create a new bolt client
 bolt_client_t *bolt_client_new
 (
-	socket_t socket,                   // the socket file descriptor
-	RedisModuleCtx *ctx,               // the redis module context
-	RedisModuleEventLoopFunc on_write  // the write callback
+	socket_t socket,           // the socket file descriptor
+	bolt_io_loop *loop,        // the I/O loop serving the client
+	RedisModuleCtx *ctx,       // the redis module context
+	bolt_io_handler on_write   // the write callback
 );
 
 // reply the response type
@@ -75,14 +103,59 @@ void bolt_client_end_message
 	bolt_client_t *client  // the client
 );
 
-// write all messages to the socket on the main thread
+// write all messages to the socket on the client's I/O thread
 void bolt_client_finish_write
 (
 	bolt_client_t *client  // the client
 );
 
-// write all messages to the socket
-void bolt_client_send
+// reply to the current PULL, flush and suspend the calling query thread
+// until the client either pulls more records or discards the stream
+// the wait is bounded by 'deadline' and BOLT_PULL_TIMEOUT, once expired
+// the remainder of the stream should be discarded
+bolt_pull_status bolt_client_await_pull
+(
+	bolt_client_t *client,  // the client
+	bool has_more,          // reply to the current PULL with has_more
+	uint64_t deadline       // query deadline, ms on Cron_Now's clock, 0 if none
+);
+
+// claim the client for processing its next message
+// returns false if the client is already being processed
+bool bolt_client_claim
+(
+	bolt_client_t *client  // the client
+);
+
+// release the client once its message was processed and replied
+// a suspended query waiting for the client to be released is notified
+void bolt_client_release
+(
+	bolt_client_t *client  // the client
+);
+
+// mark a disconnected client for shutdown
+// an idle suspended query is resumed to discard the remainder of its stream
+// returns false if the client isn't in use and can be freed right away
+// otherwise the client is freed once its last reply is flushed
+bool bolt_client_shutdown
+(
+	bolt_client_t *client  // the client
+);
+
+// resume a query suspended by bolt_client_await_pull
+// returns false if there's no suspended query
+bool bolt_client_resume
+(
+	bolt_client_t *client,  // the client
+	int64_t n,              // number of records to send, -1 for all
+	bool discard            // discard the remainder of the result stream
+);
+
+// write all messages to the socket without blocking
+// once the socket isn't writable the unsent remainder is kept
+// and BOLT_SEND_PENDING is returned, the next call resumes writing it
+bolt_send_status bolt_client_send
 (
 	bolt_client_t *client  // the client
 );
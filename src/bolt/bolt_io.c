@@ -0,0 +1,351 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "bolt_io.h"
+#include "util/rmalloc.h"
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#ifdef __APPLE__
+#include <sys/event.h>
+#else
+#include <sys/epoll.h>
+#endif
+
+// max number of events handled per loop iteration
+#define BOLT_IO_MAX_FIRED 128
+
+// loop wait timeout in milliseconds
+// bounds the time it takes a loop to notice it should stop
+#define BOLT_IO_TIMEOUT 100
+
+// handlers registered for a file descriptor
+typedef struct {
+	int mask;               // monitored events
+	bolt_io_handler rproc;  // readable handler
+	bolt_io_handler wproc;  // writable handler
+	void *user_data;        // user data passed to handlers
+} bolt_io_event;
+
+// event reported by the OS
+typedef struct {
+	int fd;    // the socket file descriptor
+	int mask;  // fired events
+} bolt_io_fired;
+
+struct bolt_io_loop {
+	int fd;                  // epoll or kqueue descriptor
+	pthread_t thread;        // thread running the loop
+	pthread_mutex_t lock;    // guards events
+	bolt_io_event *events;   // registered events indexed by file descriptor
+	int nevents;             // number of entries in events
+};
+
+static bolt_io_loop *loops = NULL;  // I/O loops
+static uint32_t loop_count = 0;     // number of I/O loops
+static atomic_uint next_loop;       // next loop to assign a client to
+static atomic_bool running;         // are the loops running
+
+//------------------------------------------------------------------------------
+// OS specific multiplexing
+//------------------------------------------------------------------------------
+
+#ifdef __APPLE__
+
+static int _BoltIO_Create(void) {
+	return kqueue();
+}
+
+// update monitored events of 'fd' from 'old_mask' to 'new_mask'
+static bool _BoltIO_Update
+(
+	bolt_io_loop *loop,  // the event loop
+	int fd,              // the socket file descriptor
+	int old_mask,        // currently monitored events
+	int new_mask         // events to monitor
+) {
+	struct kevent ke;
+
+	int added   = new_mask & ~old_mask;
+	int removed = old_mask & ~new_mask;
+
+	if(added & BOLT_IO_READABLE) {
+		EV_SET(&ke, fd, EVFILT_READ, EV_ADD, 0, 0, NULL);
+		if(kevent(loop->fd, &ke, 1, NULL, 0, NULL) == -1) return false;
+	}
+	if(added & BOLT_IO_WRITABLE) {
+		EV_SET(&ke, fd, EVFILT_WRITE, EV_ADD, 0, 0, NULL);
+		if(kevent(loop->fd, &ke, 1, NULL, 0, NULL) == -1) return false;
+	}
+	if(removed & BOLT_IO_READABLE) {
+		EV_SET(&ke, fd, EVFILT_READ, EV_DELETE, 0, 0, NULL);
+		kevent(loop->fd, &ke, 1, NULL, 0, NULL);
+	}
+	if(removed & BOLT_IO_WRITABLE) {
+		EV_SET(&ke, fd, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
+		kevent(loop->fd, &ke, 1, NULL, 0, NULL);
+	}
+
+	return true;
+}
+
+// wait for events, returns number of fired events
+static int _BoltIO_Poll
+(
+	bolt_io_loop *loop,    // the event loop
+	bolt_io_fired *fired,  // [output] fired events
+	int timeout            // timeout in milliseconds
+) {
+	struct kevent events[BOLT_IO_MAX_FIRED];
+	struct timespec ts = {timeout / 1000, (timeout % 1000) * 1000000};
+
+	int n = kevent(loop->fd, NULL, 0, events, BOLT_IO_MAX_FIRED, &ts);
+	for(int i = 0; i < n; i++) {
+		fired[i].fd   = events[i].ident;
+		fired[i].mask = (events[i].filter == EVFILT_READ)
+			? BOLT_IO_READABLE
+			: BOLT_IO_WRITABLE;
+	}
+
+	return n;
+}
+
+#else
+
+static int _BoltIO_Create(void) {
+	return epoll_create1(0);
+}
+
+// update monitored events of 'fd' from 'old_mask' to 'new_mask'
+static bool _BoltIO_Update
+(
+	bolt_io_loop *loop,  // the event loop
+	int fd,              // the socket file descriptor
+	int old_mask,        // currently monitored events
+	int new_mask         // events to monitor
+) {
+	struct epoll_event ee = {0};
+	ee.data.fd = fd;
+	if(new_mask & BOLT_IO_READABLE) ee.events |= EPOLLIN;
+	if(new_mask & BOLT_IO_WRITABLE) ee.events |= EPOLLOUT;
+
+	int op = (old_mask == 0)
+		? EPOLL_CTL_ADD
+		: (new_mask == 0)
+			? EPOLL_CTL_DEL
+			: EPOLL_CTL_MOD;
+
+	return epoll_ctl(loop->fd, op, fd, &ee) == 0;
+}
+
+// wait for events, returns number of fired events
+static int _BoltIO_Poll
+(
+	bolt_io_loop *loop,    // the event loop
+	bolt_io_fired *fired,  // [output] fired events
+	int timeout            // timeout in milliseconds
+) {
+	struct epoll_event events[BOLT_IO_MAX_FIRED];
+
+	int n = epoll_wait(loop->fd, events, BOLT_IO_MAX_FIRED, timeout);
+	for(int i = 0; i < n; i++) {
+		int mask = 0;
+		uint32_t e = events[i].events;
+		// errors and hangups are reported to both handlers
+		if(e & (EPOLLIN  | EPOLLERR | EPOLLHUP)) mask |= BOLT_IO_READABLE;
+		if(e & (EPOLLOUT | EPOLLERR | EPOLLHUP)) mask |= BOLT_IO_WRITABLE;
+		fired[i].fd   = events[i].data.fd;
+		fired[i].mask = mask;
+	}
+
+	return n;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// event loop
+//------------------------------------------------------------------------------
+
+// get a snapshot of the events registered for 'fd'
+static bolt_io_event _BoltIO_GetEvent
+(
+	bolt_io_loop *loop,  // the event loop
+	int fd               // the socket file descriptor
+) {
+	bolt_io_event e = {0};
+
+	pthread_mutex_lock(&loop->lock);
+	if(fd < loop->nevents) {
+		e = loop->events[fd];
+	}
+	pthread_mutex_unlock(&loop->lock);
+
+	return e;
+}
+
+// I/O thread main function
+static void *_BoltIO_Run
+(
+	void *arg  // the event loop
+) {
+	bolt_io_loop *loop = (bolt_io_loop *)arg;
+	bolt_io_fired fired[BOLT_IO_MAX_FIRED];
+
+	while(atomic_load(&running)) {
+		int n = _BoltIO_Poll(loop, fired, BOLT_IO_TIMEOUT);
+		for(int i = 0; i < n; i++) {
+			int fd   = fired[i].fd;
+			int mask = fired[i].mask;
+
+			bolt_io_event e = _BoltIO_GetEvent(loop, fd);
+			if(mask & e.mask & BOLT_IO_READABLE) {
+				e.rproc(fd, e.user_data, mask);
+			}
+
+			// the read handler might have unregistered the socket
+			if(mask & BOLT_IO_WRITABLE) {
+				e = _BoltIO_GetEvent(loop, fd);
+				if(e.mask & BOLT_IO_WRITABLE) {
+					e.wproc(fd, e.user_data, mask);
+				}
+			}
+		}
+	}
+
+	return NULL;
+}
+
+// start 'n' I/O threads
+bool BoltIO_Start
+(
+	uint32_t n  // number of I/O threads
+) {
+	ASSERT(n > 0);
+	ASSERT(loops == NULL);
+
+	loops = rm_calloc(n, sizeof(bolt_io_loop));
+	atomic_init(&next_loop, 0);
+	atomic_init(&running, true);
+
+	for(uint32_t i = 0; i < n; i++) {
+		bolt_io_loop *loop = loops + i;
+		loop->fd = _BoltIO_Create();
+		if(loop->fd == -1) {
+			BoltIO_Stop();
+			return false;
+		}
+
+		loop->events  = NULL;
+		loop->nevents = 0;
+		pthread_mutex_init(&loop->lock, NULL);
+
+		if(pthread_create(&loop->thread, NULL, _BoltIO_Run, loop) != 0) {
+			close(loop->fd);
+			pthread_mutex_destroy(&loop->lock);
+			BoltIO_Stop();
+			return false;
+		}
+
+		loop_count++;
+	}
+
+	return true;
+}
+
+// pick an I/O loop for a new client, loops are assigned round robin
+bolt_io_loop *BoltIO_Next(void) {
+	ASSERT(loop_count > 0);
+
+	uint32_t i = atomic_fetch_add(&next_loop, 1);
+	return loops + (i % loop_count);
+}
+
+// register handler for events of 'mask' type on 'fd'
+// can be called from any thread
+bool BoltIO_Add
+(
+	bolt_io_loop *loop,       // the event loop
+	int fd,                   // the socket file descriptor
+	int mask,                 // events to monitor
+	bolt_io_handler handler,  // the event handler
+	void *user_data           // user data passed to handler
+) {
+	ASSERT(fd      >= 0);
+	ASSERT(loop    != NULL);
+	ASSERT(handler != NULL);
+
+	pthread_mutex_lock(&loop->lock);
+
+	// grow events to accommodate fd
+	if(fd >= loop->nevents) {
+		int n = (fd + 1 > loop->nevents * 2) ? fd + 1 : loop->nevents * 2;
+		loop->events = rm_realloc(loop->events, sizeof(bolt_io_event) * n);
+		memset(loop->events + loop->nevents, 0,
+				sizeof(bolt_io_event) * (n - loop->nevents));
+		loop->nevents = n;
+	}
+
+	bolt_io_event *e = loop->events + fd;
+	bool res = _BoltIO_Update(loop, fd, e->mask, e->mask | mask);
+	if(res) {
+		e->mask |= mask;
+		e->user_data = user_data;
+		if(mask & BOLT_IO_READABLE) e->rproc = handler;
+		if(mask & BOLT_IO_WRITABLE) e->wproc = handler;
+	}
+
+	pthread_mutex_unlock(&loop->lock);
+
+	return res;
+}
+
+// stop monitoring events of 'mask' type on 'fd'
+// can be called from any thread
+void BoltIO_Del
+(
+	bolt_io_loop *loop,  // the event loop
+	int fd,              // the socket file descriptor
+	int mask             // events to stop monitoring
+) {
+	ASSERT(fd   >= 0);
+	ASSERT(loop != NULL);
+
+	pthread_mutex_lock(&loop->lock);
+
+	if(fd < loop->nevents) {
+		bolt_io_event *e = loop->events + fd;
+		if(e->mask & mask) {
+			_BoltIO_Update(loop, fd, e->mask, e->mask & ~mask);
+			e->mask &= ~mask;
+		}
+	}
+
+	pthread_mutex_unlock(&loop->lock);
+}
+
+// stop and join all I/O threads
+void BoltIO_Stop(void) {
+	if(loops == NULL) return;
+
+	atomic_store(&running, false);
+
+	for(uint32_t i = 0; i < loop_count; i++) {
+		bolt_io_loop *loop = loops + i;
+		pthread_join(loop->thread, NULL);
+		close(loop->fd);
+		pthread_mutex_destroy(&loop->lock);
+		if(loop->events != NULL) rm_free(loop->events);
+	}
+
+	rm_free(loops);
+	loops      = NULL;
+	loop_count = 0;
+}
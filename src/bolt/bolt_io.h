@@ -0,0 +1,59 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// bolt I/O threads
+// each thread runs its own event loop (epoll on linux, kqueue on macOS)
+// monitoring the sockets of the bolt clients assigned to it
+// handlers registered with a loop are invoked on the loop's thread
+
+#define BOLT_IO_READABLE 1  // socket is readable
+#define BOLT_IO_WRITABLE 2  // socket is writable
+
+typedef struct bolt_io_loop bolt_io_loop;
+
+// socket event handler
+typedef void (*bolt_io_handler)
+(
+	int fd,           // the socket file descriptor
+	void *user_data,  // user data
+	int mask          // the event mask
+);
+
+// start 'n' I/O threads
+bool BoltIO_Start
+(
+	uint32_t n  // number of I/O threads
+);
+
+// pick an I/O loop for a new client, loops are assigned round robin
+bolt_io_loop *BoltIO_Next(void);
+
+// register handler for events of 'mask' type on 'fd'
+// can be called from any thread
+bool BoltIO_Add
+(
+	bolt_io_loop *loop,       // the event loop
+	int fd,                   // the socket file descriptor
+	int mask,                 // events to monitor
+	bolt_io_handler handler,  // the event handler
+	void *user_data           // user data passed to handler
+);
+
+// stop monitoring events of 'mask' type on 'fd'
+// can be called from any thread
+void BoltIO_Del
+(
+	bolt_io_loop *loop,  // the event loop
+	int fd,              // the socket file descriptor
+	int mask             // events to stop monitoring
+);
+
+// stop and join all I/O threads
+void BoltIO_Stop(void);
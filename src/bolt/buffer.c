@@ -263,6 +263,41 @@ bool buffer_socket_read
 	return true;
 }
 
+// append the buffer range [from, to) to an array of iovecs
+// one entry per chunk spanned by the range
+void buffer_iovec_append
+(
+	buffer_index_t *from,  // range start
+	buffer_index_t *to,    // range end
+	struct iovec **iov     // array of iovecs to extend
+) {
+	ASSERT(to   != NULL);
+	ASSERT(iov  != NULL);
+	ASSERT(from != NULL);
+	ASSERT(from->buf == to->buf);
+
+	char **chunks = from->buf->chunks;
+
+	if(from->chunk == to->chunk) {
+		struct iovec v = {chunks[from->chunk] + from->offset,
+			to->offset - from->offset};
+		array_append(*iov, v);
+		return;
+	}
+
+	struct iovec first = {chunks[from->chunk] + from->offset,
+		BUFFER_CHUNK_SIZE - from->offset};
+	array_append(*iov, first);
+
+	for(int32_t i = from->chunk + 1; i < to->chunk; i++) {
+		struct iovec v = {chunks[i], BUFFER_CHUNK_SIZE};
+		array_append(*iov, v);
+	}
+
+	struct iovec last = {chunks[to->chunk], to->offset};
+	array_append(*iov, last);
+}
+
 // write data from the buffer to the socket
 bool buffer_socket_write
 (
@@ -113,6 +113,15 @@ bool buffer_socket_read
 	socket_t socket  // socket
 );
 
+// append the buffer range [from, to) to an array of iovecs
+// one entry per chunk spanned by the range
+void buffer_iovec_append
+(
+	buffer_index_t *from,  // range start
+	buffer_index_t *to,    // range end
+	struct iovec **iov     // array of iovecs to extend
+);
+
 // write data from the buffer to the socket
 bool buffer_socket_write
 (
@@ -8,6 +8,7 @@
 #include "RG.h"
 #include <string.h>
 #include <errno.h>
+#include <limits.h>
 #include <sys/ioctl.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -68,6 +69,17 @@ bool socket_set_non_blocking
 	return true;
 }
 
+// block until socket is writable
+static void socket_wait_writable
+(
+	socket_t socket
+) {
+	fd_set wfds;
+	FD_ZERO(&wfds);
+	FD_SET(socket, &wfds);
+	select(socket + 1, NULL, &wfds, NULL, NULL);
+}
+
 bool socket_write_all
 (
 	socket_t socket,
@@ -79,10 +91,7 @@ bool socket_write_all
 		int n = socket_write(socket, buff + res, size - res);
 		if(n < 0) {
 			if(errno == EAGAIN || errno == EWOULDBLOCK) {
-				fd_set wfds;
-				FD_ZERO(&wfds);
-				FD_SET(socket, &wfds);
-				select(socket + 1, NULL, &wfds, NULL, NULL);
+				socket_wait_writable(socket);
 				continue;
 			} else {
 				return false;
@@ -92,3 +101,48 @@ bool socket_write_all
 	}
 	return true;
 }
+
+// write as much of the buffers as the socket accepts without blocking
+// '*iov' and '*iovcnt' are advanced past the written data
+// all data was written once '*iovcnt' reaches 0
+// returns false if the socket failed
+bool socket_writev
+(
+	socket_t socket,
+	struct iovec **iov,
+	int *iovcnt
+) {
+	ASSERT(iov    != NULL);
+	ASSERT(iovcnt != NULL);
+
+	struct iovec *v = *iov;
+	int cnt = *iovcnt;
+	bool res = true;
+
+	while(cnt > 0) {
+		ssize_t n = writev(socket, v, cnt < IOV_MAX ? cnt : IOV_MAX);
+		if(n < 0) {
+			if(errno == EINTR) continue;
+			// socket's send buffer is full, resume once it drains
+			res = (errno == EAGAIN || errno == EWOULDBLOCK);
+			break;
+		}
+
+		// skip fully written buffers
+		while(cnt > 0 && (size_t)n >= v->iov_len) {
+			n -= v->iov_len;
+			v++;
+			cnt--;
+		}
+
+		// advance partially written buffer
+		if(cnt > 0) {
+			v->iov_base = (char *)v->iov_base + n;
+			v->iov_len -= n;
+		}
+	}
+
+	*iov    = v;
+	*iovcnt = cnt;
+	return res;
+}
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <sys/uio.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
@@ -36,3 +37,14 @@ bool socket_write_all
 	const char *buff,
 	uint32_t size
 );
+
+// write as much of the buffers as the socket accepts without blocking
+// '*iov' and '*iovcnt' are advanced past the written data
+// all data was written once '*iovcnt' reaches 0
+// returns false if the socket failed
+bool socket_writev
+(
+	socket_t socket,
+	struct iovec **iov,
+	int *iovcnt
+);
@@ -206,6 +206,9 @@ static bool _Constraint_Drop
 	// acquire graph write lock
 	Graph_AcquireWriteLock(gc->g);
 
+	// replicate preceding modifications ahead of the constraint's
+	QueryCtx_FlushCommitGroup(ctx, gc);
+
 	Schema_RemoveConstraint(s, c);
 
 	// release graph R/W lock
@@ -256,6 +259,9 @@ static bool _Constraint_Create
 	// acquire graph write lock
 	Graph_AcquireWriteLock(gc->g);
 
+	// replicate preceding modifications ahead of the constraint's
+	QueryCtx_FlushCommitGroup(ctx, gc);
+
 	//--------------------------------------------------------------------------
 	// convert attribute name to attribute ID
 	//--------------------------------------------------------------------------
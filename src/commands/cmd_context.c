@@ -36,6 +36,7 @@ CommandCtx *CommandCtx_New
 	context->bc                 = bc;
 	context->ctx                = ctx;
 	context->bolt_client        = bolt_client;
+	context->read_locked        = false;
 	context->query              = NULL;
 	context->thread             = thread;
 	context->compact            = compact;
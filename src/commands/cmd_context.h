@@ -37,6 +37,7 @@ typedef struct {
 	uint64_t received_ts;          // command received at this UNIX timestamp
 	simple_timer_t timer;          // stopwatch started upon command received
 	bolt_client_t *bolt_client;    // BOLT client
+	bool read_locked;              // graph read lock acquired by the dispatcher
 } CommandCtx;
 
 // create a new command context
@@ -5,67 +5,37 @@
 
 // copying a graph is performed in a number of steps:
 //
-// 1. a cron task is created with the responsibility of creating a fork
+// 1. a cron task is created with the responsibility of cloning the graph
 //
-// 2. the forked child process encodes the graph into a temporary file
-//    once done the child exists and a callback is invoked on Redis main thread
+// 2. while holding the source graph READ lock the graph is cloned in-process
+//    entities are duplicated block by block (attribute-sets in parallel)
+//    and matrices are duplicated via GraphBLAS
 //
-// 3. a second cron task is created with the responsibility of decoding the
-//    dumped file and creating a new graph key
+// 3. once the READ lock is released, the clone's indices are populated
+//    and the clone is serialized into memory for replication
 //
+// 4. the clone is added to the keyspace under the destination key
 //
 //
-// ┌────────────────┐                  ┌────────────────┐
-// │                │                  │                │
-// │   Cron Task    │                  │     Child      │
-// │                │                  │                │
-// │                │                  │                │       ┌────────┐
-// │                │                  │                │       │        │
-// │                │                  │                │       │ Dump   │
-// │      Fork      ├─────────────────►│                ├──────►│ Graph  │
-// │                │                  │                │       │        │
-// │                │                  │                │       │        │
-// └────────────────┘                  └───────┬────────┘       │        │
-//                                             │                │        │
-//                                             │                └────────┘
-//                                             │                    ▲
-// ┌────────────────┐                          │                    │
-// │                │                          │                    │
-// │  Main thread   │      Done callback       │                    │
-// │                │◄─────────────────────────┘                    │
-// │                │                                               │
-// │                │                                               │
-// │                │                                               │
-// └────────┬───────┘                                               │
-//          │                                                       │
-//          │                                                       │
-//          ▼                                                       │
-// ┌────────────────┐                                               │
-// │                │                                               │
-// │   Cron Task    │                                               │
-// │                │                                               │
-// │                │                                               │
-// │  Decode Graph  ├───────────────────────────────────────────────┘
-// │                │
-// │                │
-// │                │
-// │                │
-// └────────────────┘
+// ┌────────────────┐         ┌────────────────┐        ┌────────────────┐
+// │                │         │                │        │                │
+// │   Cron Task    │         │  Clone Graph   │        │  Add clone to  │
+// │                ├────────►│                ├───────►│    keyspace    │
+// │                │         │  (READ lock)   │        │     (GIL)      │
+// │                │         │                │        │                │
+// └────────────────┘         └────────────────┘        └────────────────┘
 
 
 #include "RG.h"
 #include "../cron/cron.h"
-#include "../util/uuid.h"
 #include "../redismodule.h"
 #include "../graph/graphcontext.h"
+#include "../configuration/config.h"
 #include "../serializers/serializer_io.h"
 #include "../serializers/encoder/v16/encode_v16.h"
-#include "../serializers/decoders/current/v16/decode_v16.h"
 
 #include <stdio.h>
-#include <fcntl.h>
 #include <stdlib.h>
-#include <unistd.h>
 
 extern RedisModuleType *GraphContextRedisModuleType;
 
@@ -73,23 +43,11 @@ extern RedisModuleType *GraphContextRedisModuleType;
 typedef struct {
 	const char *src;               // src graph id
 	const char *dest;              // dest graph id
-	char *path;                    // path to dumped graph on disk
 	RedisModuleString *rm_src;     // redismodule string src
 	RedisModuleString *rm_dest;    // redismodule string dest
 	RedisModuleBlockedClient *bc;  // blocked client
 } GraphCopyContext;
 
-// return a full path to a temporary dump file
-// e.g. /tmp/<UUID>.dump
-static char *_temp_file(void) {
-	char *uuid = UUID_New();
-	char *path;
-	asprintf(&path, "/tmp/%s.dump", uuid);
-	rm_free(uuid);
-
-	return path;
-}
-
 // create a new graph copy context
 static GraphCopyContext *GraphCopyContext_New
 (
@@ -104,7 +62,6 @@ static GraphCopyContext *GraphCopyContext_New
 	GraphCopyContext *ctx = rm_malloc(sizeof(GraphCopyContext));
 
 	ctx->bc      = bc;
-	ctx->path    = _temp_file();
 	ctx->rm_src  = src;
 	ctx->rm_dest = dest;
 	ctx->src     = RedisModule_StringPtrLen(src, NULL);
@@ -120,13 +77,6 @@ static void GraphCopyContext_Free
 ) {
 	ASSERT(copy_ctx != NULL);
 
-	// delete file in case it exists, no harm if file is missing
-	RedisModule_Log(NULL, REDISMODULE_LOGLEVEL_NOTICE,
-			"deleting dumped graph file: %s", copy_ctx->path);
-	remove(copy_ctx->path);
-
-	free(copy_ctx->path);
-
 	RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(copy_ctx->bc);
 	RedisModule_FreeString(ctx, copy_ctx->rm_src);
 	RedisModule_FreeString(ctx, copy_ctx->rm_dest);
@@ -136,221 +86,43 @@ static void GraphCopyContext_Free
 	rm_free(copy_ctx);
 }
 
-// encode graph to disk
-// this function should run on a child process, giving us the guarantees:
-// 1. the cloned graph wouldn't change
-// 2. due to memory seperation we do not need to hold any locks
-// 3. we're allowed to make modification to the graph e.g. rename
-static int encode_graph
+// encode graph into memory
+// the returned buffer is used as the payload of a replicated GRAPH.RESTORE
+// caller is responsible for freeing the buffer
+static char *encode_graph
 (
-	RedisModuleCtx *ctx,         // redis module context
-	GraphContext *gc,            // graph to clone
-	GraphCopyContext *copy_ctx   // graph copy context
+	GraphContext *gc,  // graph to encode
+	size_t *len        // [output] encoded graph size
 ) {
-	// validations
-	ASSERT(gc       != NULL);
-	ASSERT(ctx      != NULL);
-	ASSERT(copy_ctx != NULL);
+	ASSERT(gc  != NULL);
+	ASSERT(len != NULL);
 
-	int          res = 0;  // 0 indicates success
-	FILE         *f  = NULL;
-	SerializerIO io  = NULL;
+	char *buffer = NULL;
 
-	// rename graph, needed by the decoding procedure
-	// when the graph is decoded it is already holds the target name
-	GraphContext_Rename(ctx, gc, copy_ctx->dest);
-
-	//--------------------------------------------------------------------------
-	// serialize graph to file
-	//--------------------------------------------------------------------------
-
-	// open dump file
-	// write only, create if missing, truncate if exists
-	// grant READ access to group (0644)
-	f = fopen(copy_ctx->path, "wb");
-	if(f == NULL) {
-		// failed to open file
-		res = 1;  // indicate error
-		goto cleanup;
+	// open a dynamic memory stream
+	FILE *stream = open_memstream(&buffer, len);
+	if(stream == NULL) {
+		return NULL;
 	}
 
 	// create serializer
-	io = SerializerIO_FromStream(f);
+	SerializerIO io = SerializerIO_FromStream(stream);
 	ASSERT(io != NULL);
 
-	// encode graph to disk
-	RedisModule_Log(NULL, REDISMODULE_LOGLEVEL_NOTICE, "dump graph: %s to: %s",
-			copy_ctx->src, copy_ctx->path);
-
 	RdbSaveGraph_latest(io, gc);
 
-cleanup:
-
-	// free serializer
-	if(io != NULL) SerializerIO_Free(&io);
-
-	// close file
-	if(f != NULL) fclose(f);
-
-	// all done, no errors
-	return res;
-}
-
-// load graph from file
-static void LoadGraphFromFile
-(
-	void *pdata  // graph copy context
-) {
-	ASSERT(pdata != NULL);
-
-	GraphCopyContext *copy_ctx = (GraphCopyContext*)pdata;
-
-	SerializerIO   io      = NULL;  // graph decode stream
-	char           *buffer = NULL;  // dumped graph
-	FILE           *stream = NULL;  // memory stream over buffer
-	RedisModuleCtx *ctx    = RedisModule_GetThreadSafeContext(copy_ctx->bc);
-
-	//--------------------------------------------------------------------------
-	// decode graph from disk
-	//--------------------------------------------------------------------------
-
-	// open file
-	FILE *f = fopen(copy_ctx->path, "rb");
-	if(f == NULL) {
-		RedisModule_ReplyWithError(ctx, "copy failed");
-		goto cleanup;
-	}
-
-	//--------------------------------------------------------------------------
-	// load dumped file to memory
-	//--------------------------------------------------------------------------
-
-	// seek to the end of the file
-	fseek(f, 0, SEEK_END);
-
-	// get current position, which is the size of the file
-	long fileLength = ftell(f);
-
-	// seek to the beginning of the file
-	rewind(f);
-
-	// allocate buffer to hold entire dumped graph
-	buffer = rm_malloc(sizeof(char) * fileLength);
-
-	// read file content into buffer
-	fread(buffer, 1, fileLength, f);
-
-	fclose(f);  // close file
-
-	//--------------------------------------------------------------------------
-	// create memory stream
-	//--------------------------------------------------------------------------
-
-	stream = fmemopen(buffer, fileLength, "r");
-	if(stream == NULL) {
-		RedisModule_ReplyWithError(ctx, "copy failed");
-		goto cleanup;
-	}
-
-	// create serializer ontop of file descriptor
-	io = SerializerIO_FromStream(stream);
-	ASSERT(io != NULL);
-
-	// decode graph from io
-	RedisModule_Log(NULL, REDISMODULE_LOGLEVEL_NOTICE,
-			"Decoding graph: %s from: %s", copy_ctx->dest, copy_ctx->path);
-
-	GraphContext *gc = RdbLoadGraphContext_latest(io, copy_ctx->rm_dest);
-	ASSERT(gc != NULL);
-
-	//--------------------------------------------------------------------------
-	// add cloned graph to keyspace
-	//--------------------------------------------------------------------------
-
-	RedisModule_ThreadSafeContextLock(ctx); // lock GIL
-
-	// make sure dest key does not exists
-	RedisModuleKey *key =
-		RedisModule_OpenKey(ctx, copy_ctx->rm_dest, REDISMODULE_READ);
-	int key_type = RedisModule_KeyType(key);
-
-	RedisModule_CloseKey(key);
-
-	if(key_type != REDISMODULE_KEYTYPE_EMPTY) {
-		// error!
-		RedisModule_ThreadSafeContextUnlock(ctx);  // release GIL
-
-		// free graph
-		GraphContext_DecreaseRefCount(gc);
-
-		RedisModule_ReplyWithError(ctx, "copy failed");
-	} else {
-		// create key
-		key = RedisModule_OpenKey(ctx, copy_ctx->rm_dest, REDISMODULE_WRITE);
-
-		// set value in key
-		RedisModule_ModuleTypeSetValue(key, GraphContextRedisModuleType, gc);
-
-		RedisModule_CloseKey(key);
-
-		// replicate graph
-		// GRAPH.RESTORE dest <payload>
-		RedisModule_Replicate(ctx, "GRAPH.RESTORE", "cb", copy_ctx->dest, buffer,
-				fileLength);
-
-		RedisModule_ThreadSafeContextUnlock(ctx);  // release GIL
-
-		// register graph context for BGSave
-		GraphContext_RegisterWithModule(gc);
-
-		RedisModule_ReplyWithCString(ctx, "OK");
-	}
-
-cleanup:
-
 	// free serializer
-	if(io != NULL) SerializerIO_Free(&io);
-
-	// close file descriptor
-	if(stream != NULL) fclose(stream);
+	SerializerIO_Free(&io);
 
-	// free buffer
-	if(buffer != NULL) rm_free(buffer);
+	// close stream, flushing content to buffer
+	fclose(stream);
 
-	// free copy context
-	GraphCopyContext_Free(copy_ctx);
-
-	RedisModule_FreeThreadSafeContext(ctx);
-}
-
-// fork done handler
-// this function runs on Redis main thread
-static void ForkDoneHandler
-(
-	int exitcode,    // fork return code
-	int bysignal,    // how did fork terminated
-	void *user_data  // private data (GraphCopyContext*)
-) {
-	ASSERT(user_data != NULL);
-
-	// check fork exit code
-	if(exitcode != 0 || bysignal != 0) {
-		GraphCopyContext *copy_ctx = (GraphCopyContext*)user_data;
-		RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(copy_ctx->bc);
-		RedisModule_ReplyWithError(ctx, "copy failed");
-		// fork failed
-		GraphCopyContext_Free(copy_ctx);
-		RedisModule_FreeThreadSafeContext(ctx);
-		return;
-	}
-
-	// perform decoding on a different thread to avoid blocking Redis
-	Cron_AddTask(0, LoadGraphFromFile, NULL, user_data);
+	return buffer;
 }
 
 // implements GRAPH.COPY logic
 // this function is expected to run on a cron thread
-// avoiding blocking redis main thread while trying to create a fork
+// avoiding blocking redis main thread while cloning the graph
 static void _Graph_Copy
 (
 	void *context  // graph copy context
@@ -359,8 +131,10 @@ static void _Graph_Copy
 
 	GraphCopyContext *copy_ctx = (GraphCopyContext*)context;
 
-	bool error = false;
-	GraphContext *gc = NULL;
+	GraphContext *gc    = NULL;  // source graph
+	GraphContext *clone = NULL;  // cloned graph
+	char *payload       = NULL;  // encoded clone, replicated
+	size_t payload_len  = 0;     // encoded clone size
 
 	RedisModuleString *rm_src    = copy_ctx->rm_src;
 	RedisModuleString *rm_dest   = copy_ctx->rm_dest;
@@ -389,7 +163,6 @@ static void _Graph_Copy
 	// dest key shouldn't exists
 	if(dest_key_type != REDISMODULE_KEYTYPE_EMPTY) {
 		// destination key already exists, abort
-		error = true;
 		RedisModule_ReplyWithError(ctx, "destination key already exists");
 		goto cleanup;
 	}
@@ -397,51 +170,95 @@ static void _Graph_Copy
 	// src key should be a graph
 	if(gc == NULL) {
 		// src graph is missing, abort
-		error = true;
 		// error alreay omitted by 'GraphContext_Retrieve'
 		goto cleanup;
 	}
 
 	//--------------------------------------------------------------------------
-	// fork process
+	// clone graph
+	//--------------------------------------------------------------------------
+
+	RedisModule_Log(NULL, REDISMODULE_LOGLEVEL_NOTICE, "cloning graph: %s to: %s",
+			copy_ctx->src, copy_ctx->dest);
+
+	// acquire READ lock on gc
+	// we do not want to clone while the graph is modified
+	Graph_AcquireReadLock(gc->g);
+
+	clone = GraphContext_Clone(gc, copy_ctx->dest);
+
+	// release graph READ lock
+	Graph_ReleaseLock(gc->g);
+
+	// the clone is private to this thread up until it is added to the keyspace
+	// no locks are required from this point on
+
+	// get delay indexing configuration
+	bool delay_indexing;
+	Config_Option_get(Config_DELAY_INDEXING, &delay_indexing);
+
+	// populate indices and constraints ahead of exposing the clone
+	if(!delay_indexing) {
+		GraphContext_PopulateIndices(clone, false);
+		GraphContext_PopulateConstraints(clone, false);
+	}
+
+	// encode clone, replicas restore it from this payload
+	payload = encode_graph(clone, &payload_len);
+	if(payload == NULL) {
+		RedisModule_ReplyWithError(ctx, "copy failed");
+		goto cleanup;
+	}
+
+	//--------------------------------------------------------------------------
+	// add cloned graph to keyspace
 	//--------------------------------------------------------------------------
 
-	// child process will encode src graph to a file
-	// parent process will decode cloned graph from file
+	RedisModule_ThreadSafeContextLock(ctx); // lock GIL
 
-	int pid = -1;
-	while(pid == -1) {
-		// try to fork
-		RedisModule_ThreadSafeContextLock(ctx); // lock GIL
+	// make sure dest key does not exists
+	RedisModuleKey *key =
+		RedisModule_OpenKey(ctx, rm_dest, REDISMODULE_READ);
+	int key_type = RedisModule_KeyType(key);
 
-		// acquire READ lock on gc
-		// we do not want to fork while the graph is modified
-		// might be redundant, see: GraphContext_LockForCommit
-		Graph_AcquireReadLock(gc->g);
+	RedisModule_CloseKey(key);
 
-		pid = RedisModule_Fork(ForkDoneHandler, copy_ctx);
+	if(key_type != REDISMODULE_KEYTYPE_EMPTY) {
+		// error!
 		RedisModule_ThreadSafeContextUnlock(ctx);  // release GIL
+		RedisModule_ReplyWithError(ctx, "copy failed");
+		goto cleanup;
+	}
+
+	// create key
+	key = RedisModule_OpenKey(ctx, rm_dest, REDISMODULE_WRITE);
+
+	// set value in key
+	RedisModule_ModuleTypeSetValue(key, GraphContextRedisModuleType, clone);
+
+	RedisModule_CloseKey(key);
+
+	// replicate graph
+	// GRAPH.RESTORE dest <payload>
+	RedisModule_Replicate(ctx, "GRAPH.RESTORE", "cb", copy_ctx->dest, payload,
+			payload_len);
 
-		// release graph READ lock
-		Graph_ReleaseLock(gc->g);
-
-		if(pid < 0) {
-			// failed to fork! retry in a bit
-			// go to sleep for 5.0ms
-			struct timespec sleep_time;
-			sleep_time.tv_sec = 0;
-			sleep_time.tv_nsec = 5000000;
-			nanosleep(&sleep_time, NULL);
-		} else if(pid == 0) {
-			// managed to fork, in child process
-			// encode graph to disk
-			int res = encode_graph(ctx, gc, copy_ctx);
-			// all done, Redis require us to call 'RedisModule_ExitFromChild'
-			RedisModule_ExitFromChild(res);
-			return;
-		}
+	RedisModule_ThreadSafeContextUnlock(ctx);  // release GIL
+
+	// register graph context for BGSave
+	GraphContext_RegisterWithModule(clone);
+
+	// start async indexing
+	if(delay_indexing) {
+		GraphContext_PopulateIndices(clone, true);
+		GraphContext_PopulateConstraints(clone, true);
 	}
 
+	// clone is owned by the keyspace
+	clone = NULL;
+
+	RedisModule_ReplyWithCString(ctx, "OK");
+
 	// clean up
 cleanup:
 
@@ -450,12 +267,19 @@ cleanup:
 		GraphContext_DecreaseRefCount(gc);
 	}
 
-	if(error) {
-		// free command context only in the case of an error
-		// otherwise the fork callback is responsible for freeing this context
-		GraphCopyContext_Free(copy_ctx);
+	// free clone in case it didn't make it into the keyspace
+	if(clone != NULL) {
+		GraphContext_Free(clone);
 	}
 
+	// free encoded graph
+	if(payload != NULL) {
+		free(payload);
+	}
+
+	// free command context
+	GraphCopyContext_Free(copy_ctx);
+
 	RedisModule_FreeThreadSafeContext(ctx);
 }
 
@@ -27,6 +27,7 @@ static int _read_flags
 	long long *timeout,         // query level timeout
   	bool *timeout_rw,           // apply timeout on both read and write queries
   	uint *graph_version,        // graph version [UNUSED]
+  	TaskPriority *priority,     // query priority class
   	char **errmsg,              // reported error message
 	bolt_client_t **bolt_client // BOLT client
 ) {
@@ -39,6 +40,7 @@ static int _read_flags
 	*compact       = false;  // verbose
 	*bolt_client   = NULL;
 	*graph_version = GRAPH_VERSION_MISSING;
+	*priority      = TASK_PRIORITY_NORMAL;
 	Config_Option_get(Config_TIMEOUT_DEFAULT, timeout);
 	Config_Option_get(Config_TIMEOUT_MAX, &max_timeout);
 
@@ -111,6 +113,17 @@ static int _read_flags
 			}
 
 			continue;
+		} else if(!strcasecmp(arg, "priority")) {
+			// query priority class
+			bool valid = (i < argc - 1) && TaskPriority_FromString(
+					RedisModule_StringPtrLen(argv[++i], NULL), priority);
+
+			// emit error on missing or unknown priority class
+			if(!valid) {
+				int rc __attribute__((unused));
+				rc = asprintf(errmsg, "Failed to parse query priority, expecting HIGH, NORMAL or LOW");
+				return REDISMODULE_ERR;
+			}
 		}
 	}
 	return REDISMODULE_OK;
@@ -138,7 +151,7 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 		case CMD_EXPLAIN:
 		case CMD_PROFILE:
 			// Expect a command, graph name, a query, and optional config flags.
-			return arity >= 3 && arity <= 8;
+			return arity >= 3 && arity <= 10;
 		default:
 			ASSERT("encountered unhandled query type" && false);
 			return false;
@@ -161,6 +174,37 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 	return NULL;
 }
 
+// returns true if query should run inline on Redis main thread
+// rather than being handed off to a reader thread
+// in which case the graph's read lock is held and handed to the query
+// a query qualifies if it's a read-only query whose recent executions
+// utilized the cache and averaged under INLINE_QUERY_THRESHOLD, the hand off
+// to a reader thread and back costing more than the query itself
+static bool _should_run_inline
+(
+	GRAPH_Commands cmd,       // command
+	GraphContext *gc,         // graph context
+	RedisModuleString *query  // query
+) {
+	if(cmd != CMD_QUERY && cmd != CMD_RO_QUERY) return false;
+
+	uint64_t threshold;
+	Config_Option_get(Config_INLINE_QUERY_THRESHOLD, &threshold);
+	if(threshold == INLINE_QUERY_DISABLED) return false;
+
+	// threshold is specified in microseconds, logged runtimes in milliseconds
+	const char *q = RedisModule_StringPtrLen(query, NULL);
+	if(!QueriesLog_CheapRead(gc->queries_log, q, threshold / 1000.0)) {
+		return false;
+	}
+
+	// don't block Redis main thread waiting on a writer
+	// the read lock is retained by the query, a writer acquiring the lock
+	// meanwhile, e.g. a commit group which holds it without the GIL,
+	// would otherwise stall Redis main thread for its entire run
+	return Graph_TryAcquireReadLock(gc->g);
+}
+
 static bool should_command_create_graph(GRAPH_Commands cmd) {
 	switch(cmd) {
 		case CMD_QUERY:
@@ -187,6 +231,7 @@ int CommandDispatch
 	bool compact;
 	bool timeout_rw;
 	long long timeout;
+	TaskPriority priority;
 	simple_timer_t timer;
 	CommandCtx *context = NULL;
 
@@ -202,7 +247,7 @@ int CommandDispatch
 
 	// parse additional arguments
 	int res = _read_flags(argv, argc, &compact, &timeout, &timeout_rw, &version,
-			&errmsg, &bolt_client);
+			&priority, &errmsg, &bolt_client);
 	if(res == REDISMODULE_ERR) {
 		// emit error and exit if argument parsing failed
 		RedisModule_ReplyWithError(ctx, errmsg);
@@ -243,12 +288,22 @@ int CommandDispatch
 		? EXEC_THREAD_MAIN
 		: EXEC_THREAD_READER;
 
+	// cheap read queries run inline, sparing the hand off to a reader thread
+	bool read_locked = false;
+	if(exec_thread == EXEC_THREAD_READER && bolt_client == NULL &&
+	   _should_run_inline(cmd, gc, query)) {
+		exec_thread = EXEC_THREAD_MAIN;
+		read_locked = true;
+	}
+
 	Command_Handler handler = get_command_handler(cmd);
 	if(exec_thread == EXEC_THREAD_MAIN) {
 		// run query on Redis main thread
 		context = CommandCtx_New(ctx, NULL, argv[0], query, gc, exec_thread,
 								 is_replicated, compact, timeout, timeout_rw,
 								 received_ts, timer, bolt_client);
+		// hand the read lock acquired by _should_run_inline to the query
+		context->read_locked = read_locked;
 		handler(context);
 	} else {
 		// run query on a dedicated thread
@@ -258,7 +313,8 @@ int CommandDispatch
 								 is_replicated, compact, timeout, timeout_rw,
 								 received_ts, timer, bolt_client);
 
-		if(ThreadPools_AddWorkReader(handler, context, false) ==
+		// queries are queued by priority and served fairly across graphs
+		if(ThreadPools_AddQueryReader(handler, context, gc, priority, false) ==
 				THPOOL_QUEUE_FULL) {
 			// report an error once our workers thread pool internal queue
 			// is full, this error usually happens when the server is
@@ -20,9 +20,12 @@
 #define WAIT_DURATION_KEY_NAME      "Wait duration"
 #define RECEIVED_TIMESTAMP_KEY_NAME "Received at"
 #define EXECUTION_DURATION_KEY_NAME "Execution duration"
+#define PRIORITY_KEY_NAME           "Priority"
+#define QUEUED_COUNT_KEY_NAME       "Queued queries"
 
 #define SUBCOMMAND_NAME_RUNNING_QUERIES "RunningQueries"
 #define SUBCOMMAND_NAME_WAITING_QUERIES "WaitingQueries"
+#define SUBCOMMAND_NAME_QUEUE_WAIT      "QueueWait"
 
 //------------------------------------------------------------------------------
 // Info section API
@@ -240,6 +243,49 @@ static void _info_waiting_queries
 	free(cmds);
 }
 
+// handles the "GRAPH.INFO QueueWait" section
+// "GRAPH.INFO QueueWait"
+static void _info_queue_wait
+(
+	RedisModuleCtx *ctx       // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO QueueWait
+	// reply:
+	// "# Queue wait"
+	//     "Priority"
+	//     "Queued queries"
+	//     "Wait p50"
+	//     "Wait p95"
+	//     "Wait p99"
+
+	ASSERT(ctx != NULL);
+
+	const double quantiles[]    = {0.5, 0.95, 0.99};
+	const char *quantile_keys[] = {"Wait p50", "Wait p95", "Wait p99"};
+	const int n = sizeof(quantiles) / sizeof(quantiles[0]);
+
+	// create a new subsection in the reply, an entry per priority class
+	Info_AddSection(ctx, "# Queue wait", TASK_PRIORITY_COUNT);
+
+	for(int i = 0; i < TASK_PRIORITY_COUNT; i++) {
+		double waits[n];
+		uint64_t count = ThreadPools_QueueWait(i, quantiles, waits, n);
+
+		RedisModule_ReplyWithArray(ctx, (n + 2) * 2);
+
+		Info_SectionAddEntryString(ctx, PRIORITY_KEY_NAME,
+				TaskPriority_ToString(i));
+		Info_SectionAddEntryLongLong(ctx, QUEUED_COUNT_KEY_NAME, count);
+
+		// queue wait quantiles in milliseconds
+		for(int j = 0; j < n; j++) {
+			Info_SectionAddEntryDouble(ctx, quantile_keys[j], waits[j]);
+		}
+	}
+}
+
 // attempts to find the specified sections of "GRAPH.INFO" and dispatch it
 static void _handle_sections
 (
@@ -253,6 +299,7 @@ static void _handle_sections
 	int section_count = 0;
 	bool running_queries = false;
 	bool waiting_queries = false;
+	bool queue_wait      = false;
 
 	if(argc == 0) {
 		running_queries = true;
@@ -269,6 +316,10 @@ static void _handle_sections
 					  !strcasecmp(subcmd, SUBCOMMAND_NAME_WAITING_QUERIES)) {
 				waiting_queries = true;
 				section_count++;
+			} else if(!queue_wait &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_QUEUE_WAIT)) {
+				queue_wait = true;
+				section_count++;
 			}
 		}
 	}
@@ -285,11 +336,14 @@ static void _handle_sections
 	if(waiting_queries) {
 		_info_waiting_queries(ctx);
 	}
+	if(queue_wait) {
+		_info_queue_wait(ctx);
+	}
 }
 
 // graph.info command handler
 // GRAPH.INFO [Section [Section ...]]
-// GRAPH.INFO RunningQueries WaitingQueries
+// GRAPH.INFO RunningQueries WaitingQueries QueueWait
 int Graph_Info
 (
 	RedisModuleCtx *ctx,       // redis module context
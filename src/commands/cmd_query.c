@@ -22,6 +22,10 @@
 #include "../configuration/config.h"
 #include "../execution_plan/execution_plan.h"
 
+// clients whose replies are held back until the writer's commit group ends
+// NULL when the writer isn't executing a commit group
+static __thread CommandCtx **_deferred_clients = NULL;
+
 // GraphQueryCtx stores the allocations required to execute a query.
 typedef struct {
 	GraphContext *graph_ctx;  // graph context
@@ -110,7 +114,7 @@ static bool abort_and_check_timeout
 ) {
 	// abort timeout if set
 	if(gq_ctx->timeout != 0) {
-		Cron_AbortTask(gq_ctx->timeout);
+		Cron_AbortTimeout(gq_ctx->timeout);
 	}
 
 	// emit error if query timed out
@@ -136,9 +140,11 @@ void QueryTimedOut(void *pdata) {
 }
 
 // set timeout for query execution
+// the plan is drained by CRON once the timeout is due, in addition
+// the query's deadline is checked cooperatively during execution
 CronTaskHandle Query_SetTimeOut(uint timeout, ExecutionPlan *plan) {
-	// increase execution plan ref count
-	return Cron_AddTask(timeout, QueryTimedOut, NULL, plan);
+	QueryCtx_SetDeadline(QueryCtx_GetQueryCtx(), timeout);
+	return Cron_AddTimeout(timeout, QueryTimedOut, plan);
 }
 
 inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
@@ -191,10 +197,15 @@ static void _ExecuteQuery(void *args) {
 
 	QueryCtx_SetResultSet(result_set);
 
+	// within a commit group the graph is already write locked
+	// and the graph key was opened for writing
+	const bool grouped = QueryCtx_InCommitGroup();
+
 	// acquire the appropriate lock
-	if(readonly) {
-		Graph_AcquireReadLock(gc->g);
-	} else {
+	// unless the read lock was acquired by the dispatcher
+	if(readonly && !grouped) {
+		if(!command_ctx->read_locked) Graph_AcquireReadLock(gc->g);
+	} else if(!grouped) {
 		// if this is a writer query `we need to re-open the graph key with write flag
 		// this notifies Redis that the key is "dirty" any watcher on that key will
 		// be notified
@@ -210,6 +221,9 @@ static void _ExecuteQuery(void *args) {
 		// avoid resetting policies between readers and writers
 		Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
+		// values computed during execution live no longer than the query
+		QueryCtx_ActivateArena(query_ctx);
+
 		ExecutionPlan_PreparePlan(plan);
 		if(profile) {
 			ExecutionPlan_Profile(plan);
@@ -224,14 +238,19 @@ static void _ExecuteQuery(void *args) {
 			}
 		}
 		else {
+			ExecutionCtx_ObserveCardinalities(exec_ctx);
 			result_set = ExecutionPlan_Execute(plan);
 			if (abort_and_check_timeout(gq_ctx, plan)) {
 				query_ctx->status = QueryExecutionStatus_TIMEDOUT;
 			}
+
+			if(!ErrorCtx_EncounteredError()) {
+				ExecutionCtx_ReviewCardinalities(exec_ctx);
+			}
 		}
 
-		ExecutionPlan_Free(plan);
-		exec_ctx->plan = NULL;
+		// return the plan to its pool while the graph is locked
+		ExecutionCtx_ReleasePlan(exec_ctx);
 	} else if(exec_type == EXECUTION_TYPE_INDEX_CREATE ||
 			exec_type == EXECUTION_TYPE_INDEX_DROP) {
 		IndexOperation_Run(gc, ast, exec_type);
@@ -239,6 +258,15 @@ static void _ExecuteQuery(void *args) {
 		ASSERT("Unhandled query type" && false);
 	}
 
+	// a commit group executes its queries without the GIL, the graph key
+	// might have been deleted meanwhile, modifications made once the graph
+	// is detached from its key are lost along with it, fail the query
+	if(grouped && !ErrorCtx_EncounteredError() &&
+	   ResultSetStat_IndicateModification(&result_set->stats) &&
+	   GraphContext_Detached(gc)) {
+		ErrorCtx_SetError(EMSG_EMPTY_KEY, GraphContext_GetName(gc));
+	}
+
 	// in case of an error, rollback any modifications
 	if(ErrorCtx_EncounteredError()) {
 		QueryCtx_Rollback();
@@ -251,8 +279,14 @@ static void _ExecuteQuery(void *args) {
 		// replicate if graph was modified
 		if(ResultSetStat_IndicateModification(&result_set->stats)) {
 			// determine rather or not to replicate via effects
-			if(EffectsBuffer_Length(QueryCtx_GetEffectsBuffer()) > 0 &&
-			   _should_replicate_effects()) {
+			bool use_effects =
+				EffectsBuffer_Length(QueryCtx_GetEffectsBuffer()) > 0 &&
+				_should_replicate_effects();
+
+			// within a commit group replication is deferred to the group's end
+			if(QueryCtx_DeferReplication(query_ctx, use_effects)) {
+				// replicated by the commit group
+			} else if(use_effects) {
 				// compute effects buffer
 				size_t effects_len = 0;
 				u_char *effects = EffectsBuffer_Buffer(
@@ -283,7 +317,7 @@ static void _ExecuteQuery(void *args) {
 		QueryCtx_AdvanceStage(query_ctx);
 	}
 
-	if(readonly) Graph_ReleaseLock(gc->g); // release read lock
+	if(readonly && !grouped) Graph_ReleaseLock(gc->g); // release read lock
 
 	// log query to slowlog
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
@@ -291,17 +325,103 @@ static void _ExecuteQuery(void *args) {
 				QueryCtx_GetRuntime(), NULL);
 
 	// clean up
+	Globals_UntrackCommandCtx(command_ctx);
+	if(_deferred_clients != NULL) {
+		// client is unblocked once its modifications are committed
+		array_append(_deferred_clients, command_ctx);
+	} else {
+		CommandCtx_UnblockClient(command_ctx);
+		CommandCtx_Free(command_ctx);
+	}
+
+	// client is unblocked, prepare a plan for the next cache hit
+	ExecutionCtx_ReplenishPool(exec_ctx);
 	ExecutionCtx_Free(exec_ctx);
 	GraphContext_DecreaseRefCount(gc);
-	Globals_UntrackCommandCtx(command_ctx);
-	CommandCtx_UnblockClient(command_ctx);
-	CommandCtx_Free(command_ctx);
 	QueryCtx_Free(); // reset the QueryCtx and free its allocations
 	ErrorCtx_Clear();
 	ResultSet_Free(result_set);
 	GraphQueryCtx_Free(gq_ctx);
 }
 
+// writes eligible for a commit group target the same graph
+// and are issued by blocked clients
+static TaskFilterResult _GroupCommitFilter
+(
+	void *task,  // queued GraphQueryCtx
+	void *pdata  // graph of the group
+) {
+	GraphQueryCtx *gq_ctx = (GraphQueryCtx *)task;
+
+	// writes to other graphs are independent of the group
+	if(gq_ctx->graph_ctx != (GraphContext *)pdata) return TASK_SKIP;
+
+	// keep the graph's writes in order
+	if(gq_ctx->command_ctx->bc == NULL) return TASK_STOP;
+
+	return TASK_TAKE;
+}
+
+// writer thread entry point
+// drains queued writes against the same graph and executes them all
+// within a single commit group: the write lock is acquired once,
+// their replication is deferred to the group's end
+// and their clients are unblocked only once the group is replicated
+static void _ExecuteWrites(void *args) {
+	ASSERT(args != NULL);
+
+	GraphQueryCtx *gq_ctx = (GraphQueryCtx *)args;
+
+	// only blocked clients can have their replies held back
+	if(gq_ctx->command_ctx->bc == NULL) {
+		_ExecuteQuery(gq_ctx);
+		return;
+	}
+
+	// max number of queued writes executed within a single commit group
+	uint64_t group_max;
+	Config_Option_get(Config_GROUP_COMMIT_MAX, &group_max);
+	ASSERT(group_max > 0 && group_max <= GROUP_COMMIT_MAX_LIMIT);
+
+	GraphQueryCtx *group[group_max];
+	group[0] = gq_ctx;
+
+	uint32_t n = 1 + ThreadPools_TakeWriterTasks((void **)(group + 1),
+			group_max - 1, _ExecuteWrites, _GroupCommitFilter,
+			gq_ctx->graph_ctx);
+
+	if(n == 1) {
+		_ExecuteQuery(gq_ctx);
+		return;
+	}
+
+	// the group locks and replicates via the first client's context
+	// which remains valid until the group's clients are unblocked
+	char *err = NULL;
+	if(!QueryCtx_BeginCommitGroup(gq_ctx->graph_ctx, gq_ctx->rm_ctx, true,
+				&err)) {
+		// graph key is inaccessible, let each query report its own error
+		free(err);
+		for(uint32_t i = 0; i < n; i++) _ExecuteQuery(group[i]);
+		return;
+	}
+
+	_deferred_clients = array_new(CommandCtx *, n);
+
+	for(uint32_t i = 0; i < n; i++) _ExecuteQuery(group[i]);
+
+	QueryCtx_EndCommitGroup();
+
+	// group committed, reply to clients
+	for(uint32_t i = 0; i < n; i++) {
+		CommandCtx_UnblockClient(_deferred_clients[i]);
+		CommandCtx_Free(_deferred_clients[i]);
+	}
+
+	array_free(_deferred_clients);
+	_deferred_clients = NULL;
+}
+
 static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 	ASSERT(gq_ctx != NULL);
 
@@ -324,7 +444,7 @@ static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 	QueryCtx_ResetStage(gq_ctx->query_ctx);
 
 	// dispatch work to the writer thread
-	int res = ThreadPools_AddWorkWriter(_ExecuteQuery, gq_ctx, 0);
+	int res = ThreadPools_AddWorkWriter(_ExecuteWrites, gq_ctx, 0);
 	ASSERT(res == 0);
 }
 
@@ -358,6 +478,13 @@ void _query
 	bool index_op = (exec_type == EXECUTION_TYPE_INDEX_CREATE ||
 	     exec_type == EXECUTION_TYPE_INDEX_DROP);
 
+	// the dispatcher read locked the graph for a query it deemed read-only
+	// a write must not hold the read lock while acquiring the write lock
+	if(command_ctx->read_locked && (!readonly || index_op)) {
+		Graph_ReleaseLock(gc->g);
+		command_ctx->read_locked = false;
+	}
+
 	if(profile && index_op) {
 		RedisModule_ReplyWithError(ctx, "Can't profile index operations.");
 		goto cleanup;
@@ -403,6 +530,12 @@ void _query
 	return;
 
 cleanup:
+	// release the read lock acquired by the dispatcher
+	if(command_ctx->read_locked) {
+		Graph_ReleaseLock(gc->g);
+		command_ctx->read_locked = false;
+	}
+
 	// if there were any query compile time errors, report them
 	if(ErrorCtx_EncounteredError()) {
 		ErrorCtx_EmitException();
@@ -0,0 +1,222 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+// GRAPH.QUERY_BATCH executes a list of queries against a single graph
+//
+// the batch is handed off to the writer thread as a single task, where its
+// queries run one after the other within a commit group: the graph's write
+// lock is acquired once for the entire batch and the queries' replication is
+// deferred to the batch's end, where consecutive effects are replicated as
+// a single GRAPH.EFFECT, the GIL is held only while opening the graph key
+// and while replicating
+//
+// each query succeeds or fails on its own, a failed query is rolled back
+// without affecting the rest of the batch
+
+#include "RG.h"
+#include "commands.h"
+#include "cmd_context.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../util/thpool/pools.h"
+#include "../util/simple_timer.h"
+#include "../util/blocked_client.h"
+#include "../configuration/config.h"
+
+// GRAPH.QUERY_BATCH command context
+typedef struct {
+	GraphContext *gc;              // graph context
+	RedisModuleCtx *ctx;           // redis module context
+	RedisModuleBlockedClient *bc;  // blocked client
+	char **queries;                // queries to execute
+	bool compact;                  // compact result-set format
+	long long timeout;             // per query timeout
+	bool timeout_rw;               // apply timeout on both read and write queries
+	uint64_t received_ts;          // command received at this UNIX timestamp
+} QueryBatch;
+
+// builds the batch's i-th query from its query and parameters arguments
+static char *_QueryBatch_Query
+(
+	RedisModuleString *query,  // query string
+	RedisModuleString *params  // query parameters "name=value ..."
+) {
+	size_t params_len;
+	const char *q = RedisModule_StringPtrLen(query, NULL);
+	const char *p = RedisModule_StringPtrLen(params, &params_len);
+
+	if(params_len == 0) return rm_strdup(q);
+
+	// prefix query with its parameters: CYPHER <params> <query>
+	char *s;
+	int rc __attribute__((unused));
+	rc = asprintf(&s, "CYPHER %s %s", p, q);
+
+	char *res = rm_strdup(s);
+	free(s);
+
+	return res;
+}
+
+static void _QueryBatch_Free
+(
+	QueryBatch *batch  // batch to free
+) {
+	uint n = array_len(batch->queries);
+	for(uint i = 0; i < n; i++) {
+		// queries handed off to a command context are NULL-set
+		if(batch->queries[i] != NULL) rm_free(batch->queries[i]);
+	}
+	array_free(batch->queries);
+
+	GraphContext_DecreaseRefCount(batch->gc);
+	rm_free(batch);
+}
+
+// executes the batch's queries within a single commit group
+// replies with an array holding each query's result-set or error
+static void _QueryBatch_Run
+(
+	void *arg  // query batch
+) {
+	QueryBatch   *batch = (QueryBatch *)arg;
+	GraphContext *gc    = batch->gc;
+	uint          n     = array_len(batch->queries);
+
+	// a blocked client is replied to via a thread safe context
+	RedisModuleCtx *ctx = (batch->bc != NULL)
+		? RedisModule_GetThreadSafeContext(batch->bc)
+		: batch->ctx;
+
+	char *err = NULL;
+	if(!QueryCtx_BeginCommitGroup(gc, ctx, batch->bc != NULL, &err)) {
+		RedisModule_ReplyWithError(ctx, err);
+		free(err);
+		goto cleanup;
+	}
+
+	RedisModule_ReplyWithArray(ctx, n);
+
+	for(uint i = 0; i < n; i++) {
+		simple_timer_t timer;
+		simple_tic(timer);
+
+		// each query replies and is freed by Graph_Query
+		// it runs inline, holding the group's write lock
+		GraphContext_IncreaseRefCount(gc);
+		CommandCtx *command_ctx = CommandCtx_New(ctx, NULL, NULL, NULL, gc,
+				EXEC_THREAD_MAIN, false, batch->compact, batch->timeout,
+				batch->timeout_rw, batch->received_ts, timer, NULL);
+
+		// queries are replicated individually under GRAPH.QUERY
+		// when their modifications aren't captured by effects
+		command_ctx->command_name = rm_strdup("GRAPH.QUERY");
+		command_ctx->query        = batch->queries[i];
+		batch->queries[i]         = NULL;
+
+		Graph_Query(command_ctx);
+	}
+
+	QueryCtx_EndCommitGroup();
+
+cleanup:
+	if(batch->bc != NULL) {
+		RedisGraph_UnblockClient(batch->bc);
+		RedisModule_FreeThreadSafeContext(ctx);
+	}
+
+	_QueryBatch_Free(batch);
+}
+
+// execute a batch of queries against a single graph
+//
+// usage:
+// GRAPH.QUERY_BATCH <graph> <query> <params> [<query> <params> ...] [--compact]
+//
+// where params holds the query's parameters in the form "name=value ..."
+// and may be empty
+int Graph_QueryBatch
+(
+	RedisModuleCtx *ctx,       // redis module context
+	RedisModuleString **argv,  // command arguments
+	int argc                   // number of arguments
+) {
+	ASSERT(ctx  != NULL);
+	ASSERT(argv != NULL);
+
+	bool compact = false;
+	if(argc > 2 && (argc % 2) == 1) {
+		const char *flag = RedisModule_StringPtrLen(argv[argc - 1], NULL);
+		compact = (strcasecmp(flag, "--compact") == 0);
+		if(compact) argc--;
+	}
+
+	// expecting a graph name followed by at least one (query, params) pair
+	if(argc < 4 || (argc % 2) == 1) {
+		return RedisModule_WrongArity(ctx);
+	}
+
+	uint64_t received_ts = unix_timestamp();
+
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], false, true);
+
+	// if GraphContext is null, key access failed and an error been emitted
+	if(gc == NULL) return REDISMODULE_ERR;
+
+	QueryBatch *batch = rm_malloc(sizeof(QueryBatch));
+
+	batch->gc          = gc;
+	batch->bc          = NULL;
+	batch->ctx         = NULL;
+	batch->compact     = compact;
+	batch->received_ts = received_ts;
+
+	// queries are subject to the configured default timeout
+	long long max_timeout;
+	Config_Option_get(Config_TIMEOUT_DEFAULT, &batch->timeout);
+	Config_Option_get(Config_TIMEOUT_MAX, &max_timeout);
+
+	batch->timeout_rw = (batch->timeout != CONFIG_TIMEOUT_NO_TIMEOUT ||
+			max_timeout != CONFIG_TIMEOUT_NO_TIMEOUT);
+	if(!batch->timeout_rw) {
+		Config_Option_get(Config_TIMEOUT, &batch->timeout);
+	} else if(batch->timeout == CONFIG_TIMEOUT_NO_TIMEOUT) {
+		batch->timeout = max_timeout;
+	}
+
+	uint n = (argc - 2) / 2;
+	batch->queries = array_new(char *, n);
+	for(uint i = 0; i < n; i++) {
+		char *q = _QueryBatch_Query(argv[2 + i * 2], argv[3 + i * 2]);
+		array_append(batch->queries, q);
+	}
+
+	// batches issued within a LUA script or multi exec block must
+	// run on Redis main thread
+	int flags = RedisModule_GetContextFlags(ctx);
+	bool main_thread = (flags & (REDISMODULE_CTX_FLAGS_MULTI |
+				REDISMODULE_CTX_FLAGS_LUA           |
+				REDISMODULE_CTX_FLAGS_REPLICATED    |
+				REDISMODULE_CTX_FLAGS_DENY_BLOCKING |
+				REDISMODULE_CTX_FLAGS_LOADING));
+
+	if(main_thread) {
+		batch->ctx = ctx;
+		_QueryBatch_Run(batch);
+		return REDISMODULE_OK;
+	}
+
+	batch->bc = RedisGraph_BlockClient(ctx);
+	if(ThreadPools_AddWorkWriter(_QueryBatch_Run, batch, 0) ==
+			THPOOL_QUEUE_FULL) {
+		// report an error once the writer's queue is full
+		RedisModule_ReplyWithError(ctx, "Max pending queries exceeded");
+		RedisGraph_UnblockClient(batch->bc);
+		_QueryBatch_Free(batch);
+	}
+
+	return REDISMODULE_OK;
+}
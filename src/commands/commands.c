@@ -21,6 +21,7 @@ GRAPH_Commands CommandFromString(const char *cmd_name) {
 	if (!strcasecmp(cmd_name, "graph.SLOWLOG"))  return CMD_SLOWLOG;
 	if (!strcasecmp(cmd_name, "graph.RO_QUERY")) return CMD_RO_QUERY;
 	if (!strcasecmp(cmd_name, "graph.BULK"))     return CMD_BULK_INSERT;
+	if (!strcasecmp(cmd_name, "graph.QUERY_BATCH")) return CMD_QUERY_BATCH;
 
 	// we shouldn't reach this point
 	ASSERT(false);
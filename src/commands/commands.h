@@ -29,7 +29,8 @@ typedef enum {
 	CMD_INFO        = 11,
 	CMD_EFFECT      = 12,
 	CMD_COPY        = 13,
-	CMD_RESTORE     = 14
+	CMD_RESTORE     = 14,
+	CMD_QUERY_BATCH = 15
 } GRAPH_Commands;
 
 //------------------------------------------------------------------------------
@@ -51,6 +52,7 @@ int Graph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Config(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Restore(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Slowlog(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_QueryBatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Constraint(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 
@@ -7,9 +7,281 @@
 #include "execution_ctx.h"
 #include "RG.h"
 #include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/arena.h"
+#include "../util/sds/sds.h"
 #include "../errors/errors.h"
+#include "../ast/ast_parameterize.h"
+#include "../util/thpool/pools.h"
+#include "../configuration/config.h"
+#include "../execution_plan/ops/op_skip.h"
+#include "../execution_plan/ops/op_limit.h"
+#include "../execution_plan/ops/op_node_by_label_scan.h"
+#include "../execution_plan/ops/op_node_by_index_scan.h"
 #include "../execution_plan/execution_plan_clone.h"
 #include "../execution_plan/optimizations/optimizer.h"
+#include "../execution_plan/optimizations/cardinality_estimation.h"
+#include "../execution_plan/execution_plan_build/execution_plan_util.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define OBSERVE_INTERVAL   8     // observe every n'th execution of a plan
+#define REPLAN_MIN_RECORDS 1000  // min observed records to consider re-planning
+#define MAX_REPLANS        4     // max number of times a pool is re-planned
+
+// scan ops whose cardinality is observed
+static const OPType OBSERVED_SCANS[] = {
+	OPType_ALL_NODE_SCAN,
+	OPType_NODE_BY_LABEL_SCAN,
+	OPType_NODE_BY_INDEX_SCAN
+};
+#define OBSERVED_SCAN_COUNT 3
+
+// number of records a template's scan op was estimated to produce
+typedef struct {
+	const char *alias;  // scanned alias
+	double records;     // estimated number of records
+} ScanEstimate;
+
+// pool of ready to run execution plans cloned from a cached template
+// a plan is specialized to its execution by runtime optimizations
+// (parameters, indices, label counts) and by evaluating its expressions
+// once executed, a plan is restored against the template it was cloned from
+// and returned to the pool, to be prepared once again by its next execution
+// plans which diverged from their template e.g. an index scan replaced a
+// label scan, or contain ops which can't be restored are freed, in which
+// case the pool is topped up with a fresh clone once the query replied
+// clones are resolved against the graph's schema, a schema change
+// e.g. a new relationship type, drops the pooled clones
+// the pool is shared by the cached execution ctx and all of its clones
+// and is freed once the last of them is freed
+//
+// a template is planned against the graph as it was when the query was
+// first seen, a sample of executions counts the records produced by their
+// scan ops, once a scan is found to produce far more records than the
+// template was planned for, the template is rebuilt
+// replaced templates are retired rather than freed as they might be cloned
+// concurrently, which caps the number of times a pool is re-planned
+struct PlanPool {
+	ExecutionPlan *template;     // plan template, never executed
+	ExecutionPlan **instances;   // pooled clones of template
+	ExecutionPlan **retired;     // replaced templates
+	ScanEstimate *estimates;     // template's scan estimates
+	uint cap;                    // max number of pooled clones
+	bool recyclable;             // template is independent of parameters
+	XXH32_hash_t version;        // graph version clones were made at
+	pthread_mutex_t lock;        // guards template, instances and estimates
+	atomic_uint ref_count;       // number of execution ctxs referring pool
+	atomic_uint executions;      // number of observation opportunities
+	atomic_bool replan;          // template should be rebuilt
+};
+
+// estimate the number of records produced by each of the template's scans
+static ScanEstimate *_PlanPool_Estimate
+(
+	const ExecutionPlan *template  // plan template
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	OpBase **scans = ExecutionPlan_CollectOpsMatchingTypes(template->root,
+			OBSERVED_SCANS, OBSERVED_SCAN_COUNT);
+
+	uint n = array_len(scans);
+	ScanEstimate *estimates = array_new(ScanEstimate, n);
+
+	for(uint i = 0; i < n; i++) {
+		OpBase *op = scans[i];
+
+		// scans fed by a child op are invoked once per input record
+		if(op->childCount > 0) {
+			continue;
+		}
+
+		LabelID l = GRAPH_NO_LABEL;
+		const FT_FilterNode *ft = NULL;
+		if(op->type == OPType_NODE_BY_LABEL_SCAN) {
+			l = ((NodeByLabelScan *)op)->n->label_id;
+		} else if(op->type == OPType_NODE_BY_INDEX_SCAN) {
+			l  = ((IndexScan *)op)->n->label_id;
+			ft = ((IndexScan *)op)->filter;
+		}
+
+		const char *alias = op->modifies[0];
+		ScanEstimate e = {
+			.alias   = alias,
+			.records = Cardinality_LabelScan(gc, l, alias, ft)
+		};
+		array_append(estimates, e);
+	}
+
+	array_free(scans);
+	return estimates;
+}
+
+// LIMIT and SKIP are evaluated once their op is constructed
+// plans cloned ahead of their execution or carried over to another execution
+// would hold the values of another query's parameters
+static bool _PlanPool_Recyclable
+(
+	const ExecutionPlan *template  // plan template
+) {
+	const OPType types[2] = {OPType_LIMIT, OPType_SKIP};
+	OpBase **ops = ExecutionPlan_CollectOpsMatchingTypes(template->root,
+			types, 2);
+
+	bool recyclable = true;
+	uint n = array_len(ops);
+	for(uint i = 0; i < n && recyclable; i++) {
+		const AR_ExpNode *exp = (ops[i]->type == OPType_LIMIT)
+			? ((OpLimit *)ops[i])->limit_exp
+			: ((OpSkip *)ops[i])->skip_exp;
+		recyclable = AR_EXP_IsConstant(exp);
+	}
+
+	array_free(ops);
+	return recyclable;
+}
+
+static PlanPool *_PlanPool_New
+(
+	ExecutionPlan *template  // plan template, owned by the pool
+) {
+	PlanPool *pool = rm_malloc(sizeof(PlanPool));
+
+	// one pooled clone per thread can execute concurrently
+	pool->cap        = ThreadPools_ThreadCount();
+	pool->version    = GraphContext_GetVersion(QueryCtx_GetGraphCtx());
+	pool->template   = template;
+	pool->retired    = array_new(ExecutionPlan *, 0);
+	pool->estimates  = _PlanPool_Estimate(template);
+	pool->instances  = array_new(ExecutionPlan *, pool->cap);
+	pool->recyclable = _PlanPool_Recyclable(template);
+
+	pthread_mutex_init(&pool->lock, NULL);
+	atomic_init(&pool->ref_count, 1);
+	atomic_init(&pool->executions, 0);
+	atomic_init(&pool->replan, false);
+
+	return pool;
+}
+
+static PlanPool *_PlanPool_Retain
+(
+	PlanPool *pool
+) {
+	atomic_fetch_add(&pool->ref_count, 1);
+	return pool;
+}
+
+// drop pooled clones
+// must be called with the pool's lock held
+static void _PlanPool_Clear
+(
+	PlanPool *pool
+) {
+	uint n = array_len(pool->instances);
+	for(uint i = 0; i < n; i++) {
+		ExecutionPlan_Free(pool->instances[i]);
+	}
+	array_clear(pool->instances);
+}
+
+// labels, relationship types and attributes are resolved when a plan is
+// cloned, clones made before the graph's schema changed are stale
+// must be called with the pool's lock held
+static void _PlanPool_Validate
+(
+	PlanPool *pool,
+	XXH32_hash_t version
+) {
+	if(pool->version != version) {
+		_PlanPool_Clear(pool);
+		pool->version = version;
+	}
+}
+
+static void _PlanPool_Release
+(
+	PlanPool *pool
+) {
+	if(atomic_fetch_sub(&pool->ref_count, 1) != 1) {
+		return;
+	}
+
+	_PlanPool_Clear(pool);
+	array_free(pool->instances);
+	array_free(pool->estimates);
+	array_free_cb(pool->retired, ExecutionPlan_Free);
+	ExecutionPlan_Free(pool->template);
+	pthread_mutex_destroy(&pool->lock);
+	rm_free(pool);
+}
+
+// get a ready to run plan for 'ctx'
+// pops a pooled clone if available, otherwise clones the template
+static void _PlanPool_Acquire
+(
+	PlanPool *pool,    // plan pool
+	ExecutionCtx *ctx  // execution context acquiring the plan
+) {
+	ExecutionPlan *plan = NULL;
+	XXH32_hash_t version = GraphContext_GetVersion(QueryCtx_GetGraphCtx());
+
+	pthread_mutex_lock(&pool->lock);
+	_PlanPool_Validate(pool, version);
+	if(array_len(pool->instances) > 0) {
+		plan = array_pop(pool->instances);
+	}
+	ExecutionPlan *template = pool->template;
+	pthread_mutex_unlock(&pool->lock);
+
+	if(plan == NULL) {
+		plan = ExecutionPlan_Clone(template);
+	}
+
+	ctx->plan    = plan;
+	ctx->origin  = template;
+	ctx->version = version;
+}
+
+// rebuild the pool's template from the AST in thread local storage
+// planning against the graph's current state
+static void _PlanPool_Replan
+(
+	PlanPool *pool
+) {
+	ExecutionPlan *template = ExecutionPlan_FromTLS_AST();
+	if(ErrorCtx_EncounteredError()) {
+		// keep the current template
+		ExecutionPlan_Free(template);
+		ErrorCtx_Clear();
+		return;
+	}
+
+	Optimizer_CompileTimeOptimize(template);
+	ScanEstimate *estimates = _PlanPool_Estimate(template);
+
+	pthread_mutex_lock(&pool->lock);
+	if(array_len(pool->retired) < MAX_REPLANS) {
+		// pooled clones were made of the replaced template
+		_PlanPool_Clear(pool);
+		array_append(pool->retired, pool->template);
+		array_free(pool->estimates);
+
+		pool->template  = template;
+		pool->estimates = estimates;
+
+		template  = NULL;
+		estimates = NULL;
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	// re-planning cap reached
+	if(template != NULL) {
+		ExecutionPlan_Free(template);
+		array_free(estimates);
+	}
+}
 
 static ExecutionType _GetExecutionTypeFromAST
 (
@@ -55,6 +327,88 @@ static AST *_ExecutionCtx_ParseAST
 	return ast;
 }
 
+// parse query and build its execution plan
+// returns false if the query is invalid
+static bool _ExecutionCtx_Build
+(
+	const char *q_str,         // query string
+	AST **ast,                 // [output] AST
+	ExecutionPlan **plan,      // [output] execution plan, NULL for index ops
+	ExecutionType *exec_type   // [output] execution type
+) {
+	*plan = NULL;
+
+	// try to parse the query
+	*ast = _ExecutionCtx_ParseAST(q_str);
+
+	// parser failed
+	if(*ast == NULL) {
+		// if no error has been set, emit one now
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError(EMSG_COULD_NOT_PARSE_QUERY);
+		}
+		return false;
+	}
+
+	*exec_type = _GetExecutionTypeFromAST(*ast);
+	if(*exec_type != EXECUTION_TYPE_QUERY) {
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	// build execution-plan
+	//--------------------------------------------------------------------------
+
+	*plan = ExecutionPlan_FromTLS_AST();
+
+	// TODO: there must be a better way to understand if the execution-plan
+	// was constructed correctly,
+	// maybe free the plan within ExecutionPlan_FromTLS_AST, if error was
+	// encountered and return NULL ?
+	if(ErrorCtx_EncounteredError()) {
+		// failed to construct plan
+		AST_Free(*ast);
+		ExecutionPlan_Free(*plan);
+		*ast  = NULL;
+		*plan = NULL;
+		return false;
+	}
+
+	// apply compile time optimizations
+	Optimizer_CompileTimeOptimize(*plan);
+
+	return true;
+}
+
+// bind literals replaced by AST_ParameterizeLiterals to their parameters
+static void _ExecutionCtx_BindLiterals
+(
+	SIValue *literals  // replaced literals
+) {
+	rax *params = QueryCtx_GetParams();
+	if(params == NULL) {
+		params = raxNew();
+		QueryCtx_SetParams(params);
+	}
+
+	char name[32];
+	uint n = array_len(literals);
+	for(uint i = 0; i < n; i++) {
+		int len = snprintf(name, sizeof(name), LITERAL_PARAM_PREFIX "%u", i);
+		SIValue *v = rm_malloc(sizeof(SIValue));
+		*v = literals[i];
+
+		SIValue *old = NULL;
+		raxInsert(params, (unsigned char *)name, len, v, (void **)&old);
+		if(old != NULL) {
+			SIValue_Free(*old);
+			rm_free(old);
+		}
+	}
+
+	array_free(literals);
+}
+
 static ExecutionCtx *_ExecutionCtx_New
 (
 	AST *ast,
@@ -65,18 +419,25 @@ static ExecutionCtx *_ExecutionCtx_New
 
 	exec_ctx->ast       = ast;
 	exec_ctx->plan      = plan;
+	exec_ctx->pool      = NULL;
+	exec_ctx->origin    = NULL;
+	exec_ctx->version   = 0;
 	exec_ctx->cached    = false;
+	exec_ctx->observed  = false;
 	exec_ctx->exec_type = exec_type;
 
 	return exec_ctx;
 }
 
 // clone the execution ctx and return a shallow copy for the ast
-// deep copy for the execution plan
+// deep copy for the execution plan, taken from the plan pool when available
 ExecutionCtx *ExecutionCtx_Clone
 (
 	const ExecutionCtx *ctx  // execution context to clone
 ) {
+	ASSERT(ctx       != NULL);
+	ASSERT(ctx->pool != NULL);
+
 	ExecutionCtx *clone = rm_malloc(sizeof(ExecutionCtx));
 
 	clone->ast = AST_ShallowCopy(ctx->ast);
@@ -84,10 +445,13 @@ ExecutionCtx *ExecutionCtx_Clone
 	// set the AST copy in thread local storage
 	QueryCtx_SetAST(clone->ast);
 
-	clone->plan      = ExecutionPlan_Clone(ctx->plan);
+	clone->pool      = _PlanPool_Retain(ctx->pool);
 	clone->cached    = ctx->cached;
+	clone->observed  = false;
 	clone->exec_type = ctx->exec_type;
 
+	_PlanPool_Acquire(clone->pool, clone);
+
 	return clone;
 }
 
@@ -139,7 +503,23 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	Cache *cache = GraphContext_GetCache(QueryCtx_GetGraphCtx());
 
 	// see if we already have a cached execution-ctx for given query
-	ret = Cache_GetValue(cache, q_str);
+	// queries without parameterizable literals are cached as given
+	const char *key = q_str;  // cache key
+	ret = Cache_GetValue(cache, key);
+
+	// replace literals with hidden parameters, such that queries
+	// differing only by their literals share a cache entry
+	// skip queries which might refer to parameters of the same name
+	if(ret == NULL && strstr(q_str, LITERAL_PARAM_PREFIX) == NULL) {
+		SIValue *literals;
+		char *parameterized = AST_ParameterizeLiterals(q_str, &literals);
+		if(parameterized != NULL) {
+			_ExecutionCtx_BindLiterals(literals);
+			ctx->query_data.query_parameterized = parameterized;
+			key = parameterized;
+			ret = Cache_GetValue(cache, key);
+		}
+	}
 
 	//--------------------------------------------------------------------------
 	// cache hit
@@ -155,49 +535,36 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	// cache miss
 	//--------------------------------------------------------------------------
 
-	// try to parse the query
-	AST *ast = _ExecutionCtx_ParseAST(q_str);
+	AST *ast;
+	ExecutionPlan *plan;
+	ExecutionType exec_type;
+	bool built = _ExecutionCtx_Build(key, &ast, &plan, &exec_type);
+
+	// fall back to the query as given if its parameterized form is rejected
+	// reporting errors against the original query string
+	if(!built && key != q_str) {
+		ErrorCtx_Clear();
+		key = q_str;
+		sdsfree(ctx->query_data.query_parameterized);
+		ctx->query_data.query_parameterized = NULL;
+		built = _ExecutionCtx_Build(key, &ast, &plan, &exec_type);
+	}
 
-	// parser failed
-	if(ast == NULL) {
+	if(!built) {
 		parse_result_free(params_parse_result);  // free parsed params
-
-		// if no error has been set, emit one now
-		if(!ErrorCtx_EncounteredError()) {
-			ErrorCtx_SetError(EMSG_COULD_NOT_PARSE_QUERY);
-		}
 		return NULL;
 	}
 
 	// associate parameters with AST
 	AST_SetParamsParseResult(ast, params_parse_result);
 
-	ExecutionType exec_type = _GetExecutionTypeFromAST(ast);
-	// in case of valid query
-	// create execution plan, and cache it and the AST
+	// in case of valid query cache the AST and execution plan
 	if(exec_type == EXECUTION_TYPE_QUERY) {
-		//----------------------------------------------------------------------
-		// build execution-plan
-		//----------------------------------------------------------------------
-		ExecutionPlan *plan = ExecutionPlan_FromTLS_AST();
-
-		// TODO: there must be a better way to understand if the execution-plan
-		// was constructed correctly,
-		// maybe free the plan within ExecutionPlan_FromTLS_AST, if error was
-		// encountered and return NULL ?
-		if(ErrorCtx_EncounteredError()) {
-			// failed to construct plan
-			// clean up and return NULL
-			AST_Free(ast);
-			ExecutionPlan_Free(plan);
-			return NULL;
-		}
-
-		// apply compile time optimizations
-		Optimizer_CompileTimeOptimize(plan);
-
-		ExecutionCtx *exec_ctx = _ExecutionCtx_New(ast, plan, exec_type);
-		ret = Cache_SetGetValue(cache, q_str, exec_ctx);
+		// the cached execution ctx holds no plan of its own
+		// its plan template is owned by the plan pool
+		ExecutionCtx *exec_ctx = _ExecutionCtx_New(ast, NULL, exec_type);
+		exec_ctx->pool = _PlanPool_New(plan);
+		ret = Cache_SetGetValue(cache, key, exec_ctx);
 	} else {
 		ret = _ExecutionCtx_New(ast, NULL, exec_type);
 	}
@@ -205,6 +572,205 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	return ret;
 }
 
+// return the executed plan of 'ctx' to its plan pool
+// plans which can't be restored for another execution are freed
+// must be called while the graph is still locked
+void ExecutionCtx_ReleasePlan
+(
+	ExecutionCtx *ctx  // execution context
+) {
+	ASSERT(ctx != NULL);
+
+	PlanPool *pool = ctx->pool;
+	ExecutionPlan *plan = ctx->plan;
+	ctx->plan = NULL;
+
+	if(plan == NULL) {
+		return;
+	}
+
+	// a failed execution might have halted ops midway
+	// plans are stale once the graph's schema changed during their execution
+	bool restored = pool != NULL && pool->recyclable &&
+		!ErrorCtx_EncounteredError() &&
+		ctx->version == GraphContext_GetVersion(QueryCtx_GetGraphCtx()) &&
+		ExecutionPlan_Restore(plan, ctx->origin);
+
+	if(restored) {
+		pthread_mutex_lock(&pool->lock);
+		if(pool->version == ctx->version && pool->template == ctx->origin &&
+		   array_len(pool->instances) < pool->cap) {
+			array_append(pool->instances, plan);
+			plan = NULL;
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	// plan diverged from its template, pool went stale, re-planned or is full
+	if(plan != NULL) {
+		ExecutionPlan_Free(plan);
+	}
+}
+
+// top up the plan pool 'ctx' was taken from with a fresh plan clone
+// called once the query replied, moving the cost of cloning
+// off the next cache hit's critical path
+void ExecutionCtx_ReplenishPool
+(
+	const ExecutionCtx *ctx  // execution context
+) {
+	ASSERT(ctx != NULL);
+
+	PlanPool *pool = ctx->pool;
+	if(pool == NULL) {
+		return;
+	}
+
+	// an execution observed the template's estimates to be off
+	// leave re-planning to a successful execution
+	if(!ErrorCtx_EncounteredError() && atomic_exchange(&pool->replan, false)) {
+		// the new template outlives the query, values folded while planning
+		// must not be drawn from the query's arena
+		Arena *arena = Arena_GetActive();
+		Arena_SetActive(NULL);
+
+		_PlanPool_Replan(pool);
+
+		Arena_SetActive(arena);
+	}
+
+	// clones of parameter dependent templates are made once executed
+	if(!pool->recyclable) {
+		return;
+	}
+
+	XXH32_hash_t version = GraphContext_GetVersion(QueryCtx_GetGraphCtx());
+
+	pthread_mutex_lock(&pool->lock);
+	_PlanPool_Validate(pool, version);
+	bool full = array_len(pool->instances) >= pool->cap;
+	ExecutionPlan *template = pool->template;
+	pthread_mutex_unlock(&pool->lock);
+
+	if(full) {
+		return;
+	}
+
+	// clone outside of the lock, concurrent clones of a template are safe
+	ExecutionPlan *plan = ExecutionPlan_Clone(template);
+
+	pthread_mutex_lock(&pool->lock);
+	if(pool->version == version && pool->template == template &&
+	   array_len(pool->instances) < pool->cap) {
+		array_append(pool->instances, plan);
+		plan = NULL;
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	// pool filled up, went stale or re-planned while cloning
+	if(plan != NULL) {
+		ExecutionPlan_Free(plan);
+	}
+}
+
+// observe the cardinalities produced by the scan ops of a sample of
+// executions, must be called once the plan is prepared, before it executes
+void ExecutionCtx_ObserveCardinalities
+(
+	ExecutionCtx *ctx  // execution context
+) {
+	ASSERT(ctx != NULL);
+
+	PlanPool *pool = ctx->pool;
+	if(pool == NULL || ctx->plan == NULL) {
+		return;
+	}
+
+	if(atomic_fetch_add(&pool->executions, 1) % OBSERVE_INTERVAL != 0) {
+		return;
+	}
+
+	uint64_t factor;
+	Config_Option_get(Config_REPLAN_FACTOR, &factor);
+	if(factor == REPLAN_FACTOR_DISABLED) {
+		return;
+	}
+
+	OpBase **scans = ExecutionPlan_CollectOpsMatchingTypes(ctx->plan->root,
+			OBSERVED_SCANS, OBSERVED_SCAN_COUNT);
+
+	uint n = array_len(scans);
+	for(uint i = 0; i < n; i++) {
+		if(scans[i]->childCount == 0) {
+			OpBase_CountRecords(scans[i]);
+		}
+	}
+
+	array_free(scans);
+	ctx->observed = true;
+}
+
+// compare the observed scan cardinalities against the estimates the plan
+// was built upon, a large underestimation marks the plan pool for re-planning
+// overestimation is ignored as execution might terminate early e.g. LIMIT
+void ExecutionCtx_ReviewCardinalities
+(
+	const ExecutionCtx *ctx  // execution context
+) {
+	ASSERT(ctx != NULL);
+
+	if(!ctx->observed) {
+		return;
+	}
+
+	uint64_t factor;
+	Config_Option_get(Config_REPLAN_FACTOR, &factor);
+	if(factor == REPLAN_FACTOR_DISABLED) {
+		return;
+	}
+
+	bool replan = false;
+	PlanPool *pool = ctx->pool;
+	OpBase **scans = ExecutionPlan_CollectOpsMatchingTypes(ctx->plan->root,
+			OBSERVED_SCANS, OBSERVED_SCAN_COUNT);
+
+	pthread_mutex_lock(&pool->lock);
+
+	uint n = array_len(scans);
+	uint m = array_len(pool->estimates);
+	for(uint i = 0; i < n && !replan; i++) {
+		OpBase *op = scans[i];
+		if(op->stats == NULL) {
+			continue;
+		}
+
+		double observed = op->stats->profileRecordCount;
+		if(observed < REPLAN_MIN_RECORDS) {
+			continue;
+		}
+
+		// runtime optimizations might have replaced the template's scan
+		// match estimates by the scanned alias
+		for(uint j = 0; j < m; j++) {
+			const ScanEstimate *e = pool->estimates + j;
+			if(strcmp(e->alias, op->modifies[0]) == 0) {
+				replan = observed > e->records * factor;
+				break;
+			}
+		}
+	}
+
+	replan &= array_len(pool->retired) < MAX_REPLANS;
+
+	pthread_mutex_unlock(&pool->lock);
+
+	array_free(scans);
+
+	if(replan) {
+		atomic_store(&pool->replan, true);
+	}
+}
+
 // free an ExecutionCTX struct and its inner fields
 void ExecutionCtx_Free
 (
@@ -218,6 +784,10 @@ void ExecutionCtx_Free
 		ExecutionPlan_Free(ctx->plan);
 	}
 
+	if(ctx->pool != NULL) {
+		_PlanPool_Release(ctx->pool);
+	}
+
 	if(ctx->ast != NULL) {
 		AST_Free(ctx->ast);
 	}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../ast/ast.h"
+#include "../graph/graphcontext.h"
 #include "../execution_plan/execution_plan.h"
 
  // execution type derived from a query
@@ -16,12 +17,19 @@ typedef enum {
 	EXECUTION_TYPE_INDEX_DROP     // drop index execution
 } ExecutionType;
 
+ // pool of ready to run execution plans cloned from a cached template
+typedef struct PlanPool PlanPool;
+
  // a struct for saving execution objects in cache
 typedef struct {
-	AST *ast;                 // AST
-	bool cached;              // cache hit/miss
-	ExecutionPlan *plan;      // execution plan
-	ExecutionType exec_type;  // execution type: query, index create/delete
+	AST *ast;                     // AST
+	bool cached;                  // cache hit/miss
+	bool observed;                // plan's scan cardinalities are observed
+	ExecutionPlan *plan;          // execution plan
+	PlanPool *pool;               // plan pool, NULL for uncached executions
+	const ExecutionPlan *origin;  // pool template plan was cloned from
+	XXH32_hash_t version;         // graph version plan was acquired at
+	ExecutionType exec_type;      // execution type: query, index create/delete
 } ExecutionCtx;
 
 // returns the objects and information required for query execution
@@ -41,6 +49,37 @@ ExecutionCtx *ExecutionCtx_Clone
 	const ExecutionCtx *ctx  // execution context to clone
 );
 
+// return the executed plan of 'ctx' to its plan pool
+// plans which can't be restored for another execution are freed
+// must be called while the graph is still locked
+void ExecutionCtx_ReleasePlan
+(
+	ExecutionCtx *ctx  // execution context
+);
+
+// top up the plan pool 'ctx' was taken from with a fresh plan clone
+// called once the query replied, moving the cost of cloning
+// off the next cache hit's critical path
+void ExecutionCtx_ReplenishPool
+(
+	const ExecutionCtx *ctx  // execution context
+);
+
+// observe the cardinalities produced by the scan ops of a sample of
+// executions, must be called once the plan is prepared, before it executes
+void ExecutionCtx_ObserveCardinalities
+(
+	ExecutionCtx *ctx  // execution context
+);
+
+// compare the observed scan cardinalities against the estimates the plan
+// was built upon, a large underestimation marks the plan pool for re-planning
+// must be called once the plan executed successfully
+void ExecutionCtx_ReviewCardinalities
+(
+	const ExecutionCtx *ctx  // execution context
+);
+
 // free an ExecutionCTX struct and its inner fields
 void ExecutionCtx_Free
 (
@@ -70,6 +70,21 @@
 // delay indexing
 #define DELAY_INDEXING "DELAY_INDEXING"
 
+// stream results
+#define STREAM_RESULTS "STREAM_RESULTS"
+
+// number of bolt I/O threads
+#define BOLT_IO_THREADS "BOLT_IO_THREADS"
+
+// cardinality misestimation factor triggering re-planning
+#define REPLAN_FACTOR "REPLAN_FACTOR"
+
+// max average runtime (microseconds) of cached read queries executed inline
+#define INLINE_QUERY_THRESHOLD "INLINE_QUERY_THRESHOLD"
+
+// max number of queued writes executed within a single commit group
+#define GROUP_COMMIT_MAX "GROUP_COMMIT_MAX"
+
 //------------------------------------------------------------------------------
 // Configuration defaults
 //------------------------------------------------------------------------------
@@ -81,6 +96,11 @@
 #define CMD_INFO_QUERIES_MAX_COUNT_DEFAULT 1000
 #define BOLT_PROTOCOL_PORT_DEFAULT         -1  // disabled by default
 #define DELAY_INDEXING_DEFAULT             false
+#define STREAM_RESULTS_DEFAULT             false
+#define BOLT_IO_THREADS_DEFAULT            2
+#define REPLAN_FACTOR_DEFAULT              10
+#define INLINE_QUERY_THRESHOLD_DEFAULT     INLINE_QUERY_DISABLED
+#define GROUP_COMMIT_MAX_DEFAULT           32
 
 // configuration object
 typedef struct {
@@ -103,6 +123,11 @@ typedef struct {
 	uint32_t max_info_queries_count;   // Maximum number of query info elements.
 	int16_t bolt_port;                 // bolt protocol port
 	bool delay_indexing;               // delay index construction when decoding
+	bool stream_results;               // stream read-only query results
+	uint bolt_io_threads;              // number of bolt I/O threads
+	uint64_t replan_factor;            // misestimation factor triggering re-planning
+	uint64_t inline_query_threshold;   // max runtime(us) of read queries executed inline
+	uint64_t group_commit_max;         // max number of writes committed together
 } RG_Config;
 
 RG_Config config; // global module configuration
@@ -476,6 +501,81 @@ static void Config_delay_indexing_set
 	config.delay_indexing = delay_indexing;
 }
 
+//------------------------------------------------------------------------------
+// stream results
+//------------------------------------------------------------------------------
+
+static bool Config_stream_results_get(void) {
+	return config.stream_results;
+}
+
+static void Config_stream_results_set
+(
+	const bool stream_results
+) {
+	config.stream_results = stream_results;
+}
+
+//------------------------------------------------------------------------------
+// replan factor
+//------------------------------------------------------------------------------
+
+static void Config_replan_factor_set
+(
+	uint64_t factor
+) {
+	config.replan_factor = factor;
+}
+
+static uint64_t Config_replan_factor_get(void) {
+	return config.replan_factor;
+}
+
+//------------------------------------------------------------------------------
+// inline query threshold
+//------------------------------------------------------------------------------
+
+static void Config_inline_query_threshold_set
+(
+	uint64_t threshold
+) {
+	config.inline_query_threshold = threshold;
+}
+
+static uint64_t Config_inline_query_threshold_get(void) {
+	return config.inline_query_threshold;
+}
+
+//------------------------------------------------------------------------------
+// group commit max
+//------------------------------------------------------------------------------
+
+static void Config_group_commit_max_set
+(
+	uint64_t max
+) {
+	config.group_commit_max = max;
+}
+
+static uint64_t Config_group_commit_max_get(void) {
+	return config.group_commit_max;
+}
+
+//------------------------------------------------------------------------------
+// bolt I/O threads
+//------------------------------------------------------------------------------
+
+static void Config_bolt_io_threads_set
+(
+	uint nthreads
+) {
+	config.bolt_io_threads = nthreads;
+}
+
+static uint Config_bolt_io_threads_get(void) {
+	return config.bolt_io_threads;
+}
+
 // check if field is a valid configuration option
 bool Config_Contains_field
 (
@@ -522,6 +622,16 @@ bool Config_Contains_field
 		f = Config_BOLT_PORT;
 	} else if (!(strcasecmp(field_str, DELAY_INDEXING))) {
 		f = Config_DELAY_INDEXING;
+	} else if (!(strcasecmp(field_str, STREAM_RESULTS))) {
+		f = Config_STREAM_RESULTS;
+	} else if (!(strcasecmp(field_str, BOLT_IO_THREADS))) {
+		f = Config_BOLT_IO_THREADS;
+	} else if (!(strcasecmp(field_str, REPLAN_FACTOR))) {
+		f = Config_REPLAN_FACTOR;
+	} else if (!(strcasecmp(field_str, INLINE_QUERY_THRESHOLD))) {
+		f = Config_INLINE_QUERY_THRESHOLD;
+	} else if (!(strcasecmp(field_str, GROUP_COMMIT_MAX))) {
+		f = Config_GROUP_COMMIT_MAX;
 	} else {
 		return false;
 	}
@@ -608,6 +718,26 @@ const char *Config_Field_name
 			name = DELAY_INDEXING;
 			break;
 
+		case Config_STREAM_RESULTS:
+			name = STREAM_RESULTS;
+			break;
+
+		case Config_BOLT_IO_THREADS:
+			name = BOLT_IO_THREADS;
+			break;
+
+		case Config_REPLAN_FACTOR:
+			name = REPLAN_FACTOR;
+			break;
+
+		case Config_INLINE_QUERY_THRESHOLD:
+			name = INLINE_QUERY_THRESHOLD;
+			break;
+
+		case Config_GROUP_COMMIT_MAX:
+			name = GROUP_COMMIT_MAX;
+			break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -681,6 +811,22 @@ static void _Config_SetToDefaults(void) {
 
 	// index entities as they're being decoded
 	config.delay_indexing = DELAY_INDEXING_DEFAULT;
+
+	// buffer results until query completes
+	config.stream_results = STREAM_RESULTS_DEFAULT;
+
+	// bolt I/O threads
+	config.bolt_io_threads = BOLT_IO_THREADS_DEFAULT;
+
+	// re-plan cached queries misestimating cardinality by 10x
+	config.replan_factor = REPLAN_FACTOR_DEFAULT;
+
+	// inline execution is opt-in, a query's past runtime doesn't bound
+	// the runtime of its next execution on Redis main thread
+	config.inline_query_threshold = INLINE_QUERY_THRESHOLD_DEFAULT;
+
+	// group up to 32 queued writes within a single commit
+	config.group_commit_max = GROUP_COMMIT_MAX_DEFAULT;
 }
 
 int Config_Init
@@ -1017,6 +1163,76 @@ bool Config_Option_get
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// stream results
+		//----------------------------------------------------------------------
+
+		case Config_STREAM_RESULTS: {
+			va_start(ap, field);
+			bool *stream_results = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(stream_results != NULL);
+			(*stream_results) = Config_stream_results_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// bolt I/O threads
+		//----------------------------------------------------------------------
+
+		case Config_BOLT_IO_THREADS: {
+			va_start(ap, field);
+			uint *bolt_io_threads = va_arg(ap, uint *);
+			va_end(ap);
+
+			ASSERT(bolt_io_threads != NULL);
+			(*bolt_io_threads) = Config_bolt_io_threads_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// replan factor
+		//----------------------------------------------------------------------
+
+		case Config_REPLAN_FACTOR: {
+			va_start(ap, field);
+			uint64_t *replan_factor = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(replan_factor != NULL);
+			(*replan_factor) = Config_replan_factor_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// inline query threshold
+		//----------------------------------------------------------------------
+
+		case Config_INLINE_QUERY_THRESHOLD: {
+			va_start(ap, field);
+			uint64_t *threshold = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(threshold != NULL);
+			(*threshold) = Config_inline_query_threshold_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// group commit max
+		//----------------------------------------------------------------------
+
+		case Config_GROUP_COMMIT_MAX: {
+			va_start(ap, field);
+			uint64_t *group_commit_max = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(group_commit_max != NULL);
+			(*group_commit_max) = Config_group_commit_max_get();
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -1282,6 +1498,69 @@ bool Config_Option_set
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// stream results
+		//----------------------------------------------------------------------
+
+		case Config_STREAM_RESULTS: {
+			bool stream_results;
+			if(!_Config_ParseYesNo(val, &stream_results)) return false;
+
+			Config_stream_results_set(stream_results);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// bolt I/O threads
+		//----------------------------------------------------------------------
+
+		case Config_BOLT_IO_THREADS: {
+			long long nthreads;
+			if(!_Config_ParsePositiveInteger(val, &nthreads)) return false;
+
+			Config_bolt_io_threads_set(nthreads);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// replan factor
+		//----------------------------------------------------------------------
+
+		case Config_REPLAN_FACTOR: {
+			long long factor;
+			if(!_Config_ParseNonNegativeInteger(val, &factor)) return false;
+
+			Config_replan_factor_set(factor);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// inline query threshold
+		//----------------------------------------------------------------------
+
+		case Config_INLINE_QUERY_THRESHOLD: {
+			long long threshold;
+			if(!_Config_ParseNonNegativeInteger(val, &threshold)) return false;
+
+			Config_inline_query_threshold_set(threshold);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// group commit max
+		//----------------------------------------------------------------------
+
+		case Config_GROUP_COMMIT_MAX: {
+			long long max;
+			if(!_Config_ParsePositiveInteger(val, &max) ||
+			   max > GROUP_COMMIT_MAX_LIMIT) {
+				return false;
+			}
+
+			Config_group_commit_max_set(max);
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -15,6 +15,9 @@
 #define QUERY_MEM_CAPACITY_UNLIMITED       0
 #define NODE_CREATION_BUFFER_DEFAULT       16384
 #define DELTA_MAX_PENDING_CHANGES_DEFAULT  10000
+#define REPLAN_FACTOR_DISABLED             0
+#define INLINE_QUERY_DISABLED              0
+#define GROUP_COMMIT_MAX_LIMIT             1024
 
 typedef enum {
 	Config_TIMEOUT                   = 0,   // timeout value for queries
@@ -35,7 +38,12 @@ typedef enum {
 	Config_EFFECTS_THRESHOLD         = 15,  // bolt protocol port
 	Config_BOLT_PORT                 = 16,  // replicate queries via effects
 	Config_DELAY_INDEXING            = 17,  // delay index construction when decoding
-	Config_END_MARKER                = 18
+	Config_STREAM_RESULTS            = 18,  // stream read-only query results
+	Config_BOLT_IO_THREADS           = 19,  // number of bolt I/O threads
+	Config_REPLAN_FACTOR             = 20,  // cardinality misestimation triggering re-planning
+	Config_INLINE_QUERY_THRESHOLD    = 21,  // max runtime of read queries executed inline
+	Config_GROUP_COMMIT_MAX          = 22,  // max number of writes committed together
+	Config_END_MARKER                = 23
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -56,7 +64,11 @@ static const Config_Option_Field RUNTIME_CONFIGS[] = {
 	Config_CMD_INFO,
 	Config_CMD_INFO_MAX_QUERY_COUNT,
 	Config_EFFECTS_THRESHOLD,
-	Config_DELAY_INDEXING
+	Config_DELAY_INDEXING,
+	Config_STREAM_RESULTS,
+	Config_REPLAN_FACTOR,
+	Config_INLINE_QUERY_THRESHOLD,
+	Config_GROUP_COMMIT_MAX
 };
 static const size_t RUNTIME_CONFIG_COUNT = sizeof(RUNTIME_CONFIGS) / sizeof(RUNTIME_CONFIGS[0]);
 
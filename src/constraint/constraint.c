@@ -71,6 +71,46 @@ extern bool Constraint_EnforceMandatory
 	char **err_msg         // report error message
 );
 
+// adds entity to unique constraint's hash index
+extern void UniqueConstraint_IndexEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to index
+);
+
+// removes entity from unique constraint's hash index
+extern void UniqueConstraint_RemoveEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to remove
+);
+
+// marks unique constraint's hash index as populated
+extern void UniqueConstraint_SetPopulated
+(
+	Constraint c  // constraint
+);
+
+// returns unique constraint's hash index if populated
+extern HashIndex UniqueConstraint_GetHashIndex
+(
+	const Constraint c  // constraint
+);
+
+// computes unique constraint hash index key
+extern bool UniqueConstraint_HashKey
+(
+	const SIValue *values,  // values ordered by the constraint's attributes
+	uint8_t n,              // number of values
+	uint64_t *key           // [output] key
+);
+
+// frees unique constraint internals
+extern void UniqueConstraint_Free
+(
+	Constraint c  // constraint
+);
+
 // disabled constraint enforce function
 // simply returns true
 static bool Constraint_EnforceNOP
@@ -396,15 +436,45 @@ void Constraint_Enforce
 	Indexer_EnforceConstraint(c, (GraphContext*)gc);
 }
 
-// enforce constraint on all relevant nodes
-void Constraint_EnforceNodes
+// populates an active constraint's internal structures
+// used for constraints which were introduced as active
+// e.g. loaded from RDB, and as such never went through enforcement
+void Constraint_Populate
 (
-	Constraint c,
-	Graph *g
+	Constraint c,             // constraint to populate
+	struct GraphContext *gc,  // graph context
+	bool async                // populate asynchronously
 ) {
-	// check if constraint holds
-	// scan through all entities governed by this constraint and enforce
+	ASSERT(c != NULL);
+	ASSERT(Constraint_GetStatus(c) == CT_ACTIVE);
+
+	// only unique constraints maintain internal structures
+	if(c->t != CT_UNIQUE) {
+		return;
+	}
+
+	// mark constraint as pending
+	Constraint_IncPendingChanges(c);
+
+	if(async) {
+		// add constraint population task
+		Indexer_PopulateConstraint(c, (GraphContext*)gc);
+	} else {
+		Constraint_PopulateEntities(c, ((GraphContext*)gc)->g);
+		Constraint_DecPendingChanges(c);
+	}
+}
 
+// scan through all nodes governed by constraint
+// invoking 'cb' on each node, scan stops once 'cb' returns false
+// returns true if 'cb' returned true for every scanned node
+// the graph read lock is held once this function returns
+static bool _Constraint_ScanNodes
+(
+	Constraint c,                // constraint
+	Graph *g,                    // graph
+	Constraint_EnforcementCB cb  // per node callback
+) {
 	ASSERT(c != NULL);
 	ASSERT(g != NULL);
 
@@ -451,7 +521,7 @@ void Constraint_EnforceNodes
 		{
 			Node n;
 			Graph_GetNode(g, id, &n);
-			if(!c->enforce(c, (GraphEntity*)&n, NULL)) {
+			if(!cb(c, (GraphEntity*)&n, NULL)) {
 				// found node which violate constraint
 				holds = false;
 				break;
@@ -481,19 +551,18 @@ void Constraint_EnforceNodes
 
 	Delta_MatrixTupleIter_detach(&it);
 
-	// update constraint status
-	ConstraintStatus status = (holds) ? CT_ACTIVE : CT_FAILED;
-	Constraint_SetStatus(c, status);
-
-	// release read lock
-	Graph_ReleaseLock(g);
+	return holds;
 }
 
-// enforce constraint on all relevant edges
-void Constraint_EnforceEdges
+// scan through all edges governed by constraint
+// invoking 'cb' on each edge, scan stops once 'cb' returns false
+// returns true if 'cb' returned true for every scanned edge
+// the graph read lock is held once this function returns
+static bool _Constraint_ScanEdges
 (
-	Constraint c,
-	Graph *g
+	Constraint c,                // constraint
+	Graph *g,                    // graph
+	Constraint_EnforcementCB cb  // per edge callback
 ) {
 	bool info;
 	TensorIterator it = {0};
@@ -556,7 +625,7 @@ void Constraint_EnforceEdges
 
 			bool res = Graph_GetEdge(g, edge_id, &e);
 			assert(res == true);
-			if(!c->enforce(c, (GraphEntity*)&e, NULL)) {
+			if(!cb(c, (GraphEntity*)&e, NULL)) {
 				holds = false;
 				break;
 			}
@@ -585,10 +654,99 @@ void Constraint_EnforceEdges
 		}
 	}
 
+	return holds;
+}
+
+// track entity and enforce constraint on it
+static bool _Constraint_IndexAndEnforce
+(
+	const Constraint c,    // constraint to enforce
+	const GraphEntity *e,  // enforced entity
+	char **err_msg         // report error message
+) {
+	Constraint_IndexEntity(c, e);
+	return c->enforce(c, e, err_msg);
+}
+
+// track entity
+static bool _Constraint_Index
+(
+	const Constraint c,    // constraint
+	const GraphEntity *e,  // tracked entity
+	char **err_msg         // unused
+) {
+	Constraint_IndexEntity(c, e);
+	return true;
+}
+
+// enforce constraint on all relevant nodes
+void Constraint_EnforceNodes
+(
+	Constraint c,
+	Graph *g
+) {
+	// check if constraint holds
+	// scan through all entities governed by this constraint and enforce
+	bool holds = _Constraint_ScanNodes(c, g, _Constraint_IndexAndEnforce);
+
+	// update constraint status
+	ConstraintStatus status = (holds) ? CT_ACTIVE : CT_FAILED;
+	Constraint_SetStatus(c, status);
+
+	// every entity had been tracked
+	if(holds && c->t == CT_UNIQUE) {
+		UniqueConstraint_SetPopulated(c);
+	}
+
+	// release read lock
+	Graph_ReleaseLock(g);
+}
+
+// enforce constraint on all relevant edges
+void Constraint_EnforceEdges
+(
+	Constraint c,
+	Graph *g
+) {
+	// check if constraint holds
+	// scan through all entities governed by this constraint and enforce
+	bool holds = _Constraint_ScanEdges(c, g, _Constraint_IndexAndEnforce);
+
 	// update constraint status
 	ConstraintStatus status = (holds) ? CT_ACTIVE : CT_FAILED;
 	Constraint_SetStatus(c, status);
 
+	// every entity had been tracked
+	if(holds && c->t == CT_UNIQUE) {
+		UniqueConstraint_SetPopulated(c);
+	}
+
+	// release read lock
+	Graph_ReleaseLock(g);
+}
+
+// populates constraint's internal structures
+// with all relevant entities, see Constraint_Populate
+void Constraint_PopulateEntities
+(
+	Constraint c,  // constraint to populate
+	Graph *g       // graph
+) {
+	ASSERT(c != NULL);
+	ASSERT(g != NULL);
+	ASSERT(Constraint_GetStatus(c) == CT_ACTIVE);
+
+	if(c->et == GETYPE_NODE) {
+		_Constraint_ScanNodes(c, g, _Constraint_Index);
+	} else {
+		_Constraint_ScanEdges(c, g, _Constraint_Index);
+	}
+
+	// population is complete unless it was aborted by a pending drop
+	if(Constraint_PendingChanges(c) == 1 && c->t == CT_UNIQUE) {
+		UniqueConstraint_SetPopulated(c);
+	}
+
 	// release read lock
 	Graph_ReleaseLock(g);
 }
@@ -608,6 +766,60 @@ bool Constraint_EnforceEntity
 	return c->enforce(c, e, err_msg);
 }
 
+// track entity within constraint's internal structures
+void Constraint_IndexEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to track
+) {
+	ASSERT(c != NULL);
+	ASSERT(e != NULL);
+
+	if(c->t == CT_UNIQUE) {
+		UniqueConstraint_IndexEntity(c, e);
+	}
+}
+
+// stop tracking entity within constraint's internal structures
+void Constraint_RemoveEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to remove
+) {
+	ASSERT(c != NULL);
+	ASSERT(e != NULL);
+
+	if(c->t == CT_UNIQUE) {
+		UniqueConstraint_RemoveEntity(c, e);
+	}
+}
+
+// returns constraint's native hash index
+// NULL is returned if constraint doesn't maintain a populated hash index
+HashIndex Constraint_GetHashIndex
+(
+	const Constraint c  // constraint to query
+) {
+	ASSERT(c != NULL);
+
+	if(c->t != CT_UNIQUE) {
+		return NULL;
+	}
+
+	return UniqueConstraint_GetHashIndex(c);
+}
+
+// compute hash index key for a set of values
+// returns false if values can't be looked up using the hash index
+bool Constraint_HashKey
+(
+	const SIValue *values,  // values ordered by the constraint's attributes
+	uint8_t n,              // number of values
+	uint64_t *key           // [output] key
+) {
+	return UniqueConstraint_HashKey(values, n, key);
+}
+
 void Constraint_Free
 (
 	Constraint *c
@@ -616,6 +828,10 @@ void Constraint_Free
 
 	Constraint _c = *c;
 
+	if(_c->t == CT_UNIQUE) {
+		UniqueConstraint_Free(_c);
+	}
+
     rm_free(_c->attrs);
 	rm_free(_c->attr_names);
     rm_free(_c);
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "../index/index.h"
+#include "../index/hash_index.h"
 #include "../graph/graph.h"
 #include "../graph/query_graph.h"
 #include "../graph/entities/graph_entity.h"
@@ -174,6 +175,23 @@ void Constraint_Enforce
 	struct GraphContext *gc  // graph context
 );
 
+// populates an active constraint's internal structures
+// used for constraints which were introduced as active
+// e.g. loaded from RDB, and as such never went through enforcement
+void Constraint_Populate
+(
+	Constraint c,             // constraint to populate
+	struct GraphContext *gc,  // graph context
+	bool async                // populate asynchronously
+);
+
+// populates constraint's internal structures with all relevant entities
+void Constraint_PopulateEntities
+(
+	Constraint c,  // constraint to populate
+	Graph *g       // graph
+);
+
 // enforce constraint on all relevant nodes
 void Constraint_EnforceNodes
 (
@@ -198,6 +216,36 @@ bool Constraint_EnforceEntity
 	char **err_msg         // report error message
 );
 
+// track entity within constraint's internal structures
+void Constraint_IndexEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to track
+);
+
+// stop tracking entity within constraint's internal structures
+void Constraint_RemoveEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to remove
+);
+
+// returns constraint's native hash index
+// NULL is returned if constraint doesn't maintain a populated hash index
+HashIndex Constraint_GetHashIndex
+(
+	const Constraint c  // constraint to query
+);
+
+// compute hash index key for a set of values
+// returns false if values can't be looked up using the hash index
+bool Constraint_HashKey
+(
+	const SIValue *values,  // values ordered by the constraint's attributes
+	uint8_t n,              // number of values
+	uint64_t *key           // [output] key
+);
+
 // free constraint
 void Constraint_Free
 (
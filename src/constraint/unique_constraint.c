@@ -9,6 +9,7 @@
 #include "../query_ctx.h"
 #include "../index/index.h"
 #include "redisearch_api.h"
+#include "../index/hash_index.h"
 #include "../src/datatypes/point.h"
 #include "../graph/entities/attribute_set.h"
 
@@ -28,6 +29,8 @@ struct _UniqueConstraint {
 	uint _Atomic pending_changes;           // number of pending changes
 	GraphEntityType et;                     // entity type
 	Index idx;                              // supporting index
+	HashIndex hidx;                         // native hash index
+	bool _Atomic populated;                 // hash index holds all entities
 };
 
 typedef struct _UniqueConstraint* UniqueConstraint;
@@ -62,51 +65,126 @@ static void* _GetPrivateData
 	return _c->idx;
 }
 
-// enforces unique constraint on given entity
-// returns true if entity confirms with constraint false otherwise
-bool EnforceUniqueEntity
+// returns true if value can be used as part of a unique constraint key
+static inline bool _ConstrainedType
 (
-	const Constraint c,    // constraint to enforce
-	const GraphEntity *e,  // enforced entity
-	char **err_msg         // report error message
+	SIValue v
 ) {
-	// validations
-	ASSERT(c != NULL);
-	ASSERT(e != NULL);
-
-	UniqueConstraint _c = (UniqueConstraint)c;
+	// TODO: see RediSearch MULTI-VALUE index.
+	// TODO: RediSearch exact match for point.
+	return (SI_TYPE(v) & (T_STRING | T_BOOL | SI_NUMERIC));
+}
 
-	//--------------------------------------------------------------------------
-	// validate entity has all required attributes
-	//--------------------------------------------------------------------------
+// computes entity's hash index key
+// returns false if entity isn't subject to the constraint
+// i.e. it is missing one of the constrained attributes
+// or one of its constrained attributes is of an unsupported type
+static bool _EntityKey
+(
+	const UniqueConstraint c,  // constraint
+	const GraphEntity *e,      // entity
+	uint64_t *key              // [output] entity's key
+) {
+	XXH64_state_t state;
+	XXH_errorcode res = XXH64_reset(&state, 0);
+	UNUSED(res);
+	ASSERT(res != XXH_ERROR);
 
 	const AttributeSet attributes = GraphEntity_GetAttributes(e);
 
-	for(uint8_t i = 0; i < _c->n_attr; i++) {
-		AttributeID attr_id = _c->attrs[i];
+	for(uint8_t i = 0; i < c->n_attr; i++) {
+		SIValue *v = AttributeSet_Get(attributes, c->attrs[i]);
+		if(v == ATTRIBUTE_NOTFOUND || !_ConstrainedType(*v)) {
+			return false;
+		}
+
+		SIValue_HashUpdate(*v, &state);
+	}
+
+	*key = XXH64_digest(&state);
+	return true;
+}
 
-		// make sure entity possesses attribute
-		SIValue *v = AttributeSet_Get(attributes, attr_id);
-		if(v == ATTRIBUTE_NOTFOUND) {
-			// entity satisfies constraint in a vacuous truth manner
-			return true;
+// returns true if both entities share the same constrained values
+static bool _SameValues
+(
+	const UniqueConstraint c,  // constraint
+	const GraphEntity *a,      // first entity
+	const GraphEntity *b       // second entity
+) {
+	const AttributeSet a_attrs = GraphEntity_GetAttributes(a);
+	const AttributeSet b_attrs = GraphEntity_GetAttributes(b);
+
+	for(uint8_t i = 0; i < c->n_attr; i++) {
+		SIValue *a_v = AttributeSet_Get(a_attrs, c->attrs[i]);
+		SIValue *b_v = AttributeSet_Get(b_attrs, c->attrs[i]);
+
+		if(a_v == ATTRIBUTE_NOTFOUND || b_v == ATTRIBUTE_NOTFOUND) {
+			return false;
 		}
 
-		// validate attribute type
-		SIType t = SI_TYPE(*v);
-		if(t & ~(T_STRING | T_BOOL | SI_NUMERIC)) {
-			// TODO: see RediSearch MULTI-VALUE index.
-			// TODO: RediSearch exact match for point.
-			return true;
+		if(SIValue_Compare(*a_v, *b_v, NULL) != 0) {
+			return false;
 		}
 	}
 
+	return true;
+}
+
+// enforce constraint using the native hash index
+// an O(1) lookup of all entities sharing the entity's key
+static bool _EnforceUsingHashIndex
+(
+	const UniqueConstraint c,  // constraint to enforce
+	const GraphEntity *e,      // enforced entity
+	uint64_t key               // entity's key
+) {
+	Graph    *g  = QueryCtx_GetGraph();
+	EntityID id  = ENTITY_GET_ID(e);
+	EntityID candidate;
+
+	HashIndexIterator it;
+	HashIndex_Find(c->hidx, key, &it);
+
+	while(HashIndexIterator_Next(&it, &candidate)) {
+		if(candidate == id) {
+			continue;
+		}
+
+		// keys may collide, compare actual values
+		bool found;
+		GraphEntity *other;
+		Node n;
+		Edge edge;
+
+		if(c->et == GETYPE_NODE) {
+			found = Graph_GetNode(g, candidate, &n);
+			other = (GraphEntity *)&n;
+		} else {
+			found = Graph_GetEdge(g, candidate, &edge);
+			other = (GraphEntity *)&edge;
+		}
+
+		if(found && _SameValues(c, e, other)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// enforce constraint using the supporting RediSearch index
+static bool _EnforceUsingIndex
+(
+	const UniqueConstraint c,  // constraint to enforce
+	const GraphEntity *e       // enforced entity
+) {
 	// construct a unique constraint query tree
 	// TODO: prefer to have the RediSearch query "template" constructed
 	// once and reused for each entity
-	Index idx = _c->idx;
-	RSQNode *root = Index_BuildUniqueConstraintQuery(idx, e, _c->attrs,
-			_c->n_attr);
+	Index idx = c->idx;
+	RSQNode *root = Index_BuildUniqueConstraintQuery(idx, e, c->attrs,
+			c->n_attr);
 
 	//--------------------------------------------------------------------------
 	// query RediSearch index
@@ -117,7 +195,7 @@ bool EnforceUniqueEntity
 	// constraint holds if there are no duplicates, a single index match
 	RSIndex *rs_idx = Index_RSIndex(idx);
 	RSResultsIterator *iter = RediSearch_GetResultsIterator(root, rs_idx);
-	if(Constraint_GetEntityType(c) == GETYPE_NODE) {
+	if(c->et == GETYPE_NODE) {
 		// first call, expecting to find 'e' in the index
 		const EntityID *id =
 			(EntityID*)RediSearch_ResultsIteratorNext(iter, rs_idx, NULL);
@@ -146,6 +224,37 @@ bool EnforceUniqueEntity
 
 cleanup:
 	RediSearch_ResultsIteratorFree(iter);
+	return holds;
+}
+
+// enforces unique constraint on given entity
+// returns true if entity confirms with constraint false otherwise
+bool EnforceUniqueEntity
+(
+	const Constraint c,    // constraint to enforce
+	const GraphEntity *e,  // enforced entity
+	char **err_msg         // report error message
+) {
+	// validations
+	ASSERT(c != NULL);
+	ASSERT(e != NULL);
+
+	UniqueConstraint _c = (UniqueConstraint)c;
+
+	//--------------------------------------------------------------------------
+	// validate entity has all required attributes
+	//--------------------------------------------------------------------------
+
+	uint64_t key;
+	if(!_EntityKey(_c, e, &key)) {
+		// entity satisfies constraint in a vacuous truth manner
+		return true;
+	}
+
+	// prefer the native hash index once it is populated
+	bool holds = (_c->populated) ?
+		_EnforceUsingHashIndex(_c, e, key) :
+		_EnforceUsingIndex(_c, e);
 
 	if(holds == false && err_msg != NULL) {
 		int res;
@@ -164,6 +273,100 @@ cleanup:
 	return holds;
 }
 
+// add entity to constraint's hash index
+// an entity which isn't subject to the constraint is removed from the index
+void UniqueConstraint_IndexEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to index
+) {
+	ASSERT(c != NULL);
+	ASSERT(e != NULL);
+
+	UniqueConstraint _c = (UniqueConstraint)c;
+
+	uint64_t key;
+	if(_EntityKey(_c, e, &key)) {
+		HashIndex_Insert(_c->hidx, key, ENTITY_GET_ID(e));
+	} else {
+		HashIndex_Remove(_c->hidx, ENTITY_GET_ID(e));
+	}
+}
+
+// remove entity from constraint's hash index
+void UniqueConstraint_RemoveEntity
+(
+	Constraint c,         // constraint
+	const GraphEntity *e  // entity to remove
+) {
+	ASSERT(c != NULL);
+	ASSERT(e != NULL);
+
+	UniqueConstraint _c = (UniqueConstraint)c;
+	HashIndex_Remove(_c->hidx, ENTITY_GET_ID(e));
+}
+
+// mark constraint's hash index as populated
+void UniqueConstraint_SetPopulated
+(
+	Constraint c  // constraint
+) {
+	ASSERT(c != NULL);
+
+	UniqueConstraint _c = (UniqueConstraint)c;
+	_c->populated = true;
+}
+
+// returns constraint's hash index
+// NULL is returned if the hash index isn't populated
+HashIndex UniqueConstraint_GetHashIndex
+(
+	const Constraint c  // constraint
+) {
+	ASSERT(c != NULL);
+
+	UniqueConstraint _c = (UniqueConstraint)c;
+	return (_c->populated) ? _c->hidx : NULL;
+}
+
+// compute hash index key for a set of constrained values
+// returns false if one of the values is of an unsupported type
+bool UniqueConstraint_HashKey
+(
+	const SIValue *values,  // values ordered by the constraint's attributes
+	uint8_t n,              // number of values
+	uint64_t *key           // [output] key
+) {
+	ASSERT(key    != NULL);
+	ASSERT(values != NULL);
+
+	XXH64_state_t state;
+	XXH_errorcode res = XXH64_reset(&state, 0);
+	UNUSED(res);
+	ASSERT(res != XXH_ERROR);
+
+	for(uint8_t i = 0; i < n; i++) {
+		if(!_ConstrainedType(values[i])) {
+			return false;
+		}
+		SIValue_HashUpdate(values[i], &state);
+	}
+
+	*key = XXH64_digest(&state);
+	return true;
+}
+
+// free unique constraint internals
+void UniqueConstraint_Free
+(
+	Constraint c  // constraint
+) {
+	ASSERT(c != NULL);
+
+	UniqueConstraint _c = (UniqueConstraint)c;
+	HashIndex_Free(&_c->hidx);
+}
+
 Constraint Constraint_UniqueNew
 (
 	int schema_id,            // schema ID
@@ -186,6 +389,8 @@ Constraint Constraint_UniqueNew
 	c->t               = CT_UNIQUE;
 	c->et              = et;
 	c->idx             = idx;
+	c->hidx            = HashIndex_New();
+	c->populated       = false;
 	c->n_attr          = n_fields;
 	c->status          = CT_PENDING;
 	c->enforce         = EnforceUniqueEntity;
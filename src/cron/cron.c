@@ -8,11 +8,14 @@
 #include "cron.h"
 #include "util/heap.h"
 #include "util/rmalloc.h"
+#include "util/timer_wheel.h"
 
 #include <time.h>
 #include <errno.h>
+#include <sched.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 
 #define MAX(a,b) ((a) >= (b)) ? (a) : (b)
 
@@ -28,10 +31,33 @@ typedef struct {
 	void *pdata;            // [optional] private data passed to callback
 } CRON_TASK;
 
+// CRON timeout states
+typedef enum {
+	TIMEOUT_PENDING,  // timeout is waiting to fire
+	TIMEOUT_FIRING,   // timeout's callback is running
+	TIMEOUT_FIRED,    // timeout's callback completed
+	TIMEOUT_ABORTED   // timeout aborted before firing
+} TIMEOUT_STATE;
+
+// CRON timeout
+// short lived one-shot task, e.g. a query timeout
+// referenced by both its creator and CRON
+// freed once both released it
+typedef struct {
+	WheelTimer timer;     // timer wheel entry, due in ms
+	CronTaskCB cb;        // callback to call when timeout is due
+	void *pdata;          // [optional] private data passed to callback
+	atomic_int state;     // timeout state
+	atomic_int refcount;  // number of references
+} CRON_TIMEOUT;
+
 // CRON object
 typedef struct {
 	bool alive;                        // indicates cron is active
 	heap_t *tasks;                     // min heap of cron tasks
+	TimerWheel *timeouts;              // timer wheel of pending timeouts
+	_Atomic(WheelTimer *) incoming;    // lock-free stack of new timeouts
+	atomic_uint_fast64_t wake_at;      // ms at which cron thread wakes up
 	CRON_TASK* volatile current_task;  // current task being executed
 	pthread_mutex_t mutex;             // mutex control access to tasks
 	pthread_mutex_t condv_mutex;       // mutex control access to condv
@@ -71,6 +97,13 @@ static int CRON_JobCmp
 // Utility functions
 //------------------------------------------------------------------------------
 
+// milliseconds on the monotonic clock
+uint64_t Cron_Now(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
 // compute now + ms
 static struct timespec due_in_ms
 (
@@ -173,11 +206,109 @@ static void CRON_FreeTask
 	rm_free(t);
 }
 
+// release a reference to timeout, freeing it once unreferenced
+static void CRON_ReleaseTimeout
+(
+	CRON_TIMEOUT *t  // timeout to release
+) {
+	ASSERT(t != NULL);
+
+	if(atomic_fetch_sub(&t->refcount, 1) == 1) {
+		rm_free(t);
+	}
+}
+
+// release a list of timeouts
+static void CRON_ReleaseTimeouts
+(
+	WheelTimer *t  // timeouts linked list
+) {
+	while(t != NULL) {
+		WheelTimer *next = t->next;
+		CRON_ReleaseTimeout((CRON_TIMEOUT *)t);
+		t = next;
+	}
+}
+
+// move newly added timeouts into the timer wheel
+static void CRON_CollectTimeouts(void) {
+	WheelTimer *t = atomic_exchange(&cron->incoming, NULL);
+	while(t != NULL) {
+		WheelTimer *next = t->next;
+		CRON_TIMEOUT *timeout = (CRON_TIMEOUT *)t;
+
+		// timeout aborted before reaching the wheel
+		if(atomic_load(&timeout->state) == TIMEOUT_ABORTED) {
+			CRON_ReleaseTimeout(timeout);
+		} else {
+			TimerWheel_Add(cron->timeouts, t);
+		}
+
+		t = next;
+	}
+}
+
+// fire due timeouts
+static void CRON_FireTimeouts(void) {
+	WheelTimer *t = TimerWheel_Advance(cron->timeouts, Cron_Now());
+	while(t != NULL) {
+		WheelTimer *next = t->next;
+		CRON_TIMEOUT *timeout = (CRON_TIMEOUT *)t;
+
+		// fire timeout unless it was aborted
+		int expected = TIMEOUT_PENDING;
+		if(atomic_compare_exchange_strong(&timeout->state, &expected,
+					TIMEOUT_FIRING)) {
+			timeout->cb(timeout->pdata);
+			atomic_store(&timeout->state, TIMEOUT_FIRED);
+		}
+
+		CRON_ReleaseTimeout(timeout);
+		t = next;
+	}
+}
+
+// compute when cron should wake up
+// either when the next task or the next timeout is due
+static struct timespec CRON_NextWakeUp
+(
+	const CRON_TASK *task  // [optional] next task
+) {
+	// sleep for at most a second
+	int64_t delta = 1000;
+
+	// time until next task, rounded up to a whole ms
+	if(task != NULL) {
+		struct timespec now;
+		clock_gettime(CLOCK_REALTIME, &now);
+		int64_t ns = (int64_t)(task->due.tv_sec - now.tv_sec) * 1000000000 +
+			(task->due.tv_nsec - now.tv_nsec);
+		int64_t ms = (ns + 999999) / 1000000;
+		if(ms < delta) delta = (ms > 0) ? ms : 0;
+	}
+
+	// time until next timeout tick
+	uint64_t now  = Cron_Now();
+	uint64_t tick = TimerWheel_NextTick(cron->timeouts);
+	if(tick != UINT64_MAX) {
+		int64_t ms = (tick > now) ? tick - now : 0;
+		if(ms < delta) delta = ms;
+	}
+
+	// timeouts due before wake up time must wake cron up
+	atomic_store(&cron->wake_at, now + delta);
+
+	return due_in_ms(delta);
+}
+
 static void clear_tasks() {
 	CRON_TASK *task = NULL;
 	while((task = Heap_poll(cron->tasks))) {
 		CRON_FreeTask(task);
 	}
+
+	CRON_CollectTimeouts();
+	CRON_ReleaseTimeouts(TimerWheel_Clear(cron->timeouts));
 }
 
 //------------------------------------------------------------------------------
@@ -189,6 +320,14 @@ static void *Cron_Run
 	void *arg
 ) {
 	while(cron->alive) {
+		// cron is awake, timeouts added from here on are collected
+		// before going back to sleep
+		atomic_store(&cron->wake_at, 0);
+
+		// fire due timeouts
+		CRON_CollectTimeouts();
+		CRON_FireTimeouts();
+
 		// execute due tasks
 		CRON_TASK *task = NULL;
 		while((task = CRON_Peek()) && CRON_TaskDue(task)) {
@@ -204,10 +343,14 @@ static void *Cron_Run
 		}
 
 		// sleep
-		struct timespec timeout = (task) ? task->due : due_in_ms(1000);
+		struct timespec timeout = CRON_NextWakeUp(task);
 		pthread_mutex_lock(&cron->condv_mutex);
-		int res = pthread_cond_timedwait(&cron->condv, &cron->condv_mutex, &timeout);
-		ASSERT(res == 0 || res == ETIMEDOUT);
+		// skip sleep if timeouts were added meanwhile
+		if(atomic_load(&cron->incoming) == NULL) {
+			int res = pthread_cond_timedwait(&cron->condv, &cron->condv_mutex,
+					&timeout);
+			ASSERT(res == 0 || res == ETIMEDOUT);
+		}
 		pthread_mutex_unlock(&cron->condv_mutex);
 	}
 
@@ -223,8 +366,11 @@ bool Cron_Start(void) {
 
 	cron = rm_malloc(sizeof(CRON));
 
-	cron->alive = true;
-	cron->tasks = Heap_new(CRON_JobCmp, NULL);
+	cron->alive    = true;
+	cron->tasks    = Heap_new(CRON_JobCmp, NULL);
+	cron->timeouts = TimerWheel_New(Cron_Now());
+	atomic_init(&cron->incoming, NULL);
+	atomic_init(&cron->wake_at, 0);
 
 	bool res = true;
 	res &= pthread_cond_init(&cron->condv, NULL)               == 0;
@@ -251,6 +397,7 @@ void Cron_Stop(void) {
 
 	// free resources
 	Heap_free(cron->tasks);
+	TimerWheel_Free(cron->timeouts);
 	pthread_mutex_destroy(&cron->mutex);
 	pthread_mutex_destroy(&cron->condv_mutex);
 	pthread_cond_destroy(&cron->condv);
@@ -308,3 +455,58 @@ bool Cron_AbortTask
 	return true;
 }
 
+
+// create a new CRON timeout
+CronTaskHandle Cron_AddTimeout
+(
+	uint when,        // number of miliseconds until timeout
+	CronTaskCB work,  // callback to call when timeout is due
+	void *pdata       // [optional] private data to pass to callback
+) {
+	ASSERT(work != NULL);
+	ASSERT(cron != NULL);
+
+	CRON_TIMEOUT *t = rm_malloc(sizeof(CRON_TIMEOUT));
+
+	t->cb        = work;
+	t->pdata     = pdata;
+	t->timer.due = Cron_Now() + when;
+	atomic_init(&t->state, TIMEOUT_PENDING);
+	atomic_init(&t->refcount, 2);  // caller and cron
+
+	// push timeout onto the incoming stack
+	WheelTimer *head = atomic_load(&cron->incoming);
+	do {
+		t->timer.next = head;
+	} while(!atomic_compare_exchange_weak(&cron->incoming, &head, &t->timer));
+
+	// wake cron only if it is about to sleep past the timeout
+	if(t->timer.due < atomic_load(&cron->wake_at)) {
+		CRON_WakeUp();
+	}
+
+	return (uintptr_t)t;
+}
+
+// aborts a CRON timeout
+// in case timeout is currently firing, wait for it to complete
+bool Cron_AbortTimeout
+(
+	CronTaskHandle t  // timeout to abort
+) {
+	ASSERT(cron != NULL);
+
+	CRON_TIMEOUT *timeout = (CRON_TIMEOUT *)t;
+
+	int expected = TIMEOUT_PENDING;
+	bool aborted = atomic_compare_exchange_strong(&timeout->state, &expected,
+			TIMEOUT_ABORTED);
+
+	// in case timeout is currently firing, wait for it to finish
+	while(atomic_load(&timeout->state) == TIMEOUT_FIRING) sched_yield();
+
+	// release caller's reference
+	CRON_ReleaseTimeout(timeout);
+
+	return aborted;
+}
@@ -21,6 +21,9 @@ typedef void (*CronTaskCB)(void *pdata);    // task work function
 typedef void (*CronTaskFree)(void *pdata);  // task private data free function
 typedef uintptr_t CronTaskHandle;
 
+// milliseconds on the monotonic clock CRON measures timeouts by
+uint64_t Cron_Now(void);
+
 // start CRON, should be called once
 bool Cron_Start(void);
 
@@ -50,3 +53,24 @@ bool Cron_AbortTask
 	CronTaskHandle t
 );
 
+// create a new CRON timeout
+// timeouts are one-shot tasks e.g. query timeouts, which are usually
+// aborted before they are due, they are kept in a timer wheel
+// rather than the tasks heap, adding and aborting them doesn't lock
+CronTaskHandle Cron_AddTimeout
+(
+	uint when,        // number of miliseconds until timeout
+	CronTaskCB work,  // callback to call when timeout is due
+	void *pdata       // [optional] private data to pass to callback
+);
+
+// aborts a CRON timeout
+// must be called exactly once per timeout, releasing it
+// this function waits until the timeout's callback completes if it has
+// already started at the moment of invocation
+// returns true if the timeout was aborted before firing
+bool Cron_AbortTimeout
+(
+	CronTaskHandle t  // timeout to abort
+);
+
@@ -8,13 +8,15 @@
 #include "cron.h"
 #include "util/rmalloc.h"
 #include "configuration/config.h"
+#include "tasks/sample_statistics.h"
 #include "tasks/stream_finished_queries.h"
 
 typedef struct RecurringTaskCtx {
 	uint32_t when;
 	uint32_t min_interval;
 	uint32_t max_interval;
-	Config_Option_Field field;
+	bool gated;                 // task runs only while 'field' is enabled
+	Config_Option_Field field;  // boolean configuration gating the task
 	bool (*task)(void*);
 	void *(*new)(void*);
 	void (*free)(void*);
@@ -28,13 +30,20 @@ void CronTask_RecurringTaskFree(void *pdata) {
 	rm_free(current_ctx);
 }
 
+// returns true if recurring task should keep running
+static bool _RecurringTask_Enabled(const RecurringTaskCtx *ctx) {
+	if(!ctx->gated) return true;
+
+	bool enabled = false;
+	return Config_Option_get(ctx->field, &enabled) && enabled;
+}
+
 void CronTask_RecurringTask(void *pdata) {
 	ASSERT(pdata != NULL);
 	RecurringTaskCtx *current_ctx = (RecurringTaskCtx*)pdata;
 	bool speed_up = current_ctx->task(current_ctx->ctx);	
 
-	bool info_enabled = false;
-	if(Config_Option_get(Config_CMD_INFO, &info_enabled) && info_enabled) {
+	if(_RecurringTask_Enabled(current_ctx)) {
 		RecurringTaskCtx *re_ctx = rm_malloc(sizeof(RecurringTaskCtx));
 		*re_ctx = *current_ctx;
 		re_ctx->ctx = re_ctx->new(re_ctx->ctx);
@@ -68,6 +77,8 @@ void CronTask_AddStreamFinishedQueries() {
 		re_ctx->when         = 10;   // 10ms from now
 		re_ctx->min_interval = 250;  // 250ms
 		re_ctx->max_interval = 3000; // 3s
+		re_ctx->gated        = true;
+		re_ctx->field        = Config_CMD_INFO;
 
 		// create task context
 		StreamFinishedQueryCtx *ctx = rm_malloc(sizeof(StreamFinishedQueryCtx));
@@ -80,8 +91,33 @@ void CronTask_AddStreamFinishedQueries() {
 	}
 }
 
+void CronTask_AddSampleStatistics() {
+	//--------------------------------------------------------------------------
+	// add label statistics sampling task
+	//--------------------------------------------------------------------------
+
+	RecurringTaskCtx *re_ctx = rm_malloc(sizeof(RecurringTaskCtx));
+	re_ctx->new          = CronTask_newSampleStatistics;
+	re_ctx->task         = CronTask_sampleStatistics;
+	re_ctx->free         = rm_free;
+	re_ctx->when         = 10;   // 10ms from now
+	re_ctx->min_interval = 250;  // 250ms
+	re_ctx->max_interval = 3000; // 3s
+	re_ctx->gated        = false;
+
+	// create task context
+	SampleStatisticsCtx *ctx = rm_malloc(sizeof(SampleStatisticsCtx));
+	ctx->graph_idx = 0;
+
+	re_ctx->ctx = ctx;
+
+	// add recurring task
+	Cron_AddTask(0, CronTask_RecurringTask, CronTask_RecurringTaskFree, (void*)re_ctx);
+}
+
 // add recurring tasks
 void Cron_AddRecurringTasks(void) {
 	CronTask_AddStreamFinishedQueries();
+	CronTask_AddSampleStatistics();
 }
 
@@ -0,0 +1,89 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "globals.h"
+#include "../../util/rmalloc.h"
+#include "graph/graphcontext.h"
+#include "sample_statistics.h"
+#include "util/simple_timer.h"
+
+// sample stale labels of graph 'g'
+// returns the number of sampled labels
+static uint _sample_graph
+(
+	Graph *g  // graph to sample
+) {
+	uint sampled = 0;
+
+	// labels are sampled under the read lock, blocking writers for the
+	// duration of at most STATISTICS_SAMPLE_SIZE node reads per label
+	Graph_AcquireReadLock(g);
+
+	int label_count = Graph_LabelTypeCount(g);
+	for(LabelID l = 0; l < label_count; l++) {
+		if(!GraphStatistics_LabelStale(&g->stats, l)) continue;
+
+		LabelStatistics *stats = LabelStatistics_Collect(g, l,
+				STATISTICS_SAMPLE_SIZE);
+		GraphStatistics_SetLabelStatistics(&g->stats, l, stats);
+		sampled++;
+	}
+
+	Graph_ReleaseLock(g);
+
+	return sampled;
+}
+
+void *CronTask_newSampleStatistics
+(
+	void *pdata  // task context
+) {
+	ASSERT(pdata != NULL);
+	SampleStatisticsCtx *ctx = (SampleStatisticsCtx*)pdata;
+
+	// create private data for next invocation
+	SampleStatisticsCtx *new_ctx = rm_malloc(sizeof(SampleStatisticsCtx));
+
+	// set next iteration graph index
+	new_ctx->graph_idx = ctx->graph_idx;
+
+	return new_ctx;
+}
+
+// cron task
+// sample stale label statistics for each graph in the keyspace
+bool CronTask_sampleStatistics
+(
+	void *pdata  // task context
+) {
+	SampleStatisticsCtx *ctx = (SampleStatisticsCtx*)pdata;
+
+	// start stopwatch
+	double deadline = 5;  // 5ms
+	simple_timer_t stopwatch;
+	simple_tic(stopwatch);
+
+	KeySpaceGraphIterator it;
+	Globals_ScanGraphs(&it);
+
+	// pick up from where we've left
+	GraphIterator_Seek(&it, ctx->graph_idx);
+
+	// as long as we've got processing time
+	GraphContext *gc = NULL;
+	uint sampled = 0;
+	while(TIMER_GET_ELAPSED_MILLISECONDS(stopwatch) < deadline &&
+		  (gc = GraphIterator_Next(&it)) != NULL) {
+		ctx->graph_idx++;  // prepare next iteration
+		sampled += _sample_graph(GraphContext_GetGraph(gc));
+		GraphContext_DecreaseRefCount(gc);
+	}
+
+	// set next iteration graph index
+	ctx->graph_idx = (gc == NULL) ? 0 : ctx->graph_idx;
+
+	// speed up while graphs are being modified or weren't all visited
+	return (gc != NULL || sampled > 0);
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// task context
+typedef struct {
+	uint32_t graph_idx;  // last processed graph index
+} SampleStatisticsCtx;
+
+// create task context
+void *CronTask_newSampleStatistics
+(
+	void *pdata  // task context
+);
+
+// cron task
+// sample stale label statistics for each graph in the keyspace
+bool CronTask_sampleStatistics
+(
+	void *pdata  // task context
+);
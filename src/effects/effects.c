@@ -346,6 +346,32 @@ uint64_t EffectsBuffer_Length
 	return buff->n;
 }
 
+// append the effects of 'src' to 'dst'
+void EffectsBuffer_Append
+(
+	EffectsBuffer *dst,       // effects-buffer to append to
+	const EffectsBuffer *src  // effects-buffer to append
+) {
+	ASSERT(dst != NULL);
+	ASSERT(src != NULL);
+
+	// skip src's effects version
+	size_t skip = sizeof(uint8_t);
+
+	struct EffectsBufferBlock *b = src->head;
+	while(b != NULL) {
+		size_t n = BLOCK_USED_SPACE(b) - skip;
+		if(n > 0) {
+			EffectsBuffer_WriteBytes(b->buffer + skip, n, dst);
+		}
+
+		skip = 0;
+		b = b->next;
+	}
+
+	dst->n += src->n;
+}
+
 // get a copy of effects-buffer internal buffer
 unsigned char *EffectsBuffer_Buffer
 (
@@ -55,6 +55,13 @@ uint64_t EffectsBuffer_Length
 	const EffectsBuffer *buff  // effects-buffer
 );
 
+// append the effects of 'src' to 'dst'
+void EffectsBuffer_Append
+(
+	EffectsBuffer *dst,       // effects-buffer to append to
+	const EffectsBuffer *src  // effects-buffer to append
+);
+
 // get a copy of effectspbuffer internal buffer
 unsigned char *EffectsBuffer_Buffer
 (
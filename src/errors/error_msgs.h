@@ -127,3 +127,8 @@
 #define EMSG_VECTOR_DIMENSION_MISMATCH "Vector dimension mismatch, expected %d but got %d"
 #define EMSG_INVALID_UTF8 "Invalid UTF8 string"
 
+#define EMSG_HINT_NOT_A_NODE "Cannot use %s hint on '%s', it isn't a node of its MATCH pattern"
+#define EMSG_HINT_MISSING_LABEL "Cannot use %s hint on '%s', it isn't labeled :%s in its MATCH pattern"
+#define EMSG_HINT_CONFLICT "Cannot honor hints on both '%s' and '%s', a pattern is scanned from a single node"
+#define EMSG_HINT_JOIN "Cannot use join hint on '%s', it must split its pattern into two unbound parts"
+#define EMSG_HINT_INDEX "Cannot use index hint on '%s', no index on :%s(%s) can resolve its filters"
@@ -103,7 +103,13 @@ void ErrorCtx_EmitException(void) {
 	if(ctx->error != NULL) {
 		bolt_client_t *bolt_client = QueryCtx_GetBoltClient();
 		if(bolt_client != NULL) {
-			bolt_client_reply_for(bolt_client, BST_RUN, BST_FAILURE, 1);
+			// once records were streamed the failure replies to the PULL
+			bolt_structure_type request_type =
+				(bolt_client->state == BS_STREAMING ||
+				 bolt_client->state == BS_TX_STREAMING)
+				? BST_PULL
+				: BST_RUN;
+			bolt_client_reply_for(bolt_client, request_type, BST_FAILURE, 1);
 			bolt_reply_map(bolt_client, 2);
 			bolt_reply_string(bolt_client, "code", 4);
 			bolt_reply_string(bolt_client, "SyntaxError", 11);
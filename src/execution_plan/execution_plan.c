@@ -18,6 +18,9 @@
 
 #include <setjmp.h>
 
+// number of records produced between query deadline checks
+#define DEADLINE_CHECK_INTERVAL 256
+
 // Allocate a new ExecutionPlan segment.
 inline ExecutionPlan *ExecutionPlan_NewEmptyExecutionPlan(void) {
 	return rm_calloc(1, sizeof(ExecutionPlan));
@@ -477,6 +480,10 @@ void ExecutionPlan_Init(ExecutionPlan *plan) {
 
 ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 	ASSERT(plan->prepared)
+
+	// plan preparation failed e.g. an unsatisfiable planner hint
+	if(ErrorCtx_EncounteredError()) return QueryCtx_GetResultSet();
+
 	// Set an exception-handling breakpoint to capture run-time errors.
 	// encountered_error will be set to 0 when setjmp is invoked, and will be nonzero if
 	// a downstream exception returns us to this breakpoint
@@ -487,13 +494,69 @@ ResultSet *ExecutionPlan_Execute(ExecutionPlan *plan) {
 
 	ExecutionPlan_Init(plan);
 
+	// query's deadline is checked every DEADLINE_CHECK_INTERVAL records
+	// in case CRON is late draining the plan
+	uint64_t n = 0;
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+
 	Record r = NULL;
 	// Execute the root operation and free the processed Record until the data stream is depleted.
-	while((r = OpBase_Consume(plan->root)) != NULL) ExecutionPlan_ReturnRecord(r->owner, r);
+	while((r = OpBase_Consume(plan->root)) != NULL) {
+		ExecutionPlan_ReturnRecord(r->owner, r);
+		if(++n % DEADLINE_CHECK_INTERVAL == 0 &&
+		   QueryCtx_DeadlineExceeded(ctx)) {
+			ExecutionPlan_Drain(plan);
+		}
+	}
 
 	return QueryCtx_GetResultSet();
 }
 
+//------------------------------------------------------------------------------
+// Execution plan restoration
+//------------------------------------------------------------------------------
+
+// restore op tree rooted at 'op' against its origin
+// trees diverge once runtime optimizations replaced or removed ops
+static bool _ExecutionPlan_Restore
+(
+	OpBase *op,
+	const OpBase *origin
+) {
+	if(!OpBase_Restore(op, origin)) return false;
+
+	for(int i = 0; i < op->childCount; i++) {
+		if(!_ExecutionPlan_Restore(op->children[i], origin->children[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// restore an executed plan to the state of a fresh clone of 'origin'
+// such that it can be prepared and executed again
+// returns false if the plan can't be restored, in which case it must be freed
+bool ExecutionPlan_Restore
+(
+	ExecutionPlan *plan,         // executed plan
+	const ExecutionPlan *origin  // plan 'plan' was cloned from
+) {
+	ASSERT(plan   != NULL);
+	ASSERT(origin != NULL);
+	ASSERT(plan->prepared);
+
+	// runtime optimizations are applied once again
+	// on the restored plan's next execution
+	if(ExecutionPlan_Drained(plan) ||
+	   !_ExecutionPlan_Restore(plan->root, origin->root)) {
+		return false;
+	}
+
+	plan->prepared = false;
+	return true;
+}
+
 //------------------------------------------------------------------------------
 // Execution plan draining
 //------------------------------------------------------------------------------
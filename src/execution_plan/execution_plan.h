@@ -88,6 +88,15 @@ ResultSet *ExecutionPlan_Execute
 	ExecutionPlan *plan
 );
 
+// restore an executed plan to the state of a fresh clone of 'origin'
+// such that it can be prepared and executed again
+// returns false if the plan can't be restored, in which case it must be freed
+bool ExecutionPlan_Restore
+(
+	ExecutionPlan *plan,         // executed plan
+	const ExecutionPlan *origin  // plan 'plan' was cloned from
+);
+
 // checks if execution plan been drained
 bool ExecutionPlan_Drained
 (
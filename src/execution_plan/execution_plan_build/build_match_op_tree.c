@@ -15,14 +15,338 @@
 #include "../optimizations/optimizations.h"
 #include "../../ast/ast_build_filter_tree.h"
 
+// planner hint attached to a MATCH clause
+typedef struct {
+	cypher_astnode_type_t type;  // USING INDEX, USING SCAN or USING JOIN
+	const char *alias;           // hinted node
+	const char *label;           // hinted label, index and scan hints
+	const char *attribute;       // hinted attribute, index hints only
+} PlannerHint;
+
+// collect MATCH clause planner hints
+// a join hint on multiple nodes is split into a hint per node
+static PlannerHint *_CollectHints
+(
+	const cypher_astnode_t *clause  // MATCH clause
+) {
+	uint nhints = cypher_ast_match_nhints(clause);
+	PlannerHint *hints = array_new(PlannerHint, nhints);
+
+	for(uint i = 0; i < nhints; i++) {
+		const cypher_astnode_t *hint = cypher_ast_match_get_hint(clause, i);
+		PlannerHint h = {.type = cypher_astnode_type(hint)};
+
+		if(h.type == CYPHER_AST_USING_INDEX) {
+			h.alias = cypher_ast_identifier_get_name(
+					cypher_ast_using_index_get_identifier(hint));
+			h.label = cypher_ast_label_get_name(
+					cypher_ast_using_index_get_label(hint));
+			h.attribute = cypher_ast_prop_name_get_value(
+					cypher_ast_using_index_get_prop_name(hint));
+			array_append(hints, h);
+		} else if(h.type == CYPHER_AST_USING_SCAN) {
+			h.alias = cypher_ast_identifier_get_name(
+					cypher_ast_using_scan_get_identifier(hint));
+			h.label = cypher_ast_label_get_name(
+					cypher_ast_using_scan_get_label(hint));
+			array_append(hints, h);
+		} else {
+			ASSERT(h.type == CYPHER_AST_USING_JOIN);
+			uint nids = cypher_ast_using_join_nidentifiers(hint);
+			for(uint j = 0; j < nids; j++) {
+				h.alias = cypher_ast_identifier_get_name(
+						cypher_ast_using_join_get_identifier(hint, j));
+				array_append(hints, h);
+			}
+		}
+	}
+
+	return hints;
+}
+
+// find the join hint or the scan hint applicable to query graph 'qg'
+// sets an error if multiple hints apply
+// returns NULL if no such hint exists
+static const PlannerHint *_ApplicableHint
+(
+	const QueryGraph *qg,      // connected component
+	const PlannerHint *hints,  // planner hints
+	bool join                  // look for join hint
+) {
+	const PlannerHint *applicable = NULL;
+
+	uint nhints = array_len((PlannerHint *)hints);
+	for(uint i = 0; i < nhints; i++) {
+		const PlannerHint *h = hints + i;
+		if((h->type == CYPHER_AST_USING_JOIN) != join) continue;
+		if(QueryGraph_GetNodeByAlias(qg, h->alias) == NULL) continue;
+
+		if(applicable != NULL && strcmp(applicable->alias, h->alias) != 0) {
+			ErrorCtx_SetError(EMSG_HINT_CONFLICT, applicable->alias, h->alias);
+			return NULL;
+		}
+		applicable = h;
+	}
+
+	return applicable;
+}
+
+// build a chain of traversals resolving connected component 'cc'
+// the chain starts at the hinted node if a scan or index hint applies
+// returns the chain's root, NULL on error
+static OpBase *_BuildTraversalChain
+(
+	ExecutionPlan *plan,        // plan
+	QueryGraph *qg,             // query graph
+	QueryGraph *cc,             // connected component
+	FT_FilterNode *ft,          // filters
+	rax *bound_vars,            // bound variables
+	const PlannerHint *hints    // planner hints
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	OpBase *root = NULL; // the root of the traversal chain
+	OpBase *tail = NULL;
+
+	const PlannerHint *hint = _ApplicableHint(cc, hints, false);
+	if(ErrorCtx_EncounteredError()) return NULL;
+
+	AlgebraicExpression **exps = AlgebraicExpression_FromQueryGraph(cc);
+	uint expCount = array_len(exps);
+
+	// Reorder exps, to the most performant arrangement of evaluation.
+	if(hint != NULL) {
+		// pin the hinted node as the chain's entry point
+		// by considering it bound
+		rax *pinned = raxClone(bound_vars);
+		raxInsert(pinned, (unsigned char *)hint->alias, strlen(hint->alias),
+				NULL, NULL);
+		orderExpressions(qg, exps, &expCount, ft, pinned);
+		raxFree(pinned);
+
+		// a chain reaching a bound node starts there regardless of the hint
+		if(strcmp(AlgebraicExpression_Src(exps[0]), hint->alias) != 0) {
+			hint = NULL;
+		}
+	} else {
+		orderExpressions(qg, exps, &expCount, ft, bound_vars);
+	}
+
+	// Create the SCAN operation that will be the tail of the traversal chain.
+	QGNode *src = QueryGraph_GetNodeByAlias(qg,
+		AlgebraicExpression_Src(exps[0]));
+
+	uint label_count = QGNode_LabelCount(src);
+	if(label_count > 0) {
+		AlgebraicExpression *ae_src =
+			AlgebraicExpression_RemoveSource(&exps[0]);
+		ASSERT(AlgebraicExpression_DiagonalOperand(ae_src, 0));
+
+		const char *label = AlgebraicExpression_Label(ae_src);
+		const char *alias = AlgebraicExpression_Src(ae_src);
+		ASSERT(label != NULL);
+		ASSERT(alias != NULL);
+
+		int label_id = GRAPH_UNKNOWN_LABEL;
+		Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
+		if(s != NULL) label_id = Schema_GetID(s);
+
+		// resolve source node by performing label scan
+		NodeScanCtx *ctx = NodeScanCtx_New((char *)alias, (char *)label,
+			label_id, src);
+
+		// hinted scans are honored by the label scan optimizations
+		if(hint != NULL) {
+			ctx->hint = (hint->type == CYPHER_AST_USING_INDEX) ?
+				SCAN_HINT_INDEX : SCAN_HINT_LABEL;
+			ctx->hint_label = hint->label;
+			ctx->hint_attr  = hint->attribute;
+		}
+
+		root = tail = NewNodeByLabelScanOp(plan, ctx);
+
+		// first operand has been converted into a label scan op
+		AlgebraicExpression_Free(ae_src);
+	} else {
+		root = tail = NewAllNodeScanOp(plan, src->alias);
+		// free expression source
+		// in-case there are additional patterns to traverse
+		if(array_len(cc->edges) == 0) {
+			AlgebraicExpression_Free(
+					AlgebraicExpression_RemoveSource(&exps[0]));
+		}
+	}
+
+	// for each expression, build the appropriate traversal operation
+	for(int j = 0; j < expCount; j++) {
+		AlgebraicExpression *exp = exps[j];
+		// Empty expression, already freed.
+		if(AlgebraicExpression_OperandCount(exp) == 0) continue;
+
+		QGEdge *edge = NULL;
+		if(AlgebraicExpression_Edge(exp)) {
+			edge =
+				QueryGraph_GetEdgeByAlias(qg, AlgebraicExpression_Edge(exp));
+		}
+
+		if(edge && (QGEdge_VariableLength(edge) || !QGEdge_SingleHop(edge))) {
+			if(QGEdge_IsShortestPath(edge)) {
+				// edge is part of a shortest-path
+				// MATCH allShortestPaths((a)-[*..]->(b))
+				// validate both edge ends are bounded
+				const char *src_alias  = QGNode_Alias(QGEdge_Src(edge));
+				const char *dest_alias = QGNode_Alias(QGEdge_Dest(edge));
+				bool src_bounded =
+					raxFind(bound_vars, (unsigned char *)src_alias,
+							strlen(src_alias)) != raxNotFound;
+				bool dest_bounded =
+					raxFind(bound_vars, (unsigned char *)dest_alias,
+							strlen(dest_alias)) != raxNotFound;
+
+				// TODO: would be great if we can perform this validation
+				// at AST validation time
+				if(!src_bounded || !dest_bounded) {
+					ErrorCtx_SetError(EMSG_ALLSHORTESTPATH_SRC_DST_RESLOVED);
+				}
+			}
+			root = NewCondVarLenTraverseOp(plan, gc->g, exp);
+		} else {
+			root = NewCondTraverseOp(plan, gc->g, exp);
+		}
+		// Insert the new traversal op at the root of the chain.
+		ExecutionPlan_AddOp(root, tail);
+		tail = root;
+	}
+
+	// Free the expressions array, as its parts have been converted into operations
+	array_free(exps);
+
+	return root;
+}
+
+// collect into 'side' every node reachable from 'n'
+// without passing through node 'pivot'
+static void _CollectSide
+(
+	const QGNode *n,      // current node
+	const QGNode *pivot,  // node not to pass through
+	rax *side             // [output] reached nodes
+) {
+	if(n == pivot) return;
+	if(!raxTryInsert(side, (unsigned char *)n->alias, strlen(n->alias), NULL,
+				NULL)) {
+		return;
+	}
+
+	uint n_outgoing = array_len(n->outgoing_edges);
+	for(uint i = 0; i < n_outgoing; i++) {
+		_CollectSide(n->outgoing_edges[i]->dest, pivot, side);
+	}
+
+	uint n_incoming = array_len(n->incoming_edges);
+	for(uint i = 0; i < n_incoming; i++) {
+		_CollectSide(n->incoming_edges[i]->src, pivot, side);
+	}
+}
+
+// build a value hash join of the two parts of connected component 'cc'
+// meeting at the hinted node
+// returns the join op, NULL on error
+static OpBase *_BuildHintedJoin
+(
+	ExecutionPlan *plan,      // plan
+	QueryGraph *qg,           // query graph
+	QueryGraph *cc,           // connected component
+	FT_FilterNode *ft,        // filters
+	rax *bound_vars,          // bound variables
+	const PlannerHint *hints, // planner hints
+	const char *alias         // join node
+) {
+	OpBase *join = NULL;
+
+	// both parts are resolved independently
+	// none of the component's nodes may already be bound
+	uint node_count = QueryGraph_NodeCount(cc);
+	for(uint i = 0; i < node_count; i++) {
+		const char *n = cc->nodes[i]->alias;
+		if(raxFind(bound_vars, (unsigned char *)n, strlen(n)) != raxNotFound) {
+			ErrorCtx_SetError(EMSG_HINT_JOIN, alias);
+			return NULL;
+		}
+	}
+
+	// pick the first neighbor of the join node
+	QGNode *pivot = QueryGraph_GetNodeByAlias(cc, alias);
+	QGNode *neighbor = NULL;
+	for(uint i = 0; i < array_len(pivot->outgoing_edges) && !neighbor; i++) {
+		QGNode *dest = pivot->outgoing_edges[i]->dest;
+		if(dest != pivot) neighbor = dest;
+	}
+	for(uint i = 0; i < array_len(pivot->incoming_edges) && !neighbor; i++) {
+		QGNode *src = pivot->incoming_edges[i]->src;
+		if(src != pivot) neighbor = src;
+	}
+
+	// left-hand side, every node reachable from the neighbor
+	// without passing through the join node
+	rax *side = raxNew();
+	if(neighbor != NULL) _CollectSide(neighbor, pivot, side);
+
+	// the join node must split its component into two parts
+	if(neighbor == NULL || raxSize(side) == node_count - 1) {
+		ErrorCtx_SetError(EMSG_HINT_JOIN, alias);
+		raxFree(side);
+		return NULL;
+	}
+
+	// each part keeps its own nodes and the join node
+	QueryGraph *lhs = QueryGraph_Clone(cc);
+	QueryGraph *rhs = QueryGraph_Clone(cc);
+	for(uint i = 0; i < node_count; i++) {
+		const char *n = cc->nodes[i]->alias;
+		if(n == pivot->alias) continue;
+
+		bool left = raxFind(side, (unsigned char *)n, strlen(n)) != raxNotFound;
+		QueryGraph *other = (left) ? rhs : lhs;
+		QGNode_Free(QueryGraph_RemoveNode(other,
+					QueryGraph_GetNodeByAlias(other, n)));
+	}
+
+	// self loops on the join node are resolved by the left-hand side
+	QGNode *rhs_pivot = QueryGraph_GetNodeByAlias(rhs, alias);
+	for(int i = array_len(rhs_pivot->outgoing_edges) - 1; i >= 0; i--) {
+		QGEdge *e = rhs_pivot->outgoing_edges[i];
+		if(e->dest == rhs_pivot) QGEdge_Free(QueryGraph_RemoveEdge(rhs, e));
+	}
+
+	// detect conflicting hints before building either part
+	_ApplicableHint(lhs, hints, false);
+	_ApplicableHint(rhs, hints, false);
+	if(ErrorCtx_EncounteredError()) goto cleanup;
+
+	OpBase *l = _BuildTraversalChain(plan, qg, lhs, ft, bound_vars, hints);
+	OpBase *r = _BuildTraversalChain(plan, qg, rhs, ft, bound_vars, hints);
+	ASSERT(l != NULL && r != NULL);
+
+	join = NewValueHashJoin(plan, AR_EXP_NewVariableOperandNode(alias),
+			AR_EXP_NewVariableOperandNode(alias));
+	ExecutionPlan_AddOp(join, l);
+	ExecutionPlan_AddOp(join, r);
+
+cleanup:
+	raxFree(side);
+	QueryGraph_Free(lhs);
+	QueryGraph_Free(rhs);
+	return join;
+}
+
 static void _ExecutionPlan_ProcessQueryGraph
 (
 	ExecutionPlan *plan,
 	QueryGraph *qg,
-	AST *ast
+	AST *ast,
+	const PlannerHint *hints
 ) {
-	GraphContext *gc = QueryCtx_GetGraphCtx();
-
 	// build the full FilterTree for this AST
 	// so that we can order traversals properly
 	FT_FilterNode *ft = AST_BuildFilterTree(ast);
@@ -47,7 +371,6 @@ static void _ExecutionPlan_ProcessQueryGraph
 		QueryGraph *cc = connectedComponents[i];
 		uint edge_count = array_len(cc->edges);
 		OpBase *root = NULL; // the root of the traversal chain will be added to the ExecutionPlan
-		OpBase *tail = NULL;
 
 		if(edge_count == 0) {
 			// if there are no edges in the component, we only need a node scan
@@ -60,92 +383,25 @@ static void _ExecutionPlan_ProcessQueryGraph
 			}
 		}
 
-		AlgebraicExpression **exps = AlgebraicExpression_FromQueryGraph(cc);
-		uint expCount = array_len(exps);
-
-		// Reorder exps, to the most performant arrangement of evaluation.
-		orderExpressions(qg, exps, &expCount, ft, bound_vars);
-
-		// Create the SCAN operation that will be the tail of the traversal chain.
-		QGNode *src = QueryGraph_GetNodeByAlias(qg,
-			AlgebraicExpression_Src(exps[0]));
-
-		uint label_count = QGNode_LabelCount(src);
-		if(label_count > 0) {
-			AlgebraicExpression *ae_src =
-				AlgebraicExpression_RemoveSource(&exps[0]);
-			ASSERT(AlgebraicExpression_DiagonalOperand(ae_src, 0));
-
-			const char *label = AlgebraicExpression_Label(ae_src);
-			const char *alias = AlgebraicExpression_Src(ae_src);
-			ASSERT(label != NULL);
-			ASSERT(alias != NULL);
+		// a join hint splits the component into two joined chains
+		const PlannerHint *join = _ApplicableHint(cc, hints, true);
+		if(ErrorCtx_EncounteredError()) break;
 
-			int label_id = GRAPH_UNKNOWN_LABEL;
-			Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_NODE);
-			if(s != NULL) label_id = Schema_GetID(s);
-
-			// resolve source node by performing label scan
-			NodeScanCtx *ctx = NodeScanCtx_New((char *)alias, (char *)label,
-				label_id, src);
-			root = tail = NewNodeByLabelScanOp(plan, ctx);
-
-			// first operand has been converted into a label scan op
-			AlgebraicExpression_Free(ae_src);
+		if(join != NULL) {
+			root = _BuildHintedJoin(plan, qg, cc, ft, bound_vars, hints,
+					join->alias);
 		} else {
-			root = tail = NewAllNodeScanOp(plan, src->alias);
-			// free expression source
-			// in-case there are additional patterns to traverse
-			if(array_len(cc->edges) == 0) {
-				AlgebraicExpression_Free(
-						AlgebraicExpression_RemoveSource(&exps[0]));
-			}
+			root = _BuildTraversalChain(plan, qg, cc, ft, bound_vars, hints);
 		}
+		if(root == NULL) break;
 
-		// for each expression, build the appropriate traversal operation
-		for(int j = 0; j < expCount; j++) {
-			AlgebraicExpression *exp = exps[j];
-			// Empty expression, already freed.
-			if(AlgebraicExpression_OperandCount(exp) == 0) continue;
-
-			QGEdge *edge = NULL;
-			if(AlgebraicExpression_Edge(exp)) {
-				edge =
-					QueryGraph_GetEdgeByAlias(qg, AlgebraicExpression_Edge(exp));
-			}
-
-			if(edge && (QGEdge_VariableLength(edge) || !QGEdge_SingleHop(edge))) {
-				if(QGEdge_IsShortestPath(edge)) {
-					// edge is part of a shortest-path
-					// MATCH allShortestPaths((a)-[*..]->(b))
-					// validate both edge ends are bounded
-					const char *src_alias  = QGNode_Alias(QGEdge_Src(edge));
-					const char *dest_alias = QGNode_Alias(QGEdge_Dest(edge));
-					bool src_bounded =
-						raxFind(bound_vars, (unsigned char *)src_alias,
-								strlen(src_alias)) != raxNotFound;
-					bool dest_bounded =
-						raxFind(bound_vars, (unsigned char *)dest_alias,
-								strlen(dest_alias)) != raxNotFound;
-
-					// TODO: would be great if we can perform this validation
-					// at AST validation time
-					if(!src_bounded || !dest_bounded) {
-						ErrorCtx_SetError(EMSG_ALLSHORTESTPATH_SRC_DST_RESLOVED);
-					}
-				}
-				root = NewCondVarLenTraverseOp(plan, gc->g, exp);
-			} else {
-				root = NewCondTraverseOp(plan, gc->g, exp);
-			}
-			// Insert the new traversal op at the root of the chain.
-			ExecutionPlan_AddOp(root, tail);
-			tail = root;
+		// a join can't be chained onto previously built ops
+		// combine the two streams instead
+		if(join != NULL && cartesianProduct == NULL && plan->root != NULL) {
+			cartesianProduct = NewCartesianProductOp(plan);
+			ExecutionPlan_UpdateRoot(plan, cartesianProduct);
 		}
 
-		// Free the expressions array, as its parts have been converted into operations
-		array_free(exps);
-
 		if(cartesianProduct) {
 			// We have multiple disjoint traversal chains.
 			// Add each chain as a child under the Cartesian Product.
@@ -211,7 +467,9 @@ void buildMatchOpTree(ExecutionPlan *plan, AST *ast, const cypher_astnode_t *cla
 	QueryGraph *sub_qg =
 		QueryGraph_ExtractPatterns(plan->query_graph, &pattern, 1);
 
-	_ExecutionPlan_ProcessQueryGraph(plan, sub_qg, ast);
+	PlannerHint *hints = _CollectHints(clause);
+	_ExecutionPlan_ProcessQueryGraph(plan, sub_qg, ast, hints);
+	array_free(hints);
 	if(ErrorCtx_EncounteredError()) goto cleanup;
 
 	// Build the FilterTree to model any WHERE predicates on these clauses and place ops appropriately.
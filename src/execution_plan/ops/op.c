@@ -88,6 +88,7 @@ void OpBase_Init
 	// set op's function pointers
 	op->free     = free;
 	op->clone    = clone;
+	op->restore  = NULL;  // ops opt-in to restoration
 	op->consume  = _InitialConsume;  // initial consume wrapper function
 	op->_consume = consume;          // op's consume function
 	op->toString = toString;
@@ -274,6 +275,58 @@ Record OpBase_Profile
 	return r;
 }
 
+// counts records produced by op until it first depletes
+// removes itself once depleted, such that a reset op
+// e.g. the right hand side of a cartesian product, reports a single pass
+static Record _OpBase_Count
+(
+	OpBase *op
+) {
+	Record r = op->_consume(op);
+
+	if(r) {
+		op->stats->profileRecordCount++;
+	} else {
+		op->consume = op->_consume;
+	}
+
+	return r;
+}
+
+// initial consume function of a counted op
+// performs init followed by a counted consume
+static Record _OpBase_Count_init
+(
+	OpBase *op
+) {
+	ASSERT(op->consume == _OpBase_Count_init);
+
+	// first and ONLY call to operation initialization
+	op->init(op);
+
+	op->consume = _OpBase_Count;
+	return _OpBase_Count(op);
+}
+
+// count the records produced by op, accumulated into op->stats
+// lighter than profiling as execution time isn't measured
+// must be called before op is first consumed
+void OpBase_CountRecords
+(
+	OpBase *op
+) {
+	ASSERT(op        != NULL);
+	ASSERT(op->stats == NULL);
+
+	// op had already been initialized
+	if(op->consume != _InitialConsume) {
+		return;
+	}
+
+	op->stats = rm_calloc(1, sizeof(OpStats));
+	op->consume = _OpBase_Count_init;
+}
+
 bool OpBase_IsWriter
 (
 	const OpBase *op
@@ -410,6 +463,39 @@ OpBase *OpBase_Clone
 	return NULL;
 }
 
+// restore an executed op to the state of a fresh clone of 'origin'
+// the op it was cloned from, such that it can be executed again
+// returns false if op doesn't support restoration or diverged from 'origin'
+// in which case op can only be freed
+bool OpBase_Restore
+(
+	OpBase *op,           // executed op
+	const OpBase *origin  // op 'op' was cloned from
+) {
+	ASSERT(op     != NULL);
+	ASSERT(origin != NULL);
+
+	// runtime optimizations replaced or removed ops
+	if(op->type != origin->type || op->childCount != origin->childCount) {
+		return false;
+	}
+
+	// profiled ops report their statistics once
+	if(op->restore == NULL || op->stats != NULL) {
+		return false;
+	}
+
+	// restore op's state, resetting its consume function
+	if(!op->restore(op, origin)) {
+		return false;
+	}
+
+	// op is initialized once again on its first invocation
+	op->consume = _InitialConsume;
+
+	return true;
+}
+
 void OpBase_Free
 (
 	OpBase *op
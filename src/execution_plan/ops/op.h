@@ -115,6 +115,7 @@ typedef Record(*fpConsume)(struct OpBase *);
 typedef OpResult(*fpReset)(struct OpBase *);
 typedef void (*fpToString)(const struct OpBase *, sds *);
 typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpBase *);
+typedef bool (*fpRestore)(struct OpBase *, const struct OpBase *);
 
 // Execution plan operation statistics.
 typedef struct {
@@ -128,6 +129,7 @@ struct OpBase {
 	fpFree free;                       // free operation
 	fpReset reset;                     // reset operation state
 	fpClone clone;                     // operation clone
+	fpRestore restore;                 // restore executed op, NULL if unsupported
 	fpConsume consume;                 // produce next record
 	fpConsume _consume;                // backup for the original consume func
 	fpToString toString;               // operation string representation
@@ -176,6 +178,13 @@ Record OpBase_Profile
 	OpBase *op
 );
 
+// count the records produced by op, accumulated into op->stats
+// must be called before op is first consumed
+void OpBase_CountRecords
+(
+	OpBase *op
+);
+
 void OpBase_ToString
 (
 	const OpBase *op,
@@ -188,6 +197,16 @@ OpBase *OpBase_Clone
 	const OpBase *op
 );
 
+// restore an executed op to the state of a fresh clone of 'origin'
+// the op it was cloned from, such that it can be executed again
+// returns false if op doesn't support restoration or diverged from 'origin'
+// in which case op can only be freed
+bool OpBase_Restore
+(
+	OpBase *op,           // executed op
+	const OpBase *origin  // op 'op' was cloned from
+);
+
 // returns operation type
 OPType OpBase_Type
 (
@@ -17,28 +17,41 @@ static Record AggregateConsume(OpBase *opBase);
 static OpResult AggregateReset(OpBase *opBase);
 static OpBase *AggregateClone(const ExecutionPlan *plan, const OpBase *opBase);
 
-// fake hash function
-// hash of key is simply key
-static uint64_t _id_hash
+// group lookup key
+typedef struct {
+	const OpAggregate *op;  // aggregate operation
+	const SIValue *keys;    // evaluated key expressions
+} GroupKey;
+
+// determine if group's keys equal the searched keys
+// guards against hash collisions between distinct keys
+static bool _GroupKeyEq
 (
-	const void *key
+	const void *value,  // group
+	const void *ctx     // group key
 ) {
-	return ((uint64_t)key);
+	const Group *g = (const Group *)value;
+	const GroupKey *k = (const GroupKey *)ctx;
+	const OpAggregate *op = k->op;
+
+	for(uint i = 0; i < op->key_count; i++) {
+		SIValue v = Record_Get(g->r, op->record_offsets[i]);
+		if(!SIValue_Equivalent(v, k->keys[i])) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
 // hashtable entry free callback
-static void freeCallback
+static void _FreeGroup
 (
-	dict *d,
-	void *val
+	void *value
 ) {
-	Group_Free((Group*)val);
+	Group_Free((Group*)value);
 }
 
-// hashtable callbacks
-static dictType _dt = {_id_hash, NULL, NULL, NULL, NULL, freeCallback, NULL,
-	NULL, NULL, NULL};
-
 // migrate each expression projected by this operation to either
 // the array of keys or the array of aggregate functions as appropriate
 static void _migrate_expressions
@@ -127,21 +140,21 @@ static Group *_GetGroup
 	SIValue keys[op->key_count];
 	XXH64_hash_t hash = _ComputeGroupKey(keys, op, r);
 
-	// lookup group by hashed key
+	// lookup group by hashed key, verifying its keys
 	Group *g;
-	dictEntry *existing;
-	dictEntry *entry = HashTableAddRaw(op->groups, (void *)hash, &existing);
+	bool found;
+	GroupKey key = {op, keys};
+	void **entry = FlatMap_FindOrInsert(op->groups, hash, _GroupKeyEq, &key,
+			&found);
 
-	if(entry == NULL) {
+	if(found) {
 		// group exists
-		ASSERT(existing != NULL);
-
 		// free computed keys
 		for(uint i = 0; i < op->key_count; i++) {
 			SIValue_Free(keys[i]);
 		}
 
-		g = HashTableGetVal(existing);
+		g = *entry;
 	} else {
 		// group does not exists, create it
 
@@ -163,7 +176,7 @@ static Group *_GetGroup
 
 		g = _CreateGroup(op, representative);
 
-		HashTableSetVal(op->groups, entry, g);
+		*entry = g;
 	}
 
 	return g;
@@ -193,12 +206,12 @@ static Record _handoff
 (
 	OpAggregate *op
 ) {
-	dictEntry *entry = HashTableNext(op->group_iter);
+	void **entry = FlatMap_IteratorNext(&op->group_iter, NULL);
 	if(entry == NULL) {
 		return NULL;
 	}
 
-	Group *g = (Group*)HashTableGetVal(entry);
+	Group *g = (Group*)*entry;
 	Record r = g->r;
 	g->r = NULL;
 
@@ -214,7 +227,7 @@ static Record _handoff
 
 	// free group
 	Group_Free(g);
-	HashTableSetVal(op->groups, entry, NULL);
+	*entry = NULL;
 
 	return r;
 }
@@ -226,18 +239,14 @@ OpBase *NewAggregateOp
 ) {
 	OpAggregate *op = rm_malloc(sizeof(OpAggregate));
 
-	op->groups               = HashTableCreate(&_dt);
-	op->group_iter           = NULL;
+	op->groups               = FlatMap_New(2048);
+	op->handoff              = false;
 	op->r 				     = NULL;
 
 	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL,
 			AggregateConsume, AggregateReset, NULL, AggregateClone,
 			AggregateFree, false, plan);
 
-	// expand hashtable to 2048 slots
-	int res = HashTableExpand(op->groups, 2048);
-	ASSERT(res == DICT_OK);
-
 	// migrate each expression to the keys array or
 	// the aggregations array as appropriate
 	_migrate_expressions(op, exps);
@@ -267,7 +276,7 @@ static Record AggregateConsume
 	OpBase *opBase
 ) {
 	OpAggregate *op = (OpAggregate *)opBase;
-	if(op->group_iter != NULL) {
+	if(op->handoff) {
 		return _handoff(op);
 	}
 
@@ -290,7 +299,7 @@ static Record AggregateConsume
 	// does aggregation contains keys?
 	// e.g.
 	// MATCH (n:N) WHERE n.noneExisting = 2 RETURN count(n)
-	if(HashTableElemCount(op->groups) == 0 && op->key_count == 0) {
+	if(FlatMap_Count(op->groups) == 0 && op->key_count == 0) {
 
 		// no data was processed and aggregation doesn't have a key
 		// in this case we want to return aggregation default value
@@ -312,7 +321,8 @@ static Record AggregateConsume
 	}
 
 	// create group iterator
-	op->group_iter = HashTableGetIterator(op->groups);
+	FlatMap_IteratorInit(&op->group_iter, op->groups);
+	op->handoff = true;
 
 	return _handoff(op);
 }
@@ -323,20 +333,10 @@ static OpResult AggregateReset
 ) {
 	OpAggregate *op = (OpAggregate *)opBase;
 
-	if(op->group_iter != NULL) {
-		HashTableReleaseIterator(op->group_iter);
-		op->group_iter = NULL;
-	}
-
-	// re-create hashtable
-	unsigned long elem_count = HashTableElemCount(op->groups);
-	HashTableRelease(op->groups);
+	op->handoff = false;
 
-	op->groups = HashTableCreate(&_dt);
-
-	// expand hashtable to previous element count
-	int res = HashTableExpand(op->groups, elem_count);
-	ASSERT(res == DICT_OK);
+	// clear hashtable, retaining its capacity
+	FlatMap_Clear(op->groups, _FreeGroup);
 
 	return OP_OK;
 }
@@ -400,11 +400,6 @@ static void AggregateFree
 		return;
 	}
 
-	if(op->group_iter) {
-		HashTableReleaseIterator(op->group_iter);
-		op->group_iter = NULL;
-	}
-
 	if(op->key_exps) {
 		for(uint i = 0; i < op->key_count; i++) {
 			AR_EXP_Free(op->key_exps[i]);
@@ -422,8 +417,7 @@ static void AggregateFree
 	}
 
 	if(op->groups) {
-		HashTableRelease(op->groups);
-		op->groups = NULL;
+		FlatMap_Free(&op->groups, _FreeGroup);
 	}
 
 	if(op->record_offsets) {
@@ -7,7 +7,7 @@
 #pragma once
 
 #include "op.h"
-#include "../../util/dict.h"
+#include "../../util/flat_map.h"
 #include "../execution_plan.h"
 #include "../../grouping/group.h"
 #include "../../arithmetic/arithmetic_expression.h"
@@ -18,8 +18,9 @@ typedef struct {
 	uint *record_offsets;         // record IDs for key and aggregate exps
 	AR_ExpNode **key_exps;        // array of expressions used to calculate the group key
 	AR_ExpNode **aggregate_exps;  // array of expressions that aggregate data for each key
-	dict *groups;                 // map of all groups built by this operation
-	dictIterator *group_iter;     // iterator for walking all groups
+	FlatMap groups;               // map of all groups built by this operation
+	FlatMapIterator group_iter;   // iterator for walking all groups
+	bool handoff;                 // groups are being handed off
 	uint key_count;               // number of key expressions
 	uint aggregate_count;         // number of aggregating expressions
 } OpAggregate;
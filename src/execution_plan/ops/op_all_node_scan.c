@@ -15,6 +15,7 @@ static Record AllNodeScanConsumeFromChild(OpBase *opBase);
 static OpResult AllNodeScanReset(OpBase *opBase);
 static OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void AllNodeScanFree(OpBase *opBase);
+static bool AllNodeScanRestore(OpBase *opBase, const OpBase *origin);
 
 static inline void AllNodeScanToString(const OpBase *ctx, sds *buf) {
 	ScanToString(ctx, buf, ((AllNodeScan *)ctx)->alias, NULL);
@@ -30,6 +31,7 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 	OpBase_Init((OpBase *)op, OPType_ALL_NODE_SCAN, "All Node Scan", AllNodeScanInit,
 				AllNodeScanConsume, AllNodeScanReset, AllNodeScanToString, AllNodeScanClone, AllNodeScanFree, false,
 				plan);
+	op->op.restore = AllNodeScanRestore;
 	op->nodeRecIdx = OpBase_Modifies((OpBase *)op, alias);
 	return (OpBase *)op;
 }
@@ -100,6 +102,13 @@ static inline OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *
 	return NewAllNodeScanOp(plan, ((AllNodeScan *)opBase)->alias);
 }
 
+// the scan iterator is created once the op is initialized
+static bool AllNodeScanRestore(OpBase *opBase, const OpBase *origin) {
+	AllNodeScanFree(opBase);
+	OpBase_UpdateConsume(opBase, AllNodeScanConsume);
+	return true;
+}
+
 static void AllNodeScanFree(OpBase *ctx) {
 	AllNodeScan *op = (AllNodeScan *)ctx;
 	if(op->iter) {
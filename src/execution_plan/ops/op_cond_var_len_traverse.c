@@ -207,7 +207,6 @@ static Record CondVarLenTraverseOptimizedConsume
 ) {
 	CondVarLenTraverse  *op     = (CondVarLenTraverse *)opBase;
 	OpBase              *child  =  op->op.children[0];
-	Node                dest    =  GE_NEW_NODE();
 	EntityID            dest_id =  INVALID_ENTITY_ID;
 
 	while((dest_id = AllNeighborsCtx_NextNeighbor(op->allNeighborsCtx)) ==
@@ -253,17 +252,13 @@ static Record CondVarLenTraverseOptimizedConsume
 	// could not produce destination node, return
 	if(dest_id == INVALID_ENTITY_ID) return NULL;
 
-	int res = Graph_GetNode(op->g, dest_id, &dest);
-	UNUSED(res);
-	ASSERT(res == true);
-
 	//--------------------------------------------------------------------------
 	// populate output record
 	//--------------------------------------------------------------------------
 
-	// add destination node to record
+	// add destination node to record, its attributes are resolved on access
 	Record r = OpBase_CloneRecord(op->r);
-	Record_AddNode(r, op->destNodeIdx, dest);
+	Record_AddNodeID(r, op->destNodeIdx, dest_id);
 
 	return r;
 }
@@ -19,6 +19,7 @@ static Record CondTraverseConsume(OpBase *opBase);
 static OpResult CondTraverseReset(OpBase *opBase);
 static OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void CondTraverseFree(OpBase *opBase);
+static bool CondTraverseRestore(OpBase *opBase, const OpBase *origin);
 
 static void CondTraverseToString(const OpBase *ctx, sds *buf) {
 	TraversalToString(ctx, buf, ((const OpCondTraverse *)ctx)->ae);
@@ -34,8 +35,7 @@ static void _populate_filter_matrix(OpCondTraverse *op) {
 	// F[i, srcId] = true
 	for(uint i = 0; i < op->record_count; i++) {
 		Record r = op->records[i];
-		Node *n = Record_GetNode(r, op->srcNodeIdx);
-		NodeID srcId = ENTITY_GET_ID(n);	
+		NodeID srcId = Record_GetNodeID(r, op->srcNodeIdx);
 		GrB_Matrix_setElement_BOOL(FM, true, i, srcId);
 	}
 }
@@ -87,6 +87,7 @@ OpBase *NewCondTraverseOp
 			"Conditional Traverse", CondTraverseInit, CondTraverseConsume,
 			CondTraverseReset, CondTraverseToString, CondTraverseClone,
 			CondTraverseFree, false, plan);
+	op->op.restore = CondTraverseRestore;
 
 	bool aware = OpBase_Aware((OpBase *)op, AlgebraicExpression_Src(ae),
 			&op->srcNodeIdx);
@@ -167,7 +168,7 @@ static Record CondTraverseConsume
 				break;
 			}
 
-			if(!Record_GetNode(childRecord, op->srcNodeIdx)) {
+			if(Record_GetNodeID(childRecord, op->srcNodeIdx) == INVALID_ENTITY_ID) {
 				// the child Record may not contain the source node in scenarios
 				// like a failed OPTIONAL MATCH
 				// in this case, delete the Record and try again
@@ -188,15 +189,14 @@ static Record CondTraverseConsume
 
 	/* Get node from current column. */
 	op->r = op->records[src_id];
-	// Populate the destination node and add it to the Record.
-	Node destNode = GE_NEW_NODE();
-	Graph_GetNode(op->graph, dest_id, &destNode);
-	Record_AddNode(op->r, op->destNodeIdx, destNode);
+	// Add the destination node to the Record,
+	// its attributes are resolved once accessed.
+	Record_AddNodeID(op->r, op->destNodeIdx, dest_id);
 
 	if(op->edge_ctx) {
-		Node *srcNode = Record_GetNode(op->r, op->srcNodeIdx);
+		NodeID src_node_id = Record_GetNodeID(op->r, op->srcNodeIdx);
 		// Collect all appropriate edges connecting the current pair of endpoints.
-		EdgeTraverseCtx_CollectEdges(op->edge_ctx, ENTITY_GET_ID(srcNode), ENTITY_GET_ID(&destNode));
+		EdgeTraverseCtx_CollectEdges(op->edge_ctx, src_node_id, dest_id);
 		// We're guaranteed to have at least one edge.
 		EdgeTraverseCtx_SetEdge(op->edge_ctx, op->r);
 	}
@@ -230,6 +230,31 @@ static inline OpBase *CondTraverseClone(const ExecutionPlan *plan, const OpBase
 	return NewCondTraverseOp(plan, QueryCtx_GetGraph(), AlgebraicExpression_Clone(op->ae));
 }
 
+// the algebraic expression is extended by the filter matrix and optimized
+// on the first traversal and its operands might have been patched by
+// runtime optimizations, restore it from origin
+static bool CondTraverseRestore(OpBase *opBase, const OpBase *origin) {
+	OpCondTraverse *op = (OpCondTraverse *)opBase;
+
+	CondTraverseReset(opBase);
+
+	if(op->F != NULL) Delta_Matrix_free(&op->F);
+	if(op->M != NULL) Delta_Matrix_free(&op->M);
+	op->F = NULL;
+	op->M = NULL;
+
+	if(op->records != NULL) {
+		rm_free(op->records);
+		op->records = NULL;
+	}
+	op->record_cap = BATCH_SIZE;
+
+	AlgebraicExpression_Free(op->ae);
+	op->ae = AlgebraicExpression_Clone(((const OpCondTraverse *)origin)->ae);
+
+	return true;
+}
+
 /* Frees CondTraverse */
 static void CondTraverseFree(OpBase *ctx) {
 	OpCondTraverse *op = (OpCondTraverse *)ctx;
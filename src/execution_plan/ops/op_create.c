@@ -120,7 +120,6 @@ static void _CreateEdges
 
 		// create the actual edge
 		Edge newEdge = {0};
-		newEdge.relationship = e->relation;
 		Edge_SetSrcNodeID(&newEdge, ENTITY_GET_ID(src_node));
 		Edge_SetDestNodeID(&newEdge, ENTITY_GET_ID(dest_node));
 		Edge *edge_ref = Record_AddEdge(r, e->edge_idx, newEdge);
@@ -39,6 +39,56 @@ static unsigned long long _compute_hash(OpDistinct *op, Record r) {
 	return hash;
 }
 
+// distinct values lookup key
+typedef struct {
+	const OpDistinct *op;  // distinct operation
+	Record r;              // record holding the searched values
+} DistinctKey;
+
+// determine if previously seen values equal the record's values
+// guards against hash collisions between distinct values
+static bool _DistinctKeyEq
+(
+	const void *value,  // seen values
+	const void *ctx     // distinct key
+) {
+	const SIValue *seen = (const SIValue *)value;
+	const DistinctKey *k = (const DistinctKey *)ctx;
+	const OpDistinct *op = k->op;
+
+	for(uint i = 0; i < op->offset_count; i++) {
+		SIValue v = Record_Get(k->r, op->offsets[i]);
+		if(!SIValue_Equivalent(seen[i], v)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// copy the record's distinct values
+static SIValue *_CopyValues
+(
+	const OpDistinct *op,
+	Record r
+) {
+	SIValue *values = array_newlen(SIValue, op->offset_count);
+	for(uint i = 0; i < op->offset_count; i++) {
+		values[i] = SI_CloneValue(Record_Get(r, op->offsets[i]));
+	}
+
+	return values;
+}
+
+// free copied distinct values
+static void _FreeValues
+(
+	void *value
+) {
+	SIValue *values = (SIValue *)value;
+	array_free_cb(values, SIValue_Free);
+}
+
 // compute record offset to distinct values
 static void _updateOffsets(OpDistinct *op, Record r) {
 	ASSERT(op->aliases != NULL);
@@ -57,7 +107,7 @@ OpBase *NewDistinctOp(const ExecutionPlan *plan, const char **aliases, uint alia
 
 	OpDistinct *op = rm_malloc(sizeof(OpDistinct));
 
-	op->found           =  HashTableCreate(&def_dt);
+	op->found           =  FlatMap_New(0);
 	op->mapping         =  NULL;
 	op->aliases         =  rm_malloc(alias_count * sizeof(const char *));
 	op->offset_count    =  alias_count;
@@ -94,9 +144,15 @@ static Record DistinctConsume(OpBase *opBase) {
 			op->mapping = record_mapping;
 		}
 
+		bool found;
+		DistinctKey key = {op, r};
 		unsigned long long const hash = _compute_hash(op, r);
-		int is_new = HashTableAddRaw(op->found, (void *)hash, NULL) != NULL;
-		if(is_new) return r;
+		void **entry = FlatMap_FindOrInsert(op->found, hash, _DistinctKeyEq,
+				&key, &found);
+		if(!found) {
+			*entry = _CopyValues(op, r);
+			return r;
+		}
 		OpBase_DeleteRecord(&r);
 	}
 }
@@ -114,7 +170,7 @@ static OpResult DistinctReset
 	OpDistinct *op = (OpDistinct *)opBase;
 
 	if(op->found) {
-		HashTableEmpty(op->found, NULL);
+		FlatMap_Clear(op->found, _FreeValues);
 	}
 
 	return OP_OK;
@@ -123,8 +179,7 @@ static OpResult DistinctReset
 static void DistinctFree(OpBase *ctx) {
 	OpDistinct *op = (OpDistinct *)ctx;
 	if(op->found) {
-		HashTableRelease(op->found);
-		op->found = NULL;
+		FlatMap_Free(&op->found, _FreeValues);
 	}
 
 	if(op->aliases) {
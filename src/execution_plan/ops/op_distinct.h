@@ -7,12 +7,12 @@
 #pragma once
 
 #include "op.h"
-#include "../../util/dict.h"
+#include "../../util/flat_map.h"
 #include "../execution_plan.h"
 
 typedef struct {
 	OpBase op;
-	dict *found;
+	FlatMap found;         // distinct values seen, keyed by their hash
 	rax *mapping;          // record mapping
 	uint *offsets;         // offsets to expression values
 	const char **aliases;  // expression aliases to distinct by
@@ -156,7 +156,7 @@ static inline void _UpdateRecord
 	int res;
 	UNUSED(res);
 	
-	Edge e = GE_NEW_LABELED_EDGE(op->edge->reltypes[0], op->edge->reltypeIDs[0]);
+	Edge e = GE_NEW_LABELED_EDGE(op->edge->reltypeIDs[0]);
 
 	e.src_id   =  edge_key->src_id;
 	e.dest_id  =  edge_key->dest_id;
@@ -165,18 +165,13 @@ static inline void _UpdateRecord
 	res = Graph_GetEdge(op->g, edge_id, &e);
 	ASSERT(res != 0);
 
+	// endpoints' attributes are resolved on access
 	if(!op->srcAware) {
-		Node src = GE_NEW_NODE();
-		res = Graph_GetNode(op->g, e.src_id, &src);
-		ASSERT(res != 0);
-		Record_AddNode(r, op->srcRecIdx, src);
+		Record_AddNodeID(r, op->srcRecIdx, e.src_id);
 	}
 
 	if(!op->destAware) {
-		Node dest = GE_NEW_NODE();
-		res = Graph_GetNode(op->g, e.dest_id, &dest);
-		ASSERT(res != 0);
-		Record_AddNode(r, op->destRecIdx, dest);
+		Record_AddNodeID(r, op->destRecIdx, e.dest_id);
 	}
 
 	Record_AddEdge(r, op->edgeRecIdx, e);
@@ -195,13 +190,13 @@ static inline bool _PassUnresolvedFilters
 
 static void UpdateCurrentAwareIds(const OpEdgeIndexScan *op) {
 	if(op->current_src_node_id) {
-		Node *n = Record_GetNode(op->child_record, op->srcRecIdx);
-		op->current_src_node_id->operand.constant = SI_LongVal(ENTITY_GET_ID(n));
+		NodeID id = Record_GetNodeID(op->child_record, op->srcRecIdx);
+		op->current_src_node_id->operand.constant = SI_LongVal(id);
 	}
 
 	if(op->current_dest_node_id) {
-		Node *n = Record_GetNode(op->child_record, op->destRecIdx);
-		op->current_dest_node_id->operand.constant = SI_LongVal(ENTITY_GET_ID(n));
+		NodeID id = Record_GetNodeID(op->child_record, op->destRecIdx);
+		op->current_dest_node_id->operand.constant = SI_LongVal(id);
 	}
 }
 
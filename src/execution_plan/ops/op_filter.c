@@ -11,6 +11,7 @@
 static Record FilterConsume(OpBase *opBase);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
+static bool FilterRestore(OpBase *opBase, const OpBase *origin);
 
 OpBase *NewFilterOp
 (
@@ -23,6 +24,7 @@ OpBase *NewFilterOp
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
 				NULL, NULL, FilterClone, FilterFree, false, plan);
+	op->op.restore = FilterRestore;
 
 	return (OpBase *)op;
 }
@@ -59,6 +61,19 @@ static inline OpBase *FilterClone
 	return NewFilterOp(plan, FilterTree_Clone(op->filterTree));
 }
 
+// runtime optimizations compact the filter tree and evaluation replaces
+// its parameters by constants, restore the filter tree from origin
+static bool FilterRestore
+(
+	OpBase *opBase,
+	const OpBase *origin
+) {
+	OpFilter *filter = (OpFilter *)opBase;
+	FilterTree_Free(filter->filterTree);
+	filter->filterTree = FilterTree_Clone(((const OpFilter *)origin)->filterTree);
+	return true;
+}
+
 // frees OpFilter
 static void FilterFree
 (
@@ -14,6 +14,7 @@ static Record LimitConsume(OpBase *opBase);
 static OpResult LimitReset(OpBase *opBase);
 static void LimitFree(OpBase *opBase);
 static OpBase *LimitClone(const ExecutionPlan *plan, const OpBase *opBase);
+static bool LimitRestore(OpBase *opBase, const OpBase *origin);
 
 static void _eval_limit(OpLimit *op, AR_ExpNode *limit_exp) {
 	/* Store a copy of the original expression.
@@ -51,6 +52,7 @@ OpBase *NewLimitOp(const ExecutionPlan *plan, AR_ExpNode *limit_exp) {
 	// set operations
 	OpBase_Init((OpBase *)op, OPType_LIMIT, "Limit", NULL, LimitConsume, LimitReset, NULL,
 				LimitClone, LimitFree, false, plan);
+	op->op.restore = LimitRestore;
 
 	return (OpBase *)op;
 }
@@ -84,6 +86,16 @@ static inline OpBase *LimitClone(const ExecutionPlan *plan, const OpBase *opBase
 	return NewLimitOp(plan, limit_exp);
 }
 
+/* The limit is evaluated once the operation is constructed,
+ * a parameterized limit can't be carried over to another execution. */
+static bool LimitRestore(OpBase *opBase, const OpBase *origin) {
+	OpLimit *op = (OpLimit *)opBase;
+	if(!AR_EXP_IsConstant(op->limit_exp)) return false;
+
+	LimitReset(opBase);
+	return true;
+}
+
 static void LimitFree(OpBase *opBase) {
 	OpLimit *op = (OpLimit *)opBase;
 
@@ -10,6 +10,7 @@
 #include "../../query_ctx.h"
 #include "../../errors/errors.h"
 #include "../../schema/schema.h"
+#include "../../index/hash_index.h"
 #include "../../util/rax_extensions.h"
 #include "../../arithmetic/arithmetic_expression.h"
 #include "../execution_plan_build/execution_plan_util.h"
@@ -20,28 +21,14 @@ static Record MergeConsume(OpBase *opBase);
 static OpBase *MergeClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void MergeFree(OpBase *opBase);
 
-// fake hash function
-// hash of key is simply key
-static uint64_t _id_hash
-(
-	const void *key
-) {
-	return ((uint64_t)key);
-}
-
 // hashtable entry free callback
 static void freeCallback
 (
-	dict *d,
 	void *val
 ) {
 	PendingUpdateCtx_Free((PendingUpdateCtx*)val);
 }
 
-// hashtable callbacks
-static dictType _dt = { _id_hash, NULL, NULL, NULL, NULL, freeCallback, NULL,
-	NULL, NULL, NULL};
-
 //------------------------------------------------------------------------------
 // ON MATCH / ON CREATE logic
 //------------------------------------------------------------------------------
@@ -49,8 +36,8 @@ static dictType _dt = { _id_hash, NULL, NULL, NULL, NULL, freeCallback, NULL,
 // apply a set of updates to the given records
 static void _UpdateProperties
 (
-	dict *node_pending_updates,
-	dict *edge_pending_updates,
+	FlatMap node_pending_updates,
+	FlatMap edge_pending_updates,
 	raxIterator updates,
 	Record *records,
 	uint record_count
@@ -100,19 +87,186 @@ static void _InitializeUpdates
 
 }
 
+//------------------------------------------------------------------------------
+// constraint lookup
+//------------------------------------------------------------------------------
+
+// determine if the merge pattern can be matched via a unique constraint
+// hash index lookup instead of running the match stream for each input record
+// this is the case for a single node pattern e.g.
+// UNWIND $rows AS r MERGE (n:User {id: r.id})
+// where one of the node's labels has a unique constraint over one of
+// the pattern's attributes
+// patterns over non-unique indexed attributes are matched by the match
+// stream's index scan
+static void _Merge_SetLookup
+(
+	OpMerge *op
+) {
+	OpMergeCreate *create = (OpMergeCreate *)op->create_stream;
+
+	// pattern must introduce a single node and no edges
+	if(array_len(create->pending.nodes.nodes_to_create) != 1 ||
+	   array_len(create->pending.edges) != 0) {
+		return;
+	}
+
+	NodeCreateCtx *n = create->pending.nodes.nodes_to_create;
+	PropertyMap *map = n->properties;
+	uint label_count = array_len(n->labels);
+	if(map == NULL || label_count == 0) {
+		return;
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	uint attr_count  = array_len(map->keys);
+
+	// resolve labels, a missing label means no constraint
+	LabelID *labels = array_new(LabelID, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchema(gc, n->labels[i], SCHEMA_NODE);
+		if(s == NULL) {
+			array_free(labels);
+			return;
+		}
+		array_append(labels, Schema_GetID(s));
+	}
+
+	// resolve attributes, a missing attribute is set to ATTRIBUTE_ID_NONE
+	AttributeID *attrs = array_new(AttributeID, attr_count);
+	for(uint i = 0; i < attr_count; i++) {
+		array_append(attrs, GraphContext_GetAttributeID(gc, map->keys[i]));
+	}
+
+	// search for a single attribute unique constraint over
+	// one of the pattern's labels and attributes
+	for(uint i = 0; i < label_count; i++) {
+		Schema *s = GraphContext_GetSchemaByID(gc, labels[i], SCHEMA_NODE);
+		for(uint j = 0; j < attr_count; j++) {
+			if(attrs[j] == ATTRIBUTE_ID_NONE) {
+				continue;
+			}
+
+			Constraint c = Schema_GetConstraint(s, CT_UNIQUE, attrs + j, 1);
+			if(c != NULL && Constraint_GetStatus(c) == CT_ACTIVE) {
+				op->lookup_constraint = c;
+				op->lookup_node       = n;
+				op->lookup_labels     = labels;
+				op->lookup_attrs      = attrs;
+				op->lookup_key        = j;
+				return;
+			}
+		}
+	}
+
+	array_free(attrs);
+	array_free(labels);
+}
+
+// check if node 'id' satisfies the merge pattern
+static bool _Merge_NodeMatches
+(
+	OpMerge *op,           // merge op
+	Graph *g,              // graph
+	EntityID id,           // candidate node
+	const SIValue *values  // evaluated property map values
+) {
+	Node n = GE_NEW_NODE();
+	int res = Graph_GetNode(g, id, &n);
+	ASSERT(res != 0);
+
+	uint label_count = array_len(op->lookup_labels);
+	for(uint i = 0; i < label_count; i++) {
+		if(!Graph_IsNodeLabeled(g, id, op->lookup_labels[i])) {
+			return false;
+		}
+	}
+
+	uint attr_count = array_len(op->lookup_attrs);
+	for(uint i = 0; i < attr_count; i++) {
+		SIValue *v = GraphEntity_GetProperty((GraphEntity *)&n,
+				op->lookup_attrs[i]);
+		if(v == ATTRIBUTE_NOTFOUND) {
+			return false;
+		}
+
+		int disjointOrNull = 0;
+		if(SIValue_Compare(*v, values[i], &disjointOrNull) != 0 ||
+		   disjointOrNull == COMPARED_NULL || disjointOrNull == DISJOINT) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// resolve the merge pattern for record 'r' using the hash index
+// returns false if the record can't be resolved via the hash index
+// otherwise 'node' is set to the matched node ID or INVALID_ENTITY_ID
+static bool _Merge_Lookup
+(
+	OpMerge *op,     // merge op
+	HashIndex hidx,  // constraint hash index
+	Record r,        // input record
+	EntityID *node   // [output] matched node
+) {
+	PropertyMap *map = op->lookup_node->properties;
+	uint attr_count  = array_len(op->lookup_attrs);
+	SIValue values[attr_count];
+
+	for(uint i = 0; i < attr_count; i++) {
+		values[i] = AR_EXP_Evaluate(map->values[i], r);
+	}
+
+	bool res = true;
+	*node = INVALID_ENTITY_ID;
+
+	// a missing attribute or a NULL value never match
+	for(uint i = 0; i < attr_count; i++) {
+		if(op->lookup_attrs[i] == ATTRIBUTE_ID_NONE ||
+		   SI_TYPE(values[i]) == T_NULL) {
+			goto cleanup;
+		}
+	}
+
+	uint64_t key;
+	if(!Constraint_HashKey(values + op->lookup_key, 1, &key)) {
+		// value can't be looked up, fall back to the match stream
+		res = false;
+		goto cleanup;
+	}
+
+	EntityID id;
+	HashIndexIterator it;
+	Graph *g = QueryCtx_GetGraph();
+	HashIndex_Find(hidx, key, &it);
+	while(HashIndexIterator_Next(&it, &id)) {
+		// keys may collide, validate candidate
+		if(_Merge_NodeMatches(op, g, id, values)) {
+			*node = id;
+			break;
+		}
+	}
+
+cleanup:
+	for(uint i = 0; i < attr_count; i++) {
+		SIValue_Free(values[i]);
+	}
+
+	return res;
+}
+
 // free node and edge pending updates
 static inline void _free_pending_updates
 (
 	OpMerge *op
 ) {
 	if(op->node_pending_updates) {
-		HashTableRelease(op->node_pending_updates);
-		op->node_pending_updates = NULL;
+		FlatMap_Free(&op->node_pending_updates, freeCallback);
 	}
 
 	if(op->edge_pending_updates) {
-		HashTableRelease(op->edge_pending_updates);
-		op->edge_pending_updates = NULL;
+		FlatMap_Free(&op->edge_pending_updates, freeCallback);
 	}
 }
 
@@ -193,6 +347,9 @@ static OpResult MergeInit
 	// set up an array to store records produced by the bound variable stream
 	op->input_records = array_new(Record, 1);
 
+	// see if input records can be matched via a constraint lookup
+	_Merge_SetLookup(op);
+
 	return OP_OK;
 }
 
@@ -243,6 +400,12 @@ static Record MergeConsume
 	uint match_count          = 0;
 	bool reading_matches      = true;
 	bool must_create_records  = false;
+
+	// constraint's hash index, NULL if not populated yet
+	HashIndex hidx = (op->lookup_constraint != NULL)
+		? Constraint_GetHashIndex(op->lookup_constraint)
+		: NULL;
+
 	// match mode: attempt to resolve the pattern for every record from
 	// the bound variable stream, or once if we have no bound variables
 	while(reading_matches) {
@@ -257,6 +420,28 @@ static Record MergeConsume
 			// pull a new input record
 			lhs_record = array_pop(op->input_records);
 
+			// try resolving the pattern via the constraint's hash index
+			// in place of the match stream, preserving the records order
+			EntityID id;
+			if(hidx != NULL && _Merge_Lookup(op, hidx, lhs_record, &id)) {
+				if(id != INVALID_ENTITY_ID) {
+					// pattern matched
+					Node node = GE_NEW_NODE();
+					Graph_GetNode(QueryCtx_GetGraph(), id, &node);
+					Record_AddNode(lhs_record, op->lookup_node->node_idx, node);
+					array_append(op->output_records, lhs_record);
+					match_count++;
+				} else {
+					// duplicates are resolved by the create stream
+					Argument_AddRecord(op->create_argument_tap, lhs_record);
+					Record r = _pullFromStream(op->create_stream);
+					UNUSED(r);
+					ASSERT(r == NULL);
+					must_create_records = true;
+				}
+				continue;
+			}
+
 			// propagate record to the top of the Match stream
 			// (must clone the Record, as it will be freed in the Match stream)
 			Argument_AddRecord(op->match_argument_tap, OpBase_CloneRecord(lhs_record));
@@ -310,8 +495,8 @@ static Record MergeConsume
 	}
 	OpBase_PropagateReset(op->match_stream);
 
-	op->node_pending_updates = HashTableCreate(&_dt);
-	op->edge_pending_updates = HashTableCreate(&_dt);
+	op->node_pending_updates = FlatMap_New(0);
+	op->edge_pending_updates = FlatMap_New(0);
 
 	// if we are setting properties with ON MATCH, compute all pending updates
 	if(op->on_match && match_count > 0) {
@@ -350,8 +535,8 @@ static Record MergeConsume
 	// update
 	//--------------------------------------------------------------------------
 
-	if(HashTableElemCount(op->node_pending_updates) > 0 ||
-	   HashTableElemCount(op->edge_pending_updates) > 0) {
+	if(FlatMap_Count(op->node_pending_updates) > 0 ||
+	   FlatMap_Count(op->edge_pending_updates) > 0) {
 		GraphContext *gc = QueryCtx_GetGraphCtx();
 		// lock everything
 		QueryCtx_LockForCommit(); {
@@ -366,8 +551,8 @@ static Record MergeConsume
 	// free updates
 	//--------------------------------------------------------------------------
 
-	HashTableEmpty(op->node_pending_updates, NULL);
-	HashTableEmpty(op->edge_pending_updates, NULL);
+	FlatMap_Clear(op->node_pending_updates, freeCallback);
+	FlatMap_Clear(op->edge_pending_updates, freeCallback);
 
 	return _handoff(op);
 }
@@ -419,6 +604,16 @@ static void MergeFree
 
 	_free_pending_updates(op);
 
+	if(op->lookup_labels) {
+		array_free(op->lookup_labels);
+		op->lookup_labels = NULL;
+	}
+
+	if(op->lookup_attrs) {
+		array_free(op->lookup_attrs);
+		op->lookup_attrs = NULL;
+	}
+
 	if(op->on_match) {
 		raxFreeWithCallback(op->on_match, (void(*)(void *))UpdateCtx_Free);
 		op->on_match = NULL;
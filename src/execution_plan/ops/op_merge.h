@@ -10,6 +10,7 @@
 #include "op_argument.h"
 #include "../execution_plan.h"
 #include "shared/update_functions.h"
+#include "../../constraint/constraint.h"
 #include "../../resultset/resultset_statistics.h"
 
 // the Merge operation accepts exactly one path in the query and attempts to match it
@@ -29,8 +30,13 @@ typedef struct {
 	rax *on_create;                 // updates to be performed on creation
 	raxIterator on_match_it;        // iterator for traversing ON MATCH update contexts
 	raxIterator on_create_it;       // iterator for traversing ON CREATE update contexts
-	dict *node_pending_updates;     // pending updates to apply, generated
-	dict *edge_pending_updates;     // pending updates to apply, generated
+	FlatMap node_pending_updates;   // pending updates to apply, generated
+	FlatMap edge_pending_updates;   // pending updates to apply, generated
+	Constraint lookup_constraint;   // unique constraint used to look up matches
+	NodeCreateCtx *lookup_node;     // single node pattern resolved by lookup
+	LabelID *lookup_labels;         // pattern's label IDs
+	AttributeID *lookup_attrs;      // pattern's property map attribute IDs
+	uint lookup_key;                // constrained attribute position in property map
 } OpMerge;
 
 OpBase *NewMergeOp
@@ -247,7 +247,6 @@ static bool _CreateEntities(OpMergeCreate *op, Record r, GraphContext *gc) {
 
 			// create edge
 			Edge newEdge = {0};
-			newEdge.relationship = ctx->relation;
 			Edge *e = Record_AddEdge(r, ctx->edge_idx, newEdge);
 			Edge_SetSrcNodeID(e, ENTITY_GET_ID(src_node));
 			Edge_SetDestNodeID(e, ENTITY_GET_ID(dest_node));
@@ -6,8 +6,12 @@
 
 #include "op_node_by_index_scan.h"
 #include "../../query_ctx.h"
+#include "../../util/arr.h"
 #include "../../index/index.h"
 #include "shared/print_functions.h"
+#include "../../index/hash_index.h"
+#include "../../datatypes/array.h"
+#include "../../filter_tree/filter_tree_utils.h"
 
 // forward declarations
 static OpResult IndexScanInit(OpBase *opBase);
@@ -15,6 +19,7 @@ static Record IndexScanConsume(OpBase *opBase);
 static Record IndexScanConsumeFromChild(OpBase *opBase);
 static OpResult IndexScanReset(OpBase *opBase);
 static void IndexScanFree(OpBase *opBase);
+static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id);
 
 static void IndexScanToString(const OpBase *ctx, sds *buf) {
 	IndexScan *op = (IndexScan *)ctx;
@@ -42,6 +47,12 @@ OpBase *NewIndexScanOp
 	op->iter                = NULL;
 	op->filter              = filter;
 	op->child_record        = NULL;
+	op->constraint          = NULL;
+	op->lookup_exp          = NULL;
+	op->lookup_ids          = NULL;
+	op->lookup_pos          = 0;
+	op->lookup_list         = false;
+	op->hash_lookup         = false;
 	op->unresolved_filters  = NULL;
 	op->rebuild_index_query = false;
 
@@ -53,6 +64,204 @@ OpBase *NewIndexScanOp
 	return (OpBase *)op;
 }
 
+// returns true if 'exp' extracts an attribute of 'alias'
+static bool _IsAliasAttribute
+(
+	const AR_ExpNode *exp,  // expression
+	const char *alias,      // entity alias
+	char **attr             // [output] attribute name
+) {
+	if(!AR_EXP_IsAttribute(exp, attr)) {
+		return false;
+	}
+
+	const AR_ExpNode *entity = exp->op.children[0];
+	return (AR_EXP_IsVariadic(entity) &&
+			strcmp(entity->operand.variadic.entity_alias, alias) == 0);
+}
+
+// search filter for an equality / IN predicate on an attribute of 'alias'
+// only predicates which must hold for the entire filter to pass are considered
+static bool _FindLookupPredicate
+(
+	const FT_FilterNode *filter,  // filter to search
+	const char *alias,            // scanned entity alias
+	char **attr,                  // [output] looked up attribute
+	AR_ExpNode **exp,             // [output] looked up value(s) expression
+	bool *list                    // [output] 'exp' evaluates to a list
+) {
+	if(filter->t == FT_N_COND) {
+		if(filter->cond.op != OP_AND) {
+			return false;
+		}
+
+		return (_FindLookupPredicate(filter->cond.left, alias, attr, exp, list)
+			|| _FindLookupPredicate(filter->cond.right, alias, attr, exp, list));
+	}
+
+	// n.v = exp
+	if(filter->t == FT_N_PRED) {
+		if(filter->pred.op == OP_EQUAL &&
+		   _IsAliasAttribute(filter->pred.lhs, alias, attr)) {
+			*exp  = filter->pred.rhs;
+			*list = false;
+			return true;
+		}
+		return false;
+	}
+
+	// n.v IN exp
+	if(isInFilter(filter)) {
+		AR_ExpNode *in = filter->exp.exp;
+		if(_IsAliasAttribute(in->op.children[0], alias, attr)) {
+			*exp  = in->op.children[1];
+			*list = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// check if the scan can be resolved by a unique constraint's hash index
+static void _IndexScan_SetHashLookup
+(
+	IndexScan *op
+) {
+	char        *attr = NULL;
+	AR_ExpNode  *exp  = NULL;
+	bool        list  = false;
+
+	if(!_FindLookupPredicate(op->filter, op->n->alias, &attr, &exp, &list)) {
+		return;
+	}
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	AttributeID attr_id = GraphContext_GetAttributeID(gc, attr);
+	if(attr_id == ATTRIBUTE_ID_NONE) {
+		return;
+	}
+
+	Schema *s = GraphContext_GetSchemaByID(gc, op->n->label_id, SCHEMA_NODE);
+	ASSERT(s != NULL);
+
+	Constraint c = Schema_GetConstraint(s, CT_UNIQUE, &attr_id, 1);
+	if(c == NULL || Constraint_GetStatus(c) != CT_ACTIVE) {
+		return;
+	}
+
+	op->constraint  = c;
+	op->lookup_exp  = exp;
+	op->lookup_list = list;
+	op->lookup_ids  = array_new(EntityID, 1);
+}
+
+// collect entities associated with 'v'
+// returns false if 'v' can't be looked up
+static bool _HashLookupValue
+(
+	IndexScan *op,   // index scan op
+	HashIndex hidx,  // hash index
+	SIValue v        // looked up value
+) {
+	// NULL never matches
+	if(SI_TYPE(v) == T_NULL) {
+		return true;
+	}
+
+	uint64_t key;
+	if(!Constraint_HashKey(&v, 1, &key)) {
+		return false;
+	}
+
+	EntityID id;
+	HashIndexIterator it;
+	HashIndex_Find(hidx, key, &it);
+	while(HashIndexIterator_Next(&it, &id)) {
+		array_append(op->lookup_ids, id);
+	}
+
+	return true;
+}
+
+static int _cmp_EntityID
+(
+	const void *a,
+	const void *b
+) {
+	EntityID _a = *(const EntityID *)a;
+	EntityID _b = *(const EntityID *)b;
+	return (_a > _b) - (_a < _b);
+}
+
+// resolve lookup using the constraint's hash index
+// returns false if the hash index can't be used
+// in which case the scan falls back to the RediSearch index
+static bool _HashLookup
+(
+	IndexScan *op,  // index scan op
+	Record r        // record to evaluate looked up value(s) against
+) {
+	HashIndex hidx = Constraint_GetHashIndex(op->constraint);
+	if(hidx == NULL) {
+		// hash index isn't populated yet
+		return false;
+	}
+
+	bool res = true;
+	op->lookup_pos = 0;
+	array_clear(op->lookup_ids);
+
+	SIValue v = AR_EXP_Evaluate(op->lookup_exp, r);
+
+	if(!op->lookup_list) {
+		res = _HashLookupValue(op, hidx, v);
+	} else if(SI_TYPE(v) == T_ARRAY) {
+		uint n = SIArray_Length(v);
+		for(uint i = 0; i < n && res; i++) {
+			res = _HashLookupValue(op, hidx, SIArray_Get(v, i));
+		}
+
+		// a list may contain the same value multiple times
+		uint count = array_len(op->lookup_ids);
+		if(res && count > 1) {
+			qsort(op->lookup_ids, count, sizeof(EntityID), _cmp_EntityID);
+			uint j = 0;
+			for(uint i = 1; i < count; i++) {
+				if(op->lookup_ids[i] != op->lookup_ids[j]) {
+					op->lookup_ids[++j] = op->lookup_ids[i];
+				}
+			}
+			op->lookup_ids = array_trimm_len(op->lookup_ids, j + 1);
+		}
+	} else {
+		res = (SI_TYPE(v) == T_NULL);
+	}
+
+	SIValue_Free(v);
+
+	return res;
+}
+
+// emit next entity matched by the hash lookup
+// the entire filter is applied as hash keys may collide
+static bool _HashLookupNext
+(
+	IndexScan *op,  // index scan op
+	Record r        // record to populate
+) {
+	uint count = array_len(op->lookup_ids);
+	while(op->lookup_pos < count) {
+		EntityID id = op->lookup_ids[op->lookup_pos++];
+		_UpdateRecord(op, r, id);
+		if(FilterTree_applyFilters(op->filter, r) == FILTER_PASS) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 static OpResult IndexScanInit(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 
@@ -76,15 +285,16 @@ static OpResult IndexScanInit(OpBase *opBase) {
 		op->n->label_id = schema->id;
 	}
 
+	// prefer a unique constraint's hash index for equality lookups
+	_IndexScan_SetHashLookup(op);
+
 	return OP_OK;
 }
 
 static inline void _UpdateRecord(IndexScan *op, Record r, EntityID node_id) {
-	// Populate the Record with the graph entity data.
-	Node n = GE_NEW_NODE();
-	int res = Graph_GetNode(op->g, node_id, &n);
-	ASSERT(res != 0);
-	Record_AddNode(r, op->nodeRecIdx, n);
+	// Populate the Record with the node's ID,
+	// its attributes are resolved once accessed.
+	Record_AddNodeID(r, op->nodeRecIdx, node_id);
 }
 
 static inline bool _PassUnresolvedFilters(const IndexScan *op, Record r) {
@@ -103,7 +313,12 @@ pull_index:
 	// pull from index
 	//--------------------------------------------------------------------------
 
-	if(op->iter != NULL && op->child_record != NULL) {
+	if(op->hash_lookup && op->child_record != NULL) {
+		if(_HashLookupNext(op, op->child_record)) {
+			// clone the held Record, as it will be freed upstream
+			return OpBase_CloneRecord(op->child_record);
+		}
+	} else if(op->iter != NULL && op->child_record != NULL) {
 		while((nodeId = RediSearch_ResultsIteratorNext(op->iter, rsIdx, NULL))
 				!= NULL) {
 			// populate record with node
@@ -136,6 +351,13 @@ pull_index:
 	// reset index iterator
 	//--------------------------------------------------------------------------
 
+	if(op->constraint != NULL) {
+		op->hash_lookup = _HashLookup(op, op->child_record);
+		if(op->hash_lookup) {
+			goto pull_index;
+		}
+	}
+
 	if(op->rebuild_index_query) {
 		// free previous iterator
 		if(op->iter != NULL) {
@@ -194,6 +416,22 @@ static Record IndexScanConsume(OpBase *opBase) {
 	IndexScan *op = (IndexScan *)opBase;
 	RSIndex *rsIdx = Index_RSIndex(op->idx);
 
+	// populate the Record with the actual node
+	Record r = OpBase_CreateRecord((OpBase *)op);
+
+	// try resolving lookup using the hash index on first call
+	if(op->iter == NULL && !op->hash_lookup && op->constraint != NULL) {
+		op->hash_lookup = _HashLookup(op, r);
+	}
+
+	if(op->hash_lookup) {
+		if(_HashLookupNext(op, r)) {
+			return r;
+		}
+		OpBase_DeleteRecord(&r);
+		return NULL;
+	}
+
 	// create iterator on first call
 	if(op->iter == NULL) {
 		RSQNode *rs_query_node = Index_BuildQueryTree(&op->unresolved_filters,
@@ -203,9 +441,6 @@ static Record IndexScanConsume(OpBase *opBase) {
 	}
 
 	const EntityID *nodeId = NULL;
-
-	// populate the Record with the actual node
-	Record r = OpBase_CreateRecord((OpBase *)op);
 	while((nodeId = RediSearch_ResultsIteratorNext(op->iter, rsIdx, NULL))
 			!= NULL) {
 		// populate record with node
@@ -234,6 +469,9 @@ static OpResult IndexScanReset(OpBase *opBase) {
 		op->unresolved_filters = NULL;
 	}
 
+	op->lookup_pos  = 0;
+	op->hash_lookup = false;
+
 	return OP_OK;
 }
 
@@ -266,5 +504,10 @@ static void IndexScanFree(OpBase *opBase) {
 		NodeScanCtx_Free(op->n);
 		op->n = NULL;
 	}
+
+	if(op->lookup_ids != NULL) {
+		array_free(op->lookup_ids);
+		op->lookup_ids = NULL;
+	}
 }
 
@@ -23,6 +23,12 @@ typedef struct {
 	FT_FilterNode *filter;              // filter from which to compose index query
 	FT_FilterNode *unresolved_filters;  // subset of filter, contains filters that couldn't be resolved by index
 	Record child_record;                // the Record this op acts on if it is not a tap
+	Constraint constraint;              // unique constraint offering hash lookups
+	AR_ExpNode *lookup_exp;             // expression evaluating to looked up value(s)
+	bool lookup_list;                   // lookup_exp evaluates to a list (IN)
+	bool hash_lookup;                   // current lookup resolved by hash index
+	EntityID *lookup_ids;               // entities matched by hash lookup
+	uint lookup_pos;                    // next entity to emit
 } IndexScan;
 
 // creates a new IndexScan operation
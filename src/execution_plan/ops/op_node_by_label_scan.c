@@ -21,6 +21,7 @@ static Record NodeByLabelScanNoOp(OpBase *opBase);
 static OpResult NodeByLabelScanReset(OpBase *opBase);
 static OpBase *NodeByLabelScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void NodeByLabelScanFree(OpBase *opBase);
+static bool NodeByLabelScanRestore(OpBase *opBase, const OpBase *origin);
 
 static inline void NodeByLabelScanToString
 (
@@ -64,6 +65,7 @@ OpBase *NewNodeByLabelScanOp
 			NodeByLabelScanInit, NodeByLabelScanConsume, NodeByLabelScanReset,
 			NodeByLabelScanToString, NodeByLabelScanClone, NodeByLabelScanFree,
 			false, plan);
+	op->op.restore = NodeByLabelScanRestore;
 
 	op->nodeRecIdx = OpBase_Modifies((OpBase *)op, n->alias);
 
@@ -169,10 +171,9 @@ static inline void _UpdateRecord
 	Record r,
 	GrB_Index node_id
 ) {
-	// populate the Record with the graph entity data
-	Node n = GE_NEW_NODE();
-	Graph_GetNode(op->g, node_id, &n);
-	Record_AddNode(r, op->nodeRecIdx, n);
+	// populate the Record with the node's ID
+	// its attributes are resolved once accessed
+	Record_AddNodeID(r, op->nodeRecIdx, node_id);
 }
 
 //------------------------------------------------------------------------------
@@ -367,6 +368,37 @@ static OpResult NodeByLabelScanReset
 	return OP_OK;
 }
 
+// the label iterator is attached once the op is initialized
+static bool NodeByLabelScanRestore
+(
+	OpBase *opBase,
+	const OpBase *origin
+) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	// ID ranges are evaluated against the query's parameters
+	if(array_len(op->ranges) > 0) {
+		return false;
+	}
+
+	// the scanned label was swapped by a runtime optimization
+	if(strcmp(op->n->label, ((const NodeByLabelScan *)origin)->n->label) != 0) {
+		return false;
+	}
+
+	GrB_Info info = Delta_MatrixTupleIter_detach(&(op->iter));
+	ASSERT(info == GrB_SUCCESS);
+
+	if(op->child_record) {
+		OpBase_DeleteRecord(&op->child_record);
+	}
+
+	op->L = NULL;
+	OpBase_UpdateConsume(opBase, NodeByLabelScanConsume);
+
+	return true;
+}
+
 static OpBase *NodeByLabelScanClone
 (
 	const ExecutionPlan *plan,
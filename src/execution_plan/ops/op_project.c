@@ -16,6 +16,7 @@ static Record ProjectConsume(OpBase *opBase);
 static OpResult ProjectReset(OpBase *opBase);
 static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ProjectFree(OpBase *opBase);
+static bool ProjectRestore(OpBase *opBase, const OpBase *origin);
 
 OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	OpProject *op = rm_malloc(sizeof(OpProject));
@@ -29,6 +30,7 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_PROJECT, "Project", NULL, ProjectConsume,
 				ProjectReset, NULL, ProjectClone, ProjectFree, false, plan);
+	op->op.restore = ProjectRestore;
 
 	for(uint i = 0; i < op->exp_count; i ++) {
 		// The projected record will associate values with their resolved name
@@ -108,6 +110,26 @@ static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	return NewProjectOp(plan, exps);
 }
 
+// evaluated expressions had their parameters replaced by constants
+// restore them from origin
+static bool ProjectRestore(OpBase *opBase, const OpBase *origin) {
+	OpProject *op = (OpProject *)opBase;
+	const OpProject *o = (const OpProject *)origin;
+	ASSERT(op->exp_count == o->exp_count);
+
+	ProjectReset(opBase);
+
+	if(op->r) OpBase_DeleteRecord(&op->r);
+	if(op->projection) OpBase_DeleteRecord(&op->projection);
+
+	for(uint i = 0; i < op->exp_count; i++) {
+		AR_EXP_Free(op->exps[i]);
+		op->exps[i] = AR_EXP_Clone(o->exps[i]);
+	}
+
+	return true;
+}
+
 void ProjectBindToPlan
 (
 	OpBase *opBase,            // op to bind
@@ -17,6 +17,7 @@
 static Record ResultsConsume(OpBase *opBase);
 static OpResult ResultsInit(OpBase *opBase);
 static OpBase *ResultsClone(const ExecutionPlan *plan, const OpBase *opBase);
+static bool ResultsRestore(OpBase *opBase, const OpBase *origin);
 
 OpBase *NewResultsOp(const ExecutionPlan *plan) {
 	Results *op = rm_malloc(sizeof(Results));
@@ -24,6 +25,7 @@ OpBase *NewResultsOp(const ExecutionPlan *plan) {
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_RESULTS, "Results", ResultsInit, ResultsConsume,
 				NULL, NULL, ResultsClone, NULL, false, plan);
+	op->op.restore = ResultsRestore;
 
 	return (OpBase *)op;
 }
@@ -58,7 +60,10 @@ static Record ResultsConsume(OpBase *opBase) {
 	if(!r) return NULL;
 
 	// append to final result set
-	ResultSet_AddRecord(op->result_set, r);
+	// stop consuming once the resultset refuses additional records
+	if(ResultSet_AddRecord(op->result_set, r) == RESULTSET_FULL) {
+		op->result_set_size_limit = 0;
+	}
 	return r;
 }
 
@@ -66,3 +71,10 @@ static inline OpBase *ResultsClone(const ExecutionPlan *plan, const OpBase *opBa
 	ASSERT(opBase->type == OPType_RESULTS);
 	return NewResultsOp(plan);
 }
+
+// the result set is acquired once the op is initialized
+static bool ResultsRestore(OpBase *opBase, const OpBase *origin) {
+	Results *op = (Results *)opBase;
+	op->result_set = NULL;
+	return true;
+}
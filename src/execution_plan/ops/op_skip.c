@@ -14,6 +14,7 @@ static Record SkipConsume(OpBase *opBase);
 static OpResult SkipReset(OpBase *opBase);
 static void SkipFree(OpBase *opBase);
 static OpBase *SkipClone(const ExecutionPlan *plan, const OpBase *opBase);
+static bool SkipRestore(OpBase *opBase, const OpBase *origin);
 
 static void _eval_skip
 (
@@ -57,6 +58,7 @@ OpBase *NewSkipOp
 	// set operations
 	OpBase_Init((OpBase *)op, OPType_SKIP, "Skip", NULL, SkipConsume, SkipReset,
 			NULL, SkipClone, SkipFree, false, plan);
+	op->op.restore = SkipRestore;
 
 	return (OpBase *)op;
 }
@@ -99,6 +101,16 @@ static inline OpBase *SkipClone(const ExecutionPlan *plan, const OpBase *opBase)
 	return NewSkipOp(plan, skip_exp);
 }
 
+// the skip is evaluated once the operation is constructed
+// a parameterized skip can't be carried over to another execution
+static bool SkipRestore(OpBase *opBase, const OpBase *origin) {
+	OpSkip *op = (OpSkip *)opBase;
+	if(!AR_EXP_IsConstant(op->skip_exp)) return false;
+
+	SkipReset(opBase);
+	return true;
+}
+
 static void SkipFree(OpBase *opBase) {
 	OpSkip *op = (OpSkip *)opBase;
 
@@ -11,8 +11,33 @@
 #include "../../query_ctx.h"
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../configuration/config.h"
 #include "../execution_plan_build/execution_plan_util.h"
 
+#include <math.h>
+
+// minimum number of records sorted by multiple threads
+#define PARALLEL_SORT_THRESHOLD 1000000
+
+// normalized sort key of a single value
+// keys order the same way as their values, direction included
+// when two keys are equal and either isn't exact the values are compared
+typedef struct {
+	uint64_t payload;  // order preserving encoding of the value
+	uint32_t tag;      // value's type class
+	uint32_t exact;    // key fully represents the value
+} SortKey;
+
+// record to sort followed by its sort keys
+typedef struct {
+	Record r;        // record
+	SortKey keys[];  // one key per sort expression
+} SortEntry;
+
+// entry at position 'i' of an entries buffer
+#define SORT_ENTRY(base, i, stride) \
+	((SortEntry *)((char *)(base) + (size_t)(i) * (stride)))
+
 // forward declarations
 static OpResult SortInit(OpBase *opBase);
 static Record SortConsume(OpBase *opBase);
@@ -43,13 +68,296 @@ static int _record_cmp
 	return 0;
 }
 
-static int _buffer_elem_cmp
+// order preserving encoding of a double
+static inline uint64_t _encode_double
+(
+	double d
+) {
+	// -0.0 and 0.0 are equal
+	if(d == 0) d = 0;
+
+	uint64_t bits;
+	memcpy(&bits, &d, sizeof(bits));
+
+	// flip all bits of negatives and the sign bit of positives
+	return (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+}
+
+// encode value 'v' into a sort key
+static void _encode_key
+(
+	SIValue v,      // value to encode
+	int direction,  // sort direction
+	SortKey *key    // [output] sort key
+) {
+	key->tag     = SI_TYPE(v);
+	key->exact   = true;
+	key->payload = 0;
+
+	switch(SI_TYPE(v)) {
+		case T_NULL:
+			break;
+		case T_BOOL:
+			key->payload = v.longval;
+			break;
+		case T_INT64:
+			// integers and floating points compare with one another
+			key->tag     = T_INT64;
+			key->payload = _encode_double((double)v.longval);
+			// integers beyond 2^53 lose precision
+			key->exact   = (v.longval >= -(1LL << 53) && v.longval <= (1LL << 53));
+			break;
+		case T_DOUBLE:
+			key->tag = T_INT64;
+			if(isnan(v.doubleval)) {
+				// NaN sorts after all other numerics
+				key->payload = UINT64_MAX;
+				key->exact   = false;
+			} else {
+				key->payload = _encode_double(v.doubleval);
+			}
+			break;
+		case T_STRING:
+		{
+			// big endian prefix of the string, zero padded
+			int i = 0;
+			const unsigned char *str = (const unsigned char *)v.stringval;
+			for(; i < 8 && str[i] != '\0'; i++) {
+				key->payload |= (uint64_t)str[i] << (56 - 8 * i);
+			}
+			// string fits within the key
+			key->exact = (i < 8);
+			break;
+		}
+		case T_NODE:
+		case T_EDGE:
+			key->payload = ENTITY_GET_ID((GraphEntity *)v.ptrval);
+			break;
+		default:
+			// rely on the values for ordering within the type
+			key->exact = false;
+			break;
+	}
+
+	// fold direction into the key
+	if(direction < 0) {
+		key->tag     = ~key->tag;
+		key->payload = ~key->payload;
+	}
+}
+
+// compare two sort entries
+static int _entry_cmp
+(
+	const void *a,
+	const void *b,
+	void *arg
+) {
+	const SortEntry *ea = (const SortEntry *)a;
+	const SortEntry *eb = (const SortEntry *)b;
+	OpSort *op = (OpSort *)arg;
+
+	uint comparison_count = array_len(op->record_offsets);
+	for(uint i = 0; i < comparison_count; i++) {
+		const SortKey *ka = ea->keys + i;
+		const SortKey *kb = eb->keys + i;
+
+		if(ka->tag != kb->tag) {
+			return (ka->tag < kb->tag) ? -1 : 1;
+		}
+		if(ka->payload != kb->payload) {
+			return (ka->payload < kb->payload) ? -1 : 1;
+		}
+		if(ka->exact && kb->exact) continue;
+
+		// keys are inconclusive, compare values
+		SIValue aVal = Record_Get(ea->r, op->record_offsets[i]);
+		SIValue bVal = Record_Get(eb->r, op->record_offsets[i]);
+		int rel = SIValue_Compare(aVal, bVal, NULL);
+		if(rel != 0) return rel * op->directions[i];
+	}
+
+	return 0;
+}
+
+// LSD radix sort entries by their first key's payload
+// skipping passes in which all entries share the same byte
+static void _radix_sort
+(
+	SortEntry *entries,  // entries to sort
+	SortEntry *tmp,      // scratch buffer of the same size
+	uint64_t n,          // number of entries
+	size_t stride        // entry size
+) {
+	SortEntry *src = entries;
+	SortEntry *dst = tmp;
+
+	for(int shift = 0; shift < 64; shift += 8) {
+		uint64_t counts[256] = {0};
+		for(uint64_t i = 0; i < n; i++) {
+			uint64_t payload = SORT_ENTRY(src, i, stride)->keys[0].payload;
+			counts[(payload >> shift) & 0xFF]++;
+		}
+
+		// all entries share this byte
+		if(counts[(SORT_ENTRY(src, 0, stride)->keys[0].payload >> shift) & 0xFF]
+				== n) {
+			continue;
+		}
+
+		uint64_t offset = 0;
+		for(int b = 0; b < 256; b++) {
+			uint64_t c = counts[b];
+			counts[b] = offset;
+			offset += c;
+		}
+
+		for(uint64_t i = 0; i < n; i++) {
+			SortEntry *e = SORT_ENTRY(src, i, stride);
+			uint64_t pos = counts[(e->keys[0].payload >> shift) & 0xFF]++;
+			memcpy(SORT_ENTRY(dst, pos, stride), e, stride);
+		}
+
+		SortEntry *t = src;
+		src = dst;
+		dst = t;
+	}
+
+	if(src != entries) {
+		memcpy(entries, src, n * stride);
+	}
+}
+
+// merge sorted runs src[lo..mid) and src[mid..hi) into dst[lo..hi)
+static void _merge
+(
+	const SortEntry *src,  // runs to merge
+	SortEntry *dst,        // merged output
+	uint64_t lo,           // first run start
+	uint64_t mid,          // second run start
+	uint64_t hi,           // second run end
+	size_t stride,         // entry size
+	OpSort *op             // sort operation
+) {
+	uint64_t i = lo;
+	uint64_t j = mid;
+	uint64_t k = lo;
+
+	while(i < mid && j < hi) {
+		const SortEntry *a = SORT_ENTRY(src, i, stride);
+		const SortEntry *b = SORT_ENTRY(src, j, stride);
+		if(_entry_cmp(b, a, op) < 0) {
+			memcpy(SORT_ENTRY(dst, k++, stride), b, stride);
+			j++;
+		} else {
+			memcpy(SORT_ENTRY(dst, k++, stride), a, stride);
+			i++;
+		}
+	}
+
+	memcpy(SORT_ENTRY(dst, k, stride), SORT_ENTRY(src, i, stride),
+			(mid - i) * stride);
+	k += mid - i;
+	memcpy(SORT_ENTRY(dst, k, stride), SORT_ENTRY(src, j, stride),
+			(hi - j) * stride);
+}
+
+// sort runs of entries on multiple threads and merge them pairwise
+static void _parallel_sort
+(
+	SortEntry *entries,  // entries to sort
+	SortEntry *tmp,      // scratch buffer of the same size
+	uint64_t n,          // number of entries
+	size_t stride,       // entry size
+	int threads,         // number of threads
+	OpSort *op           // sort operation
+) {
+	uint64_t run = (n + threads - 1) / threads;
+
+	#pragma omp parallel for num_threads(threads)
+	for(int i = 0; i < threads; i++) {
+		uint64_t lo = i * run;
+		if(lo >= n) continue;
+		uint64_t hi = (lo + run < n) ? lo + run : n;
+		sort_r(SORT_ENTRY(entries, lo, stride), hi - lo, stride, _entry_cmp,
+				op);
+	}
+
+	SortEntry *src = entries;
+	SortEntry *dst = tmp;
+
+	for(uint64_t width = run; width < n; width *= 2) {
+		int64_t pairs = (n + 2 * width - 1) / (2 * width);
+
+		#pragma omp parallel for num_threads(threads)
+		for(int64_t p = 0; p < pairs; p++) {
+			uint64_t lo  = p * 2 * width;
+			uint64_t mid = (lo + width < n) ? lo + width : n;
+			uint64_t hi  = (mid + width < n) ? mid + width : n;
+			_merge(src, dst, lo, mid, hi, stride, op);
+		}
+
+		SortEntry *t = src;
+		src = dst;
+		dst = t;
+	}
+
+	if(src != entries) {
+		memcpy(entries, src, n * stride);
+	}
+}
+
+// sort buffered records
+// sort keys are extracted once per record into normalized keys
+// which are cheap to compare
+static void _sort_buffer
 (
-	const Record *a,
-	const Record *b,
 	OpSort *op
 ) {
-	return _record_cmp(*a, *b, op);
+	uint64_t n = array_len(op->buffer);
+	if(n < 2) return;
+
+	uint key_count = array_len(op->record_offsets);
+	size_t stride = sizeof(SortEntry) + key_count * sizeof(SortKey);
+	SortEntry *entries = rm_malloc(n * stride);
+
+	// extract sort keys
+	// radix sort applies when a single key fully determines the order
+	bool radix = (key_count == 1);
+	for(uint64_t i = 0; i < n; i++) {
+		SortEntry *e = SORT_ENTRY(entries, i, stride);
+		e->r = op->buffer[i];
+		for(uint j = 0; j < key_count; j++) {
+			SIValue v = Record_Get(e->r, op->record_offsets[j]);
+			_encode_key(v, op->directions[j], e->keys + j);
+		}
+
+		radix = radix && e->keys[0].exact &&
+			e->keys[0].tag == entries->keys[0].tag;
+	}
+
+	int threads = 1;
+	if(!radix && n >= PARALLEL_SORT_THRESHOLD) {
+		Config_Option_get(Config_OPENMP_NTHREAD, &threads);
+	}
+
+	if(radix) {
+		SortEntry *tmp = rm_malloc(n * stride);
+		_radix_sort(entries, tmp, n, stride);
+		rm_free(tmp);
+	} else if(threads > 1) {
+		SortEntry *tmp = rm_malloc(n * stride);
+		_parallel_sort(entries, tmp, n, stride, threads, op);
+		rm_free(tmp);
+	} else {
+		sort_r(entries, n, stride, _entry_cmp, op);
+	}
+
+	for(uint64_t i = 0; i < n; i++) {
+		op->buffer[i] = SORT_ENTRY(entries, i, stride)->r;
+	}
+
+	rm_free(entries);
 }
 
 static void _accumulate
@@ -165,8 +473,7 @@ static Record SortConsume(OpBase *opBase) {
 	if(!newData) return NULL;
 
 	if(op->buffer) {
-		sort_r(op->buffer, array_len(op->buffer), sizeof(Record),
-				(heap_cmp)_buffer_elem_cmp, op);
+		_sort_buffer(op);
 	} else {
 		// heap
 		int records_count = Heap_count(op->heap);
@@ -7,20 +7,20 @@
 #pragma once
 
 #include "op.h"
-#include "../../util/dict.h"
+#include "../../util/flat_map.h"
 #include "../execution_plan.h"
 #include "shared/update_functions.h"
 #include "../../resultset/resultset_statistics.h"
 
 typedef struct {
 	OpBase op;
-	raxIterator it;      // iterator for traversing update contexts
-	uint64_t rec_idx;    // emit record index
-	Record *records;     // updated records
-	GraphContext *gc;    // graph context
-	rax *update_ctxs;    // entities to update and their expressions
-	dict *node_updates;  // enqueued node updates
-	dict *edge_updates;  // enqueued edge updates
+	raxIterator it;        // iterator for traversing update contexts
+	uint64_t rec_idx;      // emit record index
+	Record *records;       // updated records
+	GraphContext *gc;      // graph context
+	rax *update_ctxs;      // entities to update and their expressions
+	FlatMap node_updates;  // enqueued node updates
+	FlatMap edge_updates;  // enqueued edge updates
 } OpUpdate;
 
 OpBase *NewUpdateOp
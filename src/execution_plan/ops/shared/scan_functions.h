@@ -9,12 +9,22 @@
 #include "../../../graph/entities/node.h"
 #include "../../../graph/entities/qg_node.h"
 
+// planner hint pinning the way a node is scanned
+typedef enum {
+	SCAN_HINT_NONE = 0,  // scan is left to the optimizer
+	SCAN_HINT_LABEL,     // USING SCAN, label is scanned, no index is utilized
+	SCAN_HINT_INDEX      // USING INDEX, label is scanned via an index
+} ScanHint;
+
 // Storage struct for label data in node and index scans.
 typedef struct {
-	QGNode *n;          // node to scan (might hold multiple labels)
-	LabelID label_id;   // label ID of the node being traversed
-	const char *alias;  // alias of the node being traversed
-	const char *label;  // label of the node being traversed
+	QGNode *n;               // node to scan (might hold multiple labels)
+	LabelID label_id;        // label ID of the node being traversed
+	const char *alias;       // alias of the node being traversed
+	const char *label;       // label of the node being traversed
+	ScanHint hint;           // planner hint
+	const char *hint_label;  // hinted label
+	const char *hint_attr;   // hinted indexed attribute
 } NodeScanCtx;
 
 // allocates and returns a new context
@@ -42,26 +42,27 @@ static bool _ValidateAttrType
 void CommitUpdates
 (
 	GraphContext *gc,
-	dict *updates,
+	FlatMap updates,
 	EntityType type
 ) {
 	ASSERT(gc      != NULL);
 	ASSERT(updates != NULL);
 	ASSERT(type    != ENTITY_UNKNOWN);
 
-	uint update_count         = HashTableElemCount(updates);
+	uint update_count         = FlatMap_Count(updates);
 	bool constraint_violation = false;
 
 	// return early if no updates are enqueued
 	if(update_count == 0) return;
 
-	dictEntry *entry;
-	dictIterator *it = HashTableGetIterator(updates);
+	void **entry;
+	FlatMapIterator it;
+	FlatMap_IteratorInit(&it, updates);
 	MATRIX_POLICY policy = Graph_GetMatrixPolicy(gc->g);
 	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
 
-	while((entry = HashTableNext(it)) != NULL) {
-		PendingUpdateCtx *update = HashTableGetVal(entry);
+	while((entry = FlatMap_IteratorNext(&it, NULL)) != NULL) {
+		PendingUpdateCtx *update = *entry;
 
 		// if entity has been deleted, perform no updates
 		if(GraphEntity_IsDeleted(update->ge)) continue;
@@ -114,7 +115,6 @@ void CommitUpdates
 		}
 	}
 	Graph_SetMatrixPolicy(gc->g, policy);
-	HashTableReleaseIterator(it);
 }
 
 // build pending updates in the 'updates' array to match all
@@ -123,8 +123,8 @@ void CommitUpdates
 void EvalEntityUpdates
 (
 	GraphContext *gc,
-	dict *node_updates,
-	dict *edge_updates,
+	FlatMap node_updates,
+	FlatMap edge_updates,
 	const Record r,
 	const EntityUpdateEvalCtx *ctx,
 	bool allow_null
@@ -163,7 +163,7 @@ void EvalEntityUpdates
 		return;
 	}
 
-	dict *updates;
+	FlatMap updates;
 	GraphEntityType entity_type;
 	if(t == REC_TYPE_NODE) {
 		updates = node_updates;
@@ -173,20 +173,23 @@ void EvalEntityUpdates
 		entity_type = GETYPE_EDGE;
 	}
 
+	// entity IDs are unique, no need to verify entries
+	bool found;
 	PendingUpdateCtx *update;
-	dictEntry *entry = HashTableFind(updates, (void *)ENTITY_GET_ID(entity));
-	if(entry == NULL) {
+	void **entry = FlatMap_FindOrInsert(updates, ENTITY_GET_ID(entity), NULL,
+			NULL, &found);
+	if(!found) {
 		// create a new update context
 		update = rm_malloc(sizeof(PendingUpdateCtx));
 		update->ge            = entity;
 		update->attributes    = AttributeSet_ShallowClone(*entity->attributes);
 		update->add_labels    = NULL;
 		update->remove_labels = NULL;
-		// add update context to updates dictionary
-		HashTableAdd(updates, (void *)ENTITY_GET_ID(entity), update);
+		// add update context to updates map
+		*entry = update;
 	} else {
 		// update context already exists
-		update = (PendingUpdateCtx *)HashTableGetVal(entry);
+		update = (PendingUpdateCtx *)*entry;
 	}
 
 	if(array_len(ctx->add_labels) > 0 && update->add_labels == NULL) {
@@ -7,7 +7,7 @@
 #pragma once
 
 #include "../../execution_plan.h"
-#include "../../../util/dict.h"
+#include "../../../util/flat_map.h"
 
 // context representing a single update to perform on an entity
 typedef struct {
@@ -21,7 +21,7 @@ typedef struct {
 void CommitUpdates
 (
 	GraphContext *gc,
-	dict *updates,
+	FlatMap updates,
 	EntityType type
 );
 
@@ -31,8 +31,8 @@ void CommitUpdates
 void EvalEntityUpdates
 (
 	GraphContext *gc,
-	dict *node_updates,
-	dict *edge_updates,
+	FlatMap node_updates,
+	FlatMap edge_updates,
 	const Record r,
 	const EntityUpdateEvalCtx *ctx,
 	bool allow_null
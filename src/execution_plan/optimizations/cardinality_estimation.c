@@ -0,0 +1,148 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "cardinality_estimation.h"
+#include "../../arithmetic/arithmetic_op.h"
+#include "../../arithmetic/arithmetic_expression.h"
+
+// returns true if 'exp' mentions 'alias'
+static bool _mentions_alias
+(
+	AR_ExpNode *exp,   // expression
+	const char *alias  // alias
+) {
+	rax *entities = raxNew();
+	AR_EXP_CollectEntities(exp, entities);
+	bool mentioned = raxFind(entities, (unsigned char *)alias, strlen(alias))
+		!= raxNotFound;
+	raxFree(entities);
+
+	return mentioned;
+}
+
+// returns true if 'exp' is an attribute lookup on 'alias' e.g. n.v
+static bool _alias_attribute
+(
+	AR_ExpNode *exp,    // expression
+	const char *alias,  // alias
+	char **attr         // [output] attribute name
+) {
+	if(!AR_EXP_IsAttribute(exp, attr)) return false;
+
+	AR_ExpNode *entity = exp->op.children[0];
+	return (entity->type == AR_EXP_OPERAND &&
+			entity->operand.type == AR_EXP_VARIADIC &&
+			strcmp(entity->operand.variadic.entity_alias, alias) == 0);
+}
+
+// estimate the selectivity of predicate: lhs op rhs
+static double _predicate_selectivity
+(
+	GraphContext *gc,          // graph context
+	LabelID l,                 // label
+	const char *alias,         // filtered alias
+	const FT_FilterNode *pred  // predicate
+) {
+	char         *attr = NULL;
+	AR_ExpNode   *lhs  = pred->pred.lhs;
+	AR_ExpNode   *rhs  = pred->pred.rhs;
+	AST_Operator op    = pred->pred.op;
+
+	bool on_lhs = _mentions_alias(lhs, alias);
+	bool on_rhs = _mentions_alias(rhs, alias);
+
+	// predicate doesn't filter 'alias'
+	if(!on_lhs && !on_rhs) return 1;
+
+	// normalize to: alias.attr op exp
+	if(!on_lhs) {
+		AR_ExpNode *tmp = lhs;
+		lhs = rhs;
+		rhs = tmp;
+		op  = ArithmeticOp_ReverseOp(op);
+	}
+
+	double default_selectivity = (op == OP_EQUAL) ?
+		DEFAULT_EQ_SELECTIVITY : DEFAULT_RANGE_SELECTIVITY;
+
+	// alias mentioned on both ends, e.g. n.v = n.x
+	// or not in the form of alias.attr op exp
+	if((on_lhs && on_rhs) || !_alias_attribute(lhs, alias, &attr)) {
+		return default_selectivity;
+	}
+
+	AttributeID attr_id = GraphContext_GetAttributeID(gc, attr);
+	if(attr_id == ATTRIBUTE_ID_NONE) return 0;
+
+	// only constants are considered, a parameter's value may differ
+	// between executions of a cached plan
+	const SIValue *v = AR_EXP_IsConstant(rhs) ? &rhs->operand.constant : NULL;
+
+	double selectivity = -1;
+	if(l != GRAPH_NO_LABEL) {
+		selectivity = GraphStatistics_Selectivity(&gc->g->stats, l, attr_id,
+				op, v);
+	}
+
+	return (selectivity < 0) ? default_selectivity : selectivity;
+}
+
+double Cardinality_FilterSelectivity
+(
+	GraphContext *gc,         // graph context
+	LabelID l,                // label, GRAPH_NO_LABEL for unlabeled nodes
+	const char *alias,        // filtered alias
+	const FT_FilterNode *ft   // [optional] filter tree
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(alias != NULL);
+
+	if(ft == NULL) return 1;
+
+	double left;
+	double right;
+
+	switch(ft->t) {
+		case FT_N_PRED:
+			return _predicate_selectivity(gc, l, alias, ft);
+
+		case FT_N_EXP:
+			return _mentions_alias(ft->exp.exp, alias) ?
+				DEFAULT_RANGE_SELECTIVITY : 1;
+
+		case FT_N_COND:
+			left  = Cardinality_FilterSelectivity(gc, l, alias, ft->cond.left);
+			right = Cardinality_FilterSelectivity(gc, l, alias, ft->cond.right);
+			if(ft->cond.op == OP_AND) return left * right;
+			if(ft->cond.op == OP_OR)  return left + right - left * right;
+			return MAX(left, right);
+
+		default:
+			ASSERT(false);
+			return 1;
+	}
+}
+
+double Cardinality_LabelScan
+(
+	GraphContext *gc,         // graph context
+	LabelID l,                // label, GRAPH_NO_LABEL for all nodes
+	const char *alias,        // scanned alias
+	const FT_FilterNode *ft   // [optional] filter tree
+) {
+	ASSERT(gc    != NULL);
+	ASSERT(alias != NULL);
+
+	// label doesn't exist
+	if(l == GRAPH_UNKNOWN_LABEL) return 0;
+
+	uint64_t nodes = (l == GRAPH_NO_LABEL) ?
+		Graph_NodeCount(gc->g) : Graph_LabeledNodeCount(gc->g, l);
+
+	if(nodes == 0 || ft == NULL) return nodes;
+
+	return nodes * Cardinality_FilterSelectivity(gc, l, alias, ft);
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../../graph/graphcontext.h"
+#include "../../filter_tree/filter_tree.h"
+
+// estimate the fraction of label 'l' nodes, bound to 'alias',
+// which pass filter tree 'ft'
+// predicates not involving 'alias' are ignored
+// predicates are assumed to be independent of one another
+double Cardinality_FilterSelectivity
+(
+	GraphContext *gc,         // graph context
+	LabelID l,                // label, GRAPH_NO_LABEL for unlabeled nodes
+	const char *alias,        // filtered alias
+	const FT_FilterNode *ft   // [optional] filter tree
+);
+
+// estimate the number of nodes produced by scanning label 'l'
+// bound to 'alias' and applying filter tree 'ft'
+double Cardinality_LabelScan
+(
+	GraphContext *gc,         // graph context
+	LabelID l,                // label, GRAPH_NO_LABEL for all nodes
+	const char *alias,        // scanned alias
+	const FT_FilterNode *ft   // [optional] filter tree
+);
@@ -58,6 +58,7 @@ static void _costBaseLabelScan
 
 	// node has multiple labels
 	// find label with minimum entities
+	// unless a USING SCAN hint pins the scanned label
 	int min_label_id = n_ctx->label_id;
 	const char *min_label_str = n_ctx->label;
 	uint64_t min_nnz =(uint64_t) Graph_LabeledNodeCount(g, n_ctx->label_id);
@@ -65,12 +66,23 @@ static void _costBaseLabelScan
 	for(uint i = 0; i < label_count; i++) {
 		uint64_t nnz;
 		int label_id = QGNode_GetLabelID(n, i);
+		const char *label = QGNode_GetLabel(n, i);
+
+		if(n_ctx->hint == SCAN_HINT_LABEL) {
+			if(strcmp(label, n_ctx->hint_label) == 0) {
+				min_label_id  = label_id;
+				min_label_str = label;
+				break;
+			}
+			continue;
+		}
+
 		nnz = Graph_LabeledNodeCount(g, label_id);
 		if(min_nnz > nnz) {
 			// update minimum
 			min_nnz       = nnz;
 			min_label_id  = label_id;
-			min_label_str = QGNode_GetLabel(n, i);
+			min_label_str = label;
 		}
 	}
 
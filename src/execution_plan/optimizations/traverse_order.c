@@ -5,13 +5,56 @@
  */
 
 #include "RG.h"
+#include "../../query_ctx.h"
 #include "../../util/arr.h"
 #include "../../util/rmalloc.h"
 #include "../../arithmetic/algebraic_expression/utils.h"
 #include "traverse_order_utils.h"
+#include "cardinality_estimation.h"
 
+#include <float.h>
 #include <stdlib.h>
 
+// estimate the number of nodes 'alias' resolves to when used as
+// a traversal's entry point, -1 if unknown
+static double _entry_point_cardinality
+(
+	const QueryGraph *qg,     // query graph
+	const char *alias,        // node alias
+	const FT_FilterNode *ft   // [optional] filter tree
+) {
+	QGNode *n = QueryGraph_GetNodeByAlias(qg, alias);
+	if(n == NULL) return -1;
+
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+	uint label_count = QGNode_LabelCount(n);
+	if(label_count == 0) {
+		return Cardinality_LabelScan(gc, GRAPH_NO_LABEL, alias, ft);
+	}
+
+	// the most restrictive label is scanned
+	double cardinality = DBL_MAX;
+	for(uint i = 0; i < label_count; i++) {
+		double c = Cardinality_LabelScan(gc, QGNode_GetLabelID(n, i), alias, ft);
+		cardinality = MIN(cardinality, c);
+	}
+
+	return cardinality;
+}
+
+// compare estimated cardinalities
+// estimates are considered equal unless one is less than half the other
+static int _cardinality_cmp
+(
+	double a,
+	double b
+) {
+	if(a < 0 || b < 0) return 0;
+	if(a * 2 < b)      return -1;
+	if(b * 2 < a)      return 1;
+	return 0;
+}
+
 // having chosen which algebraic expression will be evaluated first
 // determine whether it is worthwhile to transpose it
 // thus swap the source and destination
@@ -19,6 +62,7 @@ static bool _should_transpose_entry_point
 (
 	const QueryGraph *qg,
 	AlgebraicExpression *ae,
+	const FT_FilterNode *ft,
 	rax *filtered_entities,
 	rax *bound_vars
 ) {
@@ -55,7 +99,13 @@ static bool _should_transpose_entry_point
 	int dest_score = scored_exp[0].score;
 
 	// transpose if top scored expression is 'dest_exp'
+	// on a tie, transpose if 'dest' is estimated to resolve far fewer nodes
 	bool transpose = dest_score > src_score;
+	if(dest_score == src_score) {
+		transpose = _cardinality_cmp(
+				_entry_point_cardinality(qg, dest, ft),
+				_entry_point_cardinality(qg, src, ft)) < 0;
+	}
 
 	AlgebraicExpression_Free(exps[0]);
 	AlgebraicExpression_Free(exps[1]);
@@ -199,12 +249,479 @@ static void _order_expressions
 	ASSERT(res == true);
 }
 
+//------------------------------------------------------------------------------
+// cost based arrangement
+//------------------------------------------------------------------------------
+
+// maximum number of expressions arranged by exhaustive enumeration
+// longer traversals are arranged greedily with a single step lookahead
+#define DP_MAX_EXPRESSIONS 12
+
+// a cost based arrangement replaces the heuristic one only if it's
+// estimated to be at least this many times cheaper
+#define COST_IMPROVEMENT_FACTOR 2
+
+// cost model of a traversal
+// the number of records produced by a set of expressions is estimated as
+// the product of the estimated rows of every node the set resolves
+// multiplied by the selectivity of each expression connecting them
+// an arrangement's cost is the sum of records produced by each of its prefixes
+typedef struct {
+	uint nexp;            // number of expressions
+	uint nalias;          // number of node aliases
+	const char **alias;   // node aliases
+	double *rows;         // estimated rows per node alias
+	uint *src;            // expression source alias index
+	uint *dest;           // expression destination alias index
+	double *selectivity;  // expression selectivity
+} TraversalCost;
+
+// returns index of 'alias' in cost model, adding it if missing
+static uint _cost_alias
+(
+	TraversalCost *cost,
+	const char *alias
+) {
+	for(uint i = 0; i < cost->nalias; i++) {
+		if(strcmp(cost->alias[i], alias) == 0) return i;
+	}
+
+	cost->alias[cost->nalias] = alias;
+	return cost->nalias++;
+}
+
+// estimated number of nodes 'n' resolves to ignoring filters
+static double _node_population
+(
+	GraphContext *gc,
+	const QGNode *n
+) {
+	uint label_count = QGNode_LabelCount(n);
+	if(label_count == 0) {
+		return Cardinality_LabelScan(gc, GRAPH_NO_LABEL, n->alias, NULL);
+	}
+
+	double population = DBL_MAX;
+	for(uint i = 0; i < label_count; i++) {
+		population = MIN(population,
+				Cardinality_LabelScan(gc, QGNode_GetLabelID(n, i), n->alias,
+					NULL));
+	}
+
+	return population;
+}
+
+// locate the query graph edge connecting 'src' and 'dest'
+// sets 'outgoing' to true if the edge is directed from 'src' to 'dest'
+static QGEdge *_connecting_edge
+(
+	const QGNode *src,
+	const QGNode *dest,
+	bool *outgoing
+) {
+	for(uint i = 0; i < array_len(src->outgoing_edges); i++) {
+		QGEdge *e = src->outgoing_edges[i];
+		if(e->dest == dest) {
+			*outgoing = true;
+			return e;
+		}
+	}
+
+	for(uint i = 0; i < array_len(src->incoming_edges); i++) {
+		QGEdge *e = src->incoming_edges[i];
+		if(e->src == dest) {
+			*outgoing = false;
+			return e;
+		}
+	}
+
+	return NULL;
+}
+
+// estimate the probability of a pair of 'src' and 'dest' nodes
+// being connected via 'e'
+// returns -1 if 'e' can't be estimated
+static double _edge_selectivity
+(
+	GraphContext *gc,
+	const QGEdge *e,
+	const QGNode *src,
+	const QGNode *dest,
+	bool outgoing
+) {
+	Graph *g = gc->g;
+
+	if(!QGEdge_SingleHop(e)) return -1;
+
+	double src_population  = _node_population(gc, src);
+	double dest_population = _node_population(gc, dest);
+	if(src_population == 0 || dest_population == 0) return 0;
+
+	double selectivity = 0;
+	uint rel_count = QGEdge_RelationCount(e);
+	if(rel_count == 0) {
+		selectivity = Graph_EdgeCount(g) / (src_population * dest_population);
+	}
+
+	for(uint i = 0; i < rel_count; i++) {
+		RelationID r = QGEdge_RelationID(e, i);
+		if(r == GRAPH_UNKNOWN_RELATION) continue;
+
+		// prefer sampled average degree of a labeled source
+		double degree = -1;
+		if(QGNode_LabelCount(src) > 0) {
+			degree = GraphStatistics_AverageDegree(&g->stats,
+					QGNode_GetLabelID(src, 0), r, outgoing);
+		}
+
+		if(degree >= 0) {
+			selectivity += degree / dest_population;
+		} else {
+			selectivity += Graph_RelationEdgeCount(g, r) /
+				(src_population * dest_population);
+		}
+	}
+
+	if(e->bidirectional) selectivity *= 2;
+
+	return MIN(selectivity, 1);
+}
+
+// build traversal cost model
+// returns false if the traversal can't be modeled
+static bool _TraversalCost_Init
+(
+	TraversalCost *cost,               // cost model to initialize
+	const QueryGraph *qg,              // query graph
+	AlgebraicExpression **exps,        // expressions
+	uint nexp,                         // number of expressions
+	const FT_FilterNode *ft,           // filter tree
+	rax *bound_vars                    // bound variables
+) {
+	GraphContext *gc = QueryCtx_GetGraphCtx();
+
+	cost->nexp        = nexp;
+	cost->nalias      = 0;
+	cost->alias       = rm_malloc(sizeof(char *) * nexp * 2);
+	cost->rows        = rm_malloc(sizeof(double) * nexp * 2);
+	cost->src         = rm_malloc(sizeof(uint) * nexp);
+	cost->dest        = rm_malloc(sizeof(uint) * nexp);
+	cost->selectivity = rm_malloc(sizeof(double) * nexp);
+
+	for(uint i = 0; i < nexp; i++) {
+		const char *src  = AlgebraicExpression_Src(exps[i]);
+		const char *dest = AlgebraicExpression_Dest(exps[i]);
+
+		// bound variables are handled by the heuristic arrangement
+		if(bound_vars != NULL &&
+		   (raxFind(bound_vars, (unsigned char *)src, strlen(src))
+				!= raxNotFound ||
+			raxFind(bound_vars, (unsigned char *)dest, strlen(dest))
+				!= raxNotFound)) {
+			return false;
+		}
+
+		QGNode *src_node  = QueryGraph_GetNodeByAlias(qg, src);
+		QGNode *dest_node = QueryGraph_GetNodeByAlias(qg, dest);
+		if(src_node == NULL || dest_node == NULL) return false;
+
+		cost->src[i]  = _cost_alias(cost, src);
+		cost->dest[i] = _cost_alias(cost, dest);
+
+		// label expression
+		if(src_node == dest_node) {
+			if(AlgebraicExpression_Edge(exps[i]) != NULL) return false;
+			cost->selectivity[i] = 1;
+			continue;
+		}
+
+		// expressions spanning multiple hops can't be estimated
+		bool outgoing;
+		QGEdge *e = _connecting_edge(src_node, dest_node, &outgoing);
+		if(e == NULL) return false;
+
+		cost->selectivity[i] = _edge_selectivity(gc, e, src_node, dest_node,
+				outgoing);
+		if(cost->selectivity[i] < 0) return false;
+	}
+
+	for(uint i = 0; i < cost->nalias; i++) {
+		cost->rows[i] = _entry_point_cardinality(qg, cost->alias[i], ft);
+		if(cost->rows[i] < 0) return false;
+	}
+
+	return true;
+}
+
+static void _TraversalCost_Free
+(
+	TraversalCost *cost
+) {
+	rm_free(cost->alias);
+	rm_free(cost->rows);
+	rm_free(cost->src);
+	rm_free(cost->dest);
+	rm_free(cost->selectivity);
+}
+
+// factor by which expression 'i' multiplies the number of records
+// given the set of already resolved aliases
+static double _expression_factor
+(
+	const TraversalCost *cost,
+	uint i,
+	const bool *resolved
+) {
+	uint src  = cost->src[i];
+	uint dest = cost->dest[i];
+
+	double factor = cost->selectivity[i];
+	if(!resolved[src])                  factor *= cost->rows[src];
+	if(!resolved[dest] && dest != src)  factor *= cost->rows[dest];
+
+	return factor;
+}
+
+// cost of scanning expression 'i' entry point
+static double _entry_cost
+(
+	const TraversalCost *cost,
+	uint i
+) {
+	return MIN(cost->rows[cost->src[i]], cost->rows[cost->dest[i]]);
+}
+
+// returns true if expression 'i' can follow the set of resolved aliases
+static bool _expression_connects
+(
+	const TraversalCost *cost,
+	uint i,
+	const bool *resolved
+) {
+	return resolved[cost->src[i]] || resolved[cost->dest[i]];
+}
+
+// compute the cost of arrangement 'order'
+static double _arrangement_cost
+(
+	const TraversalCost *cost,
+	const uint *order
+) {
+	bool resolved[cost->nalias];
+	memset(resolved, 0, sizeof(resolved));
+
+	double rows  = 1;
+	double total = _entry_cost(cost, order[0]);
+	for(uint i = 0; i < cost->nexp; i++) {
+		uint e = order[i];
+		rows  *= _expression_factor(cost, e, resolved);
+		total += rows;
+		resolved[cost->src[e]]  = true;
+		resolved[cost->dest[e]] = true;
+	}
+
+	return total;
+}
+
+// find the cheapest arrangement by enumerating connected subsets
+// of expressions, the number of records produced by a subset is independent
+// of the order in which its expressions were applied
+static void _dp_arrangement
+(
+	const TraversalCost *cost,
+	uint *order  // [output] cheapest arrangement
+) {
+	uint nexp = cost->nexp;
+	uint nsets = 1 << nexp;
+
+	double   *best    = rm_malloc(sizeof(double) * nsets);
+	double   *rows    = rm_malloc(sizeof(double) * nsets);
+	uint32_t *aliases = rm_malloc(sizeof(uint32_t) * nsets);
+	uint8_t  *last    = rm_malloc(sizeof(uint8_t) * nsets);
+
+	best[0]    = 0;
+	rows[0]    = 1;
+	aliases[0] = 0;
+
+	for(uint s = 1; s < nsets; s++) {
+		best[s] = DBL_MAX;
+
+		// derive set's resolved aliases and rows from its lowest expression
+		uint low = __builtin_ctz(s);
+		uint p   = s & ~(1 << low);
+
+		bool resolved[cost->nalias];
+		for(uint a = 0; a < cost->nalias; a++) {
+			resolved[a] = (aliases[p] >> a) & 1;
+		}
+
+		rows[s] = rows[p] * _expression_factor(cost, low, resolved);
+		aliases[s] = aliases[p] |
+			(1 << cost->src[low]) | (1 << cost->dest[low]);
+
+		// find the cheapest expression to apply last
+		for(uint e = 0; e < nexp; e++) {
+			if(!(s & (1 << e))) continue;
+
+			uint prev = s & ~(1 << e);
+			double c;
+			if(prev == 0) {
+				c = _entry_cost(cost, e);
+			} else {
+				uint32_t e_aliases = (1 << cost->src[e]) | (1 << cost->dest[e]);
+				if(best[prev] == DBL_MAX || !(aliases[prev] & e_aliases)) {
+					continue;
+				}
+				c = best[prev];
+			}
+
+			c += rows[s];
+			if(c < best[s]) {
+				best[s] = c;
+				last[s] = e;
+			}
+		}
+	}
+
+	// reconstruct arrangement
+	uint s = nsets - 1;
+	ASSERT(best[s] != DBL_MAX);
+	for(int i = nexp - 1; i >= 0; i--) {
+		order[i] = last[s];
+		s &= ~(1 << last[s]);
+	}
+
+	rm_free(best);
+	rm_free(rows);
+	rm_free(aliases);
+	rm_free(last);
+}
+
+// arrange expressions greedily, picking at each position the expression
+// minimizing the records produced by it and its best follower
+static void _greedy_arrangement
+(
+	const TraversalCost *cost,
+	uint *order  // [output] arrangement
+) {
+	uint nexp = cost->nexp;
+	bool used[nexp];
+	bool resolved[cost->nalias];
+	memset(used, 0, sizeof(used));
+	memset(resolved, 0, sizeof(resolved));
+
+	double rows = 1;
+	for(uint i = 0; i < nexp; i++) {
+		int    pick      = -1;
+		double pick_cost = DBL_MAX;
+
+		for(uint e = 0; e < nexp; e++) {
+			if(used[e]) continue;
+			if(i > 0 && !_expression_connects(cost, e, resolved)) continue;
+
+			double e_rows = rows * _expression_factor(cost, e, resolved);
+			double c = e_rows + ((i == 0) ? _entry_cost(cost, e) : 0);
+
+			// lookahead
+			bool src_resolved  = resolved[cost->src[e]];
+			bool dest_resolved = resolved[cost->dest[e]];
+			resolved[cost->src[e]]  = true;
+			resolved[cost->dest[e]] = true;
+
+			double follow = DBL_MAX;
+			for(uint f = 0; f < nexp; f++) {
+				if(used[f] || f == e) continue;
+				if(!_expression_connects(cost, f, resolved)) continue;
+				follow = MIN(follow,
+						e_rows * _expression_factor(cost, f, resolved));
+			}
+			if(follow != DBL_MAX) c += follow;
+
+			resolved[cost->src[e]]  = src_resolved;
+			resolved[cost->dest[e]] = dest_resolved;
+
+			if(c < pick_cost) {
+				pick      = e;
+				pick_cost = c;
+			}
+		}
+
+		ASSERT(pick != -1);
+		order[i]    = pick;
+		used[pick]  = true;
+		rows       *= _expression_factor(cost, pick, resolved);
+		resolved[cost->src[pick]]  = true;
+		resolved[cost->dest[pick]] = true;
+	}
+}
+
+// replace 'arrangement' with the cheapest arrangement according to 'cost'
+// if it's estimated to be considerably cheaper
+// returns true if 'arrangement' was replaced
+static bool _apply_cheaper_arrangement
+(
+	const TraversalCost *cost,         // cost model
+	AlgebraicExpression **arrangement  // heuristic arrangement
+) {
+	uint nexp = cost->nexp;
+
+	uint order[nexp];
+	if(nexp <= DP_MAX_EXPRESSIONS) {
+		_dp_arrangement(cost, order);
+	} else {
+		_greedy_arrangement(cost, order);
+	}
+
+	// cost of heuristic arrangement, expressions are in model order
+	uint heuristic[nexp];
+	for(uint i = 0; i < nexp; i++) heuristic[i] = i;
+
+	double heuristic_cost = _arrangement_cost(cost, heuristic);
+	double cost_based     = _arrangement_cost(cost, order);
+
+	if(cost_based * COST_IMPROVEMENT_FACTOR >= heuristic_cost) return false;
+
+	AlgebraicExpression *exps[nexp];
+	memcpy(exps, arrangement, sizeof(AlgebraicExpression *) * nexp);
+	for(uint i = 0; i < nexp; i++) arrangement[i] = exps[order[i]];
+
+	return true;
+}
+
+// replace 'arrangement' with a cost based arrangement if it's estimated to be
+// considerably cheaper
+// returns true if 'arrangement' was replaced
+static bool _cost_based_arrangement
+(
+	AlgebraicExpression **arrangement,  // heuristic arrangement
+	const QueryGraph *qg,               // query graph
+	uint nexp,                          // number of expressions
+	const FT_FilterNode *ft,            // filter tree
+	rax *bound_vars                     // bound variables
+) {
+	// short traversals are well served by the heuristic arrangement
+	if(nexp < 3) return false;
+
+	TraversalCost cost;
+	bool replaced = false;
+
+	if(_TraversalCost_Init(&cost, qg, arrangement, nexp, ft, bound_vars)) {
+		replaced = _apply_cheaper_arrangement(&cost, arrangement);
+	}
+
+	_TraversalCost_Free(&cost);
+	return replaced;
+}
+
 static int _score_cmp
 (
 	const ScoredExp *a,
 	const ScoredExp *b
 ) {
-	return b->score - a->score;
+	if(a->score != b->score) return b->score - a->score;
+
+	// break ties by the estimated number of entry nodes
+	return _cardinality_cmp(a->cardinality, b->cardinality);
 }
 
 // given a set of algebraic expressions representing a graph traversal
@@ -244,6 +761,16 @@ void orderExpressions
 	TraverseOrder_ScoreExpressions(scored_exps, exps, _exp_count, bound_vars,
 								   filtered_entities, qg);
 
+	// estimate each expression's cheapest entry point
+	for(uint i = 0; i < _exp_count; i++) {
+		AlgebraicExpression *exp = scored_exps[i].exp;
+		double src  = _entry_point_cardinality(qg,
+				AlgebraicExpression_Src(exp), ft);
+		double dest = _entry_point_cardinality(qg,
+				AlgebraicExpression_Dest(exp), ft);
+		scored_exps[i].cardinality = (src < 0 || dest < 0) ? -1 : MIN(src, dest);
+	}
+
 	// sort scored_exps on score in descending order
 	qsort(scored_exps, _exp_count, sizeof(ScoredExp),
 			(int(*)(const void*, const void*))_score_cmp);
@@ -254,6 +781,11 @@ void orderExpressions
 
 	_order_expressions(arrangement, scored_exps, _exp_count);
 
+	// replace the heuristic arrangement if statistics suggest
+	// a considerably cheaper one
+	bool cost_based = _cost_based_arrangement(arrangement, qg, _exp_count, ft,
+			bound_vars);
+
 	// overwrite the original expressions array with the optimal arrangement
 	memcpy(exps, arrangement, _exp_count * sizeof(AlgebraicExpression *));
 
@@ -263,8 +795,18 @@ void orderExpressions
 
 	// transpose the winning expression if the destination node is a more
 	// efficient starting point
-	if(_should_transpose_entry_point(qg, exps[0], filtered_entities,
-									 bound_vars)) {
+	bool transpose;
+	if(cost_based) {
+		transpose = _cardinality_cmp(
+				_entry_point_cardinality(qg, AlgebraicExpression_Dest(exps[0]), ft),
+				_entry_point_cardinality(qg, AlgebraicExpression_Src(exps[0]), ft))
+			< 0;
+	} else {
+		transpose = _should_transpose_entry_point(qg, exps[0], ft,
+				filtered_entities, bound_vars);
+	}
+
+	if(transpose) {
 		AlgebraicExpression_Transpose(exps);
 	}
 
@@ -255,6 +255,7 @@ void TraverseOrder_ScoreExpressions
 		score = TraverseOrder_LabelsScore(exp, qg);
 		scored_exp->exp = exp;
 		scored_exp->score = score;
+		scored_exp->cardinality = -1;
 
 		max = MAX(max, score);
 	}
@@ -13,6 +13,7 @@
 // algebraic expression associated with a score
 typedef struct {
 	int score;                 // score given to expression
+	double cardinality;        // estimated number of entry nodes, -1 if unknown
 	AlgebraicExpression *exp;  // algebraic expression
 } ScoredExp;
 
@@ -9,6 +9,7 @@
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
 #include "../ops/op_filter.h"
+#include "cardinality_estimation.h"
 #include "../../ast/ast_shared.h"
 #include "../../datatypes/array.h"
 #include "../../datatypes/point.h"
@@ -19,12 +20,15 @@
 #include "../ops/op_edge_by_index_scan.h"
 #include "../ops/op_conditional_traverse.h"
 #include "../../arithmetic/arithmetic_op.h"
+#include "../../errors/errors.h"
 #include "../../filter_tree/filter_tree_utils.h"
 #include "../../arithmetic/algebraic_expression.h"
 #include "../../arithmetic/algebraic_expression/utils.h"
 #include "../execution_plan_build/execution_plan_util.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
+#include <float.h>
+
 //------------------------------------------------------------------------------
 // Filter normalization
 //------------------------------------------------------------------------------
@@ -299,9 +303,37 @@ static FT_FilterNode *_Concat_Filters(OpFilter **filter_ops) {
 	return root;
 }
 
+// checks if an index hint's attribute is both indexed by 'idx'
+// and filtered by one of 'filters'
+static bool _hinted_attribute_applicable
+(
+	GraphContext *gc,      // graph context
+	const Index idx,       // candidate index
+	OpFilter **filters,    // applicable filters
+	const char *attribute  // hinted attribute
+) {
+	AttributeID id = GraphContext_GetAttributeID(gc, attribute);
+	if(id == ATTRIBUTE_ID_NONE ||
+	   !Index_ContainsField(idx, id, INDEX_FLD_RANGE)) {
+		return false;
+	}
+
+	bool filtered = false;
+	uint n = array_len(filters);
+	for(uint i = 0; i < n && !filtered; i++) {
+		rax *attrs = FilterTree_CollectAttributes(filters[i]->filterTree);
+		filtered = raxFind(attrs, (unsigned char *)attribute,
+				strlen(attribute)) != raxNotFound;
+		raxFree(attrs);
+	}
+
+	return filtered;
+}
+
 // try to replace given Label Scan operation and a set of Filter operations with
 // a single Index Scan operation
-void reduce_scan_op
+// returns true if the scan was replaced
+bool reduce_scan_op
 (
 	ExecutionPlan *plan,
 	NodeByLabelScan *scan
@@ -313,9 +345,12 @@ void reduce_scan_op
 	QueryGraph   *qg = scan->op.plan->query_graph;
 
 	// find label with filtered indexed properties
-	// that has the minimum NNZ entries
+	// that has the minimum estimated number of matching entries
+	// an index hint restricts the search to the hinted label and attribute
+	bool        replaced       = false;       // scan replaced by index scan
+	bool        hinted         = scan->n->hint == SCAN_HINT_INDEX;
 	int         min_label_id;                 // tracks min label ID
-	uint64_t    min_nnz        = UINT64_MAX;  // tracks min entries
+	double      min_rows       = DBL_MAX;     // tracks min estimated entries
 	Index       idx            = NULL;        // the index to be applied
 	OpFilter    **filters      = NULL;        // tracks indexed filters to apply
 	uint        filters_count  = 0;           // number of matching filters
@@ -328,7 +363,7 @@ void reduce_scan_op
 
 	uint label_count = QGNode_LabelCount(qn);
 	for(uint i = 0; i < label_count; i++) {
-		uint64_t nnz;
+		double rows;
 		Index cur_idx = NULL;
 		int label_id = QGNode_GetLabelID(qn, i);
 		const char *label = QGNode_GetLabel(qn, i);
@@ -336,6 +371,9 @@ void reduce_scan_op
 		// unknown label
 		if(label_id == GRAPH_UNKNOWN_LABEL) continue;
 
+		// label isn't the hinted one
+		if(hinted && strcmp(label, scan->n->hint_label) != 0) continue;
+
 		cur_idx = GraphContext_GetIndexByID(gc, label_id, NULL, 0,
 				INDEX_FLD_RANGE, GETYPE_NODE);
 
@@ -348,20 +386,26 @@ void reduce_scan_op
 		OpFilter **cur_filters = _applicableFilters((OpBase *)scan,
 				scan->n->alias, cur_idx);
 
-		// TODO consider heuristic which combines max
-		// number / restrictiveness of applicable filters
-		// vs. the label's NNZ?
 		uint cur_filters_count = array_len(cur_filters);
-		if(cur_filters_count == 0) {
+		if(cur_filters_count == 0 || (hinted &&
+		   !_hinted_attribute_applicable(gc, cur_idx, cur_filters,
+			   scan->n->hint_attr))) {
 			// no filters
 			array_free(cur_filters);
 			continue;
 		}
 
-		nnz = Graph_LabeledNodeCount(g, label_id);
-		if(min_nnz > nnz) {
+		// estimate the number of entries the index will produce
+		// combining the label's NNZ with the restrictiveness of the filters
+		rows = Graph_LabeledNodeCount(g, label_id);
+		for(uint j = 0; j < cur_filters_count; j++) {
+			rows *= Cardinality_FilterSelectivity(gc, label_id, node_alias,
+					cur_filters[j]->filterTree);
+		}
+
+		if(min_rows > rows) {
 			idx           = cur_idx;
-			min_nnz       = nnz;
+			min_rows      = rows;
 			min_label_str = label;
 			min_label_id  = label_id;
 
@@ -426,8 +470,11 @@ void reduce_scan_op
 		OpBase_Free((OpBase *)filter);
 	}
 
+	replaced = true;
+
 cleanup:
 	array_free(filters);
+	return replaced;
 }
 
 // try to replace given Conditional Traverse operation and a set of Filter
@@ -558,16 +605,46 @@ static void labelScanToIndexScan
 	int scanOpCount = array_len(scanOps);
 	for(int i = 0; i < scanOpCount; i++) {
 		NodeByLabelScan *scanOp = (NodeByLabelScan *)scanOps[i];
+		const NodeScanCtx n = *scanOp->n;
 
-		// make sure scan is followed by filter(s)
-		OpBase *parent = scanOp->op.parent;
-		if(parent->type != OPType_FILTER) {
-			// no filters to utilize
+		// label scan pinned by a USING SCAN hint
+		if(n.hint == SCAN_HINT_LABEL) {
 			continue;
 		}
 
+		// make sure scan is followed by filter(s)
 		// try to reduce label scan + filter(s) to a single IndexScan operation
-		reduce_scan_op(plan, scanOp);
+		OpBase *parent = scanOp->op.parent;
+		bool reduced = (parent->type == OPType_FILTER &&
+				reduce_scan_op(plan, scanOp));
+
+		// USING INDEX hint can't be honored
+		if(!reduced && n.hint == SCAN_HINT_INDEX) {
+			ErrorCtx_SetError(EMSG_HINT_INDEX, n.alias, n.hint_label,
+					n.hint_attr);
+			break;
+		}
+	}
+
+	array_free(scanOps);
+}
+
+// report USING INDEX hints on a graph without indices
+static void _unsatisfiedIndexHints
+(
+	ExecutionPlan *plan
+) {
+	OpBase **scanOps = ExecutionPlan_CollectOps(plan->root,
+			OPType_NODE_BY_LABEL_SCAN);
+
+	uint scanOpCount = array_len(scanOps);
+	for(uint i = 0; i < scanOpCount; i++) {
+		const NodeScanCtx *n = ((NodeByLabelScan *)scanOps[i])->n;
+		if(n->hint == SCAN_HINT_INDEX) {
+			ErrorCtx_SetError(EMSG_HINT_INDEX, n->alias, n->hint_label,
+					n->hint_attr);
+			break;
+		}
 	}
 
 	array_free(scanOps);
@@ -579,7 +656,10 @@ void utilizeIndices
 ) {
 	// return immediately if the graph has no indices
 	GraphContext *gc = QueryCtx_GetGraphCtx();
-	if(!GraphContext_HasIndices(gc)) return;
+	if(!GraphContext_HasIndices(gc)) {
+		_unsatisfiedIndexHints(plan);
+		return;
+	}
 
 	// indices are utilized in three sections:
 	// 1. label scan followed by filter(s)
@@ -6,9 +6,13 @@
 
 #include "RG.h"
 #include "record.h"
+#include "../query_ctx.h"
 #include "../errors/errors.h"
 #include "../util/rmalloc.h"
 
+// attribute set of a node added by ID, resolved on first access
+#define UNRESOLVED_ATTRIBUTES ((AttributeSet *)UINTPTR_MAX)
+
 Record Record_New
 (
 	rax *mapping
@@ -170,8 +174,13 @@ Node *Record_GetNode
 	uint idx
 ) {
 	switch(r->entries[idx].type) {
-		case REC_TYPE_NODE:
-			return &(r->entries[idx].value.n);
+		case REC_TYPE_NODE: {
+			Node *n = &(r->entries[idx].value.n);
+			if(unlikely(n->attributes == UNRESOLVED_ATTRIBUTES)) {
+				Graph_ResolveNode(QueryCtx_GetGraph(), n);
+			}
+			return n;
+		}
 		case REC_TYPE_UNKNOWN:
 			return NULL;
 		case REC_TYPE_SCALAR:
@@ -183,6 +192,25 @@ Node *Record_GetNode
 	}
 }
 
+NodeID Record_GetNodeID
+(
+	const Record r,
+	uint idx
+) {
+	switch(r->entries[idx].type) {
+		case REC_TYPE_NODE:
+			return ENTITY_GET_ID(&(r->entries[idx].value.n));
+		case REC_TYPE_UNKNOWN:
+			return INVALID_ENTITY_ID;
+		case REC_TYPE_SCALAR:
+			// Null scalar values are expected here; otherwise fall through.
+			if(SIValue_IsNull(r->entries[idx].value.s)) return INVALID_ENTITY_ID;
+		default:
+			ErrorCtx_RaiseRuntimeException("encountered unexpected type in Record; expected Node");
+			return INVALID_ENTITY_ID;
+	}
+}
+
 Edge *Record_GetEdge
 (
 	const Record r,
@@ -292,6 +320,17 @@ Node *Record_AddNode
 	return &(r->entries[idx].value.n);
 }
 
+void Record_AddNodeID
+(
+	Record r,
+	uint idx,
+	NodeID id
+) {
+	r->entries[idx].value.n.id         = id;
+	r->entries[idx].value.n.attributes = UNRESOLVED_ATTRIBUTES;
+	r->entries[idx].type               = REC_TYPE_NODE;
+}
+
 Edge *Record_AddEdge
 (
 	Record r,
@@ -99,12 +99,22 @@ RecordEntryType Record_GetType
 );
 
 // get a node from record at position idx
+// resolves the node's attributes if it was added by ID
 Node *Record_GetNode
 (
 	const Record r,
 	uint idx
 );
 
+// get the ID of the node at position idx
+// returns INVALID_ENTITY_ID if there's no node at idx
+// the node's attributes are not resolved
+NodeID Record_GetNodeID
+(
+	const Record r,
+	uint idx
+);
+
 // get an edge from record at position idx
 Edge *Record_GetEdge
 (
@@ -157,6 +167,15 @@ Node *Record_AddNode
 	Node node
 );
 
+// add a node to record at position idx by its ID
+// the node's attributes are resolved on first access
+void Record_AddNodeID
+(
+	Record r,
+	uint idx,
+	NodeID id
+);
+
 // add an edge to record at position idx and return a reference to it
 Edge *Record_AddEdge
 (
@@ -395,6 +395,31 @@ AttributeSet AttributeSet_ShallowClone
     return clone;
 }
 
+// clones attribute set, duplicating all si values
+AttributeSet AttributeSet_Clone
+(
+	const AttributeSet set  // set to clone
+) {
+	// in case attribute-set is marked as read-only, clear marker
+	AttributeSet _set = (AttributeSet)ATTRIBUTE_SET_CLEAR_MSB(set);
+
+	if(_set == NULL) return NULL;
+
+	size_t n = ATTRIBUTESET_BYTE_SIZE(_set);
+	AttributeSet clone = rm_malloc(n);
+	clone->attr_count  = _set->attr_count;
+
+	for(uint16_t i = 0; i < _set->attr_count; ++i) {
+		Attribute *attr       = _set->attributes  + i;
+		Attribute *clone_attr = clone->attributes + i;
+
+		clone_attr->id    = attr->id;
+		clone_attr->value = SI_CloneValue(attr->value);
+	}
+
+	return clone;
+}
+
 // persists all attributes within given set
 void AttributeSet_PersistValues
 (
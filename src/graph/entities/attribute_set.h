@@ -118,6 +118,12 @@ AttributeSet AttributeSet_ShallowClone
 	const AttributeSet set  // set to clone
 );
 
+// clones attribute set, duplicating all si values
+AttributeSet AttributeSet_Clone
+(
+	const AttributeSet set  // set to clone
+);
+
 // persists all attributes within given set
 void AttributeSet_PersistValues
 (
@@ -16,20 +16,20 @@ typedef int RelationID;
 
 
 // instantiate a new edge with relation data
-#define GE_NEW_LABELED_EDGE(r_str, r_id)    \
+#define GE_NEW_LABELED_EDGE(r_id)           \
 (Edge) {                                    \
 	.attributes   = NULL,                   \
 	.id           = INVALID_ENTITY_ID,      \
-	.relationship = (r_str),                \
 	.relationID   = (r_id),                 \
 	.src_id       = INVALID_ENTITY_ID,      \
 	.dest_id      = INVALID_ENTITY_ID       \
 }
 
+// the relationship type name is not held by the edge
+// it is resolved from the relation ID when needed
 struct Edge {
 	AttributeSet *attributes;   // MUST be the first member
 	EntityID id;                // Unique id, MUST be the second member
-	const char *relationship;   // Label attached to edge
 	RelationID relationID;      // Relation ID
 	NodeID src_id;              // Source node ID
 	NodeID dest_id;             // Destination node ID
@@ -186,13 +186,19 @@ void GraphEntity_ToString
 
 			case GETYPE_EDGE: {
 				Edge *edge = (Edge *)e;
-				if(edge->relationship) {
-					size_t relationshipLen = strlen(edge->relationship);
+				GraphContext *gc = QueryCtx_GetGraphCtx();
+				RelationID r = Edge_GetRelationID(edge);
+				Schema *s = (r >= 0)
+					? GraphContext_GetSchemaByID(gc, r, SCHEMA_EDGE)
+					: NULL;
+				if(s) {
+					const char *relationship = Schema_GetName(s);
+					size_t relationshipLen = strlen(relationship);
 					if(*bufferLen - *bytesWritten < relationshipLen) {
 						*bufferLen += relationshipLen;
 						*buffer = rm_realloc(*buffer, sizeof(char) * *bufferLen);
 					}
-					*bytesWritten += snprintf(*buffer + *bytesWritten, *bufferLen, ":%s", edge->relationship);
+					*bytesWritten += snprintf(*buffer + *bytesWritten, *bufferLen, ":%s", relationship);
 				}
 				break;
 			}
@@ -57,6 +57,17 @@ void Graph_AcquireReadLock
 	pthread_rwlock_rdlock(&g->_rwlock);
 }
 
+// try acquiring a read lock without blocking
+// returns true if the lock was acquired
+bool Graph_TryAcquireReadLock
+(
+	Graph *g
+) {
+	ASSERT(g != NULL);
+
+	return pthread_rwlock_tryrdlock(&g->_rwlock) == 0;
+}
+
 // acquire a lock for exclusive access to this graph's data
 void Graph_AcquireWriteLock
 (
@@ -383,6 +394,116 @@ Graph *Graph_New
 	return g;
 }
 
+// clone a delta matrix, including its transpose
+static Delta_Matrix _Graph_CloneMatrix
+(
+	const Delta_Matrix A,  // matrix to clone
+	GrB_Type type          // matrix type
+) {
+	ASSERT(A != NULL);
+
+	GrB_Info  info;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	UNUSED(info);
+
+	info = Delta_Matrix_nrows(&nrows, A);
+	ASSERT(info == GrB_SUCCESS);
+	info = Delta_Matrix_ncols(&ncols, A);
+	ASSERT(info == GrB_SUCCESS);
+
+	Delta_Matrix C;
+	Delta_Matrix TA = Delta_Matrix_getTranspose(A);
+	info = Delta_Matrix_new(&C, type, nrows, ncols, TA != NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = Delta_Matrix_copy(C, A);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(TA != NULL) {
+		info = Delta_Matrix_copy(Delta_Matrix_getTranspose(C), TA);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	return C;
+}
+
+// replace a bitwise copied attribute-set with a deep copy
+static void _Graph_CloneAttributeSet
+(
+	void *item  // attribute-set to clone
+) {
+	AttributeSet *set = (AttributeSet *)item;
+	*set = AttributeSet_Clone(*set);
+}
+
+// clone graph
+Graph *Graph_Clone
+(
+	const Graph *g  // graph to clone
+) {
+	ASSERT(g != NULL);
+	ASSERT(g->reserved_node_count == 0);
+
+	Graph *clone = rm_calloc(1, sizeof(Graph));
+
+	//--------------------------------------------------------------------------
+	// clone entities
+	//--------------------------------------------------------------------------
+
+	// attribute-sets are duplicated in parallel, one task per block
+	clone->nodes = DataBlock_Clone(g->nodes, _Graph_CloneAttributeSet);
+	clone->edges = DataBlock_Clone(g->edges, _Graph_CloneAttributeSet);
+
+	//--------------------------------------------------------------------------
+	// clone matrices
+	//--------------------------------------------------------------------------
+
+	clone->node_labels = _Graph_CloneMatrix(Graph_GetNodeLabelMatrix(g),
+			GrB_BOOL);
+	clone->adjacency_matrix =
+		_Graph_CloneMatrix(Graph_GetAdjacencyMatrix(g, false), GrB_BOOL);
+
+	GrB_Index n = Graph_RequiredMatrixDim(clone);
+	Delta_Matrix_new(&clone->_zero_matrix, GrB_BOOL, n, n, false);
+
+	int label_count = Graph_LabelTypeCount(g);
+	clone->labels = array_new(Delta_Matrix, label_count);
+	for(int i = 0; i < label_count; i++) {
+		Delta_Matrix L = Graph_GetLabelMatrix(g, i);
+		array_append(clone->labels, _Graph_CloneMatrix(L, GrB_BOOL));
+	}
+
+	int relation_count = Graph_RelationTypeCount(g);
+	clone->relations = array_new(Tensor, relation_count);
+	for(int i = 0; i < relation_count; i++) {
+		// in case relation contains multi-edges clone tensor
+		// otherwise treat the relation matrix as a regular 2D matrix
+		// which is a bit faster to clone
+		Tensor R = Graph_GetRelationMatrix(g, i, false);
+		if(Graph_RelationshipContainsMultiEdge(g, i)) {
+			array_append(clone->relations, Tensor_Clone(R));
+		} else {
+			array_append(clone->relations, _Graph_CloneMatrix(R, GrB_UINT64));
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// clone statistics
+	//--------------------------------------------------------------------------
+
+	GraphStatistics_Clone(&clone->stats, &g->stats);
+
+	// initialize a read-write lock scoped to the individual graph
+	_CreateRWLock(clone);
+	clone->_writelocked = false;
+
+	// force GraphBLAS updates and resize matrices to node count by default
+	clone->SynchronizeMatrix = _MatrixSynchronize;
+
+	return clone;
+}
+
 // get outgoing edges of node 'n'
 static void _GetOutgoingNodeEdges
 (
@@ -1049,6 +1170,20 @@ bool Graph_GetNode
 	return (n->attributes != NULL);
 }
 
+// resolves the attributes of node 'n' by its ID
+// deleted nodes are resolved as well, as if they were retrieved prior to
+// their deletion
+void Graph_ResolveNode
+(
+	const Graph *g,
+	Node *n
+) {
+	ASSERT(g != NULL);
+	ASSERT(n != NULL);
+
+	n->attributes = DataBlock_GetItemUnchecked(g->nodes, n->id);
+}
+
 // retrieves edge with given id from graph,
 // returns NULL if edge wasn't found
 bool Graph_GetEdge
@@ -68,6 +68,13 @@ void Graph_AcquireReadLock
 	Graph *g
 );
 
+// try acquiring a read lock without blocking
+// returns true if the lock was acquired
+bool Graph_TryAcquireReadLock
+(
+	Graph *g
+);
+
 // acquire a lock for exclusive access to this graph's data
 void Graph_AcquireWriteLock
 (
@@ -113,6 +120,14 @@ Graph *Graph_New
 	size_t edge_cap   // allocation size for edge datablocks
 );
 
+// clone graph
+// the clone shares no data with 'g', entities and matrices are duplicated
+// caller is expected to hold 'g' read lock
+Graph *Graph_Clone
+(
+	const Graph *g  // graph to clone
+);
+
 // creates a new label matrix, returns id given to label
 LabelID Graph_AddLabel
 (
@@ -352,6 +367,15 @@ bool Graph_GetNode
 	Node *n
 );
 
+// resolves the attributes of node 'n' by its ID
+// deleted nodes are resolved as well, as if they were retrieved prior to
+// their deletion
+void Graph_ResolveNode
+(
+	const Graph *g,
+	Node *n
+);
+
 // retrieves edge with given id from graph,
 // returns NULL if edge wasn't found
 bool Graph_GetEdge
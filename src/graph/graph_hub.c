@@ -205,6 +205,13 @@ void UpdateEntityProperties
 
 	if(entity_type == GETYPE_NODE) {
 		GraphContext_AddNodeToIndices(gc, (Node *)ge);
+
+		// account for the update in the labels' statistics
+		uint label_count;
+		NODE_GET_LABELS(gc->g, (Node *)ge, label_count);
+		for(uint i = 0; i < label_count; i++) {
+			GraphStatistics_IncLabelModifications(&gc->g->stats, labels[i], 1);
+		}
 	} else {
 		GraphContext_AddEdgeToIndices(gc, (Edge *)ge);
 	}
@@ -243,6 +250,8 @@ void UpdateNodeProperty
 		s = GraphContext_GetSchemaByID(gc, label_id, SCHEMA_NODE);
 		ASSERT(s != NULL);
 
+		GraphStatistics_IncLabelModifications(&gc->g->stats, label_id, 1);
+
 		if(attr_id == ATTRIBUTE_ID_ALL) {
 			// remove node from all indices
 			Schema_RemoveNodeFromIndex(s, &n);
@@ -12,8 +12,36 @@ void GraphStatistics_init
 	GraphStatistics *stats
 ) {
 	ASSERT(stats);
-	stats->node_count = array_new(uint64_t, 0);
-	stats->edge_count = array_new(uint64_t, 0);
+	stats->node_count  = array_new(uint64_t, 0);
+	stats->edge_count  = array_new(uint64_t, 0);
+	stats->label_mods  = array_new(uint64_t, 0);
+	stats->label_stats = array_new(LabelStatistics *, 0);
+
+	int res = pthread_mutex_init(&stats->lock, NULL);
+	ASSERT(res == 0);
+}
+
+void GraphStatistics_Clone
+(
+	GraphStatistics *clone,
+	const GraphStatistics *stats
+) {
+	ASSERT(clone != NULL);
+	ASSERT(stats != NULL);
+
+	array_clone(clone->node_count, stats->node_count);
+	array_clone(clone->edge_count, stats->edge_count);
+
+	uint label_count = array_len(stats->node_count);
+	clone->label_mods  = array_new(uint64_t, label_count);
+	clone->label_stats = array_new(LabelStatistics *, label_count);
+	for(uint i = 0; i < label_count; i++) {
+		array_append(clone->label_mods, 0);
+		array_append(clone->label_stats, NULL);
+	}
+
+	int res = pthread_mutex_init(&clone->lock, NULL);
+	ASSERT(res == 0);
 }
 
 void GraphStatistics_IntroduceRelationship
@@ -30,6 +58,11 @@ void GraphStatistics_IntroduceLabel
 ) {
 	ASSERT(stats && stats->node_count);
 	array_append(stats->node_count, 0);
+	array_append(stats->label_mods, 0);
+
+	pthread_mutex_lock(&stats->lock);
+	array_append(stats->label_stats, NULL);
+	pthread_mutex_unlock(&stats->lock);
 }
 
 uint64_t GraphStatistics_EdgeCount
@@ -62,6 +95,102 @@ uint64_t GraphStatistics_NodeCount
 	return stats->node_count[l];
 }
 
+bool GraphStatistics_LabelStale
+(
+	GraphStatistics *stats,
+	LabelID l
+) {
+	ASSERT(stats != NULL);
+	ASSERT(l >= 0 && l < (LabelID)array_len(stats->node_count));
+
+	bool stale;
+	uint64_t mods = stats->label_mods[l];
+
+	pthread_mutex_lock(&stats->lock);
+
+	const LabelStatistics *label_stats = stats->label_stats[l];
+	if(label_stats == NULL) {
+		// never sampled, sample once the label is populated
+		stale = stats->node_count[l] > 0;
+	} else {
+		stale = mods >= MAX(STATISTICS_MIN_MODIFICATIONS,
+				label_stats->node_count * STATISTICS_STALE_RATIO);
+	}
+
+	pthread_mutex_unlock(&stats->lock);
+
+	return stale;
+}
+
+void GraphStatistics_SetLabelStatistics
+(
+	GraphStatistics *stats,
+	LabelID l,
+	LabelStatistics *label_stats
+) {
+	ASSERT(stats       != NULL);
+	ASSERT(label_stats != NULL);
+	ASSERT(l >= 0 && l < (LabelID)array_len(stats->label_stats));
+
+	// modifications are only made under the graph's write lock
+	stats->label_mods[l] = 0;
+
+	pthread_mutex_lock(&stats->lock);
+	LabelStatistics *prev = stats->label_stats[l];
+	stats->label_stats[l] = label_stats;
+	pthread_mutex_unlock(&stats->lock);
+
+	if(prev != NULL) LabelStatistics_Free(prev);
+}
+
+double GraphStatistics_Selectivity
+(
+	GraphStatistics *stats,
+	LabelID l,
+	AttributeID attr,
+	AST_Operator op,
+	const SIValue *v
+) {
+	ASSERT(stats != NULL);
+
+	double selectivity = -1;
+
+	pthread_mutex_lock(&stats->lock);
+
+	if(l >= 0 && l < (LabelID)array_len(stats->label_stats) &&
+	   stats->label_stats[l] != NULL) {
+		selectivity = LabelStatistics_Selectivity(stats->label_stats[l], attr,
+				op, v);
+	}
+
+	pthread_mutex_unlock(&stats->lock);
+
+	return selectivity;
+}
+
+double GraphStatistics_AverageDegree
+(
+	GraphStatistics *stats,
+	LabelID l,
+	RelationID r,
+	bool outgoing
+) {
+	ASSERT(stats != NULL);
+
+	double degree = -1;
+
+	pthread_mutex_lock(&stats->lock);
+
+	if(l >= 0 && l < (LabelID)array_len(stats->label_stats) &&
+	   stats->label_stats[l] != NULL) {
+		degree = LabelStatistics_Degree(stats->label_stats[l], r, outgoing);
+	}
+
+	pthread_mutex_unlock(&stats->lock);
+
+	return degree;
+}
+
 void GraphStatistics_FreeInternals
 (
 	GraphStatistics *stats
@@ -69,4 +198,13 @@ void GraphStatistics_FreeInternals
 	ASSERT(stats);
 	if(stats->node_count) array_free(stats->node_count);
 	if(stats->edge_count) array_free(stats->edge_count);
+	if(stats->label_mods) array_free(stats->label_mods);
+	if(stats->label_stats) {
+		for(uint i = 0; i < array_len(stats->label_stats); i++) {
+			if(stats->label_stats[i]) LabelStatistics_Free(stats->label_stats[i]);
+		}
+		array_free(stats->label_stats);
+	}
+
+	pthread_mutex_destroy(&stats->lock);
 }
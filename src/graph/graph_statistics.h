@@ -7,15 +7,28 @@
 #pragma once
 
 #include <stdint.h>
+#include <pthread.h>
 #include "../util/arr.h"
 #include "entities/node.h"
 #include "entities/edge.h"
+#include "label_statistics.h"
+
+// number of nodes sampled per label when collecting label statistics
+#define STATISTICS_SAMPLE_SIZE 1024
+
+// label statistics are considered stale once the number of modifications
+// made to the label exceeds both a minimum and a fraction of its sampled size
+#define STATISTICS_MIN_MODIFICATIONS 32
+#define STATISTICS_STALE_RATIO 0.2
 
 // graph related statistics
 
 typedef struct {
-	uint64_t *node_count; // array of node count per label matrix
-	uint64_t *edge_count; // array of edge count per relationship matrix
+	uint64_t *node_count;           // array of node count per label matrix
+	uint64_t *edge_count;           // array of edge count per relationship matrix
+	uint64_t *label_mods;           // array of modifications per label since sampled
+	LabelStatistics **label_stats;  // array of sampled statistics per label
+	pthread_mutex_t lock;           // guards label_stats
 } GraphStatistics;
 
 // initialize the node_count and edge_count arrays
@@ -24,6 +37,14 @@ void GraphStatistics_init
 	GraphStatistics *stats
 );
 
+// clone statistics
+// sampled label statistics aren't cloned and will be collected again
+void GraphStatistics_Clone
+(
+	GraphStatistics *clone,       // [output] cloned statistics
+	const GraphStatistics *stats  // statistics to clone
+);
+
 // new relationship is added, resize the edge_count array
 void GraphStatistics_IntroduceRelationship
 (
@@ -67,6 +88,7 @@ static inline void GraphStatistics_IncNodeCount
 ) {
 	ASSERT(l < array_len(stats->node_count));
 	stats->node_count[l] += amount;
+	stats->label_mods[l] += amount;
 }
 
 // decrement the node counter by amount
@@ -78,6 +100,18 @@ static inline void GraphStatistics_DecNodeCount
 ) {
 	ASSERT(l < array_len(stats->node_count) && stats->node_count[l] >= amount);
 	stats->node_count[l] -= amount;
+	stats->label_mods[l] += amount;
+}
+
+// account for modified attributes of nodes with label 'l'
+static inline void GraphStatistics_IncLabelModifications
+(
+	GraphStatistics *stats,
+	LabelID l,
+	uint64_t amount
+) {
+	ASSERT(l < array_len(stats->label_mods));
+	stats->label_mods[l] += amount;
 }
 
 // retrieves edge count for given relationship type
@@ -94,6 +128,44 @@ uint64_t GraphStatistics_NodeCount
 	LabelID l
 );
 
+// returns true if label 'l' should be sampled
+// either it was never sampled or it was modified considerably since
+bool GraphStatistics_LabelStale
+(
+	GraphStatistics *stats,
+	LabelID l
+);
+
+// replace label 'l' sampled statistics, resetting its modification count
+// the caller is expected to hold the graph's read lock
+void GraphStatistics_SetLabelStatistics
+(
+	GraphStatistics *stats,
+	LabelID l,
+	LabelStatistics *label_stats
+);
+
+// estimate the fraction of label 'l' nodes satisfying: attr op v
+// returns -1 if label 'l' wasn't sampled
+double GraphStatistics_Selectivity
+(
+	GraphStatistics *stats,
+	LabelID l,
+	AttributeID attr,
+	AST_Operator op,
+	const SIValue *v
+);
+
+// returns the average outgoing or incoming degree of label 'l' nodes
+// for relationship 'r', -1 if unknown
+double GraphStatistics_AverageDegree
+(
+	GraphStatistics *stats,
+	LabelID l,
+	RelationID r,
+	bool outgoing
+);
+
 // free the internal structures
 void GraphStatistics_FreeInternals
 (
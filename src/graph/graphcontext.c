@@ -14,6 +14,7 @@
 #include "../util/rmalloc.h"
 #include "../util/thpool/pools.h"
 #include "../constraint/constraint.h"
+#include "../index/indexer.h"
 #include "../serializers/graphcontext_type.h"
 #include "../commands/execution_ctx.h"
 
@@ -87,10 +88,11 @@ inline void GraphContext_DecreaseRefCount
 // GraphContext API
 //------------------------------------------------------------------------------
 
-// creates and initializes a graph context struct
-GraphContext *GraphContext_New
+// creates and initializes a graph context struct around graph 'g'
+static GraphContext *_GraphContext_New
 (
-	const char *graph_name
+	const char *graph_name,  // graph name
+	Graph *g                 // graph
 ) {
 	GraphContext *gc = rm_malloc(sizeof(GraphContext));
 
@@ -98,23 +100,14 @@ GraphContext *GraphContext_New
 	gc->slowlog          = SlowLog_New();
 	gc->queries_log      = QueriesLog_New();
 	gc->ref_count        = 0;  // no refences
+	gc->detached         = false;
 	gc->attributes       = raxNew();
 	gc->index_count      = 0;  // no indicies
 	gc->string_mapping   = array_new(char *, 64);
 	gc->encoding_context = GraphEncodeContext_New();
 	gc->decoding_context = GraphDecodeContext_New();
 
-	// read NODE_CREATION_BUFFER size from configuration
-	// this value controls how much extra room we're willing to spend for:
-	// 1. graph entity storage
-	// 2. matrices dimensions
-	size_t node_cap;
-	size_t edge_cap;
-	bool rc = Config_Option_get(Config_NODE_CREATION_BUFFER, &node_cap);
-	assert(rc);
-	edge_cap = node_cap;
-
-	gc->g = Graph_New(node_cap, edge_cap);
+	gc->g = g;
 	gc->graph_name = rm_strdup(graph_name);
 	gc->telemetry_stream = RedisModule_CreateStringPrintf(NULL,
 			TELEMETRY_FORMAT, gc->graph_name);
@@ -138,6 +131,219 @@ GraphContext *GraphContext_New
 	return gc;
 }
 
+// creates and initializes a graph context struct
+GraphContext *GraphContext_New
+(
+	const char *graph_name
+) {
+	// read NODE_CREATION_BUFFER size from configuration
+	// this value controls how much extra room we're willing to spend for:
+	// 1. graph entity storage
+	// 2. matrices dimensions
+	size_t node_cap;
+	size_t edge_cap;
+	bool rc = Config_Option_get(Config_NODE_CREATION_BUFFER, &node_cap);
+	assert(rc);
+	edge_cap = node_cap;
+
+	return _GraphContext_New(graph_name, Graph_New(node_cap, edge_cap));
+}
+
+// clone schema 's' into graph context 'gc'
+// the cloned index is created disabled and is yet to be populated
+static void _GraphContext_CloneSchema
+(
+	GraphContext *gc,  // graph context to add schema to
+	const Schema *s    // schema to clone
+) {
+	SchemaType t = Schema_GetType(s);
+	Schema *clone = Schema_New(t, Schema_GetID(s), Schema_GetName(s));
+
+	if(t == SCHEMA_NODE) {
+		ASSERT(array_len(gc->node_schemas) == Schema_GetID(s));
+		array_append(gc->node_schemas, clone);
+	} else {
+		ASSERT(array_len(gc->relation_schemas) == Schema_GetID(s));
+		array_append(gc->relation_schemas, clone);
+	}
+
+	//--------------------------------------------------------------------------
+	// clone index
+	//--------------------------------------------------------------------------
+
+	// index, prefer pending over active
+	Index idx = PENDING_IDX(s) ? PENDING_IDX(s) : ACTIVE_IDX(s);
+	if(idx != NULL) {
+		Index idx_clone = NULL;
+
+		uint n = Index_FieldsCount(idx);
+		const IndexField *fields = Index_GetFields(idx);
+		for(uint i = 0; i < n; i++) {
+			IndexField field;
+			IndexField_Clone(fields + i, &field);
+			Schema_AddIndex(&idx_clone, clone, &field);
+		}
+		ASSERT(idx_clone != NULL);
+
+		Index_SetLanguage(idx_clone, Index_GetLanguage(idx));
+
+		size_t stopwords_count;
+		char **stopwords = Index_GetStopwords(idx, &stopwords_count);
+		if(stopwords != NULL) {
+			char **_stopwords = array_new(char *, stopwords_count);
+			for(size_t i = 0; i < stopwords_count; i++) {
+				array_append(_stopwords, stopwords[i]);
+			}
+			rm_free(stopwords);
+
+			Index_SetStopwords(idx_clone, &_stopwords);
+		}
+
+		// disable and create index structure
+		// must be enabled once the index is populated
+		Index_Disable(idx_clone);
+	}
+
+	//--------------------------------------------------------------------------
+	// clone constraints
+	//--------------------------------------------------------------------------
+
+	GraphEntityType et = (t == SCHEMA_NODE) ? GETYPE_NODE : GETYPE_EDGE;
+	const Constraint *constraints = Schema_GetConstraints(s);
+	uint n = array_len((Constraint *)constraints);
+	for(uint i = 0; i < n; i++) {
+		Constraint c = constraints[i];
+
+		// only active constraints are cloned
+		if(Constraint_GetStatus(c) != CT_ACTIVE) continue;
+
+		const AttributeID *attrs;
+		uint8_t n_attrs = Constraint_GetAttributes(c, &attrs, NULL);
+
+		AttributeID attr_ids[n_attrs];
+		const char *attr_strs[n_attrs];
+		for(uint8_t j = 0; j < n_attrs; j++) {
+			attr_ids[j]  = attrs[j];
+			attr_strs[j] = GraphContext_GetAttributeString(gc, attrs[j]);
+		}
+
+		Constraint c_clone = Constraint_New((struct GraphContext *)gc,
+				Constraint_GetType(c), Schema_GetID(clone), attr_ids,
+				attr_strs, n_attrs, et, NULL);
+		ASSERT(c_clone != NULL);
+
+		// source constraint is satisfied, so is its clone
+		Constraint_SetStatus(c_clone, CT_ACTIVE);
+		Schema_AddConstraint(clone, c_clone);
+	}
+}
+
+// clone graph context
+// the clone is named 'name' and holds a copy of gc's graph, attributes,
+// schemas, indices and constraints
+// cloned indices are disabled, see GraphContext_PopulateIndices
+// caller is expected to hold gc's graph read lock
+GraphContext *GraphContext_Clone
+(
+	GraphContext *gc,  // graph context to clone
+	const char *name   // clone's name
+) {
+	ASSERT(gc   != NULL);
+	ASSERT(name != NULL);
+
+	GraphContext *clone = _GraphContext_New(name, Graph_Clone(gc->g));
+
+	//--------------------------------------------------------------------------
+	// clone attributes
+	//--------------------------------------------------------------------------
+
+	// attributes are added in order, preserving their IDs
+	pthread_rwlock_rdlock(&gc->_attribute_rwlock);
+
+	uint n = array_len(gc->string_mapping);
+	for(uint i = 0; i < n; i++) {
+		GraphContext_FindOrAddAttribute(clone, gc->string_mapping[i], NULL);
+	}
+
+	pthread_rwlock_unlock(&gc->_attribute_rwlock);
+
+	//--------------------------------------------------------------------------
+	// clone schemas
+	//--------------------------------------------------------------------------
+
+	n = array_len(gc->node_schemas);
+	for(uint i = 0; i < n; i++) {
+		_GraphContext_CloneSchema(clone, gc->node_schemas[i]);
+	}
+
+	n = array_len(gc->relation_schemas);
+	for(uint i = 0; i < n; i++) {
+		_GraphContext_CloneSchema(clone, gc->relation_schemas[i]);
+	}
+
+	return clone;
+}
+
+// populate and enable all of the graph's disabled indices
+// if 'async' is set population is handed to the indexer
+// otherwise indices are populated on the calling thread
+void GraphContext_PopulateIndices
+(
+	GraphContext *gc,  // graph context
+	bool async         // populate asynchronously
+) {
+	ASSERT(gc != NULL);
+
+	Schema **schemas[2] = {gc->node_schemas, gc->relation_schemas};
+
+	for(int i = 0; i < 2; i++) {
+		uint n = array_len(schemas[i]);
+		for(uint j = 0; j < n; j++) {
+			Schema *s = schemas[i][j];
+			Index idx = PENDING_IDX(s);
+
+			if(idx == NULL || Index_Enabled(idx)) continue;
+
+			if(async) {
+				// start async indexing
+				Indexer_PopulateIndex(gc, s, idx);
+			} else {
+				// populate and enable index
+				Index_Populate(idx, gc->g);
+				Index_Enable(idx);
+				Schema_ActivateIndex(s);
+			}
+		}
+	}
+}
+
+// populate the internal structures of all of the graph's active constraints
+// if 'async' is set population is handed to the indexer
+// otherwise constraints are populated on the calling thread
+void GraphContext_PopulateConstraints
+(
+	GraphContext *gc,  // graph context
+	bool async         // populate asynchronously
+) {
+	ASSERT(gc != NULL);
+
+	Schema **schemas[2] = {gc->node_schemas, gc->relation_schemas};
+
+	for(int i = 0; i < 2; i++) {
+		uint n = array_len(schemas[i]);
+		for(uint j = 0; j < n; j++) {
+			Schema *s = schemas[i][j];
+			uint constraint_count = array_len(s->constraints);
+			for(uint k = 0; k < constraint_count; k++) {
+				Constraint c = s->constraints[k];
+				if(Constraint_GetStatus(c) == CT_ACTIVE) {
+					Constraint_Populate(c, (struct GraphContext *)gc, async);
+				}
+			}
+		}
+	}
+}
+
 // _GraphContext_Create tries to get a graph context
 // and if it does not exists, create a new one
 // the try-get-create flow is done when module global lock is acquired
@@ -868,6 +1074,39 @@ static void _DeleteTelemetryStream
 	RedisModule_CloseKey(key);
 }
 
+// mark the graph as detached from its key
+// called once the key holding the graph is deleted or overwritten
+void GraphContext_Detach
+(
+	GraphContext *gc  // graph context
+) {
+	ASSERT(gc != NULL);
+
+	__atomic_store_n(&gc->detached, true, __ATOMIC_SEQ_CST);
+}
+
+// returns true if the graph was detached from its key
+bool GraphContext_Detached
+(
+	const GraphContext *gc  // graph context
+) {
+	ASSERT(gc != NULL);
+
+	return __atomic_load_n(&gc->detached, __ATOMIC_SEQ_CST);
+}
+
+// free a graph context which was never exposed
+// e.g. a clone which didn't make it into the keyspace
+void GraphContext_Free
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	ASSERT(gc->ref_count == 0);
+
+	_GraphContext_Free(gc);
+}
+
 // Free all data associated with graph
 static void _GraphContext_Free(void *arg) {
 	GraphContext *gc = (GraphContext *)arg;
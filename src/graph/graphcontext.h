@@ -43,6 +43,7 @@ typedef struct {
 	Cache *cache;                          // global cache of execution plans
 	XXH32_hash_t version;                  // graph version
 	RedisModuleString *telemetry_stream;   // telemetry stream name
+	bool detached;                         // graph key was deleted or overwritten
 } GraphContext;
 
 //------------------------------------------------------------------------------
@@ -55,6 +56,35 @@ GraphContext *GraphContext_New
 	const char *graph_name
 );
 
+// clone graph context
+// the clone is named 'name' and holds a copy of gc's graph, attributes,
+// schemas, indices and constraints
+// cloned indices are disabled, see GraphContext_PopulateIndices
+// caller is expected to hold gc's graph read lock
+GraphContext *GraphContext_Clone
+(
+	GraphContext *gc,  // graph context to clone
+	const char *name   // clone's name
+);
+
+// populate and enable all of the graph's disabled indices
+// if 'async' is set population is handed to the indexer
+// otherwise indices are populated on the calling thread
+void GraphContext_PopulateIndices
+(
+	GraphContext *gc,  // graph context
+	bool async         // populate asynchronously
+);
+
+// populate the internal structures of all of the graph's active constraints
+// if 'async' is set population is handed to the indexer
+// otherwise constraints are populated on the calling thread
+void GraphContext_PopulateConstraints
+(
+	GraphContext *gc,  // graph context
+	bool async         // populate asynchronously
+);
+
 // increase graph context ref count by 1
 void GraphContext_IncreaseRefCount
 (
@@ -67,6 +97,26 @@ void GraphContext_DecreaseRefCount
 	GraphContext *gc
 );
 
+// mark the graph as detached from its key
+// called once the key holding the graph is deleted or overwritten
+void GraphContext_Detach
+(
+	GraphContext *gc  // graph context
+);
+
+// returns true if the graph was detached from its key
+bool GraphContext_Detached
+(
+	const GraphContext *gc  // graph context
+);
+
+// free a graph context which was never exposed
+// e.g. a clone which didn't make it into the keyspace
+void GraphContext_Free
+(
+	GraphContext *gc
+);
+
 // retrive the graph context according to the graph name
 // readOnly is the access mode to the graph key
 GraphContext *GraphContext_Retrieve
@@ -0,0 +1,401 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "graph.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "label_statistics.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// number of disjoint random ranges a large label is sampled from
+#define SAMPLE_CHUNKS 16
+
+static int _cmp_u64
+(
+	const void *a,
+	const void *b
+) {
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+static int _cmp_double
+(
+	const void *a,
+	const void *b
+) {
+	double x = *(const double *)a;
+	double y = *(const double *)b;
+	return (x > y) - (x < y);
+}
+
+LabelStatistics *LabelStatistics_New
+(
+	uint64_t node_count,  // label's node count
+	uint64_t sample_size  // number of sampled nodes
+) {
+	LabelStatistics *stats = rm_malloc(sizeof(LabelStatistics));
+
+	stats->node_count  = node_count;
+	stats->sample_size = sample_size;
+	stats->attributes  = array_new(AttributeStatistics, 0);
+	stats->degrees     = array_new(DegreeStatistics, 0);
+
+	return stats;
+}
+
+// estimate the number of distinct values among 'n' sampled values
+// out of an estimated 'total' values using the GEE estimator:
+// D = sqrt(total / n) * f1 + (d - f1)
+// where 'd' is the number of distinct sampled values
+// and 'f1' the number of values sampled exactly once
+static double _estimate_distinct
+(
+	SIValue *values,  // sampled values
+	uint64_t n,       // number of sampled values
+	double total      // estimated total number of values
+) {
+	if(n == 0) return 0;
+
+	uint64_t *hashes = rm_malloc(sizeof(uint64_t) * n);
+	for(uint64_t i = 0; i < n; i++) {
+		hashes[i] = SIValue_HashCode(values[i]);
+	}
+	qsort(hashes, n, sizeof(uint64_t), _cmp_u64);
+
+	uint64_t d  = 0;  // distinct sampled values
+	uint64_t f1 = 0;  // values sampled exactly once
+	uint64_t i  = 0;
+	while(i < n) {
+		uint64_t j = i + 1;
+		while(j < n && hashes[j] == hashes[i]) j++;
+		d++;
+		if(j - i == 1) f1++;
+		i = j;
+	}
+
+	rm_free(hashes);
+
+	// all values were sampled
+	if(total <= n) return d;
+
+	double D = sqrt(total / n) * f1 + (d - f1);
+	return MIN(MAX(D, d), total);
+}
+
+void LabelStatistics_AddAttribute
+(
+	LabelStatistics *stats,  // label statistics
+	AttributeID id,          // attribute ID
+	SIValue *values,         // sampled values, reordered in place
+	uint64_t n               // number of values
+) {
+	ASSERT(stats != NULL);
+	ASSERT(n <= stats->sample_size);
+	ASSERT(n == 0 || values != NULL);
+
+	AttributeStatistics attr = {0};
+	attr.id = id;
+
+	if(stats->sample_size == 0) {
+		attr.null_fraction = 1;
+		array_append(stats->attributes, attr);
+		return;
+	}
+
+	double sample_size = stats->sample_size;
+	attr.null_fraction = 1 - (n / sample_size);
+
+	// move numeric values to the front
+	uint64_t numeric = 0;
+	for(uint64_t i = 0; i < n; i++) {
+		if(SI_TYPE(values[i]) & SI_NUMERIC) {
+			SIValue tmp       = values[numeric];
+			values[numeric++] = values[i];
+			values[i]         = tmp;
+		}
+	}
+	attr.numeric_fraction = numeric / sample_size;
+
+	double total = stats->node_count * (1 - attr.null_fraction);
+	attr.distinct = _estimate_distinct(values, n, total);
+
+	//--------------------------------------------------------------------------
+	// equi-depth histogram over numeric values
+	//--------------------------------------------------------------------------
+
+	if(numeric > 1) {
+		double *nums = rm_malloc(sizeof(double) * numeric);
+		for(uint64_t i = 0; i < numeric; i++) {
+			nums[i] = SI_GET_NUMERIC(values[i]);
+		}
+		qsort(nums, numeric, sizeof(double), _cmp_double);
+
+		// each bucket holds the same number of sampled values
+		uint64_t bound_count = MIN(numeric, HISTOGRAM_BUCKETS + 1);
+		for(uint64_t i = 0; i < bound_count; i++) {
+			attr.bounds[i] = nums[i * (numeric - 1) / (bound_count - 1)];
+		}
+		attr.bound_count = bound_count;
+
+		rm_free(nums);
+	}
+
+	array_append(stats->attributes, attr);
+}
+
+void LabelStatistics_AddDegree
+(
+	LabelStatistics *stats,  // label statistics
+	RelationID r,            // relationship type
+	double out_degree,       // average outgoing degree
+	double in_degree         // average incoming degree
+) {
+	ASSERT(stats != NULL);
+
+	DegreeStatistics degree = {.r = r, .out_degree = out_degree,
+		.in_degree = in_degree};
+	array_append(stats->degrees, degree);
+}
+
+// collect up to 'limit' labeled nodes within rows [start, end]
+static void _collect_range
+(
+	const Graph *g,              // graph
+	Delta_MatrixTupleIter *it,   // label matrix iterator
+	GrB_Index start,             // first row
+	GrB_Index end,               // last row
+	uint64_t limit,              // maximum number of nodes to collect
+	Node **nodes                 // [output] collected nodes
+) {
+	GrB_Info info = Delta_MatrixTupleIter_iterate_range(it, start, end);
+	ASSERT(info == GrB_SUCCESS);
+
+	EntityID id;
+	uint64_t collected = 0;
+	while(collected < limit &&
+		  Delta_MatrixTupleIter_next_BOOL(it, &id, NULL, NULL) == GrB_SUCCESS) {
+		Node n;
+		Graph_GetNode(g, id, &n);
+		array_append(*nodes, n);
+		collected++;
+	}
+}
+
+static uint64_t _random_row
+(
+	uint64_t dim
+) {
+	return (((uint64_t)rand() << 31) ^ (uint64_t)rand()) % dim;
+}
+
+LabelStatistics *LabelStatistics_Collect
+(
+	const Graph *g,       // graph to sample
+	LabelID l,            // label to sample
+	uint64_t sample_size  // maximum number of nodes to sample
+) {
+	ASSERT(g != NULL);
+	ASSERT(sample_size >= SAMPLE_CHUNKS);
+
+	uint64_t node_count = Graph_LabeledNodeCount(g, l);
+	Node *nodes = array_new(Node, MIN(node_count, sample_size));
+
+	//--------------------------------------------------------------------------
+	// sample nodes
+	//--------------------------------------------------------------------------
+
+	Delta_MatrixTupleIter it = {0};
+	GrB_Info info = Delta_MatrixTupleIter_attach(&it,
+			Graph_GetLabelMatrix(g, l));
+	ASSERT(info == GrB_SUCCESS);
+
+	if(node_count <= sample_size) {
+		// small label, take all of its nodes
+		_collect_range(g, &it, 0, UINT64_MAX, sample_size, &nodes);
+	} else {
+		// take fixed size chunks starting at random rows
+		// chunks are kept disjoint such that no node is sampled twice
+		uint64_t dim = Graph_RequiredMatrixDim(g);
+		uint64_t starts[SAMPLE_CHUNKS];
+		for(int i = 0; i < SAMPLE_CHUNKS; i++) starts[i] = _random_row(dim);
+		qsort(starts, SAMPLE_CHUNKS, sizeof(uint64_t), _cmp_u64);
+
+		uint64_t chunk = sample_size / SAMPLE_CHUNKS;
+		for(int i = 0; i < SAMPLE_CHUNKS; i++) {
+			uint64_t end = UINT64_MAX;
+			if(i + 1 < SAMPLE_CHUNKS) {
+				if(starts[i + 1] == starts[i]) continue;
+				end = starts[i + 1] - 1;
+			}
+			_collect_range(g, &it, starts[i], end, chunk, &nodes);
+		}
+	}
+
+	Delta_MatrixTupleIter_detach(&it);
+
+	uint64_t n = array_len(nodes);
+	LabelStatistics *stats = LabelStatistics_New(node_count, n);
+	if(n == 0) goto cleanup;
+
+	//--------------------------------------------------------------------------
+	// attribute statistics
+	//--------------------------------------------------------------------------
+
+	// group sampled values by attribute
+	// values are borrowed from the graph, which is locked for reading
+	SIValue **values = array_new(SIValue *, 0);
+	for(uint64_t i = 0; i < n; i++) {
+		const AttributeSet set = GraphEntity_GetAttributes(
+				(GraphEntity *)(nodes + i));
+		uint16_t attr_count = AttributeSet_Count(set);
+		for(uint16_t j = 0; j < attr_count; j++) {
+			AttributeID id;
+			SIValue v = AttributeSet_GetIdx(set, j, &id);
+			while(array_len(values) <= id) array_append(values, NULL);
+			if(values[id] == NULL) values[id] = array_new(SIValue, 1);
+			array_append(values[id], v);
+		}
+	}
+
+	for(uint i = 0; i < array_len(values); i++) {
+		if(values[i] == NULL) continue;
+		LabelStatistics_AddAttribute(stats, i, values[i],
+				array_len(values[i]));
+		array_free(values[i]);
+	}
+	array_free(values);
+
+	//--------------------------------------------------------------------------
+	// degree statistics
+	//--------------------------------------------------------------------------
+
+	int relation_count = Graph_RelationTypeCount(g);
+	for(RelationID r = 0; r < relation_count; r++) {
+		uint64_t out_degree = 0;
+		uint64_t in_degree  = 0;
+		for(uint64_t i = 0; i < n; i++) {
+			out_degree += Graph_GetNodeDegree(g, nodes + i,
+					GRAPH_EDGE_DIR_OUTGOING, r);
+			in_degree  += Graph_GetNodeDegree(g, nodes + i,
+					GRAPH_EDGE_DIR_INCOMING, r);
+		}
+
+		LabelStatistics_AddDegree(stats, r, (double)out_degree / n,
+				(double)in_degree / n);
+	}
+
+cleanup:
+	array_free(nodes);
+	return stats;
+}
+
+// fraction of the histogram's values smaller than 'x'
+static double _histogram_fraction_below
+(
+	const AttributeStatistics *attr,  // attribute statistics
+	double x                          // value
+) {
+	ASSERT(attr->bound_count > 1);
+
+	uint8_t n = attr->bound_count;
+	if(x <= attr->bounds[0])     return 0;
+	if(x >= attr->bounds[n - 1]) return 1;
+
+	// interpolate within the bucket containing 'x'
+	uint8_t buckets = n - 1;
+	for(uint8_t i = 0; i < buckets; i++) {
+		double lo = attr->bounds[i];
+		double hi = attr->bounds[i + 1];
+		if(x < hi) {
+			double within = (hi > lo) ? (x - lo) / (hi - lo) : 0.5;
+			return (i + within) / buckets;
+		}
+	}
+
+	return 1;
+}
+
+double LabelStatistics_Selectivity
+(
+	const LabelStatistics *stats,  // label statistics
+	AttributeID attr,              // compared attribute
+	AST_Operator op,               // comparison operator
+	const SIValue *v               // [optional] compared value
+) {
+	ASSERT(stats != NULL);
+
+	if(stats->sample_size == 0) {
+		return (op == OP_EQUAL) ?
+			DEFAULT_EQ_SELECTIVITY : DEFAULT_RANGE_SELECTIVITY;
+	}
+
+	const AttributeStatistics *a = NULL;
+	for(uint i = 0; i < array_len(stats->attributes); i++) {
+		if(stats->attributes[i].id == attr) {
+			a = stats->attributes + i;
+			break;
+		}
+	}
+
+	// none of the sampled nodes holds the attribute
+	if(a == NULL) return 1.0 / (stats->sample_size + 1);
+
+	double not_null = 1 - a->null_fraction;
+	double distinct = MAX(a->distinct, 1);
+
+	switch(op) {
+		case OP_EQUAL:
+			return not_null / distinct;
+
+		case OP_NEQUAL:
+			return not_null * (1 - 1 / distinct);
+
+		case OP_LT:
+		case OP_LE:
+		case OP_GT:
+		case OP_GE:
+			if(v != NULL && (SI_TYPE(*v) & SI_NUMERIC) && a->bound_count > 1) {
+				double below = _histogram_fraction_below(a, SI_GET_NUMERIC(*v));
+				double frac  = (op == OP_LT || op == OP_LE) ? below : 1 - below;
+				return a->numeric_fraction * frac;
+			}
+			return not_null * DEFAULT_RANGE_SELECTIVITY;
+
+		default:
+			return not_null * DEFAULT_RANGE_SELECTIVITY;
+	}
+}
+
+double LabelStatistics_Degree
+(
+	const LabelStatistics *stats,  // label statistics
+	RelationID r,                  // relationship type
+	bool outgoing                  // outgoing or incoming edges
+) {
+	ASSERT(stats != NULL);
+
+	for(uint i = 0; i < array_len(stats->degrees); i++) {
+		const DegreeStatistics *d = stats->degrees + i;
+		if(d->r == r) return outgoing ? d->out_degree : d->in_degree;
+	}
+
+	return -1;
+}
+
+void LabelStatistics_Free
+(
+	LabelStatistics *stats  // statistics to free
+) {
+	ASSERT(stats != NULL);
+
+	array_free(stats->attributes);
+	array_free(stats->degrees);
+	rm_free(stats);
+}
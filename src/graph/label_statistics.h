@@ -0,0 +1,109 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../value.h"
+#include "../ast/ast_shared.h"
+#include "entities/node.h"
+#include "entities/edge.h"
+
+#include <stdint.h>
+
+// number of buckets in an attribute's equi-depth histogram
+#define HISTOGRAM_BUCKETS 16
+
+// selectivity assumed for predicates the statistics can't account for
+#define DEFAULT_EQ_SELECTIVITY    0.1
+#define DEFAULT_RANGE_SELECTIVITY (1.0 / 3.0)
+
+// forward declaration
+typedef struct Graph Graph;
+
+// statistics of a single attribute across a label's sampled nodes
+typedef struct {
+	AttributeID id;                        // attribute ID
+	double null_fraction;                  // fraction of nodes missing attribute
+	double numeric_fraction;               // fraction of nodes holding a number
+	double distinct;                       // estimated number of distinct values
+	double bounds[HISTOGRAM_BUCKETS + 1];  // equi-depth numeric histogram
+	uint8_t bound_count;                   // number of bounds, 0 no histogram
+} AttributeStatistics;
+
+// average degree of a label's nodes for a single relationship type
+typedef struct {
+	RelationID r;       // relationship type
+	double out_degree;  // average number of outgoing edges
+	double in_degree;   // average number of incoming edges
+} DegreeStatistics;
+
+// sampled statistics of a single label
+typedef struct {
+	uint64_t node_count;              // label's node count at sample time
+	uint64_t sample_size;             // number of sampled nodes
+	AttributeStatistics *attributes;  // array of attribute statistics
+	DegreeStatistics *degrees;        // array of degree statistics
+} LabelStatistics;
+
+// create an empty label statistics
+LabelStatistics *LabelStatistics_New
+(
+	uint64_t node_count,  // label's node count
+	uint64_t sample_size  // number of sampled nodes
+);
+
+// compute attribute statistics from sampled values
+// 'values' holds the attribute's value of every sampled node holding it
+void LabelStatistics_AddAttribute
+(
+	LabelStatistics *stats,  // label statistics
+	AttributeID id,          // attribute ID
+	SIValue *values,         // sampled values, reordered in place
+	uint64_t n               // number of values
+);
+
+// record the average degree of the sampled nodes for relationship 'r'
+void LabelStatistics_AddDegree
+(
+	LabelStatistics *stats,  // label statistics
+	RelationID r,            // relationship type
+	double out_degree,       // average outgoing degree
+	double in_degree         // average incoming degree
+);
+
+// sample up to 'sample_size' nodes of label 'l' and compute their statistics
+// the caller is expected to hold the graph's read lock
+LabelStatistics *LabelStatistics_Collect
+(
+	const Graph *g,       // graph to sample
+	LabelID l,            // label to sample
+	uint64_t sample_size  // maximum number of nodes to sample
+);
+
+// estimate the fraction of the label's nodes satisfying: attr op v
+// 'v' is NULL when the compared value is unknown at planning time
+// e.g. a query parameter
+double LabelStatistics_Selectivity
+(
+	const LabelStatistics *stats,  // label statistics
+	AttributeID attr,              // compared attribute
+	AST_Operator op,               // comparison operator
+	const SIValue *v               // [optional] compared value
+);
+
+// returns the average outgoing or incoming degree of the label's nodes
+// for relationship 'r', -1 if unknown
+double LabelStatistics_Degree
+(
+	const LabelStatistics *stats,  // label statistics
+	RelationID r,                  // relationship type
+	bool outgoing                  // outgoing or incoming edges
+);
+
+// free label statistics
+void LabelStatistics_Free
+(
+	LabelStatistics *stats  // statistics to free
+);
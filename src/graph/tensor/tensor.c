@@ -760,6 +760,76 @@ static void _free_vectors
 	}
 }
 
+// duplicate vector entries of a tensor
+static void _dup_vectors
+(
+	void *z,       // new value
+	const void *x  // current entry
+) {
+	uint64_t _x = *(uint64_t*)(x);
+
+	// see if entry is a vector
+	if(!SCALAR_ENTRY(_x)) {
+		// replace entry with a duplicate of the vector
+		GrB_Vector V = AS_VECTOR(_x);
+		GrB_Vector dup;
+		GrB_Info info = GrB_Vector_dup(&dup, V);
+		ASSERT(info == GrB_SUCCESS);
+		_x = (uint64_t)(uintptr_t)SET_MSB(dup);
+	}
+
+	*(uint64_t*)z = _x;
+}
+
+// clone tensor
+// vector entries are duplicated, the clone shares no data with T
+Tensor Tensor_Clone
+(
+	const Tensor T  // tensor to clone
+) {
+	ASSERT(T != NULL);
+
+	GrB_Info  info;
+	GrB_Index nrows;
+	GrB_Index ncols;
+
+	info = Delta_Matrix_nrows(&nrows, T);
+	ASSERT(info == GrB_SUCCESS);
+	info = Delta_Matrix_ncols(&ncols, T);
+	ASSERT(info == GrB_SUCCESS);
+
+	Tensor clone = Tensor_new(nrows, ncols);
+
+	// copy both T and its transpose
+	info = Delta_Matrix_copy(clone, T);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = Delta_Matrix_copy(Delta_Matrix_getTranspose(clone),
+			Delta_Matrix_getTranspose(T));
+	ASSERT(info == GrB_SUCCESS);
+
+	// flush clone, all entries, vectors included, are now in M
+	// entries pending deletion are dropped and won't be visited below
+	info = Delta_Matrix_wait(clone, true);
+	ASSERT(info == GrB_SUCCESS);
+
+	GrB_Matrix M = Delta_Matrix_M(clone);
+
+	// initialize unaryop only once
+	static GrB_UnaryOp unaryop = NULL;
+	if(unaryop == NULL) {
+		info = GrB_UnaryOp_new(&unaryop, _dup_vectors, GrB_UINT64, GrB_UINT64);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	// at this point vector entries are shared between T and its clone
+	// replace each vector entry with its own copy
+	info = GrB_Matrix_apply(M, NULL, NULL, unaryop, M, NULL);
+	ASSERT(info == GrB_SUCCESS);
+
+	return clone;
+}
+
 // free tensor
 void Tensor_free
 (
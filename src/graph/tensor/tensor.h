@@ -86,6 +86,13 @@ uint64_t Tensor_ColDegree
 	GrB_Index col    // col
 );
 
+// clone tensor
+// vector entries are duplicated, the clone shares no data with T
+Tensor Tensor_Clone
+(
+	const Tensor T  // tensor to clone
+);
+
 // free tensor
 void Tensor_free
 (
@@ -0,0 +1,383 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "hash_index.h"
+#include "../util/rmalloc.h"
+
+// entity slot states are encoded within the slot's entity ID
+#define SLOT_EMPTY     ((EntityID)INVALID_ENTITY_ID)
+#define SLOT_TOMBSTONE ((EntityID)INVALID_ENTITY_ID - 1)
+#define SLOT_USED(id)  ((id) < SLOT_TOMBSTONE)
+
+// key slot states are encoded within the slot's chain head
+#define NIL            UINT64_MAX        // no slot
+#define KEY_TOMBSTONE  (UINT64_MAX - 1)  // removed key
+#define KEY_USED(head) ((head) < KEY_TOMBSTONE)
+
+// initial number of slots, must be a power of 2
+#define HASH_INDEX_INIT_CAP 64
+
+// table is grown once used + tombstone slots exceed 3/4 of its capacity
+#define HASH_INDEX_OVERLOADED(cap, used) ((used) > ((cap) >> 1) + ((cap) >> 2))
+
+// key -> chain of entities slot
+typedef struct {
+	uint64_t key;   // key
+	uint64_t head;  // first entity slot associated with key
+} _KeySlot;
+
+// entity -> key slot
+// entities sharing a key are chained
+typedef struct {
+	EntityID id;    // entity ID
+	uint64_t key;   // key entity is associated with
+	uint64_t next;  // next entity slot associated with key
+	uint64_t prev;  // previous entity slot associated with key
+} _EntitySlot;
+
+struct _HashIndex {
+	_KeySlot *keys;           // key -> entities table, one slot per key
+	_EntitySlot *entities;    // entity -> key table
+	uint64_t cap;             // number of slots in each table
+	uint64_t count;           // number of indexed entities
+	uint64_t key_count;       // number of distinct keys
+	uint64_t tombstones;      // number of tombstones in entities table
+	uint64_t key_tombstones;  // number of tombstones in keys table
+};
+
+// entity IDs are sequential, scramble them before probing
+static inline uint64_t _mix
+(
+	uint64_t x
+) {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+// allocate tables with 'cap' empty slots
+static void _HashIndex_Allocate
+(
+	HashIndex hidx,  // hash index
+	uint64_t cap     // number of slots
+) {
+	hidx->cap            = cap;
+	hidx->count          = 0;
+	hidx->key_count      = 0;
+	hidx->tombstones     = 0;
+	hidx->key_tombstones = 0;
+	hidx->keys           = rm_malloc(sizeof(_KeySlot) * cap);
+	hidx->entities       = rm_malloc(sizeof(_EntitySlot) * cap);
+
+	for(uint64_t i = 0; i < cap; i++) {
+		hidx->keys[i].head   = NIL;
+		hidx->entities[i].id = SLOT_EMPTY;
+	}
+}
+
+// locate entity slot, returns NIL if entity isn't indexed
+static uint64_t _HashIndex_FindEntity
+(
+	const HashIndex hidx,  // hash index
+	EntityID id            // entity to locate
+) {
+	uint64_t mask = hidx->cap - 1;
+	uint64_t pos  = _mix(id) & mask;
+
+	for(uint64_t i = 0; i < hidx->cap; i++) {
+		const _EntitySlot *slot = hidx->entities + pos;
+		if(slot->id == id) {
+			return pos;
+		}
+		if(slot->id == SLOT_EMPTY) {
+			return NIL;
+		}
+		pos = (pos + 1) & mask;
+	}
+
+	return NIL;
+}
+
+// locate key slot, returns NIL if key isn't indexed
+static uint64_t _HashIndex_FindKey
+(
+	const HashIndex hidx,  // hash index
+	uint64_t key           // key
+) {
+	uint64_t mask = hidx->cap - 1;
+	uint64_t pos  = key & mask;
+
+	for(uint64_t i = 0; i < hidx->cap; i++) {
+		const _KeySlot *slot = hidx->keys + pos;
+		if(KEY_USED(slot->head) && slot->key == key) {
+			return pos;
+		}
+		if(slot->head == NIL) {
+			return NIL;
+		}
+		pos = (pos + 1) & mask;
+	}
+
+	return NIL;
+}
+
+// get key slot, adding key if it isn't indexed
+// assumes keys table isn't overloaded
+static uint64_t _HashIndex_AddKey
+(
+	HashIndex hidx,  // hash index
+	uint64_t key     // key
+) {
+	uint64_t mask      = hidx->cap - 1;
+	uint64_t pos       = key & mask;
+	uint64_t tombstone = NIL;
+
+	while(true) {
+		_KeySlot *slot = hidx->keys + pos;
+		if(KEY_USED(slot->head)) {
+			if(slot->key == key) {
+				return pos;
+			}
+		} else if(slot->head == KEY_TOMBSTONE) {
+			if(tombstone == NIL) {
+				tombstone = pos;
+			}
+		} else {
+			// reached the end of the probe sequence, key is missing
+			break;
+		}
+		pos = (pos + 1) & mask;
+	}
+
+	// reuse the first tombstone along the probe sequence
+	if(tombstone != NIL) {
+		pos = tombstone;
+		hidx->key_tombstones--;
+	}
+
+	// the key's chain is populated by the caller
+	hidx->keys[pos].key  = key;
+	hidx->keys[pos].head = KEY_TOMBSTONE;
+	hidx->key_count++;
+
+	return pos;
+}
+
+// add (key, id) pair to both tables
+// assumes entity isn't indexed and tables aren't overloaded
+static void _HashIndex_Add
+(
+	HashIndex hidx,  // hash index
+	uint64_t key,    // key
+	EntityID id      // entity ID
+) {
+	uint64_t mask = hidx->cap - 1;
+
+	// entity -> key, entity isn't indexed, reuse the first free slot
+	uint64_t pos = _mix(id) & mask;
+	while(SLOT_USED(hidx->entities[pos].id)) {
+		pos = (pos + 1) & mask;
+	}
+	if(hidx->entities[pos].id == SLOT_TOMBSTONE) {
+		hidx->tombstones--;
+	}
+
+	// key -> entities, prepend entity to key's chain
+	_KeySlot *k_slot = hidx->keys + _HashIndex_AddKey(hidx, key);
+	uint64_t head = KEY_USED(k_slot->head) ? k_slot->head : NIL;
+
+	_EntitySlot *e_slot = hidx->entities + pos;
+	e_slot->id   = id;
+	e_slot->key  = key;
+	e_slot->next = head;
+	e_slot->prev = NIL;
+
+	if(head != NIL) {
+		hidx->entities[head].prev = pos;
+	}
+	k_slot->head = pos;
+
+	hidx->count++;
+}
+
+// rebuild tables, dropping tombstones and growing if required
+static void _HashIndex_Rehash
+(
+	HashIndex hidx  // hash index
+) {
+	_EntitySlot *entities = hidx->entities;
+	_KeySlot    *keys     = hidx->keys;
+	uint64_t    cap       = hidx->cap;
+	uint64_t    new_cap   = cap;
+
+	// grow only if live entries occupy at least half of the tables
+	// otherwise clearing tombstones is sufficient
+	if(hidx->count >= (cap >> 1)) {
+		new_cap = cap << 1;
+	}
+
+	_HashIndex_Allocate(hidx, new_cap);
+
+	for(uint64_t i = 0; i < cap; i++) {
+		if(SLOT_USED(entities[i].id)) {
+			_HashIndex_Add(hidx, entities[i].key, entities[i].id);
+		}
+	}
+
+	rm_free(entities);
+	rm_free(keys);
+}
+
+// create a new hash index
+HashIndex HashIndex_New(void) {
+	HashIndex hidx = rm_malloc(sizeof(struct _HashIndex));
+
+	_HashIndex_Allocate(hidx, HASH_INDEX_INIT_CAP);
+
+	return hidx;
+}
+
+// returns number of entities in index
+uint64_t HashIndex_Count
+(
+	const HashIndex hidx  // hash index
+) {
+	ASSERT(hidx != NULL);
+
+	return hidx->count;
+}
+
+// associate entity with key
+// if entity is already associated with a different key
+// its previous association is dropped
+void HashIndex_Insert
+(
+	HashIndex hidx,  // hash index
+	uint64_t key,    // key
+	EntityID id      // entity ID
+) {
+	ASSERT(hidx != NULL);
+	ASSERT(SLOT_USED(id));
+
+	uint64_t pos = _HashIndex_FindEntity(hidx, id);
+	if(pos != NIL) {
+		// entity already associated with key, nothing to do
+		if(hidx->entities[pos].key == key) {
+			return;
+		}
+
+		// drop previous association
+		HashIndex_Remove(hidx, id);
+	}
+
+	if(HASH_INDEX_OVERLOADED(hidx->cap, hidx->count + hidx->tombstones + 1) ||
+	   HASH_INDEX_OVERLOADED(hidx->cap,
+		   hidx->key_count + hidx->key_tombstones + 1)) {
+		_HashIndex_Rehash(hidx);
+	}
+
+	_HashIndex_Add(hidx, key, id);
+}
+
+// remove entity from index
+// returns true if entity was removed
+bool HashIndex_Remove
+(
+	HashIndex hidx,  // hash index
+	EntityID id      // entity to remove
+) {
+	ASSERT(hidx != NULL);
+
+	uint64_t pos = _HashIndex_FindEntity(hidx, id);
+	if(pos == NIL) {
+		return false;
+	}
+
+	_EntitySlot *e_slot = hidx->entities + pos;
+	uint64_t k = _HashIndex_FindKey(hidx, e_slot->key);
+	ASSERT(k != NIL);
+	_KeySlot *k_slot = hidx->keys + k;
+
+	// unlink entity from key's chain
+	if(e_slot->prev != NIL) {
+		hidx->entities[e_slot->prev].next = e_slot->next;
+	} else {
+		k_slot->head = e_slot->next;
+	}
+
+	if(e_slot->next != NIL) {
+		hidx->entities[e_slot->next].prev = e_slot->prev;
+	}
+
+	e_slot->id = SLOT_TOMBSTONE;
+	hidx->count--;
+	hidx->tombstones++;
+
+	// last entity associated with key, drop key
+	if(k_slot->head == NIL) {
+		k_slot->head = KEY_TOMBSTONE;
+		hidx->key_count--;
+		hidx->key_tombstones++;
+	}
+
+	return true;
+}
+
+// initialize iterator over all entities associated with key
+void HashIndex_Find
+(
+	const HashIndex hidx,   // hash index
+	uint64_t key,           // key to search
+	HashIndexIterator *it   // iterator to initialize
+) {
+	ASSERT(it   != NULL);
+	ASSERT(hidx != NULL);
+
+	uint64_t k = _HashIndex_FindKey(hidx, key);
+
+	it->hidx = hidx;
+	it->pos  = (k == NIL) ? NIL : hidx->keys[k].head;
+}
+
+// advance iterator, returns false when depleted
+bool HashIndexIterator_Next
+(
+	HashIndexIterator *it,  // iterator
+	EntityID *id            // [output] entity ID
+) {
+	ASSERT(it != NULL);
+
+	if(it->pos == NIL) {
+		return false;
+	}
+
+	const _EntitySlot *slot = it->hidx->entities + it->pos;
+	if(id != NULL) {
+		*id = slot->id;
+	}
+	it->pos = slot->next;
+
+	return true;
+}
+
+// free hash index
+void HashIndex_Free
+(
+	HashIndex *hidx  // hash index to free
+) {
+	ASSERT(hidx != NULL && *hidx != NULL);
+
+	HashIndex _hidx = *hidx;
+
+	rm_free(_hidx->keys);
+	rm_free(_hidx->entities);
+	rm_free(_hidx);
+
+	*hidx = NULL;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../graph/entities/graph_entity.h"
+
+// native hash index
+// maps a 64 bit key (usually a hash of one or more attribute values)
+// to entity IDs, multiple entities may share the same key
+//
+// the index is made of two open addressing tables
+// 1. key -> chain of entity IDs, one slot per distinct key, used for lookups
+// 2. entity ID -> key, unique, used to locate an entity's previous key
+//    when the entity is updated or removed
+//
+// entities sharing a key are linked through their entity slots
+// such that inserting, removing and looking up an entity doesn't depend
+// on the number of entities sharing its key
+//
+// keys are not required to be unique, callers are expected to verify
+// each candidate returned by a lookup against the actual searched values
+
+typedef struct _HashIndex *HashIndex;
+
+// iterates over all entities associated with a key
+typedef struct {
+	HashIndex hidx;  // iterated index
+	uint64_t pos;    // current entity slot within key's chain
+} HashIndexIterator;
+
+// create a new hash index
+HashIndex HashIndex_New(void);
+
+// returns number of entities in index
+uint64_t HashIndex_Count
+(
+	const HashIndex hidx  // hash index
+);
+
+// associate entity with key
+// if entity is already associated with a different key
+// its previous association is dropped
+void HashIndex_Insert
+(
+	HashIndex hidx,  // hash index
+	uint64_t key,    // key
+	EntityID id      // entity ID
+);
+
+// remove entity from index
+// returns true if entity was removed
+bool HashIndex_Remove
+(
+	HashIndex hidx,  // hash index
+	EntityID id      // entity to remove
+);
+
+// initialize iterator over all entities associated with key
+void HashIndex_Find
+(
+	const HashIndex hidx,   // hash index
+	uint64_t key,           // key to search
+	HashIndexIterator *it   // iterator to initialize
+);
+
+// advance iterator, returns false when depleted
+bool HashIndexIterator_Next
+(
+	HashIndexIterator *it,  // iterator
+	EntityID *id            // [output] entity ID
+);
+
+// free hash index
+void HashIndex_Free
+(
+	HashIndex *hidx  // hash index to free
+);
+
@@ -17,6 +17,7 @@ typedef enum {
 	INDEXER_IDX_POPULATE,        // populate index
 	INDEXER_CONSTRAINT_DROP,     // drop index
 	INDEXER_CONSTRAINT_ENFORCE,  // populate index
+	INDEXER_CONSTRAINT_POPULATE, // populate constraint
 } IndexerOp;
 
 // indexer task
@@ -44,6 +45,12 @@ typedef struct {
 	Constraint c;      // constraint to enforce
 } ConstraintEnforceCtx;
 
+// constraint populate context
+typedef struct {
+	GraphContext *gc;  // graph object
+	Constraint c;      // constraint to populate
+} ConstraintPopulateCtx;
+
 // constraint drop context
 typedef struct {
 	GraphContext *gc;  // graph object
@@ -176,6 +183,28 @@ cleanup:
 	rm_free(ctx);
 }
 
+// constraint populate task handler
+static void _indexer_populate_constraint
+(
+	ConstraintPopulateCtx *ctx
+) {
+	Constraint c = ctx->c;
+	Graph *g = GraphContext_GetGraph(ctx->gc);
+
+	// populate constraint unless it is about to be dropped
+	if(Constraint_PendingChanges(c) == 1) {
+		Constraint_PopulateEntities(c, g);
+	}
+
+	// decrease number of pending changes
+	Constraint_DecPendingChanges(c);
+
+	// decrease graph reference count
+	GraphContext_DecreaseRefCount(ctx->gc);
+
+	rm_free(ctx);
+}
+
 // constraint drop task handler
 static void _indexer_drop_constraint
 (
@@ -220,6 +249,12 @@ static void *_indexer_run
 				_indexer_enforce_constraint(pdata);
 				break;
 			}
+			case INDEXER_CONSTRAINT_POPULATE:
+			{
+				ConstraintPopulateCtx *pdata = (ConstraintPopulateCtx*)ctx.pdata;
+				_indexer_populate_constraint(pdata);
+				break;
+			}
 			case INDEXER_CONSTRAINT_DROP:
 			{
 				ConstraintDropCtx *pdata = (ConstraintDropCtx*)ctx.pdata;
@@ -458,6 +493,28 @@ void Indexer_EnforceConstraint
 	_indexer_AddTask(INDEXER_CONSTRAINT_ENFORCE, ctx);
 }
 
+// populates constraint
+// adds the task for populating the given constraint to the indexer
+void Indexer_PopulateConstraint
+(
+	Constraint c,     // constraint to populate
+	GraphContext *gc  // graph context
+) {
+	ASSERT(c       != NULL);
+	ASSERT(gc      != NULL);
+	ASSERT(indexer != NULL);
+
+	ConstraintPopulateCtx *ctx = rm_malloc(sizeof(ConstraintPopulateCtx));
+	ctx->c  = c;
+	ctx->gc = gc;
+
+	// increase graph reference count
+	// count will be reduced once this task is perfomed
+	GraphContext_IncreaseRefCount(gc);
+
+	_indexer_AddTask(INDEXER_CONSTRAINT_POPULATE, ctx);
+}
+
 // drops constraint asynchronously
 // this function simply place the drop constraint request onto the queue
 // eventually the indexer working thread will pick it up and drop the constraint
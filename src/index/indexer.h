@@ -50,6 +50,14 @@ void Indexer_EnforceConstraint
 	GraphContext *gc  // graph context
 );
 
+// populates constraint
+// adds the task for populating the given active constraint to the indexer
+void Indexer_PopulateConstraint
+(
+	Constraint c,     // constraint to populate
+	GraphContext *gc  // graph context
+);
+
 // drops constraint asynchronously
 // this function simply place the drop request onto a queue
 // eventually the indexer working thread will pick it up and drop the constraint
@@ -5,13 +5,33 @@
  */
 
 #include "RG.h"
+#include "xxhash.h"
 #include "queries_log.h"
 #include "util/rmalloc.h"
 #include "configuration/config.h"
 
+#include <ctype.h>
+#include <strings.h>
 #include <pthread.h>
 #include <stdatomic.h>
 
+// number of slots in the query runtime index, must be a power of 2
+#define RUNTIME_SLOTS 1024
+
+// weight of the latest execution in a query's average runtime
+#define RUNTIME_ALPHA 0.2
+
+// number of executions required before a query's average runtime is trusted
+#define RUNTIME_MIN_SAMPLES 3
+
+// average runtime of a query
+typedef struct QueryRuntime {
+	uint64_t key;        // query key
+	double runtime;      // average runtime, milliseconds
+	uint32_t samples;    // number of executions recorded
+	bool cached_read;    // last execution was a read-only cache hit
+} QueryRuntime;
+
 // holds query statistics per graph
 typedef struct QueriesCounters {
     _Atomic uint64_t ro_succeeded_n;     // # read-only queries succeeded
@@ -25,12 +45,74 @@ typedef struct QueriesCounters {
 // QueriesLog
 // maintains a log of queries
 typedef struct _QueriesLog {
-	CircularBuffer queries;    // buffer
-	CircularBuffer swap;       // swap buffer
-	QueriesCounters counters;  // counters with states
-	pthread_rwlock_t rwlock;   // RWLock
+	CircularBuffer queries;         // buffer
+	CircularBuffer swap;            // swap buffer
+	QueriesCounters counters;       // counters with states
+	pthread_rwlock_t rwlock;        // RWLock
+	QueryRuntime *runtimes;         // direct mapped query runtime index
+	pthread_mutex_t runtimes_lock;  // runtime index lock
 } _QueriesLog;
 
+// computes query key
+// the parameters prefix "CYPHER a=1 b='x' ..." is skipped such that
+// executions differing only by their parameters' values share a key
+// in case the prefix can't be scanned the entire query string is hashed
+static uint64_t _QueriesLog_QueryKey
+(
+	const char *query  // query string
+) {
+	const char *body = query;
+	while(isspace(*body)) body++;
+
+	if(strncasecmp(body, "CYPHER", 6) == 0 && isspace(body[6])) {
+		const char *p = body + 6;
+
+		// skip name=value pairs
+		while(true) {
+			while(isspace(*p)) p++;
+
+			// parameter name
+			const char *name = p;
+			while(isalnum(*p) || *p == '_') p++;
+			if(p == name) break;
+
+			while(isspace(*p)) p++;
+			if(*p != '=') break;
+			p++;
+			while(isspace(*p)) p++;
+
+			// parameter value, ends at a white space
+			// outside of quotes and brackets
+			int depth = 0;
+			char quote = 0;
+			for(; *p != '\0'; p++) {
+				if(quote != 0) {
+					if(*p == '\\' && p[1] != '\0') p++;
+					else if(*p == quote) quote = 0;
+				} else if(*p == '\'' || *p == '"') {
+					quote = *p;
+				} else if(*p == '[' || *p == '{' || *p == '(') {
+					depth++;
+				} else if(*p == ']' || *p == '}' || *p == ')') {
+					depth--;
+				} else if(depth == 0 && isspace(*p)) {
+					break;
+				}
+			}
+
+			// malformed prefix, hash entire query
+			if(quote != 0 || depth != 0) {
+				body = query;
+				break;
+			}
+
+			body = p;
+		}
+	}
+
+	return XXH64(body, strlen(body), 0);
+}
+
 // create a new queries log structure
 QueriesLog QueriesLog_New(void) {
 	QueriesLog log = rm_calloc(1, sizeof(struct _QueriesLog));
@@ -49,6 +131,10 @@ QueriesLog QueriesLog_New(void) {
 	log->swap    = CircularBuffer_New(item_size, cap);
 	log->queries = CircularBuffer_New(item_size, cap);
 
+	log->runtimes = rm_calloc(RUNTIME_SLOTS, sizeof(QueryRuntime));
+	res = pthread_mutex_init(&log->runtimes_lock, NULL);
+	ASSERT(res == 0);
+
 	return log;
 }
 
@@ -95,6 +181,57 @@ void QueriesLog_AddQuery
 
 	res = pthread_rwlock_unlock(&log->rwlock);
 	ASSERT(res == 0);
+
+	//--------------------------------------------------------------------------
+	// update query's average runtime
+	//--------------------------------------------------------------------------
+
+	uint64_t key = _QueriesLog_QueryKey(query);
+	double runtime = execution_duration + report_duration;
+
+	pthread_mutex_lock(&log->runtimes_lock);
+
+	QueryRuntime *r = log->runtimes + (key & (RUNTIME_SLOTS - 1));
+	if(r->key != key || r->samples == 0) {
+		// slot is taken over by the latest query mapped to it
+		r->key     = key;
+		r->runtime = runtime;
+		r->samples = 0;
+	}
+
+	r->runtime = (1 - RUNTIME_ALPHA) * r->runtime + RUNTIME_ALPHA * runtime;
+	r->samples++;
+	r->cached_read = utilized_cache && !write && !timeout;
+
+	pthread_mutex_unlock(&log->runtimes_lock);
+}
+
+// returns true if query is a read-only query whose recent executions
+// utilized the cache and averaged no more than 'threshold' milliseconds
+// executions differing only by their parameters' values are considered
+// the same query
+bool QueriesLog_CheapRead
+(
+	QueriesLog log,     // queries log
+	const char *query,  // query string
+	double threshold    // max average runtime, milliseconds
+) {
+	ASSERT(log   != NULL);
+	ASSERT(query != NULL);
+
+	uint64_t key = _QueriesLog_QueryKey(query);
+
+	pthread_mutex_lock(&log->runtimes_lock);
+
+	QueryRuntime *r = log->runtimes + (key & (RUNTIME_SLOTS - 1));
+	bool cheap = r->key == key                  &&
+	             r->cached_read                 &&
+	             r->samples >= RUNTIME_MIN_SAMPLES &&
+	             r->runtime <= threshold;
+
+	pthread_mutex_unlock(&log->runtimes_lock);
+
+	return cheap;
 }
 
 // returns number of queries in log
@@ -162,6 +299,8 @@ void QueriesLog_Free
 	CircularBuffer_Free(log->swap);
 	CircularBuffer_Free(log->queries);
 
+	rm_free(log->runtimes);
+	pthread_mutex_destroy(&log->runtimes_lock);
 	pthread_rwlock_destroy(&log->rwlock);
 
 	rm_free(log);
@@ -42,6 +42,17 @@ void QueriesLog_AddQuery
 	const char *query           // query string
 );
 
+// returns true if query is a read-only query whose recent executions
+// utilized the cache and averaged no more than 'threshold' milliseconds
+// executions differing only by their parameters' values are considered
+// the same query
+bool QueriesLog_CheapRead
+(
+	QueriesLog log,     // queries log
+	const char *query,  // query string
+	double threshold    // max average runtime, milliseconds
+);
+
 // returns number of queries in log
 uint64_t QueriesLog_GetQueriesCount
 (
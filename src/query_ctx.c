@@ -7,6 +7,9 @@
 #include "query_ctx.h"
 #include "RG.h"
 #include "errors.h"
+#include "cron/cron.h"
+#include "util/arr.h"
+#include "util/sds/sds.h"
 #include "util/simple_timer.h"
 #include "arithmetic/arithmetic_expression.h"
 #include "serializers/graphcontext_type.h"
@@ -16,6 +19,39 @@ extern RedisModuleType *GraphContextRedisModuleType;
 
 pthread_key_t _tlsQueryCtxKey;  // thread local storage query context key
 
+// size of each memory block of a query's arena
+#define QUERY_ARENA_BLOCK_SIZE (64 * 1024)
+
+// max size of a query's arena
+// arena values live as long as the query, once the arena is full
+// transient values are heap allocated and freed as soon as they're consumed
+// bounding the memory of queries computing a value per row
+#define QUERY_ARENA_CAPACITY (16 * QUERY_ARENA_BLOCK_SIZE)
+
+// replication deferred by a commit group
+typedef struct {
+	char *command;   // replicated command
+	char *arg;       // command's argument, effects or query
+	size_t arg_len;  // argument length
+} DeferredReplication;
+
+// commit group, see QueryCtx_BeginCommitGroup
+typedef struct {
+	GraphContext *gc;               // graph committed to
+	RedisModuleCtx *redis_ctx;      // context used for locking and replication
+	RedisModuleKey *key;            // graph key, open while the GIL is held
+	EffectsBuffer *effects;         // effects of the latest committed queries
+	DeferredReplication *deferred;  // replications preceding 'effects'
+	bool lock_gil;                  // GIL acquired by the group
+} CommitGroup;
+
+// calling thread's commit group
+static __thread CommitGroup *_group = NULL;
+
+// commit group running without the GIL, whose modifications
+// are yet to be replicated, accessed only while holding the GIL
+static CommitGroup *_unreplicated = NULL;
+
 // retrieve or instantiate new QueryCtx
 static inline QueryCtx *_QueryCtx_GetCreateCtx(void) {
 	QueryCtx *ctx = pthread_getspecific(_tlsQueryCtxKey);
@@ -25,6 +61,7 @@ static inline QueryCtx *_QueryCtx_GetCreateCtx(void) {
 		ctx = rm_calloc(1, sizeof(QueryCtx));
 
 		// created lazily only when needed
+		ctx->arena          = NULL;
 		ctx->undo_log       = NULL;
 		ctx->effects_buffer = NULL;
 		ctx->stage          = QueryStage_WAITING;  // initial query stage
@@ -226,6 +263,34 @@ void QueryCtx_SetParams
 	ctx->query_data.params = params;
 }
 
+// set query's deadline, 'timeout' ms from now
+void QueryCtx_SetDeadline
+(
+	QueryCtx *ctx,  // query context
+	uint timeout    // timeout in ms
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(timeout > 0);
+
+	ctx->deadline = Cron_Now() + timeout;
+}
+
+// draw the calling thread's transient values from the query's arena
+// up to the arena's capacity, the arena is released when the query context
+// is freed
+void QueryCtx_ActivateArena
+(
+	QueryCtx *ctx  // query context
+) {
+	ASSERT(ctx != NULL);
+
+	if(ctx->arena == NULL) {
+		ctx->arena = Arena_New(QUERY_ARENA_BLOCK_SIZE, QUERY_ARENA_CAPACITY);
+	}
+
+	Arena_SetActive(ctx->arena);
+}
+
 // retrieve the AST
 AST *QueryCtx_GetAST(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
@@ -340,6 +405,36 @@ static void _QueryCtx_ThreadSafeContextUnlock
 	if(ctx->global_exec_ctx.bc) RedisModule_ThreadSafeContextUnlock(ctx->global_exec_ctx.redis_ctx);
 }
 
+// opens graph key for writing
+// returns NULL and sets 'err' to an error message format if the key
+// no longer holds 'gc'
+static RedisModuleKey *_QueryCtx_OpenGraphKey
+(
+	RedisModuleCtx *redis_ctx,  // redis module context
+	GraphContext *gc,           // graph context
+	const char **err            // [output] error message format
+) {
+	RedisModuleString *graphID = RedisModule_CreateString(redis_ctx,
+			gc->graph_name, strlen(gc->graph_name));
+	RedisModuleKey *key = RedisModule_OpenKey(redis_ctx, graphID,
+			REDISMODULE_WRITE);
+	RedisModule_FreeString(redis_ctx, graphID);
+
+	if(RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY) {
+		*err = EMSG_EMPTY_KEY;
+	} else if(RedisModule_ModuleTypeGetType(key) != GraphContextRedisModuleType) {
+		*err = EMSG_NON_GRAPH_KEY;
+	} else if(gc != RedisModule_ModuleTypeGetValue(key)) {
+		*err = EMSG_DIFFERENT_VALUE;
+	} else {
+		return key;
+	}
+
+	// free key handle
+	RedisModule_CloseKey(key);
+	return NULL;
+}
+
 // starts a locking flow before commiting changes
 // Locking flow:
 // 1. lock GIL
@@ -354,27 +449,23 @@ bool QueryCtx_LockForCommit(void) {
 	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
 	if(ctx->internal_exec_ctx.locked_for_commit) return true;
 
+	// locks are held by the thread's commit group
+	if(_group != NULL) {
+		ASSERT(_group->gc == ctx->gc);
+		ctx->internal_exec_ctx.locked_for_commit = true;
+		return true;
+	}
+
 	// lock GIL
 	RedisModuleCtx *redis_ctx = ctx->global_exec_ctx.redis_ctx;
 	GraphContext *gc = ctx->gc;
-	RedisModuleString *graphID = RedisModule_CreateString(redis_ctx, gc->graph_name,
-														  strlen(gc->graph_name));
 	_QueryCtx_ThreadSafeContextLock(ctx);
 
 	// open key and verify
-	RedisModuleKey *key = RedisModule_OpenKey(redis_ctx, graphID, REDISMODULE_WRITE);
-	RedisModule_FreeString(redis_ctx, graphID);
-	if(RedisModule_KeyType(key) == REDISMODULE_KEYTYPE_EMPTY) {
-		ErrorCtx_SetError(EMSG_EMPTY_KEY, ctx->gc->graph_name);
-		goto clean_up;
-	}
-	if(RedisModule_ModuleTypeGetType(key) != GraphContextRedisModuleType) {
-		ErrorCtx_SetError(EMSG_NON_GRAPH_KEY, ctx->gc->graph_name);
-		goto clean_up;
-
-	}
-	if(gc != RedisModule_ModuleTypeGetValue(key)) {
-		ErrorCtx_SetError(EMSG_DIFFERENT_VALUE, ctx->gc->graph_name);
+	const char *err;
+	RedisModuleKey *key = _QueryCtx_OpenGraphKey(redis_ctx, gc, &err);
+	if(key == NULL) {
+		ErrorCtx_SetError(err, gc->graph_name);
 		goto clean_up;
 	}
 	ctx->internal_exec_ctx.key = key;
@@ -383,12 +474,12 @@ bool QueryCtx_LockForCommit(void) {
 	Graph_AcquireWriteLock(gc->g);
 	ctx->internal_exec_ctx.locked_for_commit = true;
 
+	// replicate preceding modifications ahead of this query's
+	QueryCtx_FlushCommitGroup(redis_ctx, gc);
+
 	return true;
 
 clean_up:
-	// free key handle
-	RedisModule_CloseKey(key);
-
 	// unlock GIL
 	_QueryCtx_ThreadSafeContextUnlock(ctx);
 
@@ -404,6 +495,10 @@ static void _QueryCtx_UnlockCommit
 	GraphContext *gc = ctx->gc;
 
 	ctx->internal_exec_ctx.locked_for_commit = false;
+
+	// locks are released once the thread's commit group ends
+	if(_group != NULL) return;
+
 	// release graph R/W lock
 	Graph_ReleaseLock(gc->g);
 
@@ -448,6 +543,231 @@ void QueryCtx_Replicate
 			"cc!", gc->graph_name, ctx->query_data.query);
 }
 
+//------------------------------------------------------------------------------
+// commit groups
+//------------------------------------------------------------------------------
+
+// moves the group's accumulated effects to its deferred replications
+static void _CommitGroup_SealEffects
+(
+	CommitGroup *group  // commit group
+) {
+	if(EffectsBuffer_Length(group->effects) == 0) return;
+
+	DeferredReplication r;
+	r.command = rm_strdup("GRAPH.EFFECT");
+	r.arg     = (char *)EffectsBuffer_Buffer(group->effects, &r.arg_len);
+	array_append(group->deferred, r);
+
+	EffectsBuffer_Reset(group->effects);
+}
+
+// replicates the group's deferred replications in commit order
+static void _CommitGroup_Replicate
+(
+	CommitGroup *group,        // commit group
+	RedisModuleCtx *redis_ctx  // context to replicate through
+) {
+	_CommitGroup_SealEffects(group);
+
+	uint n = array_len(group->deferred);
+	for(uint i = 0; i < n; i++) {
+		DeferredReplication *r = group->deferred + i;
+		RedisModule_Replicate(redis_ctx, r->command, "cb!",
+				group->gc->graph_name, r->arg, r->arg_len);
+
+		rm_free(r->command);
+		rm_free(r->arg);
+	}
+
+	array_clear(group->deferred);
+}
+
+static void _CommitGroup_Free
+(
+	CommitGroup *group  // commit group
+) {
+	// replications discarded along with a deleted graph
+	uint n = array_len(group->deferred);
+	for(uint i = 0; i < n; i++) {
+		rm_free(group->deferred[i].command);
+		rm_free(group->deferred[i].arg);
+	}
+
+	array_free(group->deferred);
+	EffectsBuffer_Free(group->effects);
+	rm_free(group);
+}
+
+// begin a commit group on the calling thread
+// returns false if the graph key can't be opened for writing,
+// in which case 'err' is set and should be freed by the caller
+bool QueryCtx_BeginCommitGroup
+(
+	GraphContext *gc,           // graph to commit to
+	RedisModuleCtx *redis_ctx,  // context used for locking and replication
+	bool lock_gil,              // acquire GIL, false if already held
+	char **err                  // [output] error message
+) {
+	ASSERT(gc        != NULL);
+	ASSERT(err       != NULL);
+	ASSERT(_group    == NULL);
+	ASSERT(redis_ctx != NULL);
+
+	if(lock_gil) RedisModule_ThreadSafeContextLock(redis_ctx);
+
+	// open key and verify
+	// opening the key for writing notifies Redis the key is modified
+	const char *fmt;
+	RedisModuleKey *key = _QueryCtx_OpenGraphKey(redis_ctx, gc, &fmt);
+	if(key == NULL) {
+		if(lock_gil) RedisModule_ThreadSafeContextUnlock(redis_ctx);
+
+		int rc __attribute__((unused));
+		rc = asprintf(err, fmt, gc->graph_name);
+		return false;
+	}
+
+	// acquire graph write lock, as any writer does, while holding the GIL
+	Graph_AcquireWriteLock(gc->g);
+
+	// replicate preceding modifications ahead of the group's
+	QueryCtx_FlushCommitGroup(redis_ctx, gc);
+
+	// a single group runs off Redis main thread at a time
+	ASSERT(!lock_gil || _unreplicated == NULL);
+
+	_group = rm_malloc(sizeof(CommitGroup));
+
+	_group->gc        = gc;
+	_group->key       = key;
+	_group->effects   = EffectsBuffer_New();
+	_group->deferred  = array_new(DeferredReplication, 0);
+	_group->lock_gil  = lock_gil;
+	_group->redis_ctx = redis_ctx;
+
+	if(lock_gil) {
+		// the group's queries run holding only the graph's write lock
+		// the GIL is re-acquired once the group ends, to replicate
+		RedisModule_CloseKey(key);
+		_group->key   = NULL;
+		_unreplicated = _group;
+
+		RedisModule_ThreadSafeContextUnlock(redis_ctx);
+	}
+
+	return true;
+}
+
+// returns true if the calling thread is within a commit group
+bool QueryCtx_InCommitGroup(void) {
+	return _group != NULL;
+}
+
+// defers the replication of a committed query to the end of
+// the calling thread's commit group
+// returns false if the calling thread isn't within a commit group
+bool QueryCtx_DeferReplication
+(
+	QueryCtx *ctx,  // query context
+	bool effects    // replicate via effects rather than the query itself
+) {
+	ASSERT(ctx != NULL);
+
+	if(_group == NULL) return false;
+
+	ASSERT(_group->gc == ctx->gc);
+
+	if(effects) {
+		EffectsBuffer_Append(_group->effects, ctx->effects_buffer);
+		return true;
+	}
+
+	// replicate the query itself following the effects of
+	// the queries committed before it
+	_CommitGroup_SealEffects(_group);
+
+	DeferredReplication r;
+	r.command = rm_strdup(ctx->global_exec_ctx.command_name);
+	r.arg     = rm_strdup(ctx->query_data.query);
+	r.arg_len = strlen(r.arg);
+	array_append(_group->deferred, r);
+
+	return true;
+}
+
+// replicates the modifications to 'gc' committed by a commit group
+// running without the GIL, which are yet to be replicated
+// must be called holding both the GIL and gc's write lock, by committers
+// of other modifications to 'gc' ahead of replicating their own
+void QueryCtx_FlushCommitGroup
+(
+	RedisModuleCtx *redis_ctx,  // context to replicate through
+	GraphContext *gc            // graph about to be modified
+) {
+	ASSERT(gc        != NULL);
+	ASSERT(redis_ctx != NULL);
+
+	CommitGroup *group = _unreplicated;
+	if(group == NULL || group->gc != gc) return;
+
+	_CommitGroup_Replicate(group, redis_ctx);
+}
+
+// end the calling thread's commit group
+// replicates the group's modifications and releases the group's locks
+void QueryCtx_EndCommitGroup(void) {
+	CommitGroup *group = _group;
+	ASSERT(group != NULL);
+
+	_group = NULL;
+
+	if(!group->lock_gil) {
+		// GIL is held throughout the group
+		_CommitGroup_Replicate(group, group->redis_ctx);
+		Graph_ReleaseLock(group->gc->g);
+		RedisModule_CloseKey(group->key);
+		_CommitGroup_Free(group);
+		return;
+	}
+
+	// release the write lock before acquiring the GIL
+	// Redis main thread might be waiting on the graph while holding the GIL
+	// committers acquiring the write lock meanwhile replicate
+	// the group's modifications ahead of their own
+	Graph_ReleaseLock(group->gc->g);
+
+	RedisModule_ThreadSafeContextLock(group->redis_ctx);
+
+	// replicate as long as the key holds the graph, otherwise
+	// the group's modifications were deleted along with the graph
+	// queries committing once the graph was detached from its key failed,
+	// those which succeeded precede the deletion, which replicas apply too
+	const char *fmt;
+	RedisModuleKey *key = _QueryCtx_OpenGraphKey(group->redis_ctx, group->gc,
+			&fmt);
+	if(key != NULL) {
+		_CommitGroup_Replicate(group, group->redis_ctx);
+		RedisModule_CloseKey(key);
+	}
+
+	_unreplicated = NULL;
+
+	RedisModule_ThreadSafeContextUnlock(group->redis_ctx);
+
+	_CommitGroup_Free(group);
+}
+
+// checks if the query's deadline has passed
+bool QueryCtx_DeadlineExceeded
+(
+	const QueryCtx *ctx  // query context
+) {
+	ASSERT(ctx != NULL);
+
+	return ctx->deadline != 0 && Cron_Now() >= ctx->deadline;
+}
+
 // compute and return elapsed query execution time
 double QueryCtx_GetRuntime(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
@@ -473,6 +793,16 @@ void QueryCtx_Free(void) {
 		ctx->query_data.params = NULL;
 	}
 
+	if(ctx->query_data.query_parameterized != NULL) {
+		sdsfree(ctx->query_data.query_parameterized);
+		ctx->query_data.query_parameterized = NULL;
+	}
+
+	// release all transient values, deactivating the arena
+	if(ctx->arena != NULL) {
+		Arena_Free(&ctx->arena);
+	}
+
 	rm_free(ctx);
 
 	// NULL-set the context for reuse the next time this thread receives a query
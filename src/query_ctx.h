@@ -8,6 +8,7 @@
 
 #include "ast/ast.h"
 #include "redismodule.h"
+#include "util/arena.h"
 #include "util/rmalloc.h"
 #include "util/simple_timer.h"
 #include "undo_log/undo_log.h"
@@ -51,6 +52,8 @@ typedef struct {
 	rax *params;                  // query parameters
 	const char *query;            // query string
 	const char *query_no_params;  // query string without parameters part
+	char *query_parameterized;    // [owned] query with literals parameterized
+	                              // the cache key and the AST's source text
 } QueryCtx_QueryData;
 
 typedef struct {
@@ -86,6 +89,8 @@ typedef struct QueryCtx {
 	QueryCtx_QueryData query_data;               // data related to the query syntax
 	QueryCtx_GlobalExecCtx global_exec_ctx;      // data related to global redis execution
 	QueryCtx_InternalExecCtx internal_exec_ctx;  // data related to internal query execution
+	Arena *arena;                                // allocator for transient values
+	uint64_t deadline;                           // query deadline in ms, 0 if unbounded
 } QueryCtx;
 
 // instantiate the thread-local QueryCtx on module load
@@ -164,6 +169,21 @@ void QueryCtx_SetParams
 	rax *params
 );
 
+// set query's deadline, 'timeout' ms from now
+void QueryCtx_SetDeadline
+(
+	QueryCtx *ctx,  // query context
+	uint timeout    // timeout in ms
+);
+
+// draw the calling thread's transient values from the query's arena
+// up to the arena's capacity, the arena is released when the query context
+// is freed
+void QueryCtx_ActivateArena
+(
+	QueryCtx *ctx  // query context
+);
+
 //------------------------------------------------------------------------------
 // getters
 //------------------------------------------------------------------------------
@@ -233,6 +253,63 @@ void QueryCtx_Replicate
 	QueryCtx *ctx
 );
 
+//------------------------------------------------------------------------------
+// commit groups
+//------------------------------------------------------------------------------
+
+// a commit group lets consecutive queries executed by the calling thread
+// against the same graph share a single commit
+// the group holds the graph's write lock from its beginning to its end,
+// queries executed within the group neither acquire nor release it,
+// their replication is deferred to the group's end where consecutive effects
+// are replicated as a single GRAPH.EFFECT
+//
+// a group started off Redis main thread holds the GIL only while opening
+// the graph key at its beginning and while replicating at its end
+
+// begin a commit group on the calling thread
+// returns false if the graph key can't be opened for writing,
+// in which case 'err' is set and should be freed by the caller
+bool QueryCtx_BeginCommitGroup
+(
+	GraphContext *gc,           // graph to commit to
+	RedisModuleCtx *redis_ctx,  // context used for locking and replication
+	bool lock_gil,              // acquire GIL, false if already held
+	char **err                  // [output] error message
+);
+
+// returns true if the calling thread is within a commit group
+bool QueryCtx_InCommitGroup(void);
+
+// defers the replication of a committed query to the end of
+// the calling thread's commit group
+// returns false if the calling thread isn't within a commit group
+bool QueryCtx_DeferReplication
+(
+	QueryCtx *ctx,  // query context
+	bool effects    // replicate via effects rather than the query itself
+);
+
+// replicates the modifications to 'gc' committed by a commit group
+// running without the GIL, which are yet to be replicated
+// must be called holding both the GIL and gc's write lock, by committers
+// of other modifications to 'gc' ahead of replicating their own
+void QueryCtx_FlushCommitGroup
+(
+	RedisModuleCtx *redis_ctx,  // context to replicate through
+	GraphContext *gc            // graph about to be modified
+);
+
+// end the calling thread's commit group
+// replicates the group's modifications and releases the group's locks
+void QueryCtx_EndCommitGroup(void);
+
+// checks if the query's deadline has passed
+bool QueryCtx_DeadlineExceeded
+(
+	const QueryCtx *ctx  // query context
+);
+
 // compute and return elapsed query execution time
 double QueryCtx_GetRuntime(void);
 
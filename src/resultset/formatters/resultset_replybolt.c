@@ -292,7 +292,11 @@ void ResultSet_EmitBoltStats
 (
 	ResultSet *set
 ) {
-	bolt_client_reply_for(set->bolt_client, BST_PULL, BST_SUCCESS, 1);
+	// statistics conclude the stream, either pulled or discarded
+	bolt_structure_type request_type = set->bolt_client->discard
+		? BST_DISCARD
+		: BST_PULL;
+	bolt_client_reply_for(set->bolt_client, request_type, BST_SUCCESS, 1);
 	int stats = 0;
 	if(set->stats.index_creation)            stats++;
 	if(set->stats.index_deletion)            stats++;
@@ -14,6 +14,7 @@
 #include "../bolt/socket.h"
 #include "../globals.h"
 #include "../errors/errors.h"
+#include "../configuration/config.h"
 #include "../commands/cmd_context.h"
 
 static void _ResultSet_ReplyWithPreamble
@@ -51,6 +52,130 @@ static void _ResultSet_SetColumns
 	}
 }
 
+// determine if resultset rows can be emitted as they are produced
+// rather than accumulated until the query completes
+// only read-only queries are streamed, as the rows of a write query
+// reflect changes which might be rolled back
+// bolt clients always receive read-only results in batches of their
+// requested fetch size
+static bool _ResultSet_ShouldStream
+(
+	const ResultSet *set
+) {
+	if(set->format == FORMATTER_NOP || set->column_count == 0) {
+		return false;
+	}
+
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+	if(query_ctx->flags & QueryExecutionTypeFlag_WRITE) {
+		return false;
+	}
+
+	if(set->format == FORMATTER_BOLT) {
+		return true;
+	}
+
+	bool stream_results;
+	Config_Option_get(Config_STREAM_RESULTS, &stream_results);
+	return stream_results;
+}
+
+// suspend the query until the client pulls more records
+// returns false if the remainder of the stream should be discarded
+static bool _ResultSet_BoltSuspend
+(
+	bolt_client_t *client,  // bolt client
+	bool has_more           // reply to the current PULL with has_more
+) {
+	uint64_t deadline = QueryCtx_GetQueryCtx()->deadline;
+	switch(bolt_client_await_pull(client, has_more, deadline)) {
+		case BOLT_PULL_RESUMED:
+			return true;
+		case BOLT_PULL_DISCARDED:
+			return false;
+		case BOLT_PULL_EXPIRED:
+			// client didn't pull in time, fail the stream
+			ErrorCtx_SetError(EMSG_QUERY_TIMEOUT);
+			return false;
+		default:
+			ASSERT(false);
+			return false;
+	}
+}
+
+// hold a bolt record back until the client pulls it
+// the query is suspended, retaining its read lock, while the client
+// consumes the previous batch, for no longer than the query's timeout
+// or BOLT_PULL_TIMEOUT
+// returns false if the remainder of the stream should be discarded
+static bool _ResultSet_BoltAwaitPull
+(
+	ResultSet *set  // resultset
+) {
+	bolt_client_t *client = set->bolt_client;
+
+	// RUN's reply is sent on its own, records follow the first PULL
+	if(!set->header_emitted) {
+		_ResultSet_ReplyWithPreamble(set);
+		set->header_emitted = true;
+		if(!_ResultSet_BoltSuspend(client, false)) return false;
+	} else if(client->pull_n == 0) {
+		// batch is complete and there's at least one more record
+		if(!_ResultSet_BoltSuspend(client, true)) return false;
+	}
+
+	if(client->pull_n > 0) client->pull_n--;
+	return true;
+}
+
+// emit a single row straight out of a record
+// returns false if the row was discarded
+static bool _ResultSet_StreamRecord
+(
+	ResultSet *set,  // resultset
+	Record r         // record containing projected data
+) {
+	if(set->format == FORMATTER_BOLT) {
+		if(!_ResultSet_BoltAwaitPull(set)) return false;
+	} else if(!set->header_emitted) {
+		// emit header and open rows array ahead of the first row
+		// the number of rows is unknown at this point
+		_ResultSet_ReplyWithPreamble(set);
+		RedisModule_ReplyWithArray(set->ctx, REDISMODULE_POSTPONED_LEN);
+		set->header_emitted = true;
+	}
+
+	SIValue cells[set->column_count];
+	SIValue *row[set->column_count];
+	for(uint i = 0; i < set->column_count; i++) {
+		cells[i] = Record_Get(r, set->columns_record_map[i]);
+		row[i]   = cells + i;
+	}
+
+	set->formatter->EmitRow(set, row);
+	set->streamed_rows++;
+	return true;
+}
+
+// conclude a streamed resultset
+static void _ResultSet_ReplyStreamed
+(
+	ResultSet *set  // resultset to conclude
+) {
+	if(set->format != FORMATTER_BOLT) {
+		RedisModule_ReplySetArrayLength(set->ctx, set->streamed_rows);
+	}
+
+	// a run-time error encountered after rows were emitted
+	// replaces the statistics as the last element of the reply
+	if(ErrorCtx_EncounteredError()) {
+		ErrorCtx_EmitException();
+		return;
+	}
+
+	set->formatter->EmitStats(set);
+}
+
 // create a new result set
 ResultSet *NewResultSet
 (
@@ -70,6 +195,9 @@ ResultSet *NewResultSet
 	set->column_count        =  0;
 	set->cells_allocation    =  M_NONE;
 	set->columns_record_map  =  NULL;
+	set->streaming           =  false;
+	set->streamed_rows       =  0;
+	set->header_emitted      =  false;
 
 	// init resultset statistics
 	ResultSetStat_init(&set->stats);
@@ -79,8 +207,11 @@ ResultSet *NewResultSet
 		_ResultSet_SetColumns(set);
 	}
 
+	// streamed rows are emitted as they are produced, no need to store them
+	set->streaming = _ResultSet_ShouldStream(set);
+
 	// allocate space for resultset entries only if data is expected
-	if(set->column_count > 0) {
+	if(set->column_count > 0 && !set->streaming) {
 		// none empty result-set
 		// allocate enough space for at least 10 rows
 		uint64_t nrows = set->column_count * 10;
@@ -121,6 +252,7 @@ uint64_t ResultSet_RowCount
 	ASSERT(set != NULL);
 
 	if(set->column_count == 0) return 0;
+	if(set->streaming) return set->streamed_rows;
 	return DataBlock_ItemCount(set->cells) / set->column_count;
 }
 
@@ -133,6 +265,11 @@ int ResultSet_AddRecord
 	ASSERT(r   != NULL);
 	ASSERT(set != NULL);
 
+	// emit row right away, values remain owned by the record
+	if(set->streaming) {
+		return _ResultSet_StreamRecord(set, r) ? RESULTSET_OK : RESULTSET_FULL;
+	}
+
 	// copy projected values from record to resultset
 	for(int i = 0; i < set->column_count; i++) {
 		int idx = set->columns_record_map[i];
@@ -225,6 +362,12 @@ void ResultSet_Reply
 ) {
 	ASSERT(set != NULL);
 
+	// rows were already emitted
+	if(set->header_emitted) {
+		_ResultSet_ReplyStreamed(set);
+		return;
+	}
+
 	uint64_t row_count = ResultSet_RowCount(set);
 
 	// check to see if we've encountered a run-time error
@@ -241,7 +384,7 @@ void ResultSet_Reply
 	if(set->column_count > 0) {
 		RedisModule_ReplyWithArray(set->ctx, row_count);
 		SIValue *row[set->column_count];
-		uint64_t cells = DataBlock_ItemCount(set->cells);
+		uint64_t cells = (set->cells != NULL) ? DataBlock_ItemCount(set->cells) : 0;
 		// for each row
 		for(uint64_t i = 0; i < cells; i += set->column_count) {
 			// for each column
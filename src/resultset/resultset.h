@@ -29,6 +29,9 @@ typedef struct ResultSet {
 	ResultSetFormatterType format;  // result set format; compact/verbose/nop
 	ResultSetFormatter *formatter;  // result set data formatter
 	SIAllocation cells_allocation;  // encountered values allocation
+	bool streaming;                 // rows are emitted as they are produced
+	uint64_t streamed_rows;         // number of rows emitted, streaming mode
+	bool header_emitted;            // header was emitted, streaming mode
 } ResultSet;
 
 // map each column to a record index
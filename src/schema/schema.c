@@ -324,6 +324,36 @@ int Schema_RemoveIndex
 	return INDEX_OK;
 }
 
+// track entity within schema's constraints
+static void _Schema_TrackEntity
+(
+	const Schema *s,      // schema
+	const GraphEntity *e  // entity to track
+) {
+	uint n = array_len(s->constraints);
+	for(uint i = 0; i < n; i++) {
+		Constraint c = s->constraints[i];
+		if(Constraint_GetStatus(c) != CT_FAILED) {
+			Constraint_IndexEntity(c, e);
+		}
+	}
+}
+
+// stop tracking entity within schema's constraints
+static void _Schema_UntrackEntity
+(
+	const Schema *s,      // schema
+	const GraphEntity *e  // entity to untrack
+) {
+	uint n = array_len(s->constraints);
+	for(uint i = 0; i < n; i++) {
+		Constraint c = s->constraints[i];
+		if(Constraint_GetStatus(c) != CT_FAILED) {
+			Constraint_RemoveEntity(c, e);
+		}
+	}
+}
+
 // index node under all schema index
 void Schema_AddNodeToIndex
 (
@@ -340,6 +370,8 @@ void Schema_AddNodeToIndex
 
 	idx = PENDING_IDX(s);
 	if(idx != NULL) Index_IndexNode(idx, n);
+
+	_Schema_TrackEntity(s, (const GraphEntity *)n);
 }
 
 // index edge under all schema index
@@ -358,6 +390,8 @@ void Schema_AddEdgeToIndex
 
 	idx = PENDING_IDX(s);
 	if(idx != NULL) Index_IndexEdge(idx, e);
+
+	_Schema_TrackEntity(s, (const GraphEntity *)e);
 }
 
 // remove node from schema index
@@ -376,6 +410,8 @@ void Schema_RemoveNodeFromIndex
 
 	idx = PENDING_IDX(s);
 	if(idx != NULL) Index_RemoveNode(idx, n);
+
+	_Schema_UntrackEntity(s, (const GraphEntity *)n);
 }
 
 // remove edge from schema index
@@ -394,6 +430,8 @@ void Schema_RemoveEdgeFromIndex
 
 	idx = PENDING_IDX(s);
 	if(idx != NULL) Index_RemoveEdge(idx, e);
+
+	_Schema_UntrackEntity(s, (const GraphEntity *)e);
 }
 
 //------------------------------------------------------------------------------
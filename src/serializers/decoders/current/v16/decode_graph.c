@@ -304,6 +304,9 @@ GraphContext *RdbLoadGraphContext_latest
 			}
 		}
 
+		// populate constraints which were loaded as active
+		GraphContext_PopulateConstraints(gc, delay_indexing);
+
 		// make sure graph doesn't contains may pending changes
 		ASSERT(Graph_Pending(g) == false);
 
@@ -74,6 +74,11 @@ static int _GraphContextType_AuxLoad(RedisModuleIO *rdb, int encver, int when) {
 
 static void _GraphContextType_Free(void *value) {
 	GraphContext *gc = value;
+
+	// queries running without the GIL, e.g. within a commit group,
+	// check whether the graph is still held by its key
+	GraphContext_Detach(gc);
+
 	Globals_RemoveGraph(gc);
 	GraphContext_DecreaseRefCount(gc);
 }
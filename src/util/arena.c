@@ -0,0 +1,166 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "arena.h"
+#include "rmalloc.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// allocations are aligned to 8 bytes
+#define ARENA_ALIGN(n) (((n) + 7) & ~((size_t)7))
+
+// allocations larger than this fraction of a block get a block of their own
+#define ARENA_LARGE_ALLOC(arena, n) ((n) > (arena)->block_size / 4)
+
+typedef struct ArenaBlock {
+	struct ArenaBlock *next;  // next block
+	size_t size;              // block capacity
+	size_t used;              // number of bytes in use
+	char data[];              // block memory
+} ArenaBlock;
+
+struct Arena {
+	ArenaBlock *head;   // block allocations are served from
+	size_t block_size;  // size of each memory block
+	size_t capacity;    // max number of bytes reserved, 0 for unbounded
+	size_t size;        // total number of bytes reserved
+};
+
+// calling thread's active arena
+static __thread Arena *active = NULL;
+
+// allocate a new block with room for 'n' bytes
+static ArenaBlock *_Arena_NewBlock
+(
+	Arena *arena,  // arena
+	size_t n       // block capacity
+) {
+	ArenaBlock *block = rm_malloc(sizeof(ArenaBlock) + n);
+	block->next = NULL;
+	block->size = n;
+	block->used = 0;
+
+	arena->size += n;
+
+	return block;
+}
+
+// create a new arena
+Arena *Arena_New
+(
+	size_t block_size,  // size of each memory block
+	size_t capacity     // max number of bytes reserved, 0 for unbounded
+) {
+	ASSERT(block_size > 0);
+
+	Arena *arena = rm_malloc(sizeof(Arena));
+	arena->head       = NULL;
+	arena->size       = 0;
+	arena->capacity   = capacity;
+	arena->block_size = ARENA_ALIGN(block_size);
+
+	return arena;
+}
+
+// checks if reserving 'n' additional bytes exceeds the arena's capacity
+static inline bool _Arena_Exceeds
+(
+	const Arena *arena,  // arena
+	size_t n             // number of bytes to reserve
+) {
+	return arena->capacity != 0 && arena->size + n > arena->capacity;
+}
+
+// allocate 'n' bytes, 8 bytes aligned
+// returns NULL if the allocation would exceed the arena's capacity
+void *Arena_Alloc
+(
+	Arena *arena,  // arena
+	size_t n       // number of bytes to allocate
+) {
+	ASSERT(arena != NULL);
+
+	n = ARENA_ALIGN(n);
+	ArenaBlock *head = arena->head;
+
+	// large allocations get a dedicated block placed behind the head
+	// such that the head's remaining space is still used
+	if(ARENA_LARGE_ALLOC(arena, n)) {
+		if(_Arena_Exceeds(arena, n)) return NULL;
+
+		ArenaBlock *block = _Arena_NewBlock(arena, n);
+		block->used = n;
+		if(head == NULL) {
+			arena->head = block;
+		} else {
+			block->next = head->next;
+			head->next  = block;
+		}
+		return block->data;
+	}
+
+	if(head == NULL || head->size - head->used < n) {
+		if(_Arena_Exceeds(arena, arena->block_size)) return NULL;
+
+		head = _Arena_NewBlock(arena, arena->block_size);
+		head->next  = arena->head;
+		arena->head = head;
+	}
+
+	void *p = head->data + head->used;
+	head->used += n;
+
+	return p;
+}
+
+// number of bytes reserved by the arena
+size_t Arena_Size
+(
+	const Arena *arena  // arena
+) {
+	ASSERT(arena != NULL);
+
+	return arena->size;
+}
+
+// free arena and all of its allocations
+void Arena_Free
+(
+	Arena **arena  // arena to free
+) {
+	ASSERT(arena != NULL && *arena != NULL);
+
+	Arena *a = *arena;
+
+	// make sure freed arena isn't active
+	if(active == a) {
+		active = NULL;
+	}
+
+	ArenaBlock *block = a->head;
+	while(block != NULL) {
+		ArenaBlock *next = block->next;
+		rm_free(block);
+		block = next;
+	}
+
+	rm_free(a);
+	*arena = NULL;
+}
+
+// get calling thread's active arena, NULL if none is active
+Arena *Arena_GetActive(void) {
+	return active;
+}
+
+// set calling thread's active arena, NULL deactivates
+void Arena_SetActive
+(
+	Arena *arena  // arena to activate
+) {
+	active = arena;
+}
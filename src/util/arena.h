@@ -0,0 +1,53 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+// bump allocator for short lived allocations
+// memory is carved out of large blocks and is released all at once
+// when the arena is freed, individual allocations are never freed
+//
+// each thread may have an active arena, query execution activates its
+// query's arena such that transient values are drawn from it
+
+typedef struct Arena Arena;
+
+// create a new arena
+Arena *Arena_New
+(
+	size_t block_size,  // size of each memory block
+	size_t capacity     // max number of bytes reserved, 0 for unbounded
+);
+
+// allocate 'n' bytes, 8 bytes aligned
+// returns NULL if the allocation would exceed the arena's capacity
+void *Arena_Alloc
+(
+	Arena *arena,  // arena
+	size_t n       // number of bytes to allocate
+);
+
+// number of bytes reserved by the arena
+size_t Arena_Size
+(
+	const Arena *arena  // arena
+);
+
+// free arena and all of its allocations
+void Arena_Free
+(
+	Arena **arena  // arena to free
+);
+
+// get calling thread's active arena, NULL if none is active
+Arena *Arena_GetActive(void);
+
+// set calling thread's active arena, NULL deactivates
+void Arena_SetActive
+(
+	Arena *arena  // arena to activate
+);
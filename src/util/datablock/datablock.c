@@ -10,6 +10,7 @@
 #include "../arr.h"
 #include "../rmalloc.h"
 #include <math.h>
+#include <string.h>
 #include <stdbool.h>
 
 // computes the number of blocks required to accommodate n items.
@@ -165,6 +166,13 @@ void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx) {
 	return ITEM_DATA(item_header);
 }
 
+void *DataBlock_GetItemUnchecked(const DataBlock *dataBlock, uint64_t idx) {
+	ASSERT(dataBlock != NULL);
+	ASSERT(!_DataBlock_IndexOutOfBounds(dataBlock, idx));
+
+	return ITEM_DATA(DataBlock_GetItemHeader(dataBlock, idx));
+}
+
 uint64_t DataBlock_GetReservedIdx(const DataBlock *dataBlock, uint64_t n) {
 	ASSERT(dataBlock != NULL);
 
@@ -259,6 +267,50 @@ void DataBlock_MarkAsDeletedOutOfOrder
 	array_append(dataBlock->deletedIdx, idx);
 }
 
+DataBlock *DataBlock_Clone
+(
+	const DataBlock *dataBlock,  // datablock to clone
+	fpCloner cloner              // [optional] item clone routine
+) {
+	ASSERT(dataBlock != NULL);
+
+	DataBlock *clone = rm_malloc(sizeof(DataBlock));
+	clone->blocks      =  NULL;
+	clone->itemSize    =  dataBlock->itemSize;
+	clone->itemCount   =  dataBlock->itemCount;
+	clone->blockCount  =  0;
+	clone->blockCap    =  dataBlock->blockCap;
+	clone->destructor  =  dataBlock->destructor;
+	array_clone(clone->deletedIdx, dataBlock->deletedIdx);
+
+	_DataBlock_AddBlocks(clone, dataBlock->blockCount);
+
+	// number of slots in use, both active and deleted
+	uint64_t n = dataBlock->itemCount + array_len(dataBlock->deletedIdx);
+	uint64_t blockCap = dataBlock->blockCap;
+	size_t   blockSize = blockCap * dataBlock->itemSize;
+
+	// blocks are independent of one another, copy them in parallel
+	#pragma omp parallel for schedule(dynamic)
+	for(int64_t i = 0; i < (int64_t)dataBlock->blockCount; i++) {
+		memcpy(clone->blocks[i]->data, dataBlock->blocks[i]->data, blockSize);
+
+		if(cloner == NULL) continue;
+
+		// deep copy active items within block
+		uint64_t start = i * blockCap;
+		uint64_t end   = start + blockCap;
+		if(end > n) end = n;
+
+		for(uint64_t idx = start; idx < end; idx++) {
+			DataBlockItemHeader *header = DataBlock_GetItemHeader(clone, idx);
+			if(!IS_ITEM_DELETED(header)) cloner(ITEM_DATA(header));
+		}
+	}
+
+	return clone;
+}
+
 void DataBlock_Free(DataBlock *dataBlock) {
 	for(uint i = 0; i < dataBlock->blockCount; i++) Block_Free(dataBlock->blocks[i]);
 
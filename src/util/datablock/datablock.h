@@ -14,6 +14,9 @@
 
 typedef void (*fpDestructor)(void *);
 
+// item clone routine, replaces a bitwise copied item with a deep copy
+typedef void (*fpCloner)(void *);
+
 // Returns the item header size.
 #define ITEM_HEADER_SIZE 1
 
@@ -83,6 +86,9 @@ DataBlockIterator *DataBlock_FullScan(const DataBlock *dataBlock);
 // Get item at position idx
 void *DataBlock_GetItem(const DataBlock *dataBlock, uint64_t idx);
 
+// Get item at position idx, deleted items included
+void *DataBlock_GetItemUnchecked(const DataBlock *dataBlock, uint64_t idx);
+
 // Get reserved item id after 'n' items
 uint64_t DataBlock_GetReservedIdx(const DataBlock *dataBlock, uint64_t n);
 
@@ -100,6 +106,15 @@ uint DataBlock_DeletedItemsCount(const DataBlock *dataBlock);
 // Returns true if the given item has been deleted.
 bool DataBlock_ItemIsDeleted(void *item);
 
+// clone datablock
+// items are copied bitwise, if 'cloner' is specified it is invoked
+// on each active item of the clone, blocks are processed in parallel
+DataBlock *DataBlock_Clone
+(
+	const DataBlock *dataBlock,  // datablock to clone
+	fpCloner cloner              // [optional] item clone routine
+);
+
 // Free block.
 void DataBlock_Free(DataBlock *block);
 
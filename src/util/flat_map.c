@@ -0,0 +1,388 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "flat_map.h"
+#include "rmalloc.h"
+
+#include <string.h>
+
+// number of slots in a group
+#define GROUP_WIDTH 8
+
+// control byte of an empty slot
+// occupied slots hold 7 bits of their key's hash, the high bit is clear
+#define CTRL_EMPTY 0x80
+
+// a byte with only its lowest / highest bit set, repeated across a group
+#define LSBS 0x0101010101010101ULL
+#define MSBS 0x8080808080808080ULL
+
+// index within group of the first slot in mask
+#define FIRST_SLOT(mask) (__builtin_ctzll(mask) >> 3)
+
+// no slot in mask
+#define NO_SLOT UINT64_MAX
+
+typedef struct {
+	uint64_t key;  // entry key
+	void *value;   // entry value
+} FlatMapEntry;
+
+struct _FlatMap {
+	uint8_t *ctrl;          // control bytes, one per slot
+	FlatMapEntry *entries;  // slots
+	uint64_t group_mask;    // number of groups - 1
+	uint64_t count;         // number of entries
+	uint64_t growth_left;   // number of insertions before the map grows
+};
+
+// scramble key bits, keys such as entity IDs are far from uniform
+static inline uint64_t _FlatMap_Hash
+(
+	uint64_t key
+) {
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+	return key;
+}
+
+// load a group's control bytes, first slot in the lowest byte
+static inline uint64_t _FlatMap_LoadGroup
+(
+	const uint8_t *ctrl  // group's first control byte
+) {
+	uint64_t g;
+	memcpy(&g, ctrl, sizeof(g));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	g = __builtin_bswap64(g);
+#endif
+	return g;
+}
+
+// slots in group whose control byte equals 'h2'
+// may report false positives, never false negatives
+static inline uint64_t _FlatMap_Match
+(
+	uint64_t group,  // group's control bytes
+	uint8_t h2       // searched control byte
+) {
+	uint64_t x = group ^ (LSBS * h2);
+	return (x - LSBS) & ~x & MSBS;
+}
+
+// empty slots in group
+static inline uint64_t _FlatMap_MatchEmpty
+(
+	uint64_t group  // group's control bytes
+) {
+	return group & MSBS;
+}
+
+// maximum number of entries a map with 'slots' slots holds, 7/8 load factor
+static inline uint64_t _FlatMap_MaxLoad
+(
+	uint64_t slots  // number of slots
+) {
+	return slots - slots / 8;
+}
+
+// allocate an empty table of 'groups' groups
+static void _FlatMap_Alloc
+(
+	FlatMap map,     // map
+	uint64_t groups  // number of groups, power of 2
+) {
+	uint64_t slots = groups * GROUP_WIDTH;
+
+	map->ctrl        = rm_malloc(sizeof(uint8_t) * slots);
+	map->entries     = rm_malloc(sizeof(FlatMapEntry) * slots);
+	map->group_mask  = groups - 1;
+	map->growth_left = _FlatMap_MaxLoad(slots) - map->count;
+
+	memset(map->ctrl, CTRL_EMPTY, slots);
+}
+
+// returns the first empty slot along the probe sequence of 'h'
+static uint64_t _FlatMap_FindEmpty
+(
+	const FlatMap map,  // map
+	uint64_t h          // scrambled key
+) {
+	uint64_t g = (h >> 7) & map->group_mask;
+	for(uint64_t step = 1;; step++) {
+		uint64_t group = _FlatMap_LoadGroup(map->ctrl + g * GROUP_WIDTH);
+		uint64_t empty = _FlatMap_MatchEmpty(group);
+		if(empty != 0) {
+			return g * GROUP_WIDTH + FIRST_SLOT(empty);
+		}
+		// triangular probing visits every group
+		g = (g + step) & map->group_mask;
+	}
+}
+
+// double the number of groups, rehashing all entries
+static void _FlatMap_Grow
+(
+	FlatMap map  // map
+) {
+	uint8_t      *ctrl    = map->ctrl;
+	FlatMapEntry *entries = map->entries;
+	uint64_t      slots   = (map->group_mask + 1) * GROUP_WIDTH;
+
+	_FlatMap_Alloc(map, (map->group_mask + 1) * 2);
+
+	for(uint64_t i = 0; i < slots; i++) {
+		if(ctrl[i] & CTRL_EMPTY) continue;
+
+		uint64_t h = _FlatMap_Hash(entries[i].key);
+		uint64_t slot = _FlatMap_FindEmpty(map, h);
+		map->ctrl[slot]    = h & 0x7F;
+		map->entries[slot] = entries[i];
+	}
+
+	rm_free(ctrl);
+	rm_free(entries);
+}
+
+// occupy 'slot' with a new entry
+static inline void **_FlatMap_Set
+(
+	FlatMap map,    // map
+	uint64_t slot,  // empty slot
+	uint64_t h,     // scrambled key
+	uint64_t key,   // key
+	void *value     // value
+) {
+	ASSERT(map->ctrl[slot] == CTRL_EMPTY);
+
+	map->ctrl[slot] = h & 0x7F;
+	map->entries[slot].key   = key;
+	map->entries[slot].value = value;
+	map->count++;
+	map->growth_left--;
+
+	return &map->entries[slot].value;
+}
+
+// search for an entry with 'key' for which eq(value, ctx) holds
+// if no such entry exists 'empty' is set to the slot the entry would occupy
+static void **_FlatMap_Probe
+(
+	const FlatMap map,  // map
+	uint64_t h,         // scrambled key
+	uint64_t key,       // key
+	FlatMap_EqFunc eq,  // [optional] value equality callback
+	const void *ctx,    // searched key passed to 'eq'
+	uint64_t *empty     // [optional output] first empty slot
+) {
+	uint8_t  h2 = h & 0x7F;
+	uint64_t g  = (h >> 7) & map->group_mask;
+
+	for(uint64_t step = 1;; step++) {
+		uint64_t group = _FlatMap_LoadGroup(map->ctrl + g * GROUP_WIDTH);
+
+		for(uint64_t m = _FlatMap_Match(group, h2); m != 0; m &= m - 1) {
+			uint64_t slot = g * GROUP_WIDTH + FIRST_SLOT(m);
+			// skip false positives, which might be empty slots
+			if(map->ctrl[slot] != h2) continue;
+
+			FlatMapEntry *e = map->entries + slot;
+			if(e->key == key && (eq == NULL || eq(e->value, ctx))) {
+				return &e->value;
+			}
+		}
+
+		// an empty slot terminates the probe sequence
+		uint64_t m = _FlatMap_MatchEmpty(group);
+		if(m != 0) {
+			if(empty != NULL) *empty = g * GROUP_WIDTH + FIRST_SLOT(m);
+			return NULL;
+		}
+
+		g = (g + step) & map->group_mask;
+	}
+}
+
+// create a new map with room for at least 'capacity' entries
+FlatMap FlatMap_New
+(
+	uint64_t capacity  // expected number of entries
+) {
+	FlatMap map = rm_malloc(sizeof(struct _FlatMap));
+	map->count = 0;
+
+	uint64_t groups = 1;
+	while(_FlatMap_MaxLoad(groups * GROUP_WIDTH) < capacity) {
+		groups *= 2;
+	}
+
+	_FlatMap_Alloc(map, groups);
+
+	return map;
+}
+
+// returns number of entries in map
+uint64_t FlatMap_Count
+(
+	const FlatMap map  // map
+) {
+	ASSERT(map != NULL);
+
+	return map->count;
+}
+
+// find an entry with 'key' for which eq(value, ctx) holds
+// if 'eq' is NULL the first entry with 'key' is returned
+// returns a pointer to the entry's value or NULL if no such entry exists
+// the pointer is valid until the next insertion
+void **FlatMap_Find
+(
+	const FlatMap map,  // map
+	uint64_t key,       // key
+	FlatMap_EqFunc eq,  // [optional] value equality callback
+	const void *ctx     // searched key passed to 'eq'
+) {
+	ASSERT(map != NULL);
+
+	return _FlatMap_Probe(map, _FlatMap_Hash(key), key, eq, ctx, NULL);
+}
+
+// add a new entry, existing entries with the same key are retained
+// returns a pointer to the entry's value
+// the pointer is valid until the next insertion
+void **FlatMap_Insert
+(
+	FlatMap map,   // map
+	uint64_t key,  // key
+	void *value    // value
+) {
+	ASSERT(map != NULL);
+
+	if(map->growth_left == 0) {
+		_FlatMap_Grow(map);
+	}
+
+	uint64_t h = _FlatMap_Hash(key);
+	uint64_t slot = _FlatMap_FindEmpty(map, h);
+
+	return _FlatMap_Set(map, slot, h, key, value);
+}
+
+// find an entry with 'key' for which eq(value, ctx) holds
+// adding a new entry with a NULL value if no such entry exists
+// 'found' reports if the entry existed
+// returns a pointer to the entry's value
+// the pointer is valid until the next insertion
+void **FlatMap_FindOrInsert
+(
+	FlatMap map,        // map
+	uint64_t key,       // key
+	FlatMap_EqFunc eq,  // [optional] value equality callback
+	const void *ctx,    // searched key passed to 'eq'
+	bool *found         // [output] entry existed
+) {
+	ASSERT(map   != NULL);
+	ASSERT(found != NULL);
+
+	uint64_t h = _FlatMap_Hash(key);
+	uint64_t slot = NO_SLOT;
+
+	void **value = _FlatMap_Probe(map, h, key, eq, ctx, &slot);
+	*found = (value != NULL);
+	if(*found) {
+		return value;
+	}
+
+	// the probe ended at the slot the new entry occupies
+	// unless the map has to grow first
+	if(map->growth_left == 0) {
+		_FlatMap_Grow(map);
+		slot = _FlatMap_FindEmpty(map, h);
+	}
+
+	return _FlatMap_Set(map, slot, h, key, NULL);
+}
+
+// remove all entries, 'free_value' is called for each non-NULL value
+void FlatMap_Clear
+(
+	FlatMap map,                 // map
+	FlatMap_FreeFunc free_value  // [optional] value free callback
+) {
+	ASSERT(map != NULL);
+
+	uint64_t slots = (map->group_mask + 1) * GROUP_WIDTH;
+
+	if(free_value != NULL) {
+		for(uint64_t i = 0; i < slots; i++) {
+			if(map->ctrl[i] & CTRL_EMPTY) continue;
+			void *value = map->entries[i].value;
+			if(value != NULL) free_value(value);
+		}
+	}
+
+	memset(map->ctrl, CTRL_EMPTY, slots);
+	map->count       = 0;
+	map->growth_left = _FlatMap_MaxLoad(slots);
+}
+
+// initialize iterator over map entries
+void FlatMap_IteratorInit
+(
+	FlatMapIterator *it,  // iterator to initialize
+	FlatMap map           // map to iterate over
+) {
+	ASSERT(it  != NULL);
+	ASSERT(map != NULL);
+
+	it->map = map;
+	it->pos = 0;
+}
+
+// advance iterator
+// returns a pointer to the next entry's value or NULL when depleted
+void **FlatMap_IteratorNext
+(
+	FlatMapIterator *it,  // iterator
+	uint64_t *key         // [optional output] entry's key
+) {
+	ASSERT(it != NULL);
+
+	FlatMap  map   = it->map;
+	uint64_t slots = (map->group_mask + 1) * GROUP_WIDTH;
+
+	while(it->pos < slots) {
+		uint64_t i = it->pos++;
+		if(map->ctrl[i] & CTRL_EMPTY) continue;
+
+		if(key != NULL) *key = map->entries[i].key;
+		return &map->entries[i].value;
+	}
+
+	return NULL;
+}
+
+// free map, 'free_value' is called for each non-NULL value
+void FlatMap_Free
+(
+	FlatMap *map,                // map to free
+	FlatMap_FreeFunc free_value  // [optional] value free callback
+) {
+	ASSERT(map != NULL && *map != NULL);
+
+	FlatMap m = *map;
+
+	FlatMap_Clear(m, free_value);
+
+	rm_free(m->ctrl);
+	rm_free(m->entries);
+	rm_free(m);
+
+	*map = NULL;
+}
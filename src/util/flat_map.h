@@ -0,0 +1,120 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// flat open addressing hash map
+// maps a 64 bit key to a pointer value
+//
+// slots are grouped into groups of 8, each slot is described by a control
+// byte holding either an empty marker or 7 bits of the key's hash
+// a lookup scans a whole group of control bytes at once and only
+// inspects slots whose control byte matches
+// keys and values are stored inline, no per entry allocation is made
+//
+// keys are not required to be unique, when the key is itself a hash of
+// some larger value, callers verify candidates via an equality callback
+// entries can't be removed individually, the map can only be cleared
+
+typedef struct _FlatMap *FlatMap;
+
+// determine if 'value' matches the searched key described by 'ctx'
+typedef bool (*FlatMap_EqFunc)
+(
+	const void *value,  // stored value
+	const void *ctx     // searched key
+);
+
+// free a stored value
+typedef void (*FlatMap_FreeFunc)
+(
+	void *value  // value to free
+);
+
+// iterates over all entries of a map
+typedef struct {
+	FlatMap map;   // iterated map
+	uint64_t pos;  // next slot to inspect
+} FlatMapIterator;
+
+// create a new map with room for at least 'capacity' entries
+FlatMap FlatMap_New
+(
+	uint64_t capacity  // expected number of entries
+);
+
+// returns number of entries in map
+uint64_t FlatMap_Count
+(
+	const FlatMap map  // map
+);
+
+// find an entry with 'key' for which eq(value, ctx) holds
+// if 'eq' is NULL the first entry with 'key' is returned
+// returns a pointer to the entry's value or NULL if no such entry exists
+// the pointer is valid until the next insertion
+void **FlatMap_Find
+(
+	const FlatMap map,  // map
+	uint64_t key,       // key
+	FlatMap_EqFunc eq,  // [optional] value equality callback
+	const void *ctx     // searched key passed to 'eq'
+);
+
+// add a new entry, existing entries with the same key are retained
+// returns a pointer to the entry's value
+// the pointer is valid until the next insertion
+void **FlatMap_Insert
+(
+	FlatMap map,   // map
+	uint64_t key,  // key
+	void *value    // value
+);
+
+// find an entry with 'key' for which eq(value, ctx) holds
+// adding a new entry with a NULL value if no such entry exists
+// 'found' reports if the entry existed
+// returns a pointer to the entry's value
+// the pointer is valid until the next insertion
+void **FlatMap_FindOrInsert
+(
+	FlatMap map,        // map
+	uint64_t key,       // key
+	FlatMap_EqFunc eq,  // [optional] value equality callback
+	const void *ctx,    // searched key passed to 'eq'
+	bool *found         // [output] entry existed
+);
+
+// remove all entries, 'free_value' is called for each non-NULL value
+void FlatMap_Clear
+(
+	FlatMap map,                 // map
+	FlatMap_FreeFunc free_value  // [optional] value free callback
+);
+
+// initialize iterator over map entries
+void FlatMap_IteratorInit
+(
+	FlatMapIterator *it,  // iterator to initialize
+	FlatMap map           // map to iterate over
+);
+
+// advance iterator
+// returns a pointer to the next entry's value or NULL when depleted
+void **FlatMap_IteratorNext
+(
+	FlatMapIterator *it,  // iterator
+	uint64_t *key         // [optional output] entry's key
+);
+
+// free map, 'free_value' is called for each non-NULL value
+void FlatMap_Free
+(
+	FlatMap *map,                // map to free
+	FlatMap_FreeFunc free_value  // [optional] value free callback
+);
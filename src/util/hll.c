@@ -0,0 +1,207 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "hll.h"
+#include "rmalloc.h"
+
+#include <math.h>
+#include <string.h>
+
+// number of registers
+#define HLL_REGISTERS (1 << HLL_PRECISION)
+
+// maximum number of hashes kept by the sparse representation
+// beyond which the sketch switches to registers
+// 2KB of hashes, the dense representation requires 16KB
+#define HLL_SPARSE_MAX 256
+
+// initial capacity of the sparse representation
+#define HLL_SPARSE_INIT 8
+
+// a capacity of 0 marks the dense representation
+#define HLL_IS_DENSE(hll) ((hll)->cap == 0)
+
+// sketch is either sparse: a sorted list of distinct hashes
+// or dense: HLL_REGISTERS registers each holding the longest run of
+// leading zeros observed among the hashes mapped to it
+struct _HLL {
+	uint32_t count;   // number of hashes, sparse representation only
+	uint32_t cap;     // hashes capacity, 0 for the dense representation
+	uint64_t data[];  // sorted hashes or registers
+};
+
+// update register associated with hash
+static inline void _HLL_DenseAdd
+(
+	uint8_t *registers,  // registers
+	uint64_t hash        // element hash
+) {
+	// top bits select the register
+	uint64_t idx = hash >> (64 - HLL_PRECISION);
+
+	// count leading zeros among the remaining bits
+	// a guard bit bounds the count when all remaining bits are 0
+	uint64_t w = (hash << HLL_PRECISION) | (1ULL << (HLL_PRECISION - 1));
+	uint8_t rank = __builtin_clzll(w) + 1;
+
+	if(rank > registers[idx]) {
+		registers[idx] = rank;
+	}
+}
+
+// switch sketch to the dense representation
+static void _HLL_ToDense
+(
+	HLL *hll  // sketch
+) {
+	HLL sparse = *hll;
+	HLL dense  = rm_calloc(1, sizeof(struct _HLL) + HLL_REGISTERS);
+
+	uint8_t *registers = (uint8_t *)dense->data;
+	for(uint32_t i = 0; i < sparse->count; i++) {
+		_HLL_DenseAdd(registers, sparse->data[i]);
+	}
+
+	rm_free(sparse);
+	*hll = dense;
+}
+
+// create a new HyperLogLog
+HLL HLL_New(void) {
+	HLL hll = rm_malloc(sizeof(struct _HLL) +
+			sizeof(uint64_t) * HLL_SPARSE_INIT);
+
+	hll->count = 0;
+	hll->cap   = HLL_SPARSE_INIT;
+
+	return hll;
+}
+
+// add hashed element to sketch
+void HLL_Add
+(
+	HLL *hll,      // sketch, may be reallocated
+	uint64_t hash  // element hash
+) {
+	ASSERT(hll != NULL && *hll != NULL);
+
+	HLL _hll = *hll;
+
+	if(HLL_IS_DENSE(_hll)) {
+		_HLL_DenseAdd((uint8_t *)_hll->data, hash);
+		return;
+	}
+
+	// binary search for hash position
+	uint32_t lo = 0;
+	uint32_t hi = _hll->count;
+	while(lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if(_hll->data[mid] < hash) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	// hash already present
+	if(lo < _hll->count && _hll->data[lo] == hash) {
+		return;
+	}
+
+	if(_hll->count == _hll->cap) {
+		if(_hll->cap == HLL_SPARSE_MAX) {
+			// sparse representation is full
+			_HLL_ToDense(hll);
+			_HLL_DenseAdd((uint8_t *)(*hll)->data, hash);
+			return;
+		}
+
+		_hll->cap *= 2;
+		_hll = rm_realloc(_hll, sizeof(struct _HLL) +
+				sizeof(uint64_t) * _hll->cap);
+		*hll = _hll;
+	}
+
+	memmove(_hll->data + lo + 1, _hll->data + lo,
+			sizeof(uint64_t) * (_hll->count - lo));
+	_hll->data[lo] = hash;
+	_hll->count++;
+}
+
+// merge 'src' into 'dest'
+void HLL_Merge
+(
+	HLL *dest,       // sketch to merge into, may be reallocated
+	const HLL src    // sketch to merge
+) {
+	ASSERT(src  != NULL);
+	ASSERT(dest != NULL && *dest != NULL);
+
+	if(!HLL_IS_DENSE(src)) {
+		for(uint32_t i = 0; i < src->count; i++) {
+			HLL_Add(dest, src->data[i]);
+		}
+		return;
+	}
+
+	if(!HLL_IS_DENSE(*dest)) {
+		_HLL_ToDense(dest);
+	}
+
+	uint8_t *dest_regs = (uint8_t *)(*dest)->data;
+	const uint8_t *src_regs = (const uint8_t *)src->data;
+	for(uint32_t i = 0; i < HLL_REGISTERS; i++) {
+		if(src_regs[i] > dest_regs[i]) {
+			dest_regs[i] = src_regs[i];
+		}
+	}
+}
+
+// estimate number of distinct elements added to sketch
+uint64_t HLL_Count
+(
+	const HLL hll  // sketch
+) {
+	ASSERT(hll != NULL);
+
+	// sparse representation is exact
+	if(!HLL_IS_DENSE(hll)) {
+		return hll->count;
+	}
+
+	double   m     = HLL_REGISTERS;
+	double   sum   = 0;
+	uint32_t zeros = 0;
+
+	const uint8_t *registers = (const uint8_t *)hll->data;
+	for(uint32_t i = 0; i < HLL_REGISTERS; i++) {
+		sum += ldexp(1.0, -registers[i]);
+		zeros += (registers[i] == 0);
+	}
+
+	double alpha = 0.7213 / (1 + 1.079 / m);
+	double estimate = alpha * m * m / sum;
+
+	// small range correction, use linear counting
+	if(estimate <= 2.5 * m && zeros > 0) {
+		estimate = m * log(m / zeros);
+	}
+
+	return (uint64_t)llround(estimate);
+}
+
+// free sketch
+void HLL_Free
+(
+	HLL *hll  // sketch to free
+) {
+	ASSERT(hll != NULL && *hll != NULL);
+
+	rm_free(*hll);
+	*hll = NULL;
+}
+
@@ -0,0 +1,51 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// HyperLogLog, a mergeable sketch for estimating the number of distinct
+// elements in a stream, elements are presented to the sketch by their
+// 64 bit hash
+//
+// small cardinalities are counted exactly by keeping a short list of hashes
+// once the list fills up the sketch switches to 2^HLL_PRECISION registers
+// yielding an estimation with a standard error of ~0.81%
+
+typedef struct _HLL *HLL;
+
+// number of bits used to select a register
+#define HLL_PRECISION 14
+
+// create a new HyperLogLog
+HLL HLL_New(void);
+
+// add hashed element to sketch
+void HLL_Add
+(
+	HLL *hll,      // sketch, may be reallocated
+	uint64_t hash  // element hash
+);
+
+// merge 'src' into 'dest'
+void HLL_Merge
+(
+	HLL *dest,       // sketch to merge into, may be reallocated
+	const HLL src    // sketch to merge
+);
+
+// estimate number of distinct elements added to sketch
+uint64_t HLL_Count
+(
+	const HLL hll  // sketch
+);
+
+// free sketch
+void HLL_Free
+(
+	HLL *hll  // sketch to free
+);
+
@@ -0,0 +1,258 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "tdigest.h"
+#include "rmalloc.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// a centroid summarizes 'weight' values around 'mean'
+typedef struct {
+	double mean;    // centroid mean
+	double weight;  // number of values represented by centroid
+} _Centroid;
+
+// the digest holds a fixed size array of nodes
+// the first 'merged' nodes are compressed centroids sorted by mean
+// the remaining nodes are buffered, yet to be merged, values
+// once the array fills up, all nodes are sorted and compressed
+struct _TDigest {
+	double compression;  // compression factor
+	double total;        // total weight of all nodes
+	double min;          // smallest value added
+	double max;          // largest value added
+	uint32_t merged;     // number of compressed centroids
+	uint32_t count;      // number of nodes in use
+	uint32_t cap;        // number of nodes
+	_Centroid nodes[];   // centroids followed by buffered values
+};
+
+// k1 scale function, maps quantile 'q' to a scale in which each centroid
+// is allowed a size of at most 1
+static inline double _k
+(
+	double q,           // quantile
+	double compression  // compression factor
+) {
+	return (compression / (2 * M_PI)) * asin(2 * q - 1);
+}
+
+// inverse of the k1 scale function
+static inline double _k_inv
+(
+	double k,           // scale
+	double compression  // compression factor
+) {
+	return (sin(k * (2 * M_PI) / compression) + 1) / 2;
+}
+
+static int _cmp_centroid
+(
+	const void *a,
+	const void *b
+) {
+	const _Centroid *_a = a;
+	const _Centroid *_b = b;
+	return (_a->mean > _b->mean) - (_a->mean < _b->mean);
+}
+
+// sort all nodes and merge neighbouring nodes
+// as long as the resulting centroid respects the scale function bound
+static void _TDigest_Compress
+(
+	TDigest td  // digest
+) {
+	if(td->count == td->merged) {
+		return;
+	}
+
+	qsort(td->nodes, td->count, sizeof(_Centroid), _cmp_centroid);
+
+	double    total   = td->total;
+	double    so_far  = 0;  // weight of emitted centroids
+	uint32_t  out     = 0;
+	_Centroid cur     = td->nodes[0];
+	double    q_limit = _k_inv(_k(0, td->compression) + 1, td->compression);
+
+	for(uint32_t i = 1; i < td->count; i++) {
+		_Centroid *n = td->nodes + i;
+		double proposed = cur.weight + n->weight;
+
+		if((so_far + proposed) / total <= q_limit) {
+			// absorb node into current centroid
+			cur.mean   += (n->mean - cur.mean) * n->weight / proposed;
+			cur.weight  = proposed;
+		} else {
+			// emit current centroid and start a new one
+			so_far += cur.weight;
+			td->nodes[out++] = cur;
+			q_limit = _k_inv(_k(so_far / total, td->compression) + 1,
+					td->compression);
+			cur = *n;
+		}
+	}
+
+	td->nodes[out++] = cur;
+	td->merged = out;
+	td->count  = out;
+}
+
+// add a weighted value to digest
+static void _TDigest_AddWeighted
+(
+	TDigest td,    // digest
+	double x,      // value
+	double weight  // value's weight
+) {
+	if(td->count == td->cap) {
+		_TDigest_Compress(td);
+	}
+
+	// compression is guaranteed to free up space
+	ASSERT(td->count < td->cap);
+
+	td->nodes[td->count].mean   = x;
+	td->nodes[td->count].weight = weight;
+	td->count++;
+
+	td->total += weight;
+	if(x < td->min) td->min = x;
+	if(x > td->max) td->max = x;
+}
+
+// create a new t-digest
+TDigest TDigest_New
+(
+	double compression  // compression factor
+) {
+	ASSERT(compression > 0);
+
+	// a compressed digest holds at most ~compression centroids
+	// the rest of the nodes are used for buffering
+	uint32_t cap = (uint32_t)ceil(compression) * 6 + 10;
+
+	TDigest td = rm_malloc(sizeof(struct _TDigest) + sizeof(_Centroid) * cap);
+
+	td->compression = compression;
+	td->total       = 0;
+	td->min         = INFINITY;
+	td->max         = -INFINITY;
+	td->merged      = 0;
+	td->count       = 0;
+	td->cap         = cap;
+
+	return td;
+}
+
+// add value to digest
+void TDigest_Add
+(
+	TDigest td,  // digest
+	double x     // value to add
+) {
+	ASSERT(td != NULL);
+
+	// NaN can't be ordered
+	if(isnan(x)) {
+		return;
+	}
+
+	_TDigest_AddWeighted(td, x, 1);
+}
+
+// merge 'src' into 'dest'
+void TDigest_Merge
+(
+	TDigest dest,       // digest to merge into
+	const TDigest src   // digest to merge
+) {
+	ASSERT(src  != NULL);
+	ASSERT(dest != NULL);
+
+	for(uint32_t i = 0; i < src->count; i++) {
+		_TDigest_AddWeighted(dest, src->nodes[i].mean, src->nodes[i].weight);
+	}
+
+	// centroid means never exceed the range of their values
+	if(src->min < dest->min) dest->min = src->min;
+	if(src->max > dest->max) dest->max = src->max;
+}
+
+// returns number of values added to digest
+uint64_t TDigest_Count
+(
+	TDigest td  // digest
+) {
+	ASSERT(td != NULL);
+
+	return (uint64_t)td->total;
+}
+
+// estimate the value at quantile 'q', 0 <= q <= 1
+// returns NaN if digest is empty
+double TDigest_Quantile
+(
+	TDigest td,  // digest
+	double q     // quantile
+) {
+	ASSERT(td != NULL);
+	ASSERT(q >= 0 && q <= 1);
+
+	if(td->count == 0) {
+		return NAN;
+	}
+
+	_TDigest_Compress(td);
+
+	uint32_t n = td->merged;
+	_Centroid *c = td->nodes;
+
+	if(q == 0) return td->min;
+	if(q == 1) return td->max;
+	if(n == 1) return c[0].mean;
+
+	// position of the requested value among all values
+	double index = q * td->total;
+
+	// left tail, interpolate between min and the first centroid
+	if(index < c[0].weight / 2) {
+		return td->min + (index / (c[0].weight / 2)) * (c[0].mean - td->min);
+	}
+
+	// right tail, interpolate between the last centroid and max
+	if(index > td->total - c[n - 1].weight / 2) {
+		double d = td->total - index;
+		return td->max - (d / (c[n - 1].weight / 2)) *
+			(td->max - c[n - 1].mean);
+	}
+
+	// each centroid is positioned at the center of the values it represents
+	// interpolate between the two centroids surrounding 'index'
+	double pos = c[0].weight / 2;
+	for(uint32_t i = 0; i < n - 1; i++) {
+		double gap = (c[i].weight + c[i + 1].weight) / 2;
+		if(pos + gap >= index) {
+			double t = (index - pos) / gap;
+			return c[i].mean + t * (c[i + 1].mean - c[i].mean);
+		}
+		pos += gap;
+	}
+
+	return c[n - 1].mean;
+}
+
+// free digest
+void TDigest_Free
+(
+	TDigest *td  // digest to free
+) {
+	ASSERT(td != NULL && *td != NULL);
+
+	rm_free(*td);
+	*td = NULL;
+}
+
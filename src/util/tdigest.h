@@ -0,0 +1,65 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// t-digest, a mergeable sketch for estimating quantiles
+// see: Ted Dunning, "Computing Extremely Accurate Quantiles Using t-Digests"
+//
+// the digest summarizes a stream of values as a bounded number of centroids
+// (mean, weight), centroids are small near the tails and large around the
+// median, as such extreme quantiles are estimated with high accuracy
+//
+// memory is bounded by the digest's compression factor
+// regardless of the number of values added
+
+typedef struct _TDigest *TDigest;
+
+// default compression factor
+// higher values yield more accurate estimations at the cost of memory
+#define TDIGEST_DEFAULT_COMPRESSION 100
+
+// create a new t-digest
+TDigest TDigest_New
+(
+	double compression  // compression factor
+);
+
+// add value to digest
+void TDigest_Add
+(
+	TDigest td,  // digest
+	double x     // value to add
+);
+
+// merge 'src' into 'dest'
+void TDigest_Merge
+(
+	TDigest dest,       // digest to merge into
+	const TDigest src   // digest to merge
+);
+
+// returns number of values added to digest
+uint64_t TDigest_Count
+(
+	TDigest td  // digest
+);
+
+// estimate the value at quantile 'q', 0 <= q <= 1
+// returns NaN if digest is empty
+double TDigest_Quantile
+(
+	TDigest td,  // digest
+	double q     // quantile
+);
+
+// free digest
+void TDigest_Free
+(
+	TDigest *td  // digest to free
+);
+
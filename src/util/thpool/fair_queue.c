@@ -0,0 +1,308 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "dict.h"
+#include "rmalloc.h"
+#include "fair_queue.h"
+
+#include <math.h>
+#include <strings.h>
+
+// credit granted to a tenant each DRR round, microseconds
+#define QUANTUM 1000.0
+
+// lower bound on a task's cost, microseconds
+#define MIN_COST 50.0
+
+// weight of the latest run time in a tenant's average task cost
+#define COST_ALPHA 0.2
+
+// per tenant queue
+typedef struct Flow {
+	const void *tenant;  // tenant
+	FairTask *first;     // oldest queued task
+	FairTask *last;      // newest queued task
+	double deficit;      // DRR credit
+	double cost;         // average task cost
+	uint32_t running;    // number of popped tasks yet to complete
+	bool active;         // flow has queued tasks
+	struct Flow *next;   // next active flow
+} Flow;
+
+// priority class
+typedef struct {
+	dict *flows;        // tenant -> flow
+	Flow *head;         // active flow whose turn it is
+	Flow *tail;         // last active flow
+	uint32_t n_active;  // number of active flows
+} Class;
+
+struct _FairQueue {
+	Class classes[TASK_PRIORITY_COUNT];  // priority classes
+	uint64_t len;                        // number of queued tasks
+};
+
+static const char *_priority_names[TASK_PRIORITY_COUNT] = {
+	"HIGH", "NORMAL", "LOW"
+};
+
+bool TaskPriority_FromString
+(
+	const char *name,       // priority class name
+	TaskPriority *priority  // [output] priority class
+) {
+	ASSERT(name     != NULL);
+	ASSERT(priority != NULL);
+
+	for(int i = 0; i < TASK_PRIORITY_COUNT; i++) {
+		if(strcasecmp(name, _priority_names[i]) == 0) {
+			*priority = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const char *TaskPriority_ToString
+(
+	TaskPriority priority  // priority class
+) {
+	ASSERT(priority < TASK_PRIORITY_COUNT);
+	return _priority_names[priority];
+}
+
+// append flow to the class's active list
+static void _activate
+(
+	Class *c,  // priority class
+	Flow *f    // flow
+) {
+	f->next   = NULL;
+	f->active = true;
+
+	if(c->tail == NULL) {
+		c->head = f;
+	} else {
+		c->tail->next = f;
+	}
+	c->tail = f;
+	c->n_active++;
+}
+
+// remove the head flow from the class's active list
+static Flow *_deactivate_head
+(
+	Class *c  // priority class
+) {
+	Flow *f = c->head;
+
+	c->head = f->next;
+	if(c->head == NULL) c->tail = NULL;
+	c->n_active--;
+
+	f->next    = NULL;
+	f->active  = false;
+	f->deficit = 0;
+
+	return f;
+}
+
+// release flow once it has neither queued nor running tasks
+static void _release_idle
+(
+	Class *c,  // priority class
+	Flow *f    // flow
+) {
+	if(f->active || f->running > 0) return;
+
+	HashTableDelete(c->flows, f->tenant);
+	rm_free(f);
+}
+
+FairQueue *FairQueue_New(void) {
+	FairQueue *q = rm_calloc(1, sizeof(FairQueue));
+
+	for(int i = 0; i < TASK_PRIORITY_COUNT; i++) {
+		q->classes[i].flows = HashTableCreate(&def_dt);
+	}
+
+	return q;
+}
+
+void FairQueue_Push
+(
+	FairQueue *q,   // fair queue
+	FairTask *task  // task to queue
+) {
+	ASSERT(q    != NULL);
+	ASSERT(task != NULL);
+	ASSERT(task->priority < TASK_PRIORITY_COUNT);
+
+	Class *c = q->classes + task->priority;
+
+	Flow *f = HashTableFetchValue(c->flows, task->tenant);
+	if(f == NULL) {
+		f = rm_calloc(1, sizeof(Flow));
+		f->tenant = task->tenant;
+		f->cost   = QUANTUM;
+		HashTableAdd(c->flows, (void *)task->tenant, f);
+	}
+
+	task->next = NULL;
+	if(f->last == NULL) {
+		f->first = task;
+	} else {
+		f->last->next = task;
+	}
+	f->last = task;
+
+	if(!f->active) _activate(c, f);
+
+	q->len++;
+}
+
+FairTask *FairQueue_Pop
+(
+	FairQueue *q  // fair queue
+) {
+	ASSERT(q != NULL);
+
+	// find highest priority class with pending tasks
+	Class *c = NULL;
+	for(int i = 0; i < TASK_PRIORITY_COUNT && c == NULL; i++) {
+		if(q->classes[i].head != NULL) c = q->classes + i;
+	}
+
+	if(c == NULL) return NULL;
+
+	// pass turns until reaching a flow which can afford its next task
+	uint32_t visited = 0;
+	while(c->head->deficit < c->head->cost) {
+		if(visited == c->n_active) {
+			// a full round went by without any flow affording a task
+			// fast forward, grant every flow the credit missing
+			// for the closest one
+			double credit = INFINITY;
+			for(Flow *f = c->head; f != NULL; f = f->next) {
+				credit = fmin(credit, f->cost - f->deficit);
+			}
+			credit = fmax(credit, 0);
+			for(Flow *f = c->head; f != NULL; f = f->next) {
+				f->deficit += credit;
+			}
+			visited = 0;
+			continue;
+		}
+
+		// head's turn is over, move it to the back of the line
+		// with credit for its next turn
+		Flow *f = c->head;
+		f->deficit += QUANTUM;
+		if(c->n_active > 1) {
+			c->head = f->next;
+			f->next = NULL;
+			c->tail->next = f;
+			c->tail = f;
+		}
+		visited++;
+	}
+
+	Flow *f = c->head;
+	FairTask *task = f->first;
+
+	f->first = task->next;
+	if(f->first == NULL) f->last = NULL;
+	task->next = NULL;
+
+	f->deficit -= f->cost;
+	f->running++;
+
+	// flow drained, leave the active list
+	if(f->first == NULL) _deactivate_head(c);
+
+	q->len--;
+	return task;
+}
+
+void FairQueue_Done
+(
+	FairQueue *q,          // fair queue
+	const FairTask *task,  // completed task
+	double cost            // task's run time, microseconds
+) {
+	ASSERT(q    != NULL);
+	ASSERT(task != NULL);
+
+	Class *c = q->classes + task->priority;
+	Flow *f = HashTableFetchValue(c->flows, task->tenant);
+	ASSERT(f != NULL);
+	ASSERT(f->running > 0);
+
+	f->running--;
+	f->cost = (1 - COST_ALPHA) * f->cost + COST_ALPHA * fmax(cost, MIN_COST);
+
+	_release_idle(c, f);
+}
+
+uint64_t FairQueue_Len
+(
+	const FairQueue *q  // fair queue
+) {
+	ASSERT(q != NULL);
+	return q->len;
+}
+
+void FairQueue_GetTasks
+(
+	FairQueue *q,              // fair queue
+	void **tasks,              // array of tasks
+	uint32_t *num_tasks,       // [in/out] capacity / number of tasks collected
+	void (*function)(void *),  // function to match
+	void (*match)(void *)      // [optional] executed on every matched task
+) {
+	ASSERT(q         != NULL);
+	ASSERT(tasks     != NULL);
+	ASSERT(function  != NULL);
+	ASSERT(num_tasks != NULL);
+
+	uint32_t k = 0;  // number of matched tasks
+
+	for(int i = 0; i < TASK_PRIORITY_COUNT; i++) {
+		for(Flow *f = q->classes[i].head; f != NULL; f = f->next) {
+			for(FairTask *t = f->first; t != NULL; t = t->next) {
+				if(k == *num_tasks) goto done;
+				if(t->function != function) continue;
+
+				tasks[k++] = t->arg;
+				if(match != NULL) match(t->arg);
+			}
+		}
+	}
+
+done:
+	*num_tasks = k;
+}
+
+void FairQueue_Free
+(
+	FairQueue *q  // fair queue
+) {
+	ASSERT(q != NULL);
+
+	for(int i = 0; i < TASK_PRIORITY_COUNT; i++) {
+		dictEntry *entry;
+		dictIterator *it = HashTableGetIterator(q->classes[i].flows);
+		while((entry = HashTableNext(it)) != NULL) {
+			rm_free(HashTableGetVal(entry));
+		}
+		HashTableReleaseIterator(it);
+		HashTableRelease(q->classes[i].flows);
+	}
+
+	rm_free(q);
+}
+
@@ -0,0 +1,102 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// fair task queue
+//
+// tasks are queued by priority class and by tenant
+// classes are served in strict priority order, within a class tenants are
+// served by deficit round robin (DRR), where a task's cost is its tenant's
+// average run time, as such a tenant flooding the queue with long tasks
+// doesn't starve other tenants' short tasks
+//
+// the queue isn't thread-safe, callers are expected to synchronize access
+
+// task priority classes, ordered from highest to lowest
+typedef enum {
+	TASK_PRIORITY_HIGH = 0,  // served first
+	TASK_PRIORITY_NORMAL,    // default
+	TASK_PRIORITY_LOW,       // served once no other class has pending tasks
+	TASK_PRIORITY_COUNT      // number of priority classes
+} TaskPriority;
+
+typedef struct FairTask {
+	void (*function)(void *);  // function to run
+	void *arg;                 // function argument
+	const void *tenant;        // tenant owning the task, e.g. graph
+	TaskPriority priority;     // task priority class
+	uint64_t enqueued_at;      // enqueue time, microseconds
+	struct FairTask *next;     // [internal] next task of the same tenant
+} FairTask;
+
+typedef struct _FairQueue FairQueue;
+
+// parse priority class name, case insensitive
+// returns false if name isn't a priority class
+bool TaskPriority_FromString
+(
+	const char *name,       // priority class name
+	TaskPriority *priority  // [output] priority class
+);
+
+// returns priority class name
+const char *TaskPriority_ToString
+(
+	TaskPriority priority  // priority class
+);
+
+// create a new fair queue
+FairQueue *FairQueue_New(void);
+
+// queue task
+void FairQueue_Push
+(
+	FairQueue *q,   // fair queue
+	FairTask *task  // task to queue
+);
+
+// pop the next task to run, NULL if queue is empty
+// popped tasks must be reported via FairQueue_Done once they complete
+FairTask *FairQueue_Pop
+(
+	FairQueue *q  // fair queue
+);
+
+// report a popped task had completed
+// 'cost' updates the tenant's average task cost
+void FairQueue_Done
+(
+	FairQueue *q,          // fair queue
+	const FairTask *task,  // completed task
+	double cost            // task's run time, microseconds
+);
+
+// returns number of queued tasks
+uint64_t FairQueue_Len
+(
+	const FairQueue *q  // fair queue
+);
+
+// collects queued tasks matching given function
+// 'match' is invoked on each matched task's argument
+void FairQueue_GetTasks
+(
+	FairQueue *q,              // fair queue
+	void **tasks,              // array of tasks
+	uint32_t *num_tasks,       // [in/out] capacity / number of tasks collected
+	void (*function)(void *),  // function to match
+	void (*match)(void *)      // [optional] executed on every matched task
+);
+
+// free queue, queued tasks are owned by the caller and aren't freed
+void FairQueue_Free
+(
+	FairQueue *q  // fair queue
+);
+
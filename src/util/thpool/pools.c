@@ -4,18 +4,206 @@
  * the Server Side Public License v1 (SSPLv1).
  */
 
+#include <time.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include "RG.h"
 #include "pools.h"
+#include "../rmalloc.h"
+#include "../tdigest.h"
 #include "../../configuration/config.h"
 
 //------------------------------------------------------------------------------
 // Thread pools
 //------------------------------------------------------------------------------
 
-static threadpool _readers_thpool = NULL;  // readers
+static wspool     _readers_pool   = NULL;  // readers, work-stealing
 static threadpool _writers_thpool = NULL;  // writers
 
+//------------------------------------------------------------------------------
+// Query scheduling
+//------------------------------------------------------------------------------
+
+// number of scheduled queries handed to the readers per reader
+// readers pick their next query straight off the readers pool's injection
+// queue, while queries beyond this window wait in the fair queue
+#define SCHED_WINDOW 2
+
+// a query waiting to be scheduled
+typedef struct {
+	FairTask task;      // fair queue task, must be first
+	uint64_t run_time;  // run time, microseconds, set once completed
+} SchedTask;
+
+// queue wait digests of a single reader, one per priority class
+// each reader records its own samples, GRAPH.INFO merges them
+typedef struct {
+	pthread_mutex_t lock;                  // guards digests against GRAPH.INFO
+	TDigest digests[TASK_PRIORITY_COUNT];  // queue wait per class, ms
+} QueueWait;
+
+// queries are handed to the readers by a single scheduler at a time
+// threads dispatching or completing a query push it onto a lock-free stack
+// and try to become the scheduler, threads failing to acquire the scheduler
+// lock leave their query to the current scheduler, as such neither
+// dispatching nor completing a query ever blocks on the lock
+static pthread_mutex_t _sched_lock       = PTHREAD_MUTEX_INITIALIZER;
+static FairQueue *_sched_queue           = NULL;  // queries awaiting a reader
+static _Atomic(FairTask *) _sched_intake = NULL;  // dispatched queries
+static _Atomic(FairTask *) _sched_done   = NULL;  // completed queries
+static _Atomic uint64_t _sched_queued    = 0;     // number of queued queries
+static _Atomic uint32_t _sched_running   = 0;     // queries handed to readers
+static uint32_t _sched_window            = 0;     // max queries handed out
+static uint64_t _max_pending_work        = UINT64_MAX;  // max queued tasks
+
+static QueueWait *_queue_wait            = NULL;  // queue wait per reader
+static __thread QueueWait *_reader_wait  = NULL;  // queue wait of this reader
+
+// GRAPH.INFO inspection of scheduled queries, guarded by '_sched_lock'
+static struct {
+	void (*handler)(void *);  // task handler to match
+	void (*match)(void *);    // [optional] function to invoke on each match
+	void **tasks;             // matched tasks
+	uint32_t n;               // number of matched tasks
+	uint32_t cap;             // max number of matched tasks
+} _inspect;
+
+// monotonic clock, microseconds
+static uint64_t _now_us(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+// push task onto a lock-free stack
+static void _sched_push
+(
+	_Atomic(FairTask *) *stack,  // stack
+	FairTask *task               // task to push
+) {
+	FairTask *head = atomic_load(stack);
+	do {
+		task->next = head;
+	} while(!atomic_compare_exchange_weak(stack, &head, task));
+}
+
+// move completed and dispatched queries into the fair queue
+// caller must hold '_sched_lock'
+static void _sched_collect(void) {
+	// report completed queries, updating their graph's average cost
+	FairTask *task = atomic_exchange(&_sched_done, NULL);
+	while(task != NULL) {
+		FairTask *next = task->next;
+		FairQueue_Done(_sched_queue, task, ((SchedTask *)task)->run_time);
+		rm_free(task);
+		task = next;
+	}
+
+	// the intake stack holds the newest query first, restore arrival order
+	FairTask *arrived = NULL;
+	task = atomic_exchange(&_sched_intake, NULL);
+	while(task != NULL) {
+		FairTask *next = task->next;
+		task->next = arrived;
+		arrived = task;
+		task = next;
+	}
+
+	while(arrived != NULL) {
+		FairTask *next = arrived->next;
+		FairQueue_Push(_sched_queue, arrived);
+		arrived = next;
+	}
+}
+
+static void _run_scheduled(void *arg);
+
+// hand queued queries to the readers until the window is full
+// returns without scheduling if another thread is the scheduler
+static void _schedule(void) {
+	do {
+		// pairs with the fence below, either we acquire the lock
+		// or the current scheduler sees our query
+		atomic_thread_fence(memory_order_seq_cst);
+		if(pthread_mutex_trylock(&_sched_lock) != 0) return;
+
+		_sched_collect();
+
+		// queries are injected rather than pushed onto the scheduling
+		// reader's own deque, readers pick them in scheduling order
+		FairTask *task;
+		while(atomic_load(&_sched_running) < _sched_window &&
+			  (task = FairQueue_Pop(_sched_queue)) != NULL) {
+			atomic_fetch_add(&_sched_running, 1);
+			atomic_fetch_sub(&_sched_queued, 1);
+			wspool_inject_work(_readers_pool, _run_scheduled, task);
+		}
+
+		pthread_mutex_unlock(&_sched_lock);
+
+		// queries pushed while we were scheduling are ours to schedule
+		atomic_thread_fence(memory_order_seq_cst);
+	} while(atomic_load(&_sched_intake) != NULL ||
+			atomic_load(&_sched_done) != NULL);
+}
+
+// record the queue wait of a query in the current reader's digest
+static void _record_wait
+(
+	TaskPriority priority,  // query priority class
+	double wait             // queue wait, ms
+) {
+	if(_reader_wait == NULL) {
+		int id = wspool_get_thread_id(_readers_pool, pthread_self());
+		ASSERT(id != -1);
+		_reader_wait = _queue_wait + id;
+	}
+
+	// only contended while GRAPH.INFO merges the digests
+	pthread_mutex_lock(&_reader_wait->lock);
+	TDigest_Add(_reader_wait->digests[priority], wait);
+	pthread_mutex_unlock(&_reader_wait->lock);
+}
+
+// runs a scheduled query and schedules the next queued queries
+static void _run_scheduled
+(
+	void *arg  // scheduled task
+) {
+	SchedTask *task = (SchedTask *)arg;
+
+	uint64_t start = _now_us();
+	task->task.function(task->task.arg);
+	task->run_time = _now_us() - start;
+
+	_record_wait(task->task.priority,
+			(start - task->task.enqueued_at) / 1000.0);
+
+	// task is freed by the scheduler once its cost is reported
+	atomic_fetch_sub(&_sched_running, 1);
+	_sched_push(&_sched_done, (FairTask *)task);
+
+	// no query is waiting for a reader, completed queries are reported
+	// by the next scheduler, queries dispatched from now on schedule
+	// themselves
+	if(atomic_load(&_sched_queued) > 0) _schedule();
+}
+
+// collects scheduled queries matching the inspected handler
+// invoked on jobs of the readers pool before they can start
+static void _inspect_scheduled
+(
+	void *arg  // scheduled task
+) {
+	FairTask *task = (FairTask *)arg;
+	if(task->function != _inspect.handler || _inspect.n == _inspect.cap) {
+		return;
+	}
+
+	_inspect.tasks[_inspect.n++] = task->arg;
+	if(_inspect.match != NULL) _inspect.match(task->arg);
+}
+
 int ThreadPools_Init
 (
 ) {
@@ -44,15 +232,31 @@ int ThreadPools_CreatePools
 	uint writer_count,
 	uint64_t max_pending_work
 ) {
-	ASSERT(_readers_thpool == NULL);
+	ASSERT(_readers_pool == NULL);
 	ASSERT(_writers_thpool == NULL);
 
-	_readers_thpool = thpool_init(reader_count, "reader");
-	if(_readers_thpool == NULL) return 0;
+	_readers_pool = wspool_init(reader_count, "reader");
+	if(_readers_pool == NULL) return 0;
 
 	_writers_thpool = thpool_init(writer_count, "writer");
 	if(_writers_thpool == NULL) return 0;
 
+	int reader_threads = wspool_num_threads(_readers_pool);
+
+	_sched_queue  = FairQueue_New();
+	_sched_window = SCHED_WINDOW * reader_threads;
+	atomic_store(&_sched_queued, 0);
+	atomic_store(&_sched_running, 0);
+
+	_queue_wait = rm_calloc(reader_threads, sizeof(QueueWait));
+	for(int i = 0; i < reader_threads; i++) {
+		pthread_mutex_init(&_queue_wait[i].lock, NULL);
+		for(int j = 0; j < TASK_PRIORITY_COUNT; j++) {
+			_queue_wait[i].digests[j] =
+				TDigest_New(TDIGEST_DEFAULT_COMPRESSION);
+		}
+	}
+
 	ThreadPools_SetMaxPendingWork(max_pending_work);
 
 	return 1;
@@ -63,11 +267,11 @@ uint ThreadPools_ThreadCount
 (
 	void
 ) {
-	ASSERT(_readers_thpool != NULL);
+	ASSERT(_readers_pool != NULL);
 	ASSERT(_writers_thpool != NULL);
 
 	uint count = 0;
-	count += thpool_num_threads(_readers_thpool);
+	count += wspool_num_threads(_readers_pool);
 	count += thpool_num_threads(_writers_thpool);
 
 	return count;
@@ -77,8 +281,8 @@ uint ThreadPools_ReadersCount
 (
 	void
 ) {
-	ASSERT(_readers_thpool != NULL);
-	return thpool_num_threads(_readers_thpool);
+	ASSERT(_readers_pool != NULL);
+	return wspool_num_threads(_readers_pool);
 }
 
 // retrieve current thread id
@@ -89,14 +293,14 @@ int ThreadPools_GetThreadID
 (
 	void
 ) {
-	ASSERT(_readers_thpool != NULL);
+	ASSERT(_readers_pool != NULL);
 	ASSERT(_writers_thpool != NULL);
 
 	// thpool_get_thread_id returns -1 if pthread_self isn't in the thread pool
 	// most likely Redis main thread
 	int thread_id;
 	pthread_t pthread = pthread_self();
-	int readers_count = thpool_num_threads(_readers_thpool);
+	int readers_count = wspool_num_threads(_readers_pool);
 
 	// search in writers
 	thread_id = thpool_get_thread_id(_writers_thpool, pthread);
@@ -104,7 +308,7 @@ int ThreadPools_GetThreadID
 	if(thread_id != -1) return readers_count + thread_id + 1;
 
 	// search in readers pool
-	thread_id = thpool_get_thread_id(_readers_thpool, pthread);
+	thread_id = wspool_get_thread_id(_readers_pool, pthread);
 	// compensate for Redis main thread
 	if(thread_id != -1) return thread_id + 1;
 
@@ -116,10 +320,10 @@ void ThreadPools_Pause
 (
 	void
 ) {
-	ASSERT(_readers_thpool != NULL);
+	ASSERT(_readers_pool != NULL);
 	ASSERT(_writers_thpool != NULL);
 
-	thpool_pause(_readers_thpool);
+	wspool_pause(_readers_pool);
 	thpool_pause(_writers_thpool);
 }
 
@@ -128,26 +332,62 @@ void ThreadPools_Resume
 	void
 ) {
 
-	ASSERT(_readers_thpool != NULL);
+	ASSERT(_readers_pool != NULL);
 	ASSERT(_writers_thpool != NULL);
 
-	thpool_resume(_readers_thpool);
+	wspool_resume(_readers_pool);
 	thpool_resume(_writers_thpool);
 }
 
 // adds a read task
+// tasks added by a reader thread are queued on that thread's own deque
+// where idle readers can steal them, allowing a query to fan out work
 int ThreadPools_AddWorkReader
 (
 	void (*function_p)(void *),  // function to run
 	void *arg_p,                 // function arguments
 	int force                    // true will add task even if internal queue is full
 ) {
-	ASSERT(_readers_thpool != NULL);
+	ASSERT(_readers_pool != NULL);
 
 	// make sure there's enough room in thread pool queue
-	if(!force && thpool_queue_full(_readers_thpool)) return THPOOL_QUEUE_FULL;
+	if(!force && wspool_queue_full(_readers_pool)) return THPOOL_QUEUE_FULL;
+
+	return wspool_add_work(_readers_pool, function_p, arg_p);
+}
 
-	return thpool_add_work(_readers_thpool, function_p, arg_p);
+// adds a query to run on a reader thread
+// queries are queued by priority class and by graph, higher classes are
+// served first and within a class graphs are served by deficit round robin
+int ThreadPools_AddQueryReader
+(
+	void (*function_p)(void *),  // function to run
+	void *arg_p,                 // function arguments
+	const void *graph,           // graph queried
+	TaskPriority priority,       // query priority class
+	int force                    // true will add task even if internal queue is full
+) {
+	ASSERT(_readers_pool != NULL);
+	ASSERT(priority < TASK_PRIORITY_COUNT);
+
+	// make sure there's enough room in the queue
+	uint64_t pending = atomic_load(&_sched_queued) +
+		wspool_get_jobqueue_len(_readers_pool);
+	if(!force && pending >= _max_pending_work) return THPOOL_QUEUE_FULL;
+
+	SchedTask *task        = rm_malloc(sizeof(SchedTask));
+	task->task.function    = function_p;
+	task->task.arg         = arg_p;
+	task->task.tenant      = graph;
+	task->task.priority    = priority;
+	task->task.enqueued_at = _now_us();
+	task->run_time         = 0;
+
+	atomic_fetch_add(&_sched_queued, 1);
+	_sched_push(&_sched_intake, (FairTask *)task);
+	_schedule();
+
+	return 0;
 }
 
 // add task for writer thread
@@ -165,8 +405,26 @@ int ThreadPools_AddWorkWriter
 	return thpool_add_work(_writers_thpool, function_p, arg_p);
 }
 
+// removes up to n tasks of the given handler queued for the writer thread
+// in queue order, see thpool_take_tasks
+// returns number of tasks removed
+uint32_t ThreadPools_TakeWriterTasks
+(
+	void **tasks,                                // [output] removed tasks
+	uint32_t n,                                  // max number of tasks
+	void (*handler)(void *),                     // task handler to match
+	TaskFilterResult (*filter)(void *, void *),  // task filter
+	void *pdata                                  // filter's private data
+) {
+	ASSERT(_writers_thpool != NULL);
+
+	return thpool_take_tasks(_writers_thpool, tasks, n, handler, filter,
+			pdata);
+}
+
 void ThreadPools_SetMaxPendingWork(uint64_t val) {
-	if(_readers_thpool != NULL) thpool_set_jobqueue_cap(_readers_thpool, val);
+	_max_pending_work = val;
+	if(_readers_pool != NULL) wspool_set_jobqueue_cap(_readers_pool, val);
 	if(_writers_thpool != NULL) thpool_set_jobqueue_cap(_writers_thpool, val);
 }
 
@@ -180,40 +438,126 @@ void **ThreadPools_GetTasksByHandler
 ) {
 	// validations
 	ASSERT(handler         != NULL);
-	ASSERT(_readers_thpool != NULL);
+	ASSERT(_readers_pool != NULL);
 	ASSERT(_writers_thpool != NULL);
 
+	// hold the scheduler lock while inspecting scheduled queries
+	// queued queries can't be scheduled before 'match' returns
+	pthread_mutex_lock(&_sched_lock);
+	_sched_collect();
+
+	// cap number of scheduled tasks
+	uint32_t s_task_count = (FairQueue_Len(_sched_queue) > 1000)
+		? 1000
+		: FairQueue_Len(_sched_queue);
+
 	// cap number of read tasks
-	uint32_t r_task_count = (thpool_get_jobqueue_len(_readers_thpool) > 1000)
+	// scheduled and unscheduled queries share the readers queue
+	uint32_t r_task_count = (wspool_get_jobqueue_len(_readers_pool) > 1000)
 		? 1000
-		: thpool_get_jobqueue_len(_readers_thpool);
+		: wspool_get_jobqueue_len(_readers_pool);
 
 	// cap number of write tasks
 	uint32_t w_task_count = (thpool_get_jobqueue_len(_writers_thpool) > 1000)
 		? 1000
 		: thpool_get_jobqueue_len(_writers_thpool);
 
-	void **tasks = malloc(sizeof(void *) * (r_task_count + w_task_count));
+	void **tasks = malloc(sizeof(void *) *
+			(s_task_count + 2 * r_task_count + w_task_count));
+
+	// collect queued tasks
+	FairQueue_GetTasks(_sched_queue, tasks, &s_task_count, handler, match);
+
+	// collect scheduled tasks yet to be picked by a reader
+	// scheduled jobs are collected into the space past the read tasks
+	// and matched against 'handler' as they're inspected
+	_inspect.handler = handler;
+	_inspect.match   = match;
+	_inspect.tasks   = tasks + s_task_count;
+	_inspect.n       = 0;
+	_inspect.cap     = r_task_count;
+
+	uint32_t scheduled = r_task_count;
+	wspool_get_tasks(_readers_pool, tasks + s_task_count + r_task_count,
+			&scheduled, _run_scheduled, _inspect_scheduled);
+	s_task_count += _inspect.n;
+
+	pthread_mutex_unlock(&_sched_lock);
+
+	// queries dispatched while we held the lock
+	_schedule();
 
 	// collect tasks from readers and writers
-	thpool_get_tasks(_readers_thpool, tasks, &r_task_count, handler, match);
-	thpool_get_tasks(_writers_thpool, tasks + r_task_count, &w_task_count,
+	r_task_count -= _inspect.n;
+	wspool_get_tasks(_readers_pool, tasks + s_task_count, &r_task_count,
 			handler, match);
+	thpool_get_tasks(_writers_thpool, tasks + s_task_count + r_task_count,
+			&w_task_count, handler, match);
 
 	// update number of tasks
-	*n = r_task_count + w_task_count;
+	*n = s_task_count + r_task_count + w_task_count;
 
 	return tasks;
 }
 
+// estimates queue wait of a priority class, milliseconds
+// returns number of queries which waited in the class's queue
+uint64_t ThreadPools_QueueWait
+(
+	TaskPriority priority,    // priority class
+	const double *quantiles,  // quantiles to estimate
+	double *waits,            // [output] estimated wait per quantile
+	int n                     // number of quantiles
+) {
+	ASSERT(priority  < TASK_PRIORITY_COUNT);
+	ASSERT(waits     != NULL);
+	ASSERT(quantiles != NULL);
+
+	// merge the readers' digests
+	TDigest td = TDigest_New(TDIGEST_DEFAULT_COMPRESSION);
+	int reader_threads = wspool_num_threads(_readers_pool);
+	for(int i = 0; i < reader_threads; i++) {
+		pthread_mutex_lock(&_queue_wait[i].lock);
+		TDigest_Merge(td, _queue_wait[i].digests[priority]);
+		pthread_mutex_unlock(&_queue_wait[i].lock);
+	}
+
+	uint64_t count = TDigest_Count(td);
+	for(int i = 0; i < n; i++) {
+		waits[i] = (count > 0) ? TDigest_Quantile(td, quantiles[i]) : 0;
+	}
+
+	TDigest_Free(&td);
+
+	return count;
+}
+
 void ThreadPools_Destroy
 (
 	void
 ) {
-	ASSERT(_readers_thpool != NULL);
+	ASSERT(_readers_pool != NULL);
 	ASSERT(_writers_thpool != NULL);
 
-	thpool_destroy(_readers_thpool);
+	int reader_threads = wspool_num_threads(_readers_pool);
+
+	wspool_destroy(_readers_pool);
 	thpool_destroy(_writers_thpool);
+
+	// discard queries which never got to run
+	FairTask *task;
+	_sched_collect();
+	while((task = FairQueue_Pop(_sched_queue)) != NULL) rm_free(task);
+	FairQueue_Free(_sched_queue);
+	_sched_queue = NULL;
+
+	for(int i = 0; i < reader_threads; i++) {
+		pthread_mutex_destroy(&_queue_wait[i].lock);
+		for(int j = 0; j < TASK_PRIORITY_COUNT; j++) {
+			TDigest_Free(_queue_wait[i].digests + j);
+		}
+	}
+	rm_free(_queue_wait);
+	_queue_wait = NULL;
 }
 
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "thpool.h"
+#include "wspool.h"
+#include "fair_queue.h"
 #include <sys/types.h>
 
 #define THPOOL_QUEUE_FULL -2
@@ -44,6 +46,8 @@ void ThreadPools_Pause(void);
 void ThreadPools_Resume(void);
 
 // adds a read task
+// tasks added by a reader thread are queued on that thread's own deque
+// where idle readers can steal them
 int ThreadPools_AddWorkReader
 (
 	void (*function_p)(void *),  // function to run
@@ -51,6 +55,18 @@ int ThreadPools_AddWorkReader
 	int force                    // true will add task even if internal queue is full
 );
 
+// adds a query to run on a reader thread
+// queries are queued by priority class and by graph, higher classes are
+// served first and within a class graphs are served by deficit round robin
+int ThreadPools_AddQueryReader
+(
+	void (*function_p)(void *),  // function to run
+	void *arg_p,                 // function arguments
+	const void *graph,           // graph queried
+	TaskPriority priority,       // query priority class
+	int force                    // true will add task even if internal queue is full
+);
+
 // add a write task
 int ThreadPools_AddWorkWriter
 (
@@ -74,6 +90,28 @@ void **ThreadPools_GetTasksByHandler
 	uint32_t *n               // number of tasks returned
 );
 
+// removes up to n tasks of the given handler queued for the writer thread
+// in queue order, see thpool_take_tasks
+// returns number of tasks removed
+uint32_t ThreadPools_TakeWriterTasks
+(
+	void **tasks,                                // [output] removed tasks
+	uint32_t n,                                  // max number of tasks
+	void (*handler)(void *),                     // task handler to match
+	TaskFilterResult (*filter)(void *, void *),  // task filter
+	void *pdata                                  // filter's private data
+);
+
+// estimates queue wait of a priority class, milliseconds
+// returns number of queries which waited in the class's queue
+uint64_t ThreadPools_QueueWait
+(
+	TaskPriority priority,    // priority class
+	const double *quantiles,  // quantiles to estimate
+	double *waits,            // [output] estimated wait per quantile
+	int n                     // number of quantiles
+);
+
 // destroies all threadpools, allows threads to exit gracefully
 void ThreadPools_Destroy
 (
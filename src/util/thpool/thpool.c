@@ -348,6 +348,75 @@ void thpool_get_tasks
 	*num_tasks = k;
 }
 
+// removes up to n queued tasks matching given handler, in queue order
+// scanning stops at the first task of a different handler
+// or once filter returns TASK_STOP
+// returns number of tasks removed
+uint32_t thpool_take_tasks
+(
+	threadpool thpool_p,                           // thread pool
+	void **tasks,                                  // [output] removed tasks
+	uint32_t n,                                    // max number of tasks
+	void (*handler)(void *),                       // handler function
+	TaskFilterResult (*filter)(void *, void *),    // task filter
+	void *pdata                                    // filter's private data
+) {
+	// validations
+	ASSERT(tasks    != NULL);
+	ASSERT(filter   != NULL);
+	ASSERT(handler  != NULL);
+	ASSERT(thpool_p != NULL);
+
+	jobqueue *jobqueue_p = &thpool_p->jobqueue;
+
+	// lock job queue
+	pthread_mutex_lock(&jobqueue_p->rwmutex);
+
+	uint32_t k      = 0;                  // number of removed tasks
+	job     *before = NULL;               // last job left in queue
+	job     *job_p  = jobqueue_p->front;  // current job
+
+	// jobs are linked from the front of the queue to its rear via 'prev'
+	while(job_p != NULL && k < n) {
+		// stop at a task of a different kind, preserving queue order
+		if(job_p->function != handler) break;
+
+		TaskFilterResult res = filter(job_p->arg, pdata);
+		if(res == TASK_STOP) break;
+
+		if(res == TASK_SKIP) {
+			before = job_p;
+			job_p  = job_p->prev;
+			continue;
+		}
+
+		// unlink job from queue
+		job *next = job_p->prev;
+		if(before == NULL) {
+			jobqueue_p->front = next;
+		} else {
+			before->prev = next;
+		}
+
+		if(jobqueue_p->rear == job_p) {
+			jobqueue_p->rear = before;
+		}
+
+		jobqueue_p->len--;
+		tasks[k++] = job_p->arg;
+
+		rm_free(job_p);
+		job_p = next;
+	}
+
+	// release lock
+	// a pending has_jobs post on an emptied queue results in a NULL pull,
+	// which thread_do ignores
+	pthread_mutex_unlock(&jobqueue_p->rwmutex);
+
+	return k;
+}
+
 /* ============================ THREAD ============================== */
 
 /* Initialize a thread in the thread pool
@@ -380,6 +449,17 @@ static void thread_hold(int sig_id) {
 	}
 }
 
+/* Register the handler holding paused threads */
+void thpool_register_hold_handler(void) {
+	struct sigaction act;
+	sigemptyset(&act.sa_mask);
+	act.sa_flags = 0;
+	act.sa_handler = thread_hold;
+	if(sigaction(SIGUSR2, &act, NULL) == -1) {
+		err("thread_do(): cannot handle SIGUSR1");
+	}
+}
+
 /* What each thread is doing
 *
 * In principle this is an endless loop. The only time this loop gets interuppted is once
@@ -407,13 +487,7 @@ static void *thread_do(struct thread *thread_p) {
 	thpool_* thpool_p = thread_p->thpool_p;
 
 	/* Register signal handler */
-	struct sigaction act;
-	sigemptyset(&act.sa_mask);
-	act.sa_flags = 0;
-	act.sa_handler = thread_hold;
-	if(sigaction(SIGUSR2, &act, NULL) == -1) {
-		err("thread_do(): cannot handle SIGUSR1");
-	}
+	thpool_register_hold_handler();
 
 	/* Mark thread as alive (initialized) */
 	++thpool_p->num_threads_alive;
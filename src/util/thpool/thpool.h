@@ -244,6 +244,10 @@ uint64_t thpool_get_jobqueue_len
 	threadpool
 );
 
+// registers the SIGUSR2 handler holding threads paused by thpool_pause
+// until thpool_resume is called, shared by all thread pools
+void thpool_register_hold_handler(void);
+
 // collects tasks matching given handler
 void thpool_get_tasks
 (
@@ -254,6 +258,27 @@ void thpool_get_tasks
 	void (*match)(void*)      // [optional] executed on every match task
 );
 
+// decision made by thpool_take_tasks' filter on a queued task
+typedef enum {
+	TASK_TAKE,  // remove task from queue and collect it
+	TASK_SKIP,  // leave task queued, continue scanning
+	TASK_STOP   // leave task queued, stop scanning
+} TaskFilterResult;
+
+// removes up to n queued tasks matching given handler, in queue order
+// scanning stops at the first task of a different handler
+// or once filter returns TASK_STOP
+// returns number of tasks removed
+uint32_t thpool_take_tasks
+(
+	threadpool thpool_p,                           // thread pool
+	void **tasks,                                  // [output] removed tasks
+	uint32_t n,                                    // max number of tasks
+	void (*handler)(void *),                       // handler function
+	TaskFilterResult (*filter)(void *, void *),    // task filter
+	void *pdata                                    // filter's private data
+);
+
 #ifdef __cplusplus
 }
 #endif
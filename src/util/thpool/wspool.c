@@ -0,0 +1,735 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "wspool.h"
+#include "thpool.h"
+#include "rmalloc.h"
+
+#include <stdio.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#if defined(__linux__)
+#include <sys/prctl.h>
+#endif
+
+// number of injection queue slots, a power of 2
+#define RING_CAP 4096
+#define RING_MASK (RING_CAP - 1)
+
+// number of slots in a worker's deque, a power of 2
+#define DEQUE_CAP 1024
+#define DEQUE_MASK (DEQUE_CAP - 1)
+
+// number of failed job lookups before an idle worker parks
+#define SPIN_ROUNDS 64
+
+// keeps frequently written fields on separate cache lines
+#define CACHE_LINE 64
+
+typedef void (*wsfunc)(void *);
+
+typedef struct {
+	wsfunc function;  // function to run
+	void *arg;        // function argument
+} wsjob;
+
+// injection queue cell
+// a cell is ready to be written when seq == pos
+// and ready to be read when seq == pos + 1
+typedef struct {
+	_Atomic uint64_t seq;       // cell sequence number
+	_Atomic(wsfunc) function;   // function to run
+	_Atomic(void *) arg;        // function argument
+} cell;
+
+// job spilled from a full injection queue
+typedef struct overflow_job {
+	struct overflow_job *next;  // next job
+	wsjob job;                  // job
+} overflow_job;
+
+// Chase-Lev deque
+// the owning worker pushes and takes at the bottom, thieves steal at the top
+typedef struct {
+	_Atomic int64_t top;                 // next slot to steal
+	char _pad0[CACHE_LINE];
+	_Atomic int64_t bottom;              // next slot to push
+	char _pad1[CACHE_LINE];
+	struct {
+		_Atomic(wsfunc) function;        // function to run
+		_Atomic(void *) arg;             // function argument
+	} slots[DEQUE_CAP];
+} deque;
+
+typedef struct {
+	int id;                // worker id
+	pthread_t pthread;     // worker thread
+	struct wspool_ *pool;  // owning pool
+	uint64_t rand;         // steal victim selection state
+	deque deque;           // worker's jobs
+} worker;
+
+struct wspool_ {
+	_Atomic uint64_t enq;                // next injection position to write
+	char _pad0[CACHE_LINE];
+	_Atomic uint64_t deq;                // next injection position to read
+	char _pad1[CACHE_LINE];
+	cell ring[RING_CAP];                 // injection queue
+
+	pthread_mutex_t overflow_lock;       // guards overflow list
+	overflow_job *overflow_head;         // oldest spilled job
+	overflow_job *overflow_tail;         // newest spilled job
+	_Atomic uint64_t overflow_len;       // number of spilled jobs
+
+	_Atomic uint32_t inspecting;         // number of active get_tasks calls
+
+	pthread_mutex_t sleep_lock;          // guards parking
+	pthread_cond_t sleep_cond;           // signaled on new work
+	_Atomic uint32_t sleepers;           // number of parked workers
+
+	_Atomic bool keepalive;              // workers exit once cleared
+	_Atomic int num_threads_alive;       // number of running workers
+	_Atomic uint64_t cap;                // max number of pending jobs
+	int num_threads;                     // number of workers
+	worker **workers;                    // workers
+	const char *name;                    // pool name
+};
+
+// the pool worker running on the current thread, NULL for external threads
+static __thread worker *_self = NULL;
+
+//------------------------------------------------------------------------------
+// injection queue
+//------------------------------------------------------------------------------
+
+// push job onto the injection queue
+// returns false if the queue is full
+static bool _ring_push
+(
+	struct wspool_ *pool,  // thread pool
+	wsjob job              // job to push
+) {
+	cell *c;
+	uint64_t pos = atomic_load_explicit(&pool->enq, memory_order_relaxed);
+
+	while(true) {
+		c = pool->ring + (pos & RING_MASK);
+		uint64_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+		int64_t diff = (int64_t)seq - (int64_t)pos;
+
+		if(diff == 0) {
+			// cell is free, claim position
+			if(atomic_compare_exchange_weak(&pool->enq, &pos, pos + 1)) break;
+		} else if(diff < 0) {
+			// cell still holds a job from the previous lap
+			return false;
+		} else {
+			pos = atomic_load_explicit(&pool->enq, memory_order_relaxed);
+		}
+	}
+
+	atomic_store_explicit(&c->function, job.function, memory_order_relaxed);
+	atomic_store_explicit(&c->arg, job.arg, memory_order_relaxed);
+	atomic_store_explicit(&c->seq, pos + 1, memory_order_release);
+
+	return true;
+}
+
+// pop job from the injection queue
+// returns false if the queue is empty
+static bool _ring_pop
+(
+	struct wspool_ *pool,  // thread pool
+	wsjob *job             // [output] popped job
+) {
+	cell *c;
+	uint64_t pos = atomic_load_explicit(&pool->deq, memory_order_relaxed);
+
+	while(true) {
+		c = pool->ring + (pos & RING_MASK);
+		uint64_t seq = atomic_load_explicit(&c->seq, memory_order_acquire);
+		int64_t diff = (int64_t)seq - (int64_t)(pos + 1);
+
+		if(diff == 0) {
+			// cell is published, claim position
+			if(atomic_compare_exchange_weak(&pool->deq, &pos, pos + 1)) break;
+		} else if(diff < 0) {
+			// queue is empty or cell isn't published yet
+			return false;
+		} else {
+			pos = atomic_load_explicit(&pool->deq, memory_order_relaxed);
+		}
+	}
+
+	job->function = atomic_load_explicit(&c->function, memory_order_relaxed);
+	job->arg      = atomic_load_explicit(&c->arg, memory_order_relaxed);
+
+	// release cell for the next lap
+	// sequentially consistent, pairs with get_tasks raising 'inspecting'
+	// either the inspector sees the released cell and skips it
+	// or we see the inspector and wait for it to finish processing the job
+	atomic_store(&c->seq, pos + RING_CAP);
+	while(atomic_load(&pool->inspecting) > 0) sched_yield();
+
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// overflow list
+//------------------------------------------------------------------------------
+
+static void _overflow_push
+(
+	struct wspool_ *pool,  // thread pool
+	wsjob job              // job to push
+) {
+	overflow_job *j = rm_malloc(sizeof(overflow_job));
+	j->job  = job;
+	j->next = NULL;
+
+	pthread_mutex_lock(&pool->overflow_lock);
+
+	if(pool->overflow_tail == NULL) {
+		pool->overflow_head = j;
+	} else {
+		pool->overflow_tail->next = j;
+	}
+	pool->overflow_tail = j;
+	atomic_fetch_add(&pool->overflow_len, 1);
+
+	pthread_mutex_unlock(&pool->overflow_lock);
+}
+
+static bool _overflow_pop
+(
+	struct wspool_ *pool,  // thread pool
+	wsjob *job             // [output] popped job
+) {
+	if(atomic_load(&pool->overflow_len) == 0) return false;
+
+	pthread_mutex_lock(&pool->overflow_lock);
+
+	overflow_job *j = pool->overflow_head;
+	if(j != NULL) {
+		pool->overflow_head = j->next;
+		if(pool->overflow_head == NULL) pool->overflow_tail = NULL;
+		atomic_fetch_sub(&pool->overflow_len, 1);
+	}
+
+	pthread_mutex_unlock(&pool->overflow_lock);
+
+	if(j == NULL) return false;
+
+	*job = j->job;
+	rm_free(j);
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Chase-Lev deque
+//------------------------------------------------------------------------------
+
+// push job at the bottom of the deque, owner only
+// returns false if the deque is full
+static bool _deque_push
+(
+	deque *q,  // deque
+	wsjob job  // job to push
+) {
+	int64_t b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+	int64_t t = atomic_load_explicit(&q->top, memory_order_acquire);
+
+	if(b - t >= DEQUE_CAP) return false;
+
+	atomic_store_explicit(&q->slots[b & DEQUE_MASK].function, job.function,
+			memory_order_relaxed);
+	atomic_store_explicit(&q->slots[b & DEQUE_MASK].arg, job.arg,
+			memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+
+	return true;
+}
+
+// take job from the bottom of the deque, owner only
+static bool _deque_take
+(
+	deque *q,   // deque
+	wsjob *job  // [output] taken job
+) {
+	int64_t b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t t = atomic_load_explicit(&q->top, memory_order_relaxed);
+
+	if(t > b) {
+		// deque is empty
+		atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+		return false;
+	}
+
+	job->function = atomic_load_explicit(&q->slots[b & DEQUE_MASK].function,
+			memory_order_relaxed);
+	job->arg = atomic_load_explicit(&q->slots[b & DEQUE_MASK].arg,
+			memory_order_relaxed);
+
+	if(t < b) return true;
+
+	// last job, race thieves for it
+	bool won = atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+			memory_order_seq_cst, memory_order_relaxed);
+	atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+
+	return won;
+}
+
+// steal job from the top of the deque
+// returns false if the deque is empty or another thread won the job
+static bool _deque_steal
+(
+	deque *q,   // deque
+	wsjob *job  // [output] stolen job
+) {
+	int64_t t = atomic_load_explicit(&q->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	int64_t b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+
+	if(t >= b) return false;
+
+	// slot can't be overwritten before top moves past it
+	job->function = atomic_load_explicit(&q->slots[t & DEQUE_MASK].function,
+			memory_order_relaxed);
+	job->arg = atomic_load_explicit(&q->slots[t & DEQUE_MASK].arg,
+			memory_order_relaxed);
+
+	return atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+			memory_order_seq_cst, memory_order_relaxed);
+}
+
+static inline bool _deque_empty
+(
+	deque *q  // deque
+) {
+	int64_t t = atomic_load(&q->top);
+	int64_t b = atomic_load(&q->bottom);
+	return b <= t;
+}
+
+//------------------------------------------------------------------------------
+// workers
+//------------------------------------------------------------------------------
+
+// returns true if any job is pending
+static bool _has_work
+(
+	struct wspool_ *pool  // thread pool
+) {
+	if(atomic_load(&pool->enq) != atomic_load(&pool->deq)) return true;
+	if(atomic_load(&pool->overflow_len) > 0) return true;
+
+	for(int i = 0; i < pool->num_threads; i++) {
+		if(!_deque_empty(&pool->workers[i]->deque)) return true;
+	}
+
+	return false;
+}
+
+// wake a parked worker, if there's one
+static void _wake
+(
+	struct wspool_ *pool  // thread pool
+) {
+	// pairs with _park, either we see the sleeper
+	// or the sleeper sees the new job
+	atomic_thread_fence(memory_order_seq_cst);
+	if(atomic_load(&pool->sleepers) == 0) return;
+
+	pthread_mutex_lock(&pool->sleep_lock);
+	pthread_cond_signal(&pool->sleep_cond);
+	pthread_mutex_unlock(&pool->sleep_lock);
+}
+
+// park worker until new work arrives
+static void _park
+(
+	struct wspool_ *pool  // thread pool
+) {
+	pthread_mutex_lock(&pool->sleep_lock);
+
+	atomic_fetch_add(&pool->sleepers, 1);
+	while(atomic_load(&pool->keepalive) && !_has_work(pool)) {
+		pthread_cond_wait(&pool->sleep_cond, &pool->sleep_lock);
+	}
+	atomic_fetch_sub(&pool->sleepers, 1);
+
+	pthread_mutex_unlock(&pool->sleep_lock);
+}
+
+// xorshift, picks the first steal victim
+static inline uint64_t _rand
+(
+	worker *w  // worker
+) {
+	w->rand ^= w->rand << 13;
+	w->rand ^= w->rand >> 7;
+	w->rand ^= w->rand << 17;
+	return w->rand;
+}
+
+// look for a job
+// own deque first, then the injection queue and finally other workers
+static bool _find_job
+(
+	worker *self,  // worker
+	wsjob *job     // [output] job to run
+) {
+	struct wspool_ *pool = self->pool;
+
+	if(_deque_take(&self->deque, job)) return true;
+	if(_ring_pop(pool, job))           return true;
+	if(_overflow_pop(pool, job))       return true;
+
+	int n = pool->num_threads;
+	int start = _rand(self) % n;
+	for(int i = 0; i < n; i++) {
+		worker *victim = pool->workers[(start + i) % n];
+		if(victim == self) continue;
+		if(_deque_steal(&victim->deque, job)) return true;
+	}
+
+	return false;
+}
+
+static void *_worker_main
+(
+	void *arg  // worker
+) {
+	worker *self = (worker *)arg;
+	struct wspool_ *pool = self->pool;
+
+	// set thread name for profiling and debugging
+	char thread_name[128] = {0};
+	sprintf(thread_name, "thread-pool-%s-%d", pool->name, self->id);
+#if defined(__linux__)
+	prctl(PR_SET_NAME, thread_name);
+#elif defined(__APPLE__) && defined(__MACH__)
+	pthread_setname_np(thread_name);
+#endif
+
+	thpool_register_hold_handler();
+
+	_self = self;
+	atomic_fetch_add(&pool->num_threads_alive, 1);
+
+	wsjob job;
+	int idle = 0;  // number of consecutive failed lookups
+
+	while(atomic_load(&pool->keepalive)) {
+		if(_find_job(self, &job)) {
+			idle = 0;
+			job.function(job.arg);
+			continue;
+		}
+
+		// spin for a while before parking
+		if(++idle < SPIN_ROUNDS) {
+			sched_yield();
+			continue;
+		}
+
+		idle = 0;
+		_park(pool);
+	}
+
+	_self = NULL;
+	atomic_fetch_sub(&pool->num_threads_alive, 1);
+
+	return NULL;
+}
+
+//------------------------------------------------------------------------------
+// API
+//------------------------------------------------------------------------------
+
+wspool wspool_init
+(
+	int num_threads,  // number of worker threads
+	const char *name  // pool name, used to name worker threads
+) {
+	ASSERT(name != NULL);
+
+	if(num_threads < 1) num_threads = 1;
+
+	struct wspool_ *pool = rm_calloc(1, sizeof(struct wspool_));
+
+	for(uint64_t i = 0; i < RING_CAP; i++) {
+		atomic_init(&pool->ring[i].seq, i);
+	}
+
+	pthread_mutex_init(&pool->overflow_lock, NULL);
+	pthread_mutex_init(&pool->sleep_lock, NULL);
+	pthread_cond_init(&pool->sleep_cond, NULL);
+
+	atomic_init(&pool->keepalive, true);
+	atomic_init(&pool->cap, UINT64_MAX);
+
+	pool->name        = name;
+	pool->num_threads = num_threads;
+	pool->workers     = rm_calloc(num_threads, sizeof(worker *));
+
+	// workers access each other's deques, create all of them before
+	// starting the first thread
+	for(int i = 0; i < num_threads; i++) {
+		worker *w  = rm_calloc(1, sizeof(worker));
+		w->id      = i;
+		w->pool    = pool;
+		w->rand    = i + 1;
+		pool->workers[i] = w;
+	}
+
+	for(int i = 0; i < num_threads; i++) {
+		worker *w = pool->workers[i];
+		if(pthread_create(&w->pthread, NULL, _worker_main, w) != 0) {
+			fprintf(stderr, "wspool_init(): could not create thread\n");
+			// drop workers which weren't started
+			// wait for the threads created so far and fail
+			for(int j = i; j < num_threads; j++) rm_free(pool->workers[j]);
+			pool->num_threads = i;
+			wspool_destroy(pool);
+			return NULL;
+		}
+	}
+
+	// wait for threads to initialize
+	while(atomic_load(&pool->num_threads_alive) != num_threads) sched_yield();
+
+	return pool;
+}
+
+int wspool_add_work
+(
+	wspool pool,                 // thread pool
+	void (*function_p)(void *),  // function to run
+	void *arg_p                  // function argument
+) {
+	ASSERT(pool       != NULL);
+	ASSERT(function_p != NULL);
+
+	wsjob job = {.function = function_p, .arg = arg_p};
+
+	// spawned by one of our workers, keep it local
+	if(_self != NULL && _self->pool == pool &&
+	   _deque_push(&_self->deque, job)) {
+		_wake(pool);
+		return 0;
+	}
+
+	return wspool_inject_work(pool, function_p, arg_p);
+}
+
+int wspool_inject_work
+(
+	wspool pool,                 // thread pool
+	void (*function_p)(void *),  // function to run
+	void *arg_p                  // function argument
+) {
+	ASSERT(pool       != NULL);
+	ASSERT(function_p != NULL);
+
+	wsjob job = {.function = function_p, .arg = arg_p};
+
+	// keep FIFO order, once jobs spill into the overflow list
+	// new jobs follow them there until it drains
+	if(atomic_load(&pool->overflow_len) > 0 || !_ring_push(pool, job)) {
+		_overflow_push(pool, job);
+	}
+
+	_wake(pool);
+	return 0;
+}
+
+bool wspool_queue_full
+(
+	wspool pool  // thread pool
+) {
+	ASSERT(pool != NULL);
+	return wspool_get_jobqueue_len(pool) >= atomic_load(&pool->cap);
+}
+
+void wspool_set_jobqueue_cap
+(
+	wspool pool,  // thread pool
+	uint64_t cap  // max number of pending jobs
+) {
+	ASSERT(pool != NULL);
+	atomic_store(&pool->cap, cap);
+}
+
+uint64_t wspool_get_jobqueue_len
+(
+	wspool pool  // thread pool
+) {
+	ASSERT(pool != NULL);
+
+	// read deq first, enq never falls behind it
+	uint64_t deq = atomic_load(&pool->deq);
+	uint64_t enq = atomic_load(&pool->enq);
+
+	return (enq - deq) + atomic_load(&pool->overflow_len);
+}
+
+void wspool_get_tasks
+(
+	wspool pool,              // thread pool
+	void **tasks,             // array of tasks
+	uint32_t *num_tasks,      // [in/out] capacity / number of tasks collected
+	void (*handler)(void *),  // handler function
+	void (*match)(void *)     // [optional] executed on every matched task
+) {
+	ASSERT(pool      != NULL);
+	ASSERT(tasks     != NULL);
+	ASSERT(handler   != NULL);
+	ASSERT(num_tasks != NULL);
+
+	uint32_t k = 0;  // number of matched tasks
+
+	// workers popping a job from the injection queue hold on to it
+	// until we're done, see _ring_pop
+	atomic_fetch_add(&pool->inspecting, 1);
+
+	uint64_t deq = atomic_load(&pool->deq);
+	uint64_t enq = atomic_load(&pool->enq);
+
+	for(uint64_t pos = deq; pos < enq && k < *num_tasks; pos++) {
+		cell *c = pool->ring + (pos & RING_MASK);
+
+		// skip cells already consumed or not yet published
+		uint64_t seq = atomic_load(&c->seq);
+		if(seq != pos + 1) continue;
+
+		wsfunc f  = atomic_load_explicit(&c->function, memory_order_relaxed);
+		void *arg = atomic_load_explicit(&c->arg, memory_order_relaxed);
+
+		// make sure cell wasn't recycled while reading it
+		atomic_thread_fence(memory_order_acquire);
+		if(atomic_load_explicit(&c->seq, memory_order_relaxed) != seq) continue;
+
+		if(f == handler) {
+			tasks[k++] = arg;
+			if(match != NULL) match(arg);
+		}
+	}
+
+	// spilled jobs are popped under the overflow lock
+	pthread_mutex_lock(&pool->overflow_lock);
+
+	for(overflow_job *j = pool->overflow_head; j != NULL && k < *num_tasks;
+			j = j->next) {
+		if(j->job.function == handler) {
+			tasks[k++] = j->job.arg;
+			if(match != NULL) match(j->job.arg);
+		}
+	}
+
+	pthread_mutex_unlock(&pool->overflow_lock);
+
+	atomic_fetch_sub(&pool->inspecting, 1);
+
+	*num_tasks = k;
+}
+
+int wspool_num_threads
+(
+	wspool pool  // thread pool
+) {
+	ASSERT(pool != NULL);
+	return pool->num_threads;
+}
+
+int wspool_get_thread_id
+(
+	wspool pool,       // thread pool
+	pthread_t pthread  // thread
+) {
+	ASSERT(pool != NULL);
+
+	for(int i = 0; i < pool->num_threads; i++) {
+		if(pthread_equal(pool->workers[i]->pthread, pthread)) {
+			return pool->workers[i]->id;
+		}
+	}
+
+	// could not locate thread
+	return -1;
+}
+
+void wspool_pause
+(
+	wspool pool  // thread pool
+) {
+	ASSERT(pool != NULL);
+
+	pthread_t caller = pthread_self();
+	for(int i = 0; i < pool->num_threads; i++) {
+		// do not pause caller
+		if(!pthread_equal(pool->workers[i]->pthread, caller)) {
+			pthread_kill(pool->workers[i]->pthread, SIGUSR2);
+		}
+	}
+}
+
+void wspool_resume
+(
+	wspool pool  // thread pool
+) {
+	ASSERT(pool != NULL);
+
+	// paused threads are held by the hold handler shared with thpool
+	thpool_resume(NULL);
+}
+
+void wspool_destroy
+(
+	wspool pool  // thread pool
+) {
+	if(pool == NULL) return;
+
+	// make workers leave their main loop
+	atomic_store(&pool->keepalive, false);
+	while(atomic_load(&pool->num_threads_alive) > 0) {
+		pthread_mutex_lock(&pool->sleep_lock);
+		pthread_cond_broadcast(&pool->sleep_cond);
+		pthread_mutex_unlock(&pool->sleep_lock);
+		sched_yield();
+	}
+
+	for(int i = 0; i < pool->num_threads; i++) {
+		int res = pthread_join(pool->workers[i]->pthread, NULL);
+		ASSERT(res == 0);
+		UNUSED(res);
+	}
+
+	for(int i = 0; i < pool->num_threads; i++) {
+		rm_free(pool->workers[i]);
+	}
+	rm_free(pool->workers);
+
+	// discard pending spilled jobs
+	overflow_job *j = pool->overflow_head;
+	while(j != NULL) {
+		overflow_job *next = j->next;
+		rm_free(j);
+		j = next;
+	}
+
+	pthread_mutex_destroy(&pool->overflow_lock);
+	pthread_mutex_destroy(&pool->sleep_lock);
+	pthread_cond_destroy(&pool->sleep_cond);
+
+	rm_free(pool);
+}
+
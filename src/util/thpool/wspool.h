@@ -0,0 +1,119 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+// work-stealing thread pool
+//
+// jobs added by threads outside of the pool are pushed onto a global
+// lock-free injection queue, jobs added by one of the pool's own workers
+// are pushed onto that worker's Chase-Lev deque
+// an idle worker first drains its own deque, then the injection queue
+// and finally steals from the other workers' deques
+// workers spin briefly before parking, producers only signal when a worker
+// is parked
+//
+// the injection queue is a bounded ring, once it fills up jobs spill into
+// a locked overflow list
+
+typedef struct wspool_ *wspool;
+
+// create a work-stealing thread pool
+// returns NULL on failure
+wspool wspool_init
+(
+	int num_threads,  // number of worker threads
+	const char *name  // pool name, used to name worker threads
+);
+
+// add a job to the pool
+// when called from one of the pool's workers the job is pushed onto the
+// worker's own deque, where it can be stolen by idle workers
+// returns 0 on success
+int wspool_add_work
+(
+	wspool pool,                 // thread pool
+	void (*function_p)(void *),  // function to run
+	void *arg_p                  // function argument
+);
+
+// add a job to the pool's injection queue
+// unlike wspool_add_work the job is never pushed onto the caller's own deque
+// as such jobs added by the same thread start in the order they were added
+// returns 0 on success
+int wspool_inject_work
+(
+	wspool pool,                 // thread pool
+	void (*function_p)(void *),  // function to run
+	void *arg_p                  // function argument
+);
+
+// return true if the pool's injection queue is full with pending work
+bool wspool_queue_full
+(
+	wspool pool  // thread pool
+);
+
+// set the max number of pending jobs in the injection queue
+void wspool_set_jobqueue_cap
+(
+	wspool pool,  // thread pool
+	uint64_t cap  // max number of pending jobs
+);
+
+// returns the number of pending jobs in the injection queue
+uint64_t wspool_get_jobqueue_len
+(
+	wspool pool  // thread pool
+);
+
+// collects pending jobs of the injection queue matching given handler
+// 'match' is invoked on each matched job's argument before the job
+// can start running
+void wspool_get_tasks
+(
+	wspool pool,              // thread pool
+	void **tasks,             // array of tasks
+	uint32_t *num_tasks,      // [in/out] capacity / number of tasks collected
+	void (*handler)(void *),  // handler function
+	void (*match)(void *)     // [optional] executed on every matched task
+);
+
+// returns the number of threads in the pool
+int wspool_num_threads
+(
+	wspool pool  // thread pool
+);
+
+// returns the pool's id of the given thread, -1 if it isn't a pool's thread
+int wspool_get_thread_id
+(
+	wspool pool,       // thread pool
+	pthread_t pthread  // thread
+);
+
+// pause all of the pool's threads, except the caller
+void wspool_pause
+(
+	wspool pool  // thread pool
+);
+
+// resume paused threads
+void wspool_resume
+(
+	wspool pool  // thread pool
+);
+
+// stop all worker threads and free the pool
+// jobs still pending are discarded
+void wspool_destroy
+(
+	wspool pool  // thread pool
+);
+
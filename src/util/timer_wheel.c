@@ -0,0 +1,195 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "rmalloc.h"
+#include "timer_wheel.h"
+
+#include <string.h>
+
+// number of bits addressing a level's slots
+#define SLOT_BITS 6
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+// largest number of ticks the wheel can hold a timer for
+// timers due further away are parked at the top level and re-added
+// once their slot is cascaded
+#define MAX_DELTA ((1ULL << (SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1)
+
+// push timer to the front of a slot's list
+static inline void _push
+(
+	WheelTimer **slot,  // slot
+	WheelTimer *t       // timer to push
+) {
+	t->next = *slot;
+	*slot = t;
+}
+
+// place timer within its slot relative to the wheel's current tick
+static void _place
+(
+	TimerWheel *wheel,  // timer wheel
+	WheelTimer *t       // timer to place
+) {
+	// timer already due, expire it on the next processed tick
+	if(t->due < wheel->now) {
+		_push(&wheel->slots[0][wheel->now & SLOT_MASK], t);
+		return;
+	}
+
+	uint64_t delta = t->due - wheel->now;
+	uint64_t due   = t->due;
+	if(delta > MAX_DELTA) {
+		due = wheel->now + MAX_DELTA;
+		delta = MAX_DELTA;
+	}
+
+	// find the lowest level spanning the timer's delta
+	int level = 0;
+	while(level < TIMER_WHEEL_LEVELS - 1 &&
+		  delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+		level++;
+	}
+
+	uint slot = (due >> (SLOT_BITS * level)) & SLOT_MASK;
+	_push(&wheel->slots[level][slot], t);
+}
+
+// re-place the timers of a higher level slot within the levels below
+// returns the slot's index
+static uint _cascade
+(
+	TimerWheel *wheel,  // timer wheel
+	int level           // level to cascade
+) {
+	uint idx = (wheel->now >> (SLOT_BITS * level)) & SLOT_MASK;
+
+	WheelTimer *t = wheel->slots[level][idx];
+	wheel->slots[level][idx] = NULL;
+
+	while(t != NULL) {
+		WheelTimer *next = t->next;
+		_place(wheel, t);
+		t = next;
+	}
+
+	return idx;
+}
+
+TimerWheel *TimerWheel_New
+(
+	uint64_t now  // current tick
+) {
+	TimerWheel *wheel = rm_calloc(1, sizeof(TimerWheel));
+	wheel->now = now;
+	return wheel;
+}
+
+void TimerWheel_Add
+(
+	TimerWheel *wheel,  // timer wheel
+	WheelTimer *t       // timer to add
+) {
+	ASSERT(t     != NULL);
+	ASSERT(wheel != NULL);
+
+	_place(wheel, t);
+	wheel->count++;
+}
+
+WheelTimer *TimerWheel_Advance
+(
+	TimerWheel *wheel,  // timer wheel
+	uint64_t now        // current tick
+) {
+	ASSERT(wheel != NULL);
+
+	WheelTimer *expired = NULL;
+
+	// nothing to expire, jump ahead
+	if(wheel->count == 0) {
+		if(now >= wheel->now) wheel->now = now + 1;
+		return NULL;
+	}
+
+	while(wheel->now <= now && wheel->count > 0) {
+		uint idx = wheel->now & SLOT_MASK;
+
+		// level 0 wrapped around, pull timers down from the levels above
+		for(int level = 1; idx == 0 && level < TIMER_WHEEL_LEVELS; level++) {
+			if(_cascade(wheel, level) != 0) break;
+		}
+
+		// collect slot's timers
+		WheelTimer *t = wheel->slots[0][idx];
+		wheel->slots[0][idx] = NULL;
+		while(t != NULL) {
+			WheelTimer *next = t->next;
+			_push(&expired, t);
+			wheel->count--;
+			t = next;
+		}
+
+		wheel->now++;
+	}
+
+	// wheel emptied before reaching 'now'
+	if(wheel->now <= now) wheel->now = now + 1;
+
+	return expired;
+}
+
+uint64_t TimerWheel_NextTick
+(
+	const TimerWheel *wheel  // timer wheel
+) {
+	ASSERT(wheel != NULL);
+
+	if(wheel->count == 0) return UINT64_MAX;
+
+	// higher levels are cascaded when level 0 wraps around
+	uint64_t wrap = (wheel->now | SLOT_MASK) + 1;
+	if((wheel->now & SLOT_MASK) == 0) return wheel->now;
+
+	for(uint64_t tick = wheel->now; tick < wrap; tick++) {
+		if(wheel->slots[0][tick & SLOT_MASK] != NULL) return tick;
+	}
+
+	return wrap;
+}
+
+WheelTimer *TimerWheel_Clear
+(
+	TimerWheel *wheel  // timer wheel
+) {
+	ASSERT(wheel != NULL);
+
+	WheelTimer *timers = NULL;
+
+	for(int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+		for(int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+			WheelTimer *t = wheel->slots[level][slot];
+			while(t != NULL) {
+				WheelTimer *next = t->next;
+				_push(&timers, t);
+				t = next;
+			}
+		}
+	}
+
+	memset(wheel->slots, 0, sizeof(wheel->slots));
+	wheel->count = 0;
+
+	return timers;
+}
+
+void TimerWheel_Free
+(
+	TimerWheel *wheel  // timer wheel
+) {
+	ASSERT(wheel != NULL);
+	rm_free(wheel);
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// hierarchical timer wheel
+// timers are bucketed by their due tick into one of several levels
+// each level's slots span 64 times the ticks of the level below
+// adding a timer and expiring a tick are O(1)
+// a slot of a higher level is cascaded into the levels below
+// once the wheel reaches it
+//
+// the wheel isn't thread-safe, it is meant to be owned by a single thread
+// timers can't be removed, owners are expected to mark timers as canceled
+// and discard them once they expire
+
+// number of wheel levels
+#define TIMER_WHEEL_LEVELS 4
+
+// number of slots per level, a power of 2
+#define TIMER_WHEEL_SLOTS 64
+
+// timer, embedded within the owner's struct
+typedef struct WheelTimer {
+	struct WheelTimer *next;  // next timer within the same slot
+	uint64_t due;             // tick at which the timer expires
+} WheelTimer;
+
+typedef struct {
+	uint64_t now;    // next tick to process
+	uint64_t count;  // number of timers in the wheel
+	WheelTimer *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];  // timer lists
+} TimerWheel;
+
+// create a new timer wheel starting at tick 'now'
+TimerWheel *TimerWheel_New
+(
+	uint64_t now  // current tick
+);
+
+// add timer to wheel
+// timers already due expire on the next advanced tick
+void TimerWheel_Add
+(
+	TimerWheel *wheel,  // timer wheel
+	WheelTimer *t       // timer to add
+);
+
+// advance wheel up to and including tick 'now'
+// returns a list of expired timers linked via their 'next' field
+WheelTimer *TimerWheel_Advance
+(
+	TimerWheel *wheel,  // timer wheel
+	uint64_t now        // current tick
+);
+
+// returns the next tick at which the wheel needs to be advanced
+// UINT64_MAX if the wheel is empty
+uint64_t TimerWheel_NextTick
+(
+	const TimerWheel *wheel  // timer wheel
+);
+
+// removes all timers from the wheel
+// returns a list of the removed timers linked via their 'next' field
+WheelTimer *TimerWheel_Clear
+(
+	TimerWheel *wheel  // timer wheel
+);
+
+// free timer wheel
+// timers are owned by the caller and aren't freed
+void TimerWheel_Free
+(
+	TimerWheel *wheel  // timer wheel
+);
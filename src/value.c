@@ -13,7 +13,10 @@
 #include <limits.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <stddef.h>
+#include <stdatomic.h>
 #include <sys/param.h>
+#include "util/arena.h"
 #include "util/rmalloc.h"
 #include "datatypes/datatypes.h"
 
@@ -97,9 +100,27 @@ SIValue SI_Vectorf32
 	return SIVectorf32_New(dim);
 }
 
+// reference counted string
+// strings are immutable, as such a string is shared by all of its clones
+// and released once the last of them is freed
+typedef struct {
+	atomic_uint refcount;  // number of values referencing the string
+	char str[];            // null terminated string
+} SharedString;
+
+// get the shared string 's' is the content of
+#define SHARED_STRING(s) \
+	((SharedString *)((s) - offsetof(SharedString, str)))
+
 SIValue SI_DuplicateStringVal(const char *s) {
+	size_t len = strlen(s);
+	SharedString *shared = rm_malloc(sizeof(SharedString) + len + 1);
+	atomic_init(&shared->refcount, 1);
+	memcpy(shared->str, s, len + 1);
+
 	return (SIValue) {
-		.stringval = rm_strdup(s), .type = T_STRING, .allocation = M_SELF
+		.stringval = shared->str, .type = T_STRING,
+			.allocation = M_SELF | M_SHARED
 	};
 }
 
@@ -115,6 +136,29 @@ SIValue SI_TransferStringVal(char *s) {
 	};
 }
 
+SIValue SI_TransientStringBuffer(size_t len) {
+	Arena *arena = Arena_GetActive();
+	char *s = (arena != NULL) ? Arena_Alloc(arena, len + 1) : NULL;
+
+	// no active arena or the arena is exhausted, the string is heap owned
+	// and freed as soon as its value is
+	if(s == NULL) {
+		return SI_TransferStringVal(rm_malloc(len + 1));
+	}
+
+	// the arena outlives the query's values, hence the string is const
+	return (SIValue) {
+		.stringval = s, .type = T_STRING, .allocation = M_CONST
+	};
+}
+
+SIValue SI_TransientStringVal(const char *s, size_t len) {
+	SIValue v = SI_TransientStringBuffer(len);
+	memcpy(v.stringval, s, len);
+	v.stringval[len] = '\0';
+	return v;
+}
+
 SIValue SI_Point(float latitude, float longitude) {
 	return (SIValue) {
 		.type = T_POINT, .allocation = M_NONE,
@@ -128,7 +172,9 @@ SIValue SI_Point(float latitude, float longitude) {
 SIValue SI_ShareValue(const SIValue v) {
 	SIValue dup = v;
 	// If the original value owns an allocation, mark that the duplicate shares it.
-	if(v.allocation == M_SELF) dup.allocation = M_VOLATILE;
+	if(SI_ALLOCATION(&v) == M_SELF) {
+		dup.allocation = M_VOLATILE | (v.allocation & M_SHARED);
+	}
 	return dup;
 }
 
@@ -143,6 +189,15 @@ SIValue SI_CloneValue(const SIValue v) {
 
 	switch(v.type) {
 		case T_STRING:
+			// take an additional reference to a shared string
+			if(v.allocation & M_SHARED) {
+				atomic_fetch_add_explicit(&SHARED_STRING(v.stringval)->refcount,
+						1, memory_order_relaxed);
+				return (SIValue) {
+					.stringval = v.stringval, .type = T_STRING,
+						.allocation = M_SELF | M_SHARED
+				};
+			}
 			// allocate a new copy of the input's string value
 			return SI_DuplicateStringVal(v.stringval);
 
@@ -184,7 +239,7 @@ SIValue SI_CloneValue(const SIValue v) {
 }
 
 SIValue SI_ShallowCloneValue(const SIValue v) {
-	if(v.allocation == M_CONST || v.allocation == M_NONE) return v;
+	if(SI_ALLOCATION(&v) == M_CONST || v.allocation == M_NONE) return v;
 	return SI_CloneValue(v);
 }
 
@@ -192,14 +247,16 @@ SIValue SI_ShallowCloneValue(const SIValue v) {
  *  to remain in scope. This is most frequently the case for GraphEntity properties. */
 SIValue SI_ConstValue(const SIValue *v) {
 	SIValue dup = *v;
-	if(v->allocation != M_NONE) dup.allocation = M_CONST;
+	if(v->allocation != M_NONE) {
+		dup.allocation = M_CONST | (v->allocation & M_SHARED);
+	}
 	return dup;
 }
 
 // Clone 'v' and set v's allocation to volatile if 'v' owned the memory
 SIValue SI_TransferOwnership(SIValue *v) {
 	SIValue dup = *v;
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	SIValue_MakeVolatile(v);
 	return dup;
 }
 
@@ -207,7 +264,9 @@ SIValue SI_TransferOwnership(SIValue *v) {
  * with no responsibility for freeing or guarantee regarding scope.
  * This is used in cases like performing shallow copies of scalars in Record entries. */
 void SIValue_MakeVolatile(SIValue *v) {
-	if(v->allocation == M_SELF) v->allocation = M_VOLATILE;
+	if(SI_ALLOCATION(v) == M_SELF) {
+		v->allocation = M_VOLATILE | (v->allocation & M_SHARED);
+	}
 }
 
 /* Ensure that any allocation held by the given SIValue is guaranteed to not go out
@@ -217,7 +276,7 @@ void SIValue_MakeVolatile(SIValue *v) {
 void SIValue_Persist(SIValue *v) {
 	// do nothing for non-volatile values
 	// for volatile values, persisting uses the same logic as cloning
-	if(v->allocation == M_VOLATILE) *v = SI_CloneValue(*v);
+	if(SI_ALLOCATION(v) == M_VOLATILE) *v = SI_CloneValue(*v);
 }
 
 /* Update an SIValue's allocation type to the provided value. */
@@ -460,12 +519,22 @@ void SIValue_StringJoin(SIValue *strings, unsigned int string_count, const char
 
 // assumption: either a or b is a string
 static SIValue SIValue_ConcatString(const SIValue a, const SIValue b) {
+	// concatenate strings directly into the result
+	if(a.type == T_STRING && b.type == T_STRING) {
+		size_t a_len = strlen(a.stringval);
+		size_t b_len = strlen(b.stringval);
+		SIValue result = SI_TransientStringBuffer(a_len + b_len);
+		memcpy(result.stringval, a.stringval, a_len);
+		memcpy(result.stringval + a_len, b.stringval, b_len + 1);
+		return result;
+	}
+
 	size_t bufferLen = 512;
 	size_t argument_len = 0;
 	char *buffer = rm_calloc(bufferLen, sizeof(char));
 	SIValue args[2] = {a, b};
 	SIValue_StringJoin(args, 2, "", &buffer, &bufferLen, &argument_len);
-	SIValue result = SI_DuplicateStringVal(buffer);
+	SIValue result = SI_TransientStringVal(buffer, strlen(buffer));
 	rm_free(buffer);
 	return result;
 }
@@ -783,6 +852,24 @@ void SIValue_HashUpdate(SIValue v, XXH64_state_t *state) {
 	}
 }
 
+// determine if a and b fall into the same group
+bool SIValue_Equivalent
+(
+	const SIValue a,
+	const SIValue b
+) {
+	int disjointOrNull = 0;
+	int res = SIValue_Compare(a, b, &disjointOrNull);
+
+	// nulls and NaNs never compare equal, fall back to their hash
+	// which is how they have always been grouped
+	if(disjointOrNull == COMPARED_NULL || disjointOrNull == COMPARED_NAN) {
+		return SIValue_HashCode(a) == SIValue_HashCode(b);
+	}
+
+	return (disjointOrNull == 0 && res == 0);
+}
+
 // hash SIValue
 XXH64_hash_t SIValue_HashCode(SIValue v) {
 	// initialize the hash state
@@ -866,10 +953,19 @@ SIValue SIValue_FromBinary
 			
 void SIValue_Free(SIValue v) {
 	// The free routine only performs work if it owns a heap allocation.
-	if(v.allocation != M_SELF) return;
+	if(SI_ALLOCATION(&v) != M_SELF) return;
 
 	switch(v.type) {
 	case T_STRING:
+		// release a reference to a shared string
+		if(v.allocation & M_SHARED) {
+			SharedString *shared = SHARED_STRING(v.stringval);
+			if(atomic_fetch_sub_explicit(&shared->refcount, 1,
+						memory_order_acq_rel) > 1) {
+				return;
+			}
+			v.stringval = (char *)shared;
+		}
 		rm_free(v.stringval);
 		v.stringval = NULL;
 		return;
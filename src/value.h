@@ -45,12 +45,13 @@ typedef enum {
 	M_NONE = 0,             // SIValue is not heap-allocated
 	M_SELF = (1 << 0),      // SIValue is responsible for freeing its reference
 	M_VOLATILE = (1 << 1),  // SIValue does not own its reference and may go out of scope
-	M_CONST = (1 << 2)      // SIValue does not own its allocation, but its access is safe
+	M_CONST = (1 << 2),     // SIValue does not own its allocation, but its access is safe
+	M_SHARED = (1 << 3)     // string is reference counted, set alongside one of the above
 } SIAllocation;
 
 #define T_VECTOR (T_VECTOR_F32)
 #define SI_TYPE(value) (value).type
-#define SI_ALLOCATION(value) (value)->allocation
+#define SI_ALLOCATION(value) ((value)->allocation & ~M_SHARED)
 #define SI_NUMERIC (T_INT64 | T_DOUBLE)
 #define SI_GRAPHENTITY (T_NODE | T_EDGE)
 #define SI_ALL (T_MAP | T_NODE | T_EDGE | T_ARRAY | T_PATH | T_DATETIME | T_LOCALDATETIME | T_DATE | T_TIME | T_LOCALTIME | T_DURATION | T_STRING | T_BOOL | T_INT64 | T_DOUBLE | T_NULL | T_PTR | T_POINT | T_VECTOR)
@@ -120,6 +121,7 @@ SIValue SI_Array(u_int64_t initialCapacity);
 SIValue SI_Point(float latitude, float longitude);
 
 // Duplicate and ultimately free the input string.
+// the duplicate is reference counted, clones of it share its buffer
 SIValue SI_DuplicateStringVal(const char *s);
 
 // Neither duplicate nor assume ownership of input string.
@@ -128,6 +130,16 @@ SIValue SI_ConstStringVal(const char *s);
 // Don't duplicate input string, but assume ownership.
 SIValue SI_TransferStringVal(char *s);
 
+// Allocate an uninitialized string of 'len' bytes plus a null terminator
+// for the caller to fill, drawn from the thread's active arena if any
+// arena strings are never freed individually and are cloned when persisted
+// into the graph, once the arena is exhausted or if there's no active arena
+// the value owns the string.
+SIValue SI_TransientStringBuffer(size_t len);
+
+// Duplicate the first 'len' bytes of the input string into a transient string.
+SIValue SI_TransientStringVal(const char *s, size_t len);
+
 /* Functions for copying and guaranteeing memory safety for SIValues. */
 // SI_ShareValue creates an SIValue that shares all of the original's allocations.
 SIValue SI_ShareValue(const SIValue v);
@@ -204,6 +216,10 @@ SIValue SIValue_Modulo(const SIValue a, const SIValue b);
  * If the the values are not of the same type, the macro DISJOINT is returned in disjointOrNull value. */
 int SIValue_Compare(const SIValue a, const SIValue b, int *disjointOrNull);
 
+/* Determines if two SIValues fall into the same group when grouping or
+ * removing duplicates, unlike SIValue_Compare nulls and NaNs are equivalent. */
+bool SIValue_Equivalent(const SIValue a, const SIValue b);
+
 /* Update the provided hash state with the given SIValue. */
 void SIValue_HashUpdate(SIValue v, XXH64_state_t *state);
 
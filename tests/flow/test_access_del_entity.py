@@ -213,6 +213,31 @@ class testAccessDelNode():
         self.env.assertEquals(nodes[2].properties['v'], 'c')
         self.env.assertIn('C', nodes[2].labels)
 
+    def test10_traversed_node_deleted_before_access(self):
+        # nodes produced by scans and traversals are resolved on first access
+        # make sure a node deleted prior to its first access is still readable
+        self.graph.query("CREATE (:D {v:1})-[:R]->(:E {v:2}), (:D {v:3})-[:R]->(:E {v:4})")
+
+        # every 'e' is deleted by the first record, before later records access it
+        q = """MATCH (d:D), (e:E)
+               DELETE e
+               RETURN d.v, e.v
+               ORDER BY d.v, e.v"""
+        res = self.graph.query(q)
+        self.env.assertEquals(res.nodes_deleted, 2)
+        self.env.assertEquals(res.result_set, [[1, 2], [1, 4], [3, 2], [3, 4]])
+
+        # traversed destination deleted before it is projected
+        self.graph.query("MATCH (d:D) CREATE (d)-[:R]->(:E {v: d.v + 1})")
+        q = """MATCH (d:D)-[:R]->(e:E)
+               DELETE e
+               RETURN d.v, e.v, labels(e)
+               ORDER BY d.v"""
+        res = self.graph.query(q)
+        self.env.assertEquals(res.result_set, [[1, 2, []], [3, 4, []]])
+
+        self.graph.query("MATCH (d:D) DELETE d")
+
 class testAccessDelEdge():
     def __init__(self):
         GRAPH_ID = "access_del_edge"
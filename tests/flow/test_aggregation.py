@@ -132,3 +132,46 @@ class testAggregations():
         query = 'MATCH (n:L) WHERE (null <> false) XOR true RETURN COUNT(n)'
         expected = [[0]]
         self.get_res_and_assertAlmostEquals(query, expected)
+
+    def test10_percentileApprox(self):
+        # empty input
+        query = "UNWIND [] AS x RETURN percentileApprox(x, 0.5)"
+        self.get_res_and_assertEquals(query, [[None]])
+
+        # small inputs are summarized exactly
+        query = "UNWIND [2, 4, 6, 8, 10] AS x RETURN percentileApprox(x, 0), percentileApprox(x, 1)"
+        self.get_res_and_assertEquals(query, [[2, 10]])
+
+        # estimations are close to the exact percentile
+        n = 100000
+        for p in [0.01, 0.5, 0.99]:
+            query = f"UNWIND range(0, {n - 1}) AS x RETURN percentileApprox(x, {p}), percentileCont(x, {p})"
+            approx, exact = self.graph.query(query).result_set[0]
+            self.env.assertLessEqual(abs(approx - exact), n * 0.01)
+
+        # percentile must be within [0, 1]
+        try:
+            self.graph.query("UNWIND [1, 2] AS x RETURN percentileApprox(x, 1.5)")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+    def test11_approxCountDistinct(self):
+        # empty input
+        query = "UNWIND [] AS x RETURN approxCountDistinct(x)"
+        self.get_res_and_assertEquals(query, [[0]])
+
+        # small cardinalities are exact, NULLs are ignored
+        query = "UNWIND [1, 2, 2, 'a', 'a', NULL, [1]] AS x RETURN approxCountDistinct(x)"
+        self.get_res_and_assertEquals(query, [[4]])
+
+        # estimation is close to the exact distinct count
+        n = 100000
+        query = f"UNWIND range(0, {n * 2 - 1}) AS x RETURN approxCountDistinct(x % {n})"
+        approx = self.graph.query(query).result_set[0][0]
+        self.env.assertLessEqual(abs(approx - n), n * 0.03)
+
+        # grouped
+        query = """UNWIND range(0, 199) AS x
+                   RETURN x % 2 AS k, approxCountDistinct(x) ORDER BY k"""
+        self.get_res_and_assertEquals(query, [[0, 100], [1, 100]])
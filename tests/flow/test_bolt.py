@@ -157,3 +157,54 @@ class testBolt():
              self.env.assertEquals(p.nodes[2].labels, set(['C']))
              self.env.assertEquals(p.relationships[0].type, 'R1')
              self.env.assertEquals(p.relationships[1].type, 'R2')
+
+    def test10_fetch_size(self):
+        # records are pulled in batches of fetch size
+        with bolt_con.session(fetch_size=10) as session:
+            result = session.run("UNWIND range(1, 1000) AS x RETURN x")
+            self.env.assertEquals([r[0] for r in result], list(range(1, 1001)))
+
+        # abandon a partially consumed result
+        with bolt_con.session(fetch_size=10) as session:
+            result = session.run("UNWIND range(1, 1000) AS x RETURN x")
+            self.env.assertEquals(next(iter(result))[0], 1)
+            result.consume()
+
+            # suspended query released its lock, writes proceed
+            session.run("CREATE (:Fetch {v: 1})").consume()
+            result = session.run("MATCH (n:Fetch) RETURN count(n)")
+            self.env.assertEquals(result.single()[0], 1)
+
+        # an error raised after a batch was pulled
+        with bolt_con.session(fetch_size=1) as session:
+            try:
+                result = session.run("UNWIND [1, 1, 0] AS x RETURN 1 / x")
+                list(result)
+                self.env.assertTrue(False)
+            except Exception as e:
+                self.env.assertIn("Division by zero", str(e))
+
+    def test11_abandoned_stream(self):
+        # a client which stops pulling holds the query's read lock
+        # until the query's timeout expires
+        conn = self.env.getConnection()
+        conn.execute_command("GRAPH.CONFIG", "SET", "TIMEOUT_DEFAULT", 1000)
+
+        with bolt_con.session(fetch_size=10) as session:
+            result = session.run("UNWIND range(1, 1000) AS x RETURN x")
+            it = iter(result)
+            self.env.assertEquals(next(it)[0], 1)
+
+            # the stream expires, releasing the read lock for the write
+            g = Graph(conn, "falkordb")
+            res = g.query("CREATE (:Abandoned)")
+            self.env.assertEquals(res.nodes_created, 1)
+
+            # the rest of the stream fails
+            try:
+                list(it)
+                self.env.assertTrue(False)
+            except Exception as e:
+                self.env.assertIn("Query timed out", str(e))
+
+        conn.execute_command("GRAPH.CONFIG", "SET", "TIMEOUT_DEFAULT", 0)
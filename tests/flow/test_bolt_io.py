@@ -0,0 +1,168 @@
+from common import *
+from neo4j import GraphDatabase
+import socket
+import struct
+import threading
+import time
+
+BOLT_PORT = 7688
+BOLT_IO_THREADS = 4
+BIG_QUERY = "UNWIND range(1, 200000) AS x RETURN x, 'padding padding padding'"
+
+
+def _chunk(msg):
+    # a bolt message in a single chunk followed by the end marker
+    return struct.pack('>H', len(msg)) + msg + b'\x00\x00'
+
+
+def _string(s):
+    b = s.encode()
+    if len(b) < 16:
+        return bytes([0x80 | len(b)]) + b
+    return bytes([0xD0, len(b)]) + b
+
+
+def _run(query):
+    # RUN query, no parameters, default graph
+    return _chunk(b'\xB3\x10' + _string(query) + b'\xA0\xA0')
+
+
+def _pull(n):
+    # PULL {n: n}, n is a tiny int
+    return _chunk(b'\xB1\x3F\xA1\x81n' + struct.pack('b', n))
+
+
+def _connect():
+    # raw bolt 5.4 connection, authenticated
+    s = socket.create_connection(("localhost", BOLT_PORT))
+    s.sendall(b'\x60\x60\xB0\x17' + b'\x00\x00\x04\x05' + b'\x00' * 12)
+    s.recv(4)
+
+    # HELLO followed by LOGON
+    s.sendall(_chunk(b'\xB1\x01\xA0') + _chunk(b'\xB1\x6A\xA0'))
+    s.recv(1024)
+    return s
+
+
+class testBoltIO():
+    def __init__(self):
+        self.env, _ = Env(moduleArgs=f"BOLT_PORT {BOLT_PORT} "
+                                     f"BOLT_IO_THREADS {BOLT_IO_THREADS}")
+        self.conn = self.env.getConnection()
+        self.driver = GraphDatabase.driver(f"bolt://localhost:{BOLT_PORT}",
+                                           auth=("falkordb", ""))
+
+    def concurrent_sessions(self, n):
+        # each session consumes its results in batches
+        errors = []
+
+        def consume():
+            try:
+                with self.driver.session(fetch_size=100) as session:
+                    for _ in range(10):
+                        result = session.run(
+                            "UNWIND range(1, 1000) AS x RETURN x")
+                        if sum(r[0] for r in result) != 500500:
+                            errors.append("unexpected result")
+            except Exception as e:
+                errors.append(str(e))
+
+        threads = [threading.Thread(target=consume) for _ in range(n)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        return errors
+
+    def test01_concurrent_sessions(self):
+        # sessions are spread across the I/O threads
+        errors = self.concurrent_sessions(16)
+        self.env.assertEquals(errors, [])
+
+    def test02_disconnect_with_pending_reply(self):
+        for _ in range(16):
+            # disconnect while the whole result is being written
+            s = _connect()
+            s.sendall(_run(BIG_QUERY) + _pull(-1))
+            s.close()
+
+            # disconnect while the query is suspended awaiting a PULL
+            s = _connect()
+            s.sendall(_run(BIG_QUERY) + _pull(10))
+            s.recv(1024)
+            s.close()
+
+        # queries of disconnected clients released their read locks
+        g = Graph(self.conn, "falkordb")
+        res = g.query("CREATE (:Disconnected)")
+        self.env.assertEquals(res.nodes_created, 1)
+
+        # server keeps serving bolt sessions
+        errors = self.concurrent_sessions(8)
+        self.env.assertEquals(errors, [])
+        self.env.assertTrue(self.conn.ping())
+
+    def test03_disconnect_on_pull_timeout(self):
+        # disconnect around the moment suspended queries time out
+        timeout = 500
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "TIMEOUT_DEFAULT",
+                                  timeout)
+
+        def abandon(delay):
+            s = _connect()
+            s.sendall(_run(BIG_QUERY) + _pull(10))
+            s.recv(1024)
+            time.sleep(delay)
+            s.close()
+
+        # disconnect times spread around the timeout
+        delays = [(timeout + i * 5) / 1000 for i in range(-10, 10)]
+        threads = [threading.Thread(target=abandon, args=(d,))
+                   for d in delays]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "TIMEOUT_DEFAULT", 0)
+
+        # expired queries released their read locks
+        g = Graph(self.conn, "falkordb")
+        res = g.query("CREATE (:Expired)")
+        self.env.assertEquals(res.nodes_created, 1)
+
+        # server keeps serving bolt sessions
+        errors = self.concurrent_sessions(8)
+        self.env.assertEquals(errors, [])
+        self.env.assertTrue(self.conn.ping())
+
+    def test04_stalled_reader(self):
+        # clients which don't read their replies fill their socket's
+        # send buffer, the I/O threads keep serving other clients
+        stalled = []
+        for _ in range(BOLT_IO_THREADS * 2):
+            s = _connect()
+            s.sendall(_run(BIG_QUERY) + _pull(-1))
+            stalled.append(s)
+
+        errors = self.concurrent_sessions(8)
+        self.env.assertEquals(errors, [])
+
+        # a stalled client resumes receiving its reply
+        s = stalled.pop()
+        received = 0
+        s.settimeout(10)
+        while received < 1000000:
+            data = s.recv(65536)
+            self.env.assertTrue(len(data) > 0)
+            received += len(data)
+        s.close()
+
+        # disconnecting with a partially written reply
+        for s in stalled:
+            s.close()
+
+        self.env.assertTrue(self.conn.ping())
+        errors = self.concurrent_sessions(4)
+        self.env.assertEquals(errors, [])
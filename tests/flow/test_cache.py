@@ -8,7 +8,9 @@ GRAPH_IDS = ["Cache_Test_plans", "Cache_Sanity_Check", 'Cache_Test_Create',
         'Cache_Test_Create_With_Params', 'Cache_Test_Delete', 'Cache_Test_Merge',
         'Cache_Test_Path_Filter', 'Cache_Test_Index', 'Cache_Test_ID_Scan',
         'Cache_Test_Join', 'Cache_Test_Edge_Merge', 'Cache_test_labelscan_update',
-        'Cache_test_index_scan_update', 'Cache_Empty_Key', 'cache_eviction']
+        'Cache_test_index_scan_update', 'Cache_Empty_Key', 'cache_eviction',
+        'Cache_Plan_Pool', 'Cache_Literals', 'Cache_Replan',
+        'Cache_Replan_Folded', 'Cache_Plan_Recycling']
 CACHE_SIZE = 16
 
 class testCache():
@@ -30,15 +32,16 @@ class testCache():
 
     def test_01_sanity_check(self):
         graph = self.db.select_graph('Cache_Sanity_Check')
+        # literals are parameterized, vary the label to get distinct plans
         for i in range(CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n:L{val}) WHERE n.value = {val} RETURN n".format(val=i))
             self.env.assertFalse(result.cached_execution)
         
         for i in range(1, CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n:L{val}) WHERE n.value = {val} RETURN n".format(val=i))
             self.env.assertTrue(result.cached_execution)
         
-        result = graph.query("MATCH (n) WHERE n.value = 0 RETURN n")
+        result = graph.query("MATCH (n:L0) WHERE n.value = 0 RETURN n")
         self.env.assertFalse(result.cached_execution)
 
 
@@ -241,7 +244,34 @@ class testCache():
         self.env.assertEqual(expected_result, cached_result.result_set)
         self.env.assertTrue(cached_result.cached_execution)
 
-    def test_14_cache_eviction(self):
+    def test_14_plan_pool(self):
+        # cached executions run plans taken from a pool of plan clones
+        graph = self.db.select_graph('Cache_Plan_Pool')
+        graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+
+        # each execution gets its own plan regardless of the params
+        # previous executions were specialized to
+        query = "MATCH (n:N) WHERE n.v = $v RETURN n.v"
+        for i in range(20):
+            result = graph.query(query, {'v': i % 10})
+            self.env.assertEqual(result.result_set, [[i % 10]])
+            self.env.assertEqual(bool(result.cached_execution), i > 0)
+
+        # pooled plans cloned before a relationship type was introduced
+        # must not miss the new relationship type
+        query = "MATCH (:N)-[:R]->(m) RETURN count(m)"
+        for i in range(3):
+            result = graph.query(query)
+            self.env.assertEqual(result.result_set, [[0]])
+
+        graph.query("MATCH (a:N {v: 0}), (b:N {v: 1}) CREATE (a)-[:R]->(b)")
+
+        for i in range(3):
+            result = graph.query(query)
+            self.env.assertEqual(result.result_set, [[1]])
+            self.env.assertTrue(result.cached_execution)
+
+    def test_15_cache_eviction(self):
         # this tests spawns a new graph env` with a query-cache with just
         # a single slot, then multiple clients are issuing a similar query
         # only with a small variation to cause a cache miss which implies
@@ -279,3 +309,132 @@ class testCache():
 
         asyncio.run(run(self))
 
+    def test_16_literal_parameterization(self):
+        # queries differing only by their literals share a cached plan
+        graph = self.db.select_graph('Cache_Literals')
+        graph.query("UNWIND range(0, 4) AS x CREATE (:N {v: x, s: toString(x)})")
+
+        for i in range(5):
+            result = graph.query(f"MATCH (n:N) WHERE n.v = {i} RETURN n.s")
+            self.env.assertEqual(result.result_set, [[str(i)]])
+            self.env.assertEqual(bool(result.cached_execution), i > 0)
+
+        for i in range(5):
+            result = graph.query(f"MATCH (n:N {{s: '{i}'}}) RETURN n.v")
+            self.env.assertEqual(result.result_set, [[i]])
+            self.env.assertEqual(bool(result.cached_execution), i > 0)
+
+        # projected literals name their columns and aren't parameterized
+        for i in range(2):
+            result = graph.query(f"MATCH (n:N) WHERE n.v = {i} RETURN n.v + {i}")
+            self.env.assertEqual(result.header[0][1], f"n.v + {i}")
+            self.env.assertEqual(result.result_set, [[2 * i]])
+            self.env.assertFalse(result.cached_execution)
+
+        # LIMIT shapes the plan and isn't parameterized
+        for i in range(1, 3):
+            result = graph.query(f"MATCH (n:N) RETURN n.v ORDER BY n.v LIMIT {i}")
+            self.env.assertEqual(len(result.result_set), i)
+            self.env.assertFalse(result.cached_execution)
+
+        # errors are reported against the query as given
+        try:
+            graph.query("MATCH (n:N) WHERE n.v = 1 RETURN m")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("'m' not defined", str(e))
+
+    def test_17_replan_on_misestimation(self):
+        # cached plans are rebuilt once a scan produces far more records
+        # than the plan was built for
+        graph = self.db.select_graph('Cache_Replan')
+        graph.query("UNWIND range(0, 4) AS x CREATE (:A)-[:R]->(:B)")
+        graph.query("UNWIND range(0, 1999) AS x CREATE (:B)")
+
+        query = "MATCH (a:A)-[:R]->(b:B) RETURN count(b)"
+        result = graph.query(query)
+        self.env.assertEqual(result.result_set, [[5]])
+
+        plan = str(graph.explain(query))
+        self.env.assertIn("Node By Label Scan | (a:A)", plan)
+
+        # A outgrows B, scanning A is now the more expensive entry point
+        graph.query("UNWIND range(0, 4999) AS x CREATE (:A)")
+
+        # a sample of executions is observed
+        for i in range(16):
+            result = graph.query(query)
+            self.env.assertEqual(result.result_set, [[5]])
+            self.env.assertTrue(result.cached_execution)
+
+        plan = str(graph.explain(query))
+        self.env.assertIn("Node By Label Scan | (b:B)", plan)
+
+    def test_18_replan_folded_strings(self):
+        # re-planned templates hold their folded constants
+        # beyond the query which triggered re-planning
+        graph = self.db.select_graph('Cache_Replan_Folded')
+        graph.query("UNWIND range(0, 4) AS x CREATE (:A)-[:R]->(:B)")
+        graph.query("UNWIND range(0, 1999) AS x CREATE (:B)")
+
+        query = """WITH 'a' + 'b' AS s, left('xyz', 2) AS l
+                   MATCH (a:A)-[:R]->(b:B)
+                   RETURN count(b), s, l"""
+        result = graph.query(query)
+        self.env.assertEqual(result.result_set, [[5, 'ab', 'xy']])
+
+        graph.query("UNWIND range(0, 4999) AS x CREATE (:A)")
+
+        # executions following the re-plan clone the new template
+        for i in range(32):
+            result = graph.query(query)
+            self.env.assertEqual(result.result_set, [[5, 'ab', 'xy']])
+
+        plan = str(graph.explain(query))
+        self.env.assertIn("Node By Label Scan | (b:B)", plan)
+
+    def test_19_plan_recycling(self):
+        # executed plans are restored and returned to the pool
+        # each execution evaluates its own parameters
+        graph = self.db.select_graph('Cache_Plan_Recycling')
+        graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})-[:R]->(:M {v: x})")
+
+        query = "MATCH (n:N)-[:R]->(m) WHERE n.v = $v RETURN m.v, $v LIMIT 3"
+        for i in range(40):
+            v = (i * 7) % 10
+            result = graph.query(query, {'v': v})
+            self.env.assertEqual(result.result_set, [[v, v]])
+
+        # parameterized limits are evaluated by each execution
+        query = "MATCH (n:N) RETURN n.v LIMIT $l"
+        for i in range(20):
+            result = graph.query(query, {'l': i % 4})
+            self.env.assertEqual(len(result.result_set), i % 4)
+
+        # recycled plans pick up indices created meanwhile
+        query = "MATCH (n:N) WHERE n.v = $v RETURN n.v"
+        for i in range(10):
+            result = graph.query(query, {'v': i})
+            self.env.assertEqual(result.result_set, [[i]])
+
+        create_node_range_index(graph, 'N', 'v', sync=True)
+
+        for i in range(10):
+            result = graph.query(query, {'v': i})
+            self.env.assertEqual(result.result_set, [[i]])
+            self.env.assertTrue(result.cached_execution)
+
+        plan = str(graph.profile(query, {'v': 1}))
+        self.env.assertIn("Node By Index Scan", plan)
+
+        # recycled plans pick up new labels
+        query = "MATCH (n:L) RETURN n.v"
+        for i in range(3):
+            result = graph.query(query)
+            self.env.assertEqual(result.result_set, [])
+
+        graph.query("CREATE (:L {v: 1})")
+
+        for i in range(3):
+            result = graph.query(query)
+            self.env.assertEqual(result.result_set, [[1]])
@@ -963,6 +963,60 @@ class testConstraintEdges():
         except ResponseError as e:
             self.env.assertContains("unique constraint violation, on edge of relationship-type Artist", str(e))
 
+    def test08_unique_constraint_hash_lookup(self):
+        # unique constraints are enforced using a native hash index
+        # make sure enforcement follows entity creation, update and deletion
+        create_unique_node_constraint(self.g, "Account", "id", sync=True)
+
+        # bulk ingest using MERGE
+        self.g.query("UNWIND range(0, 999) AS x MERGE (:Account {id: x})")
+
+        # re-merging existing accounts should not create new nodes
+        res = self.g.query("UNWIND range(0, 999) AS x MERGE (:Account {id: x})")
+        self.env.assertEqual(res.nodes_created, 0)
+
+        # numeric values are compared by value
+        try:
+            self.g.query("CREATE (:Account {id: 1.0})")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("unique constraint violation", str(e))
+
+        # updating an entity releases its previous value
+        self.g.query("MATCH (a:Account {id: 0}) SET a.id = -1")
+        self.g.query("CREATE (:Account {id: 0})")
+
+        try:
+            self.g.query("MATCH (a:Account {id: 1}) SET a.id = -1")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("unique constraint violation", str(e))
+
+        # deleting an entity releases its value
+        self.g.query("MATCH (a:Account {id: 2}) DELETE a")
+        self.g.query("CREATE (:Account {id: 2})")
+
+        # a failed query must not leave stale entries behind
+        try:
+            self.g.query("CREATE (:Account {id: 5000}), (:Account {id: 5000})")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains("unique constraint violation", str(e))
+        self.g.query("CREATE (:Account {id: 5000})")
+
+        # equality and IN lookups
+        res = self.g.query("MATCH (a:Account) WHERE a.id = 10 RETURN a.id")
+        self.env.assertEqual(res.result_set, [[10]])
+
+        res = self.g.query("MATCH (a:Account) WHERE a.id IN [10, 20, 20, 'x', 10.0] RETURN a.id ORDER BY a.id")
+        self.env.assertEqual(res.result_set, [[10], [20]])
+
+        res = self.g.query("UNWIND [1, 3, 7000] AS x MATCH (a:Account {id: x}) RETURN a.id ORDER BY a.id")
+        self.env.assertEqual(res.result_set, [[1], [3]])
+
+        res = self.g.query("MATCH (a:Account {id: 3}) WHERE a.id = 4 RETURN a")
+        self.env.assertEqual(len(res.result_set), 0)
+
 MONITOR_ATTACHED = False
 
 class testConstraintReplication():
@@ -2782,3 +2782,33 @@ class testFunctionCallsFlow(FlowTestsBase):
         for q in queries_with_errors:
             self.expect_error(q, err_msg)
 
+
+    def test95_transient_strings(self):
+        # strings computed during execution are drawn from the query's arena
+        # make sure they outlive the query once stored in the graph
+        query = """UNWIND range(0, 999) AS i
+                   WITH i, 'prefix_' + toString(i) AS s
+                   CREATE (:Transient {v: i, s: substring(s, 1), r: reverse(s),
+                           l: left(s, 3), t: trim(' ' + s + ' '),
+                           j: string.join([s, s], '-')})"""
+        self.graph.query(query)
+
+        # access stored strings from a different query
+        query = """MATCH (n:Transient)
+                   WITH n ORDER BY n.v
+                   RETURN collect(n.s), collect(n.r), collect(n.l),
+                          collect(n.t), collect(n.j)"""
+        actual = self.graph.query(query).result_set[0]
+        strs = ['prefix_' + str(i) for i in range(1000)]
+        self.env.assertEquals(actual[0], [s[1:] for s in strs])
+        self.env.assertEquals(actual[1], [s[::-1] for s in strs])
+        self.env.assertEquals(actual[2], [s[:3] for s in strs])
+        self.env.assertEquals(actual[3], strs)
+        self.env.assertEquals(actual[4], [s + '-' + s for s in strs])
+
+        # update existing properties with transient strings
+        self.graph.query("MATCH (n:Transient) SET n.s = toUpper(n.s) + right(n.r, 2)")
+        actual = self.graph.query("MATCH (n:Transient) WITH n ORDER BY n.v RETURN collect(n.s)").result_set[0][0]
+        self.env.assertEquals(actual, [s[1:].upper() + s[::-1][-2:] for s in strs])
+
+        self.graph.query("MATCH (n:Transient) DELETE n")
@@ -239,6 +239,49 @@ class testGraphCopy():
         # clean up
         src_graph.delete()
 
+    def test_07a_copy_multi_edges_and_deleted_entities(self):
+        # make sure multi-edges and deleted entities are copied correctly
+        # and that the copy doesn't share data with the source graph
+        src_graph_id  = GRAPH_ID
+        copy_graph_id = GRAPH_ID + "_copy"
+
+        src_graph = self.db.select_graph(src_graph_id)
+        src_graph.query("""UNWIND range(0, 99) AS x
+                           CREATE (a:A {v:x, s:'str_' + toString(x)})
+                           CREATE (a)-[:R {v:x}]->(:B {v:x})
+                           CREATE (a)-[:R {v:x}]->(:B {v:x})""")
+
+        # form multi-edges
+        src_graph.query("MATCH (a:A)-[:R]->(b:B) CREATE (a)-[:R {v:-1}]->(b)")
+
+        # introduce deleted entities
+        src_graph.query("MATCH (a:A) WHERE a.v % 3 = 0 DETACH DELETE a")
+        src_graph.query("MATCH ()-[e:R]->() WHERE e.v % 5 = 0 DELETE e")
+
+        # make a copy
+        self.graph_copy(src_graph_id, copy_graph_id)
+        copy_graph = self.db.select_graph(copy_graph_id)
+
+        self.assert_graph_eq(src_graph, copy_graph)
+
+        # modify copy, source should not be effected
+        copy_graph.query("MATCH (a:A) SET a.v = a.v + 1000, a.s = 'updated'")
+        copy_graph.query("MATCH ()-[e:R]->() WHERE e.v = -1 DELETE e")
+        copy_graph.query("CREATE (:A {v:-1})-[:R]->(:B)")
+
+        res = src_graph.query("MATCH (a:A) WHERE a.v >= 1000 OR a.s = 'updated' RETURN count(a)")
+        self.env.assertEqual(res.result_set[0][0], 0)
+
+        res = src_graph.query("MATCH ()-[e:R {v:-1}]->() RETURN count(e) > 0")
+        self.env.assertTrue(res.result_set[0][0])
+
+        res = src_graph.query("MATCH (a:A {v:-1}) RETURN count(a)")
+        self.env.assertEqual(res.result_set[0][0], 0)
+
+        # clean up
+        src_graph.delete()
+        copy_graph.delete()
+
     def test_08_replicated_copy(self):
         # skip test if we're running under Valgrind or sanitizer
         if VALGRIND or SANITIZER != "":
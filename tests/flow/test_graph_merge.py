@@ -1,6 +1,7 @@
 import re
 from common import *
 from index_utils import *
+from constraint_utils import *
 
 GRAPH_ID = "merge_1"
 
@@ -636,3 +637,62 @@ class testGraphMergeFlow():
         # ensure that only 11 nodes are created and no crash
         res = self.graph.query("UNWIND range(0, 10) AS i CREATE (:A {id: i}) MERGE (:B {id: i % 10})")
         self.env.assertEquals(res.nodes_created, 11)
+
+    def test34_batched_merge_unique_constraint(self):
+        # MERGE over a unique constraint resolves input records in bulk
+        # via the constraint's hash index
+        create_unique_node_constraint(self.graph, 'U', 'id', sync=True)
+
+        # first pass creates all nodes, duplicates within the batch
+        # should only be created once
+        query = """UNWIND range(0, 999) AS i
+                   MERGE (u:U {id: i % 500})
+                   ON CREATE SET u.created = true
+                   ON MATCH SET u.matched = true"""
+        res = self.graph.query(query)
+        self.env.assertEquals(res.nodes_created, 500)
+
+        # second pass matches all nodes, floats match integers
+        query = """UNWIND range(0, 999) AS i
+                   MERGE (u:U {id: toFloat(i)})
+                   ON MATCH SET u.matched = true
+                   RETURN count(u)"""
+        res = self.graph.query(query)
+        self.env.assertEquals(res.nodes_created, 500)
+        self.env.assertEquals(res.result_set[0][0], 1000)
+
+        res = self.graph.query("MATCH (u:U {matched: true}) RETURN count(u)")
+        self.env.assertEquals(res.result_set[0][0], 500)
+
+        # additional pattern attributes must match as well
+        query = """UNWIND range(0, 9) AS i
+                   MERGE (u:U {id: i, created: true})
+                   RETURN count(u)"""
+        res = self.graph.query(query)
+        self.env.assertEquals(res.nodes_created, 0)
+        self.env.assertEquals(res.result_set[0][0], 10)
+
+        # NULL values are not matched, MERGE fails on creation
+        try:
+            self.graph.query("UNWIND [1, NULL] AS i MERGE (u:U {id: i})")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("null property", str(e))
+
+    def test35_merge_unique_constraint_order(self):
+        # records resolved via the constraint's hash index and records
+        # falling back to the match stream are emitted in the same order
+        # as they would be without a constraint
+        create_unique_node_constraint(self.graph, 'V', 'id', sync=True)
+
+        data = "CREATE (:{0} {{id: 0}}), (:{0} {{id: [1]}}), (:{0} {{id: 2}})"
+        self.graph.query(data.format('V'))
+        self.graph.query(data.format('W'))
+
+        query = """UNWIND [0, [1], 5, 2, [1], [7], 0, 5] AS i
+                   MERGE (v:{0} {{id: i}})
+                   RETURN v.id"""
+        expected = self.graph.query(query.format('W'))
+        actual = self.graph.query(query.format('V'))
+        self.env.assertEquals(actual.nodes_created, expected.nodes_created)
+        self.env.assertEquals(actual.result_set, expected.result_set)
@@ -0,0 +1,184 @@
+from common import *
+from graph_utils import graph_eq
+from falkordb.asyncio import FalkorDB
+from redis.asyncio import BlockingConnectionPool
+import asyncio
+
+GRAPH_ID = "group_commit"
+SLOW_WRITE = "UNWIND range(0, 500000) AS x WITH x WHERE x = 0 CREATE (:S)"
+
+
+class testGroupCommit():
+    def __init__(self):
+        self.env, self.db = Env(env='oss', useSlaves=True)
+        self.master = self.env.getConnection()
+        self.replica = self.env.getSlaveConnection()
+        self.master_graph = Graph(self.master, GRAPH_ID)
+        self.replica_graph = Graph(self.replica, GRAPH_ID)
+
+    def concurrent_writes(self, queries):
+        async def run(self):
+            pool = BlockingConnectionPool(max_connections=len(queries),
+                                          timeout=None, port=self.env.port,
+                                          decode_responses=True)
+            db = FalkorDB(connection_pool=pool)
+            g = db.select_graph(GRAPH_ID)
+
+            # the first write occupies the writer while the rest queue up
+            # behind it, queued writes are executed as a group
+            async def write(q):
+                try:
+                    return await g.query(q)
+                except Exception as e:
+                    return e
+
+            tasks = [asyncio.create_task(write(q)) for q in queries]
+            results = await asyncio.gather(*tasks)
+
+            await pool.aclose()
+            return results
+
+        return asyncio.run(run(self))
+
+    def test01_concurrent_writes(self):
+        n = 64
+        queries = [SLOW_WRITE] + \
+                  [f"CREATE (:N {{v: {i}}})" for i in range(n)]
+
+        results = self.concurrent_writes(queries)
+
+        # each client receives its own result
+        for res in results:
+            self.env.assertEquals(res.nodes_created, 1)
+
+        q = "MATCH (n:N) RETURN count(n), sum(n.v)"
+        res = self.master_graph.query(q).result_set
+        self.env.assertEquals(res[0], [n, n * (n - 1) // 2])
+
+        # replica applies the group's effects
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
+
+    def test02_concurrent_writes_with_errors(self):
+        self.master_graph.query("CREATE (:E {v: 0})")
+
+        n = 32
+        queries = [SLOW_WRITE]
+        for i in range(n):
+            if i % 2 == 0:
+                queries.append("MATCH (e:E) SET e.v = e.v + 1")
+            else:
+                # fails at runtime, its modifications are rolled back
+                queries.append("MATCH (e:E) SET e.v = e.v + 100 "
+                               "WITH e RETURN 1 / 0")
+
+        results = self.concurrent_writes(queries)
+
+        for i, res in enumerate(results[1:]):
+            if i % 2 == 0:
+                self.env.assertEquals(res.properties_set, 1)
+            else:
+                self.env.assertTrue(isinstance(res, Exception))
+
+        # only the successful writes are committed
+        res = self.master_graph.query("MATCH (e:E) RETURN e.v").result_set
+        self.env.assertEquals(res[0][0], n // 2)
+
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
+
+    def test03_concurrent_writes_multiple_graphs(self):
+        # writes to several graphs interleaved in the writer's queue
+        graphs = [GRAPH_ID, GRAPH_ID + "_a", GRAPH_ID + "_b"]
+
+        async def run(self):
+            pool = BlockingConnectionPool(max_connections=64, timeout=None,
+                                          port=self.env.port,
+                                          decode_responses=True)
+            db = FalkorDB(connection_pool=pool)
+
+            tasks = [asyncio.create_task(
+                db.select_graph(GRAPH_ID).query(SLOW_WRITE))]
+            for i in range(60):
+                g = db.select_graph(graphs[i % 3])
+                tasks.append(asyncio.create_task(
+                    g.query(f"CREATE (:M {{v: {i}}})")))
+
+            await asyncio.gather(*tasks)
+            await pool.aclose()
+
+        asyncio.run(run(self))
+
+        for name in graphs:
+            g = Graph(self.master, name)
+            res = g.query("MATCH (m:M) RETURN count(m)").result_set
+            self.env.assertEquals(res[0][0], 20)
+
+        self.master.wait(1, 0)
+        for name in graphs:
+            self.env.assertTrue(graph_eq(Graph(self.master, name),
+                                         Graph(self.replica, name)))
+
+    def test04_effects_threshold(self):
+        # EFFECTS_THRESHOLD is honoured per query within a group
+        # fast queries are replicated verbatim, slow ones as effects
+        # both in commit order
+        self.env.getConnection().execute_command("GRAPH.CONFIG", "SET",
+                                                 "EFFECTS_THRESHOLD", 5)
+
+        n = 32
+        queries = [SLOW_WRITE]
+        for i in range(n):
+            if i % 2 == 0:
+                queries.append(f"CREATE (:T {{v: {i}}})")
+            else:
+                queries.append(f"UNWIND range(0, 200000) AS x "
+                               f"WITH x WHERE x = 0 CREATE (:T {{v: {i}}})")
+
+        results = self.concurrent_writes(queries)
+        for res in results:
+            self.env.assertEquals(res.nodes_created, 1)
+
+        q = "MATCH (t:T) RETURN count(t), sum(t.v)"
+        res = self.master_graph.query(q).result_set
+        self.env.assertEquals(res[0], [n, n * (n - 1) // 2])
+
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
+
+        self.env.getConnection().execute_command("GRAPH.CONFIG", "SET",
+                                                 "EFFECTS_THRESHOLD", 300)
+
+    def test05_group_commit_max(self):
+        conn = self.env.getConnection()
+        res = conn.execute_command("GRAPH.CONFIG", "GET", "GROUP_COMMIT_MAX")
+        self.env.assertEquals(res[1], 32)
+
+        for v in [0, -1, 1025]:
+            try:
+                conn.execute_command("GRAPH.CONFIG", "SET",
+                                     "GROUP_COMMIT_MAX", v)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError:
+                pass
+
+        # a group of a single write disables group commit
+        for max_group in [1, 4]:
+            conn.execute_command("GRAPH.CONFIG", "SET", "GROUP_COMMIT_MAX",
+                                 max_group)
+
+            n = 16
+            queries = [SLOW_WRITE] + \
+                      [f"CREATE (:G{max_group} {{v: {i}}})" for i in range(n)]
+            results = self.concurrent_writes(queries)
+            for res in results:
+                self.env.assertEquals(res.nodes_created, 1)
+
+            q = f"MATCH (g:G{max_group}) RETURN count(g)"
+            res = self.master_graph.query(q).result_set
+            self.env.assertEquals(res[0][0], n)
+
+        conn.execute_command("GRAPH.CONFIG", "SET", "GROUP_COMMIT_MAX", 32)
+
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
@@ -0,0 +1,61 @@
+from common import *
+
+GRAPH_ID = "inline_queries"
+
+
+class testInlineQueries():
+    def __init__(self):
+        self.env, self.db = Env()
+        self.conn = self.env.getConnection()
+        self.graph = self.db.select_graph(GRAPH_ID)
+        self.graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+
+    def test01_inline_threshold_config(self):
+        # inline execution is disabled by default
+        threshold = self.db.config_get("INLINE_QUERY_THRESHOLD")
+        self.env.assertEquals(threshold, 0)
+
+        self.db.config_set("INLINE_QUERY_THRESHOLD", 100)
+        self.env.assertEquals(self.db.config_get("INLINE_QUERY_THRESHOLD"), 100)
+
+        try:
+            self.db.config_set("INLINE_QUERY_THRESHOLD", -1)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError:
+            pass
+
+        # keep inline execution enabled for the following tests
+        self.env.assertEquals(self.db.config_get("INLINE_QUERY_THRESHOLD"), 100)
+
+    def test02_cheap_read_results(self):
+        # repeated point lookups qualify for inline execution
+        q = "MATCH (n:N) WHERE ID(n) = $id RETURN n.v"
+        for i in range(20):
+            res = self.graph.ro_query(q, {'id': i % 10}).result_set
+            self.env.assertEquals(res[0][0], i % 10)
+
+        # inline executions observe writes
+        self.graph.query("MATCH (n:N) WHERE ID(n) = 0 SET n.v = 100")
+        res = self.graph.ro_query(q, {'id': 0}).result_set
+        self.env.assertEquals(res[0][0], 100)
+
+        # compact and verbose replies
+        res = self.conn.execute_command("GRAPH.RO_QUERY", GRAPH_ID,
+                                        "CYPHER id=1 " + q, "--compact")
+        self.env.assertEquals(res[1][0][0], [3, 1])
+
+    def test03_cheap_read_errors(self):
+        # a query failing at runtime reports its error when executed inline
+        q = "MATCH (n:N) WHERE ID(n) = 1 RETURN toInteger(n.v) / $d"
+        for i in range(5):
+            self.graph.ro_query(q, {'d': 1})
+
+        try:
+            self.graph.ro_query(q, {'d': 'a'})
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Type mismatch", str(e))
+
+        # subsequent executions are unaffected
+        res = self.graph.ro_query(q, {'d': 1}).result_set
+        self.env.assertEquals(res[0][0], 1)
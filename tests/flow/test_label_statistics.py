@@ -0,0 +1,63 @@
+from common import *
+from index_utils import *
+
+GRAPH_ID = "label_statistics"
+
+
+class testLabelStatistics():
+    def __init__(self):
+        self.env, self.db = Env()
+        self.graph = self.db.select_graph(GRAPH_ID)
+
+    def tearDown(self):
+        self.graph.delete()
+
+    # traversal entry point is the label with fewer nodes
+    def test01_traversal_entry_point(self):
+        self.graph.query("UNWIND range(0, 99) AS x CREATE (:A)-[:R]->(:C)")
+        self.graph.query("UNWIND range(0, 4) AS x CREATE (:A)-[:R]->(:D)")
+
+        plan = str(self.graph.explain("MATCH (a:A)-[:R]->(d:D) RETURN a"))
+        self.env.assertIn("Node By Label Scan | (d:D)", plan)
+
+        plan = str(self.graph.explain("MATCH (d:D)<-[:R]-(a:A) RETURN a"))
+        self.env.assertIn("Node By Label Scan | (d:D)", plan)
+
+    # index scan is performed over the label with the fewest matching nodes
+    # once the labels had been sampled
+    def test02_index_label_selectivity(self):
+        # every A node shares the same value, every B node holds a unique one
+        # B has more nodes but filtering B is more restrictive
+        self.graph.query("UNWIND range(0, 99) AS x CREATE (:A {v: 1})")
+        self.graph.query("UNWIND range(0, 199) AS x CREATE (:B {v: x})")
+        create_node_range_index(self.graph, 'A', 'v')
+        create_node_range_index(self.graph, 'B', 'v', sync=True)
+
+        # labels are sampled periodically in the background
+        # use a distinct alias on each attempt to bypass the plan cache
+        plan = None
+        for i in range(50):
+            q = f"MATCH (n{i}:A:B) WHERE n{i}.v = 5 RETURN n{i}"
+            plan = str(self.graph.explain(q))
+            if f"Node By Index Scan | (n{i}:B)" in plan:
+                break
+            time.sleep(0.2)
+
+        self.env.assertIn(f"Node By Index Scan | (n{i}:B)", plan)
+
+    # multi hop traversal starts at its cheapest end
+    # although the opposite end is filtered
+    def test03_cost_based_arrangement(self):
+        self.graph.query("""UNWIND range(0, 299) AS x
+                            CREATE (:A {v: x})-[:R1]->(:B)-[:R2]->(:C)""")
+        self.graph.query("""MATCH (c:C) WITH c LIMIT 1
+                            CREATE (c)-[:R3]->(:D)""")
+
+        q = """MATCH (a:A)-[:R1]->(b:B)-[:R2]->(c:C)-[:R3]->(d:D)
+               WHERE a.v >= 0
+               RETURN count(a)"""
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Node By Label Scan | (d:D)", plan)
+
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res[0][0], 1)
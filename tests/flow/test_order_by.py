@@ -60,3 +60,45 @@ class testOrderBy(FlowTestsBase):
         # assert the order of the results
         self.env.assertEquals(res.result_set[0][0], Node(labels='N', properties={'v': 1}))
         self.env.assertEquals(res.result_set[1][0], Node(labels='N', properties={'v': 2}))
+
+    def test03_normalized_keys(self):
+        """Tests ORDER BY on values whose sort keys don't fully represent them"""
+
+        # strings sharing long prefixes, large integers and mixed numerics
+        q = """UNWIND ['abcdefghij', 'abcdefgh', 'abcdefghi', 'abc', 'b', null,
+                       'abcdefghia'] AS s
+               RETURN s ORDER BY s"""
+        res = self.graph.query(q)
+        expected = [['abc'], ['abcdefgh'], ['abcdefghi'], ['abcdefghia'],
+                    ['abcdefghij'], ['b'], [None]]
+        self.env.assertEquals(res.result_set, expected)
+
+        q = """UNWIND [9007199254740993, 9007199254740992, -1, 2.5, 0, -0.5,
+                       9007199254740995] AS x
+               RETURN x ORDER BY x DESC"""
+        res = self.graph.query(q)
+        expected = [[9007199254740995], [9007199254740993], [9007199254740992],
+                    [2.5], [0], [-0.5], [-1]]
+        self.env.assertEquals(res.result_set, expected)
+
+        q = """UNWIND range(1, 20) AS x
+               RETURN x % 3 AS a, toString(x % 4) + 'xxxxxxxxxx' AS b, x
+               ORDER BY a DESC, b ASC, x DESC"""
+        res = self.graph.query(q)
+        rows = [[x % 3, str(x % 4) + 'xxxxxxxxxx', x] for x in range(1, 21)]
+        rows.sort(key=lambda r: r[2], reverse=True)
+        rows.sort(key=lambda r: r[1])
+        rows.sort(key=lambda r: r[0], reverse=True)
+        self.env.assertEquals(res.result_set, rows)
+
+    def test04_large_sort(self):
+        """Tests ORDER BY over enough records to sort in parallel"""
+
+        q = """UNWIND range(0, 1199999) AS x
+               WITH toString((x * 7919) % 1200007) AS s
+               ORDER BY s
+               WITH collect(s) AS l
+               RETURN size(l),
+                      all(i IN range(1, size(l) - 1) WHERE l[i - 1] <= l[i])"""
+        res = self.graph.query(q)
+        self.env.assertEquals(res.result_set, [[1200000, True]])
@@ -0,0 +1,98 @@
+from common import *
+from index_utils import *
+
+GRAPH_ID = "planner_hints"
+
+
+class testPlannerHints():
+    def __init__(self):
+        self.env, self.db = Env()
+        self.graph = self.db.select_graph(GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # A is small, C is large
+        self.graph.query("""UNWIND range(0, 4) AS x
+                            CREATE (:A:X {v: x})-[:R]->(:B {v: x})-[:R]->(:C:X {v: x})""")
+        self.graph.query("""UNWIND range(5, 199) AS x
+                            CREATE (:B {v: x})-[:R]->(:C:X {v: x})""")
+        create_node_range_index(self.graph, 'C', 'v', sync=True)
+
+    def expect_error(self, q, msg):
+        try:
+            self.graph.query(q)
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn(msg, str(e))
+
+    def test01_scan_hint(self):
+        # without a hint the traversal starts at the smaller label
+        q = "MATCH (a:A)-[:R]->(b:B)-[:R]->(c:C) RETURN count(c)"
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Node By Label Scan | (a:A)", plan)
+
+        q = "MATCH (a:A)-[:R]->(b:B)-[:R]->(c:C) USING SCAN c:C RETURN count(c)"
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Node By Label Scan | (c:C)", plan)
+        self.env.assertEquals(self.graph.query(q).result_set[0][0], 5)
+
+        # scanned label of a multi labeled node
+        q = "MATCH (c:X:C) USING SCAN c:X RETURN count(c)"
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Node By Label Scan | (c:X)", plan)
+        self.env.assertEquals(self.graph.query(q).result_set[0][0], 200)
+
+        # scan hint prevents index utilization
+        q = "MATCH (c:C) USING SCAN c:C WHERE c.v = 3 RETURN c.v"
+        plan = str(self.graph.explain(q))
+        self.env.assertNotIn("Index Scan", plan)
+        self.env.assertEquals(self.graph.query(q).result_set, [[3]])
+
+    def test02_index_hint(self):
+        q = """MATCH (a:A)-[:R]->(b:B)-[:R]->(c:C)
+               USING INDEX c:C(v)
+               WHERE c.v = 2
+               RETURN a.v"""
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Node By Index Scan | (c:C)", plan)
+        self.env.assertEquals(self.graph.query(q).result_set, [[2]])
+
+        # hinted attribute isn't filtered
+        q = "MATCH (c:C) USING INDEX c:C(v) RETURN count(c)"
+        self.expect_error(q, "Cannot use index hint on 'c'")
+
+        # hinted attribute isn't indexed
+        q = "MATCH (a:A) USING INDEX a:A(v) WHERE a.v = 1 RETURN a"
+        self.expect_error(q, "no index on :A(v)")
+
+    def test03_join_hint(self):
+        q = """MATCH (a:A)-[:R]->(b:B)-[:R]->(c:C)
+               USING JOIN ON b
+               RETURN a.v, c.v ORDER BY a.v"""
+        plan = str(self.graph.explain(q))
+        self.env.assertIn("Value Hash Join", plan)
+
+        res = self.graph.query(q).result_set
+        self.env.assertEquals(res, [[x, x] for x in range(5)])
+
+        # the hinted node must split its pattern
+        q = "MATCH (a:A)-[:R]->(b:B) USING JOIN ON a RETURN a"
+        self.expect_error(q, "Cannot use join hint on 'a'")
+
+        # joined parts can't start at a bound node
+        q = """MATCH (b:B) WITH b LIMIT 1
+               MATCH (a:A)-[:R]->(b)-[:R]->(c:C) USING JOIN ON b
+               RETURN a"""
+        self.expect_error(q, "Cannot use join hint on 'b'")
+
+    def test04_invalid_hints(self):
+        q = "MATCH (a:A) USING SCAN z:A RETURN a"
+        self.expect_error(q, "it isn't a node of its MATCH pattern")
+
+        q = "MATCH (a:A) USING SCAN a:B RETURN a"
+        self.expect_error(q, "it isn't labeled :B in its MATCH pattern")
+
+        q = """MATCH (a:A)-[:R]->(b:B)
+               USING SCAN a:A USING SCAN b:B
+               RETURN a"""
+        self.expect_error(q, "Cannot honor hints on both")
@@ -0,0 +1,152 @@
+from common import *
+from graph_utils import graph_eq
+import threading
+import time
+
+GRAPH_ID = "query_batch"
+
+
+class testQueryBatch():
+    def __init__(self):
+        self.env, self.db = Env(env='oss', useSlaves=True)
+        self.master = self.env.getConnection()
+        self.replica = self.env.getSlaveConnection()
+        self.master_graph = Graph(self.master, GRAPH_ID)
+        self.replica_graph = Graph(self.replica, GRAPH_ID)
+
+    def batch(self, *args):
+        return self.master.execute_command("GRAPH.QUERY_BATCH", GRAPH_ID,
+                                           *args)
+
+    def node_count(self):
+        q = "MATCH (n:N) RETURN count(n)"
+        return self.master_graph.query(q).result_set[0][0]
+
+    def test01_batch_writes(self):
+        q = "CREATE (:N {v: $v})"
+        res = self.batch(q, "v=1", q, "v=2", q, "v=3")
+
+        # a result-set per query
+        self.env.assertEquals(len(res), 3)
+        for r in res:
+            self.env.assertIn("Nodes created: 1", r[-1])
+
+        self.env.assertEquals(self.node_count(), 3)
+
+        # replica applies the batch's effects
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
+
+    def test02_batch_reads(self):
+        # queries without parameters and read queries
+        res = self.batch("CREATE (:N {v: 4})", "",
+                         "MATCH (n:N) RETURN max(n.v)", "",
+                         "MATCH (n:N) WHERE n.v = $v RETURN n.v", "v=2")
+
+        self.env.assertEquals(len(res), 3)
+
+        # reads observe the batch's earlier writes
+        self.env.assertEquals(res[1][1][0][0], 4)
+        self.env.assertEquals(res[2][1][0][0], 2)
+
+    def test03_batch_errors(self):
+        before = self.node_count()
+
+        # a failing query is rolled back, the rest of the batch commits
+        res = self.batch("CREATE (:N {v: 5})", "",
+                         "CREATE (n:N {v: 6}) RETURN 1 / $d", "d=0",
+                         "MATCH (n:N {v: 5}) SET n.v = 7", "",
+                         "RETURN $x", "x=[1, 2",
+                         "CREATE (:N {v: 8})", "")
+
+        self.env.assertEquals(len(res), 5)
+        self.env.assertIn("Nodes created: 1", res[0][-1])
+        self.env.assertTrue(isinstance(res[1], redis.exceptions.ResponseError))
+        self.env.assertIn("Properties set: 1", res[2][-1])
+        self.env.assertTrue(isinstance(res[3], redis.exceptions.ResponseError))
+        self.env.assertIn("Nodes created: 1", res[4][-1])
+
+        self.env.assertEquals(self.node_count(), before + 2)
+
+        q = "MATCH (n:N) WHERE n.v IN [5, 6, 7, 8] RETURN n.v ORDER BY n.v"
+        res = self.master_graph.query(q).result_set
+        self.env.assertEquals(res, [[7], [8]])
+
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
+
+    def test04_compact(self):
+        res = self.batch("RETURN $v", "v=1", "RETURN 'a'", "", "--compact")
+        self.env.assertEquals(len(res), 2)
+        self.env.assertEquals(res[0][1][0][0], [3, 1])
+        self.env.assertEquals(res[1][1][0][0], [2, 'a'])
+
+    def test05_invalid_arity(self):
+        for args in [[], ["RETURN 1"], ["RETURN 1", "", "RETURN 2"],
+                     ["--compact"]]:
+            try:
+                self.batch(*args)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("wrong number of arguments", str(e))
+
+    def test06_batch_within_multi(self):
+        # batches issued within a MULTI block run on the main thread
+        pipe = self.master.pipeline(transaction=True)
+        pipe.execute_command("GRAPH.QUERY_BATCH", GRAPH_ID,
+                             "CREATE (:M {v: $v})", "v=1",
+                             "CREATE (:M {v: $v})", "v=2")
+        pipe.execute_command("GRAPH.QUERY", GRAPH_ID,
+                             "MATCH (m:M) RETURN count(m)")
+        batch, count = pipe.execute()
+
+        self.env.assertEquals(len(batch), 2)
+        self.env.assertEquals(count[1][0][0], 2)
+
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
+
+    def test07_batch_releases_gil(self):
+        # a running batch holds the graph's write lock but not the GIL
+        # commands against other keys are served while it executes
+        slow = "UNWIND range(0, 5000000) AS x WITH x WHERE x = 0 CREATE (:S)"
+        t = threading.Thread(target=self.batch,
+                             args=(slow, "", slow, "", slow, ""))
+        t.start()
+
+        conn = self.env.getConnection()
+        for i in range(10):
+            conn.set("batch_key", i)
+        self.env.assertEquals(conn.get("batch_key"), "9")
+        self.env.assertTrue(t.is_alive())
+
+        t.join()
+        self.master.wait(1, 0)
+        self.env.assertTrue(graph_eq(self.master_graph, self.replica_graph))
+
+    def test08_delete_graph_mid_batch(self):
+        # deleting the graph while a batch executes fails the batch's
+        # remaining writes instead of reporting them as committed
+        slow = "UNWIND range(0, 2000000) AS x WITH x WHERE x = 0 CREATE (:S)"
+        res = []
+        t = threading.Thread(target=lambda: res.extend(
+            self.batch(*([slow, ""] * 5))))
+        t.start()
+
+        conn = self.env.getConnection()
+        time.sleep(0.3)
+        self.env.assertTrue(t.is_alive())
+        conn.delete(GRAPH_ID)
+
+        t.join()
+        self.env.assertEquals(len(res), 5)
+
+        # once a write fails all subsequent writes fail
+        failed = [isinstance(r, redis.exceptions.ResponseError) for r in res]
+        self.env.assertTrue(failed[-1])
+        self.env.assertEquals(failed, sorted(failed))
+
+        # the graph is gone on both master and replica
+        self.master.wait(1, 0)
+        self.env.assertEquals(self.master.exists(GRAPH_ID), 0)
+        self.env.assertEquals(self.replica.exists(GRAPH_ID), 0)
@@ -18,6 +18,9 @@ from redis.asyncio import BlockingConnectionPool
 # 5. test a mixture of queries, ~90% successful ones and the rest are expected
 #    to fail due to out of memory error
 
+# 6. test a query computing a string per row, whose strings exceed the limit
+#    combined but not individually, expecting no errors
+
 GRAPH_ID          = "max_query_mem"
 MEM_HOG_QUERY     = """UNWIND range(0, 100000) AS x RETURN x, count(x)"""
 MEM_THRIFTY_QUERY = """RETURN 1"""
@@ -128,3 +131,20 @@ class testQueryMemoryLimit():
 
         self.stress_server(queries)
 
+
+    def test_06_per_row_strings_within_limit(self):
+        # strings computed per row aren't retained for the query's lifetime
+        limit = 16*1024*1024
+        self.db.config_set("QUERY_MEM_CAPACITY", limit)
+
+        prefix = 'a' * 120
+        q = f"""UNWIND range(0, 199999) AS x
+               WITH left('{prefix}' + toString(x), 100) AS s
+               WHERE s STARTS WITH 'a'
+               RETURN count(s)"""
+
+        g = self.db.select_graph(GRAPH_ID)
+        res = g.query(q).result_set
+        self.env.assertEquals(res[0][0], 200000)
+
+        self.db.config_set("QUERY_MEM_CAPACITY", 0)
@@ -0,0 +1,61 @@
+from common import *
+
+GRAPH_ID = "query_priority"
+
+
+class testQueryPriority():
+    def __init__(self):
+        self.env, self.db = Env()
+        self.conn = self.env.getConnection()
+        self.graph = self.db.select_graph(GRAPH_ID)
+        self.graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+
+    def query(self, q, *args):
+        return self.conn.execute_command("GRAPH.QUERY", GRAPH_ID, q, *args)
+
+    def test01_priority_argument(self):
+        q = "MATCH (n:N) RETURN count(n)"
+        for priority in ["HIGH", "normal", "Low"]:
+            res = self.query(q, "PRIORITY", priority)
+            self.env.assertEquals(res[1][0][0], 10)
+
+        # priority combined with other flags
+        res = self.query(q, "--compact", "TIMEOUT", 1000, "PRIORITY", "HIGH")
+        self.env.assertEquals(len(res[1]), 1)
+
+        # read only queries accept a priority as well
+        res = self.conn.execute_command("GRAPH.RO_QUERY", GRAPH_ID, q,
+                                        "PRIORITY", "LOW")
+        self.env.assertEquals(res[1][0][0], 10)
+
+    def test02_invalid_priority(self):
+        q = "MATCH (n:N) RETURN count(n)"
+        for args in [["PRIORITY", "URGENT"], ["PRIORITY"]]:
+            try:
+                self.query(q, *args)
+                self.env.assertTrue(False)
+            except redis.exceptions.ResponseError as e:
+                self.env.assertIn("Failed to parse query priority", str(e))
+
+    def test03_queue_wait_info(self):
+        q = "MATCH (n:N) RETURN count(n)"
+        for i in range(10):
+            self.query(q, "PRIORITY", "HIGH")
+
+        res = self.conn.execute_command("GRAPH.INFO", "QueueWait")
+        self.env.assertEquals(res[0], "# Queue wait")
+
+        classes = res[1]
+        self.env.assertEquals(len(classes), 3)
+        self.env.assertEquals([c[1] for c in classes], ["HIGH", "NORMAL", "LOW"])
+
+        for c in classes:
+            self.env.assertEquals(c[0], "Priority")
+            self.env.assertEquals(c[2], "Queued queries")
+            self.env.assertEquals(c[4], "Wait p50")
+            self.env.assertEquals(c[6], "Wait p95")
+            self.env.assertEquals(c[8], "Wait p99")
+            self.env.assertGreaterEqual(float(c[9]), float(c[5]))
+
+        high = classes[0]
+        self.env.assertGreaterEqual(high[3], 10)
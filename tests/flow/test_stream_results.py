@@ -0,0 +1,71 @@
+from common import *
+
+GRAPH_ID = "stream_results"
+
+
+class testStreamResults(FlowTestsBase):
+    def __init__(self):
+        self.env, self.db = Env()
+        self.conn = self.env.getConnection()
+        self.graph = self.db.select_graph(GRAPH_ID)
+        self.graph.query("UNWIND range(0, 999) AS x CREATE (:N {v: x})")
+        self.db.config_set("STREAM_RESULTS", "yes")
+
+    def test01_streamed_rows(self):
+        # rows are emitted as they're produced, content must not change
+        res = self.graph.query("MATCH (n:N) RETURN n.v ORDER BY n.v")
+        self.env.assertEquals(res.result_set, [[i] for i in range(1000)])
+
+        res = self.graph.ro_query("MATCH (n:N) WHERE n.v < 3 RETURN n ORDER BY n.v")
+        self.env.assertEquals(len(res.result_set), 3)
+        self.env.assertEquals(res.result_set[2][0].properties['v'], 2)
+
+        # empty result-set
+        res = self.graph.query("MATCH (n:N) WHERE n.v < 0 RETURN n")
+        self.env.assertEquals(res.result_set, [])
+
+    def test02_verbose_reply_structure(self):
+        # verbose reply: header, rows, statistics
+        res = self.conn.execute_command("GRAPH.QUERY", GRAPH_ID,
+                "UNWIND range(1, 5) AS x RETURN x")
+        self.env.assertEquals(len(res), 3)
+        self.env.assertEquals(res[0], ['x'])
+        self.env.assertEquals(res[1], [[1], [2], [3], [4], [5]])
+
+    def test03_write_queries_are_not_streamed(self):
+        # write queries are buffered, a failing write emits only the error
+        try:
+            self.graph.query("UNWIND [1, 0] AS x CREATE (:M {v: 1 / x}) RETURN x")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Division by zero", str(e))
+
+        res = self.graph.query("MATCH (m:M) RETURN count(m)")
+        self.env.assertEquals(res.result_set[0][0], 0)
+
+    def test04_error_after_rows(self):
+        # an error raised after rows were emitted
+        # is reported as the last element of the reply
+        res = self.conn.execute_command("GRAPH.QUERY", GRAPH_ID,
+                "UNWIND [1, 0] AS x RETURN 1 / x")
+        self.env.assertEquals(len(res), 3)
+        self.env.assertEquals(res[1], [[1]])
+        self.env.assertTrue(isinstance(res[2], ResponseError))
+        self.env.assertIn("Division by zero", str(res[2]))
+
+        # an error raised before any row was emitted is the only reply
+        try:
+            self.graph.query("UNWIND [0, 1] AS x RETURN 1 / x")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Division by zero", str(e))
+
+    def test05_disable_streaming(self):
+        self.db.config_set("STREAM_RESULTS", "no")
+
+        # once disabled, a run-time error is the only reply
+        try:
+            self.graph.query("UNWIND [1, 0] AS x RETURN 1 / x")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Division by zero", str(e))
@@ -0,0 +1,139 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/arena.h"
+#include "src/util/rmalloc.h"
+
+#include <string.h>
+#include <stdint.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+void test_arenaAlignment() {
+	Arena *arena = Arena_New(1024, 0);
+	TEST_ASSERT(Arena_Size(arena) == 0);
+
+	// odd sized allocations are 8 bytes aligned
+	for(size_t i = 1; i < 100; i++) {
+		void *p = Arena_Alloc(arena, i);
+		TEST_ASSERT(p != NULL);
+		TEST_ASSERT(((uintptr_t)p & 7) == 0);
+		memset(p, 0xAB, i);
+	}
+
+	Arena_Free(&arena);
+	TEST_ASSERT(arena == NULL);
+}
+
+void test_arenaBlocks() {
+	size_t block_size = 1024;
+	Arena *arena = Arena_New(block_size, 0);
+
+	// allocations spanning multiple blocks don't overlap
+	int n = 1000;
+	uint64_t *ptrs[1000];
+	for(int i = 0; i < n; i++) {
+		ptrs[i] = Arena_Alloc(arena, sizeof(uint64_t) * 4);
+		for(int j = 0; j < 4; j++) ptrs[i][j] = i;
+	}
+
+	for(int i = 0; i < n; i++) {
+		for(int j = 0; j < 4; j++) TEST_ASSERT(ptrs[i][j] == i);
+	}
+
+	// 32 allocations of 32 bytes fit in a block
+	TEST_ASSERT(Arena_Size(arena) == block_size * (n / 32 + 1));
+
+	Arena_Free(&arena);
+}
+
+void test_arenaLargeAlloc() {
+	size_t block_size = 1024;
+	Arena *arena = Arena_New(block_size, 0);
+
+	char *small = Arena_Alloc(arena, 8);
+	TEST_ASSERT(Arena_Size(arena) == block_size);
+
+	// large allocation gets a block of its own
+	char *large = Arena_Alloc(arena, block_size * 4);
+	memset(large, 1, block_size * 4);
+	TEST_ASSERT(Arena_Size(arena) == block_size * 5);
+
+	// the current block keeps serving small allocations
+	char *next = Arena_Alloc(arena, 8);
+	TEST_ASSERT(next == small + 8);
+	TEST_ASSERT(Arena_Size(arena) == block_size * 5);
+
+	Arena_Free(&arena);
+
+	// large allocation on an empty arena
+	arena = Arena_New(block_size, 0);
+	large = Arena_Alloc(arena, block_size);
+	TEST_ASSERT(Arena_Size(arena) == block_size);
+	small = Arena_Alloc(arena, 8);
+	TEST_ASSERT(Arena_Size(arena) == block_size * 2);
+
+	Arena_Free(&arena);
+}
+
+void test_arenaCapacity() {
+	size_t block_size = 1024;
+	Arena *arena = Arena_New(block_size, block_size * 2);
+
+	// two blocks worth of allocations
+	for(int i = 0; i < 64; i++) {
+		TEST_ASSERT(Arena_Alloc(arena, 32) != NULL);
+	}
+	TEST_ASSERT(Arena_Size(arena) == block_size * 2);
+
+	// arena is exhausted
+	TEST_ASSERT(Arena_Alloc(arena, 8) == NULL);
+	TEST_ASSERT(Arena_Alloc(arena, block_size * 4) == NULL);
+	TEST_ASSERT(Arena_Size(arena) == block_size * 2);
+
+	Arena_Free(&arena);
+
+	// large allocations count towards the capacity
+	arena = Arena_New(block_size, block_size * 2);
+	TEST_ASSERT(Arena_Alloc(arena, block_size * 3) == NULL);
+	TEST_ASSERT(Arena_Alloc(arena, block_size) != NULL);
+	TEST_ASSERT(Arena_Alloc(arena, block_size) != NULL);
+	TEST_ASSERT(Arena_Alloc(arena, block_size) == NULL);
+	TEST_ASSERT(Arena_Size(arena) == block_size * 2);
+
+	Arena_Free(&arena);
+}
+
+void test_arenaActive() {
+	TEST_ASSERT(Arena_GetActive() == NULL);
+
+	Arena *a = Arena_New(1024, 0);
+	Arena *b = Arena_New(1024, 0);
+
+	Arena_SetActive(a);
+	TEST_ASSERT(Arena_GetActive() == a);
+
+	// freeing an inactive arena leaves the active arena as is
+	Arena_Free(&b);
+	TEST_ASSERT(Arena_GetActive() == a);
+
+	// freeing the active arena deactivates it
+	Arena_Free(&a);
+	TEST_ASSERT(Arena_GetActive() == NULL);
+}
+
+TEST_LIST = {
+	{"arenaAlignment", test_arenaAlignment},
+	{"arenaBlocks", test_arenaBlocks},
+	{"arenaLargeAlloc", test_arenaLargeAlloc},
+	{"arenaCapacity", test_arenaCapacity},
+	{"arenaActive", test_arenaActive},
+	{NULL, NULL}
+};
@@ -392,6 +392,54 @@ static void test_AbortRunningTask() {
 	_AddTaskData_Free(data);
 }
 
+static void test_cronTimeout() {
+	// issue timeouts X += 2 and X *= 2
+	// abort the multiplication
+	// validate X = 3
+
+	X = 1;
+	int Y = 2;
+	AddTaskData add_task_data = _AddTaskData_New(add_task, (void *)&Y);
+	AddTaskData mul_task_data = _AddTaskData_New(mul_task, (void *)&Y);
+
+	CronTaskHandle add_timeout = Cron_AddTimeout(5, _AddTaskData_Execute,
+			&add_task_data);
+	CronTaskHandle mul_timeout = Cron_AddTimeout(1000, _AddTaskData_Execute,
+			&mul_task_data);
+
+	// abort timeout before it is due
+	TEST_ASSERT(Cron_AbortTimeout(mul_timeout));
+	TEST_ASSERT(!_AddTaskData_HasStarted(mul_task_data));
+
+	_AddTaskData_Wait(add_task_data);
+
+	// abort timeout after it fired
+	TEST_ASSERT(!Cron_AbortTimeout(add_timeout));
+
+	_AddTaskData_Free(add_task_data);
+	_AddTaskData_Free(mul_task_data);
+
+	TEST_ASSERT(X == 3);
+}
+
+static void test_AbortFiringTimeout() {
+	// issue a long running timeout ~100ms
+	// validate call to Cron_AbortTimeout returns after timeout completed
+
+	int ms = 100;
+	AddTaskData data = _AddTaskData_New(long_running_task, (void*)&ms);
+	CronTaskHandle timeout = Cron_AddTimeout(0, _AddTaskData_Execute, &data);
+
+	_AddTaskData_WaitForRunning(data);
+
+	// the timeout should be already firing
+	// abort the timeout, call should return once it completed
+	TEST_ASSERT(!Cron_AbortTimeout(timeout));
+	TEST_ASSERT(_AddTaskData_HasCompleted(data));
+
+	_AddTaskData_Free(data);
+}
+
 TEST_LIST = {
 	{"cronExec", test_cronExec},
 	{"cronAbort", test_cronAbort},
@@ -399,6 +447,8 @@ TEST_LIST = {
 	{"MultiAbort", test_MultiAbort},
 	{"abortNoneExistingTask", test_abortNoneExistingTask},
 	{"AbortRunningTask", test_AbortRunningTask},
+	{"cronTimeout", test_cronTimeout},
+	{"AbortFiringTimeout", test_AbortFiringTimeout},
 	{NULL, NULL}
 };
 
@@ -230,12 +230,59 @@ void test_dataBlockOutOfOrderBuilding() {
 	DataBlockIterator_Free(it);
 }
 
+static void _cloneItem(void *item) {
+	int *i = (int *)item;
+	*i = *i * 2;
+}
+
+void test_dataBlockClone() {
+	DataBlock *dataBlock = DataBlock_New(16, 64, sizeof(int), NULL);
+	uint itemCount = 64;
+
+	// set items
+	for(int i = 0; i < itemCount; i++) {
+		int *item = (int *)DataBlock_AllocateItem(dataBlock, NULL);
+		*item = i;
+	}
+
+	// delete a couple of items
+	DataBlock_DeleteItem(dataBlock, 3);
+	DataBlock_DeleteItem(dataBlock, 40);
+
+	DataBlock *clone = DataBlock_Clone(dataBlock, _cloneItem);
+
+	TEST_ASSERT(clone->itemCount == dataBlock->itemCount);
+	TEST_ASSERT(clone->blockCount == dataBlock->blockCount);
+	TEST_ASSERT(array_len(clone->deletedIdx) == 2);
+	TEST_ASSERT(DataBlock_GetItem(clone, 3) == NULL);
+	TEST_ASSERT(DataBlock_GetItem(clone, 40) == NULL);
+
+	// cloner should have been invoked on each active item of the clone
+	for(int i = 0; i < itemCount; i++) {
+		if(i == 3 || i == 40) continue;
+		int *original = (int *)DataBlock_GetItem(dataBlock, i);
+		int *cloned   = (int *)DataBlock_GetItem(clone, i);
+		TEST_ASSERT(original != cloned);
+		TEST_ASSERT(*original == i);
+		TEST_ASSERT(*cloned == i * 2);
+	}
+
+	// deleted slots are reused by the clone
+	DataBlock_AllocateItem(clone, NULL);
+	TEST_ASSERT(array_len(clone->deletedIdx) == 1);
+	TEST_ASSERT(array_len(dataBlock->deletedIdx) == 2);
+
+	DataBlock_Free(clone);
+	DataBlock_Free(dataBlock);
+}
+
 TEST_LIST = {
 	{"dataBlockNew", test_dataBlockNew},
 	{"dataBlockAddItem", test_dataBlockAddItem },
 	{"dataBlockScan", test_dataBlockScan},
 	{"dataBlockRemoveItem", test_dataBlockRemoveItem},
 	{"dataBlockOutOfOrderBuilding", test_dataBlockOutOfOrderBuilding},
+	{"dataBlockClone", test_dataBlockClone},
 	{NULL, NULL}
 };
 
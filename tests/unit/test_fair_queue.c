@@ -0,0 +1,168 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/util/thpool/fair_queue.h"
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+static void _run(void *arg) {}
+static void _other(void *arg) {}
+
+static const char *A = "A";
+static const char *B = "B";
+
+static FairTask _task
+(
+	const void *tenant,
+	TaskPriority priority,
+	void *arg
+) {
+	FairTask t = {.function = _run, .arg = arg, .tenant = tenant,
+		.priority = priority};
+	return t;
+}
+
+void test_fairQueuePriority() {
+	FairQueue *q = FairQueue_New();
+
+	FairTask low    = _task(A, TASK_PRIORITY_LOW, NULL);
+	FairTask normal = _task(A, TASK_PRIORITY_NORMAL, NULL);
+	FairTask high   = _task(B, TASK_PRIORITY_HIGH, NULL);
+
+	FairQueue_Push(q, &low);
+	FairQueue_Push(q, &normal);
+	FairQueue_Push(q, &high);
+	TEST_ASSERT(FairQueue_Len(q) == 3);
+
+	// classes are served in strict priority order
+	TEST_ASSERT(FairQueue_Pop(q) == &high);
+	TEST_ASSERT(FairQueue_Pop(q) == &normal);
+	TEST_ASSERT(FairQueue_Pop(q) == &low);
+	TEST_ASSERT(FairQueue_Pop(q) == NULL);
+	TEST_ASSERT(FairQueue_Len(q) == 0);
+
+	FairQueue_Done(q, &high, 100);
+	FairQueue_Done(q, &normal, 100);
+	FairQueue_Done(q, &low, 100);
+
+	FairQueue_Free(q);
+}
+
+void test_fairQueueRoundRobin() {
+	FairQueue *q = FairQueue_New();
+
+	// tenant A floods the queue before B queues its tasks
+	FairTask a[10];
+	FairTask b[2];
+	for(int i = 0; i < 10; i++) {
+		a[i] = _task(A, TASK_PRIORITY_NORMAL, NULL);
+		FairQueue_Push(q, a + i);
+	}
+	for(int i = 0; i < 2; i++) {
+		b[i] = _task(B, TASK_PRIORITY_NORMAL, NULL);
+		FairQueue_Push(q, b + i);
+	}
+
+	// tenants take turns, each tenant's tasks are served in order
+	FairTask *expected[] = {a, b, a + 1, b + 1, a + 2, a + 3};
+	for(int i = 0; i < 6; i++) {
+		TEST_ASSERT(FairQueue_Pop(q) == expected[i]);
+	}
+
+	FairTask *t;
+	while((t = FairQueue_Pop(q)) != NULL) {}
+
+	for(int i = 0; i < 10; i++) FairQueue_Done(q, a + i, 100);
+	for(int i = 0; i < 2; i++)  FairQueue_Done(q, b + i, 100);
+
+	FairQueue_Free(q);
+}
+
+void test_fairQueueCost() {
+	FairQueue *q = FairQueue_New();
+
+	// tenant A runs expensive tasks, B runs cheap ones
+	FairTask a[100];
+	FairTask b[100];
+	for(int i = 0; i < 100; i++) {
+		a[i] = _task(A, TASK_PRIORITY_NORMAL, NULL);
+		b[i] = _task(B, TASK_PRIORITY_NORMAL, NULL);
+		FairQueue_Push(q, a + i);
+		FairQueue_Push(q, b + i);
+	}
+
+	// once costs are learned B is served far more often than A
+	int a_count = 0;
+	int b_count = 0;
+	for(int i = 0; i < 100; i++) {
+		FairTask *t = FairQueue_Pop(q);
+		bool is_a = (t->tenant == A);
+		FairQueue_Done(q, t, is_a ? 20000 : 100);
+		if(i < 20) continue;
+
+		if(is_a) a_count++;
+		else b_count++;
+	}
+	TEST_ASSERT(b_count > 5 * a_count);
+
+	FairTask *t;
+	while((t = FairQueue_Pop(q)) != NULL) FairQueue_Done(q, t, 100);
+
+	FairQueue_Free(q);
+}
+
+void test_fairQueueGetTasks() {
+	FairQueue *q = FairQueue_New();
+
+	FairTask tasks[6];
+	for(intptr_t i = 0; i < 6; i++) {
+		tasks[i] = _task((i % 2) ? A : B, TASK_PRIORITY_NORMAL, (void *)i);
+		if(i == 5) tasks[i].function = _other;
+		FairQueue_Push(q, tasks + i);
+	}
+
+	void *args[6];
+	uint32_t n = 6;
+	FairQueue_GetTasks(q, args, &n, _run, NULL);
+	TEST_ASSERT(n == 5);
+
+	n = 2;
+	FairQueue_GetTasks(q, args, &n, _run, NULL);
+	TEST_ASSERT(n == 2);
+
+	n = 6;
+	FairQueue_GetTasks(q, args, &n, _other, NULL);
+	TEST_ASSERT(n == 1);
+	TEST_ASSERT(args[0] == (void *)5);
+
+	FairTask *t;
+	while((t = FairQueue_Pop(q)) != NULL) FairQueue_Done(q, t, 100);
+
+	FairQueue_Free(q);
+}
+
+void test_taskPriorityNames() {
+	TaskPriority p;
+	TEST_ASSERT(TaskPriority_FromString("high", &p) && p == TASK_PRIORITY_HIGH);
+	TEST_ASSERT(TaskPriority_FromString("Normal", &p) && p == TASK_PRIORITY_NORMAL);
+	TEST_ASSERT(TaskPriority_FromString("LOW", &p) && p == TASK_PRIORITY_LOW);
+	TEST_ASSERT(!TaskPriority_FromString("urgent", &p));
+	TEST_ASSERT(strcmp(TaskPriority_ToString(TASK_PRIORITY_LOW), "LOW") == 0);
+}
+
+TEST_LIST = {
+	{"fairQueuePriority", test_fairQueuePriority},
+	{"fairQueueRoundRobin", test_fairQueueRoundRobin},
+	{"fairQueueCost", test_fairQueueCost},
+	{"fairQueueGetTasks", test_fairQueueGetTasks},
+	{"taskPriorityNames", test_taskPriorityNames},
+	{NULL, NULL}
+};
@@ -0,0 +1,198 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/dict.h"
+#include "src/util/rmalloc.h"
+#include "src/util/flat_map.h"
+#include "src/util/simple_timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// value equality callback, values are integers
+static bool _eq
+(
+	const void *value,
+	const void *ctx
+) {
+	return (intptr_t)value == (intptr_t)ctx;
+}
+
+// count freed values
+static int freed = 0;
+static void _free
+(
+	void *value
+) {
+	freed++;
+}
+
+void test_flatMapInsertFind() {
+	FlatMap map = FlatMap_New(0);
+	TEST_ASSERT(FlatMap_Count(map) == 0);
+	TEST_ASSERT(FlatMap_Find(map, 1, NULL, NULL) == NULL);
+
+	// insert enough entries to force multiple resizes
+	uint64_t n = 100000;
+	for(uint64_t i = 0; i < n; i++) {
+		void **v = FlatMap_Insert(map, i, (void *)(intptr_t)(i + 1));
+		TEST_ASSERT(*v == (void *)(intptr_t)(i + 1));
+	}
+	TEST_ASSERT(FlatMap_Count(map) == n);
+
+	for(uint64_t i = 0; i < n; i++) {
+		void **v = FlatMap_Find(map, i, NULL, NULL);
+		TEST_ASSERT(v != NULL);
+		TEST_ASSERT(*v == (void *)(intptr_t)(i + 1));
+	}
+	TEST_ASSERT(FlatMap_Find(map, n, NULL, NULL) == NULL);
+
+	FlatMap_Free(&map, NULL);
+	TEST_ASSERT(map == NULL);
+}
+
+void test_flatMapCollisions() {
+	FlatMap map = FlatMap_New(16);
+
+	// distinct values sharing the same key
+	bool found;
+	for(intptr_t i = 1; i <= 100; i++) {
+		void **v = FlatMap_FindOrInsert(map, 7, _eq, (void *)i, &found);
+		TEST_ASSERT(!found);
+		TEST_ASSERT(*v == NULL);
+		*v = (void *)i;
+	}
+	TEST_ASSERT(FlatMap_Count(map) == 100);
+
+	// each value is located by verifying equality
+	for(intptr_t i = 1; i <= 100; i++) {
+		void **v = FlatMap_FindOrInsert(map, 7, _eq, (void *)i, &found);
+		TEST_ASSERT(found);
+		TEST_ASSERT(*v == (void *)i);
+	}
+	TEST_ASSERT(FlatMap_Find(map, 7, _eq, (void *)101) == NULL);
+	TEST_ASSERT(FlatMap_Count(map) == 100);
+
+	FlatMap_Free(&map, NULL);
+}
+
+void test_flatMapIterateClear() {
+	FlatMap map = FlatMap_New(4);
+
+	uint64_t n = 1000;
+	for(uint64_t i = 0; i < n; i++) {
+		FlatMap_Insert(map, i * 3, (void *)(intptr_t)(i + 1));
+	}
+
+	// every entry is visited exactly once
+	uint64_t key;
+	uint64_t visited = 0;
+	uint64_t key_sum = 0;
+	FlatMapIterator it;
+	FlatMap_IteratorInit(&it, map);
+	while(FlatMap_IteratorNext(&it, &key) != NULL) {
+		visited++;
+		key_sum += key;
+	}
+	TEST_ASSERT(visited == n);
+	TEST_ASSERT(key_sum == 3 * n * (n - 1) / 2);
+
+	// NULL values are skipped by the free callback
+	*FlatMap_Find(map, 0, NULL, NULL) = NULL;
+
+	freed = 0;
+	FlatMap_Clear(map, _free);
+	TEST_ASSERT(freed == n - 1);
+	TEST_ASSERT(FlatMap_Count(map) == 0);
+	TEST_ASSERT(FlatMap_Find(map, 3, NULL, NULL) == NULL);
+
+	// map is reusable after clear
+	FlatMap_Insert(map, 3, (void *)1);
+	TEST_ASSERT(FlatMap_Count(map) == 1);
+
+	freed = 0;
+	FlatMap_Free(&map, _free);
+	TEST_ASSERT(freed == 1);
+}
+
+//------------------------------------------------------------------------------
+// benchmark
+//------------------------------------------------------------------------------
+
+// fake hash function, keys are already hashed
+static uint64_t _id_hash
+(
+	const void *key
+) {
+	return ((uint64_t)key);
+}
+
+static dictType _dt = {_id_hash, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+	NULL, NULL};
+
+// scramble sequential values into well distributed hashes
+static uint64_t _hash
+(
+	uint64_t x
+) {
+	x ^= x >> 31;
+	x *= 0x7fb5d329728ea185ULL;
+	x ^= x >> 27;
+	x *= 0x81dadef4bc2dd44dULL;
+	x ^= x >> 33;
+	return x;
+}
+
+// group n * 4 hashed keys into n groups
+// the way the aggregate operation groups records
+// only runs when the BENCHMARK environment variable is set
+// e.g. BENCHMARK=1 ./test_flat_map flatMapBenchmark
+void benchmark_flatMap() {
+	if(getenv("BENCHMARK") == NULL) return;
+
+	uint64_t groups[] = {1000000, 10000000, 100000000};
+	for(int i = 0; i < sizeof(groups) / sizeof(groups[0]); i++) {
+		uint64_t n = groups[i];
+		double tic[2];
+		bool found;
+
+		simple_tic(tic);
+		dict *d = HashTableCreate(&_dt);
+		for(uint64_t j = 0; j < n * 4; j++) {
+			dictEntry *existing;
+			HashTableAddRaw(d, (void *)_hash(j % n), &existing);
+		}
+		TEST_ASSERT(HashTableElemCount(d) == n);
+		HashTableRelease(d);
+		double dict_time = simple_toc(tic);
+
+		simple_tic(tic);
+		FlatMap map = FlatMap_New(0);
+		for(uint64_t j = 0; j < n * 4; j++) {
+			FlatMap_FindOrInsert(map, _hash(j % n), NULL, NULL, &found);
+		}
+		TEST_ASSERT(FlatMap_Count(map) == n);
+		FlatMap_Free(&map, NULL);
+		double flat_time = simple_toc(tic);
+
+		printf("%lu groups, dict: %.3f sec, flat map: %.3f sec\n", n,
+				dict_time, flat_time);
+	}
+}
+
+TEST_LIST = {
+	{"flatMapInsertFind", test_flatMapInsertFind},
+	{"flatMapCollisions", test_flatMapCollisions},
+	{"flatMapIterateClear", test_flatMapIterateClear},
+	{"flatMapBenchmark", benchmark_flatMap},
+	{NULL, NULL}
+};
@@ -0,0 +1,154 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/index/hash_index.h"
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// count number of entities associated with key
+static int _count
+(
+	HashIndex hidx,
+	uint64_t key
+) {
+	int n = 0;
+	HashIndexIterator it;
+	HashIndex_Find(hidx, key, &it);
+	while(HashIndexIterator_Next(&it, NULL)) n++;
+	return n;
+}
+
+void test_hashIndexInsertFind() {
+	HashIndex hidx = HashIndex_New();
+
+	// multiple entities sharing the same key
+	HashIndex_Insert(hidx, 7, 1);
+	HashIndex_Insert(hidx, 7, 2);
+	HashIndex_Insert(hidx, 9, 3);
+
+	TEST_ASSERT(HashIndex_Count(hidx) == 3);
+	TEST_ASSERT(_count(hidx, 7) == 2);
+	TEST_ASSERT(_count(hidx, 9) == 1);
+	TEST_ASSERT(_count(hidx, 8) == 0);
+
+	// re-inserting an entity with the same key is a no-op
+	HashIndex_Insert(hidx, 7, 1);
+	TEST_ASSERT(HashIndex_Count(hidx) == 3);
+	TEST_ASSERT(_count(hidx, 7) == 2);
+
+	// re-inserting an entity with a different key moves it
+	HashIndex_Insert(hidx, 9, 1);
+	TEST_ASSERT(HashIndex_Count(hidx) == 3);
+	TEST_ASSERT(_count(hidx, 7) == 1);
+	TEST_ASSERT(_count(hidx, 9) == 2);
+
+	HashIndex_Free(&hidx);
+	TEST_ASSERT(hidx == NULL);
+}
+
+void test_hashIndexRemove() {
+	HashIndex hidx = HashIndex_New();
+
+	HashIndex_Insert(hidx, 7, 1);
+	HashIndex_Insert(hidx, 7, 2);
+
+	TEST_ASSERT(HashIndex_Remove(hidx, 1) == true);
+	TEST_ASSERT(HashIndex_Remove(hidx, 1) == false);
+	TEST_ASSERT(HashIndex_Count(hidx) == 1);
+
+	EntityID id;
+	HashIndexIterator it;
+	HashIndex_Find(hidx, 7, &it);
+	TEST_ASSERT(HashIndexIterator_Next(&it, &id));
+	TEST_ASSERT(id == 2);
+	TEST_ASSERT(!HashIndexIterator_Next(&it, &id));
+
+	HashIndex_Free(&hidx);
+}
+
+void test_hashIndexGrow() {
+	HashIndex hidx = HashIndex_New();
+	uint64_t n = 100000;
+
+	// force a number of rehashes
+	for(uint64_t i = 0; i < n; i++) {
+		HashIndex_Insert(hidx, i % 1000, i);
+	}
+	TEST_ASSERT(HashIndex_Count(hidx) == n);
+
+	for(uint64_t k = 0; k < 1000; k++) {
+		TEST_ASSERT(_count(hidx, k) == n / 1000);
+	}
+
+	// remove half of the entities, leaving tombstones behind
+	for(uint64_t i = 0; i < n; i += 2) {
+		TEST_ASSERT(HashIndex_Remove(hidx, i));
+	}
+	TEST_ASSERT(HashIndex_Count(hidx) == n / 2);
+
+	// re-insert, reusing tombstones
+	for(uint64_t i = 0; i < n; i += 2) {
+		HashIndex_Insert(hidx, i % 1000, i);
+	}
+	TEST_ASSERT(HashIndex_Count(hidx) == n);
+
+	for(uint64_t k = 0; k < 1000; k++) {
+		TEST_ASSERT(_count(hidx, k) == n / 1000);
+	}
+
+	HashIndex_Free(&hidx);
+}
+
+void test_hashIndexSharedKey() {
+	HashIndex hidx = HashIndex_New();
+	uint64_t n = 100000;
+
+	// all entities share a single key
+	for(uint64_t i = 0; i < n; i++) {
+		HashIndex_Insert(hidx, 42, i);
+	}
+	TEST_ASSERT(HashIndex_Count(hidx) == n);
+	TEST_ASSERT(_count(hidx, 42) == n);
+
+	// unlink entities from the head, middle and tail of the key's chain
+	TEST_ASSERT(HashIndex_Remove(hidx, 0));
+	TEST_ASSERT(HashIndex_Remove(hidx, n / 2));
+	TEST_ASSERT(HashIndex_Remove(hidx, n - 1));
+	TEST_ASSERT(_count(hidx, 42) == n - 3);
+
+	// move an entity to a different key
+	HashIndex_Insert(hidx, 43, 1);
+	TEST_ASSERT(_count(hidx, 42) == n - 4);
+	TEST_ASSERT(_count(hidx, 43) == 1);
+
+	// drop all remaining entities, key is removed
+	for(uint64_t i = 0; i < n; i++) {
+		HashIndex_Remove(hidx, i);
+	}
+	TEST_ASSERT(HashIndex_Count(hidx) == 0);
+	TEST_ASSERT(_count(hidx, 42) == 0);
+	TEST_ASSERT(_count(hidx, 43) == 0);
+
+	// key is reusable
+	HashIndex_Insert(hidx, 42, 7);
+	TEST_ASSERT(_count(hidx, 42) == 1);
+
+	HashIndex_Free(&hidx);
+}
+
+TEST_LIST = {
+	{"hashIndexInsertFind", test_hashIndexInsertFind},
+	{"hashIndexRemove", test_hashIndexRemove},
+	{"hashIndexGrow", test_hashIndexGrow},
+	{"hashIndexSharedKey", test_hashIndexSharedKey},
+	{NULL, NULL}
+};
+
@@ -0,0 +1,101 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/util/hll.h"
+
+#include <math.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// scramble sequential values into well distributed hashes
+static uint64_t _hash
+(
+	uint64_t x
+) {
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return x;
+}
+
+void test_hllSmallExact() {
+	HLL hll = HLL_New();
+	TEST_ASSERT(HLL_Count(hll) == 0);
+
+	// small cardinalities are counted exactly, duplicates are ignored
+	for(uint64_t i = 0; i < 200; i++) {
+		HLL_Add(&hll, _hash(i % 100));
+	}
+	TEST_ASSERT(HLL_Count(hll) == 100);
+
+	HLL_Free(&hll);
+	TEST_ASSERT(hll == NULL);
+}
+
+void test_hllEstimate() {
+	uint64_t ns[] = {1000, 10000, 100000, 1000000};
+
+	for(int i = 0; i < sizeof(ns) / sizeof(ns[0]); i++) {
+		uint64_t n = ns[i];
+		HLL hll = HLL_New();
+
+		// each element is added twice
+		for(uint64_t j = 0; j < n * 2; j++) {
+			HLL_Add(&hll, _hash(j % n));
+		}
+
+		// standard error is ~0.81%, allow 3%
+		double err = fabs((double)HLL_Count(hll) - n) / n;
+		TEST_ASSERT(err < 0.03);
+
+		HLL_Free(&hll);
+	}
+}
+
+void test_hllMerge() {
+	HLL a = HLL_New();
+	HLL b = HLL_New();
+	HLL c = HLL_New();
+
+	// a and b overlap by half
+	uint64_t n = 100000;
+	for(uint64_t i = 0; i < n; i++) {
+		HLL_Add(&a, _hash(i));
+		HLL_Add(&b, _hash(i + n / 2));
+	}
+
+	// c is small, remains sparse
+	for(uint64_t i = 0; i < 10; i++) {
+		HLL_Add(&c, _hash(i + n * 2));
+	}
+
+	// merge dense into sparse and sparse into dense
+	HLL_Merge(&c, a);
+	HLL_Merge(&c, b);
+
+	double expected = n + n / 2 + 10;
+	double err = fabs((double)HLL_Count(c) - expected) / expected;
+	TEST_ASSERT(err < 0.03);
+
+	HLL_Free(&a);
+	HLL_Free(&b);
+	HLL_Free(&c);
+}
+
+TEST_LIST = {
+	{"hllSmallExact", test_hllSmallExact},
+	{"hllEstimate", test_hllEstimate},
+	{"hllMerge", test_hllMerge},
+	{NULL, NULL}
+};
+
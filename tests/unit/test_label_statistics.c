@@ -0,0 +1,144 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/arr.h"
+#include "src/util/rmalloc.h"
+#include "src/graph/label_statistics.h"
+
+#include <math.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+#define CLOSE(a, b, eps) (fabs((a) - (b)) <= (eps))
+
+void test_labelStatisticsNulls() {
+	// 100 sampled nodes out of 100, 40 of which hold attribute 0
+	LabelStatistics *stats = LabelStatistics_New(100, 100);
+
+	SIValue values[40];
+	for(int i = 0; i < 40; i++) values[i] = SI_LongVal(i % 4);
+	LabelStatistics_AddAttribute(stats, 0, values, 40);
+
+	const AttributeStatistics *attr = stats->attributes;
+	TEST_ASSERT(CLOSE(attr->null_fraction, 0.6, 1e-9));
+	TEST_ASSERT(CLOSE(attr->numeric_fraction, 0.4, 1e-9));
+
+	// entire label was sampled, distinct count is exact
+	TEST_ASSERT(attr->distinct == 4);
+
+	// equality: not null fraction spread across distinct values
+	double s = LabelStatistics_Selectivity(stats, 0, OP_EQUAL, NULL);
+	TEST_ASSERT(CLOSE(s, 0.1, 1e-9));
+
+	// attribute none of the sampled nodes holds
+	s = LabelStatistics_Selectivity(stats, 1, OP_EQUAL, NULL);
+	TEST_ASSERT(s < 0.01);
+
+	LabelStatistics_Free(stats);
+}
+
+void test_labelStatisticsDistinct() {
+	// 1000 sampled nodes out of 100000, all holding a unique value
+	LabelStatistics *stats = LabelStatistics_New(100000, 1000);
+
+	SIValue *values = rm_malloc(sizeof(SIValue) * 1000);
+	for(int i = 0; i < 1000; i++) values[i] = SI_LongVal(i);
+	LabelStatistics_AddAttribute(stats, 0, values, 1000);
+
+	// unique samples scale up with the population
+	// GEE: sqrt(100000 / 1000) * 1000
+	double distinct = stats->attributes[0].distinct;
+	TEST_ASSERT(CLOSE(distinct, 10000, 1e-6));
+
+	// few repeating values aren't scaled
+	for(int i = 0; i < 1000; i++) values[i] = SI_LongVal(i % 10);
+	LabelStatistics_AddAttribute(stats, 1, values, 1000);
+	TEST_ASSERT(stats->attributes[1].distinct == 10);
+
+	rm_free(values);
+	LabelStatistics_Free(stats);
+}
+
+void test_labelStatisticsHistogram() {
+	// values 0..999 uniformly distributed
+	LabelStatistics *stats = LabelStatistics_New(1000, 1000);
+
+	SIValue values[1000];
+	for(int i = 0; i < 1000; i++) values[i] = SI_DoubleVal(999 - i);
+	LabelStatistics_AddAttribute(stats, 0, values, 1000);
+
+	const AttributeStatistics *attr = stats->attributes;
+	TEST_ASSERT(attr->bound_count == HISTOGRAM_BUCKETS + 1);
+	TEST_ASSERT(attr->bounds[0] == 0);
+	TEST_ASSERT(attr->bounds[HISTOGRAM_BUCKETS] == 999);
+
+	SIValue v = SI_LongVal(250);
+	double s = LabelStatistics_Selectivity(stats, 0, OP_LT, &v);
+	TEST_ASSERT(CLOSE(s, 0.25, 0.01));
+
+	s = LabelStatistics_Selectivity(stats, 0, OP_GE, &v);
+	TEST_ASSERT(CLOSE(s, 0.75, 0.01));
+
+	// out of range values
+	v = SI_LongVal(-1);
+	TEST_ASSERT(LabelStatistics_Selectivity(stats, 0, OP_LT, &v) == 0);
+	v = SI_LongVal(5000);
+	TEST_ASSERT(LabelStatistics_Selectivity(stats, 0, OP_LT, &v) == 1);
+
+	// unknown value falls back to default
+	s = LabelStatistics_Selectivity(stats, 0, OP_GT, NULL);
+	TEST_ASSERT(CLOSE(s, DEFAULT_RANGE_SELECTIVITY, 1e-9));
+
+	LabelStatistics_Free(stats);
+}
+
+void test_labelStatisticsMixedTypes() {
+	// half the values are strings, histogram covers numbers only
+	LabelStatistics *stats = LabelStatistics_New(100, 100);
+
+	SIValue values[100];
+	for(int i = 0; i < 100; i++) {
+		values[i] = (i % 2) ? SI_ConstStringVal("a") : SI_LongVal(i);
+	}
+	LabelStatistics_AddAttribute(stats, 0, values, 100);
+
+	const AttributeStatistics *attr = stats->attributes;
+	TEST_ASSERT(CLOSE(attr->numeric_fraction, 0.5, 1e-9));
+	TEST_ASSERT(attr->distinct == 51);
+
+	SIValue v = SI_LongVal(1000);
+	double s = LabelStatistics_Selectivity(stats, 0, OP_LT, &v);
+	TEST_ASSERT(CLOSE(s, 0.5, 1e-9));
+
+	LabelStatistics_Free(stats);
+}
+
+void test_labelStatisticsDegree() {
+	LabelStatistics *stats = LabelStatistics_New(10, 10);
+	LabelStatistics_AddDegree(stats, 0, 2.5, 0);
+	LabelStatistics_AddDegree(stats, 2, 0, 1);
+
+	TEST_ASSERT(LabelStatistics_Degree(stats, 0, true)  == 2.5);
+	TEST_ASSERT(LabelStatistics_Degree(stats, 0, false) == 0);
+	TEST_ASSERT(LabelStatistics_Degree(stats, 2, false) == 1);
+	TEST_ASSERT(LabelStatistics_Degree(stats, 1, true)  == -1);
+
+	LabelStatistics_Free(stats);
+}
+
+TEST_LIST = {
+	{"labelStatisticsNulls", test_labelStatisticsNulls},
+	{"labelStatisticsDistinct", test_labelStatisticsDistinct},
+	{"labelStatisticsHistogram", test_labelStatisticsHistogram},
+	{"labelStatisticsMixedTypes", test_labelStatisticsMixedTypes},
+	{"labelStatisticsDegree", test_labelStatisticsDegree},
+	{NULL, NULL}
+};
@@ -0,0 +1,180 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/arr.h"
+#include "src/util/rmalloc.h"
+#include "src/util/sds/sds.h"
+#include "src/ast/ast_parameterize.h"
+
+#include <string.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// parameterize 'query' expecting 'expected'
+// NULL 'expected' denotes that no literal should be replaced
+// returns replaced literals
+static SIValue *_parameterize
+(
+	const char *query,
+	const char *expected
+) {
+	SIValue *literals = NULL;
+	char *res = AST_ParameterizeLiterals(query, &literals);
+
+	if(expected == NULL) {
+		TEST_ASSERT(res == NULL);
+		TEST_MSG("query: %s, got: %s", query, res);
+		return NULL;
+	}
+
+	TEST_ASSERT(res != NULL && strcmp(res, expected) == 0);
+	TEST_MSG("query: %s, expected: %s, got: %s", query, expected, res);
+
+	sdsfree(res);
+	return literals;
+}
+
+static void _free_literals
+(
+	SIValue *literals
+) {
+	if(literals != NULL) array_free_cb(literals, SIValue_Free);
+}
+
+void test_parameterizeComparisons() {
+	SIValue *lits = _parameterize(
+			"MATCH (n) WHERE n.v = 42 AND n.name <> 'a' AND n.x >= 1.5 RETURN n",
+			"MATCH (n) WHERE n.v = $__lit0 AND n.name <> $__lit1 AND n.x >= $__lit2 RETURN n");
+
+	TEST_ASSERT(array_len(lits) == 3);
+	TEST_ASSERT(SI_TYPE(lits[0]) == T_INT64 && lits[0].longval == 42);
+	TEST_ASSERT(SI_TYPE(lits[1]) == T_STRING &&
+			strcmp(lits[1].stringval, "a") == 0);
+	TEST_ASSERT(SI_TYPE(lits[2]) == T_DOUBLE && lits[2].doubleval == 1.5);
+
+	_free_literals(lits);
+}
+
+void test_parameterizeMaps() {
+	SIValue *lits = _parameterize(
+			"MATCH (n:L {v: 1})-[:R {w: \"x\"}]->(m) SET m.v = 2",
+			"MATCH (n:L {v: $__lit0})-[:R {w: $__lit1}]->(m) SET m.v = $__lit2");
+	TEST_ASSERT(array_len(lits) == 3);
+	_free_literals(lits);
+
+	lits = _parameterize("CREATE (:N {v: 1, s: 'a'})",
+			"CREATE (:N {v: $__lit0, s: $__lit1})");
+	TEST_ASSERT(array_len(lits) == 2);
+	_free_literals(lits);
+}
+
+void test_parameterizeRetained() {
+	// projections name columns after their text
+	_parameterize("RETURN 1, 'a', {v: 1}, 1 = 1", NULL);
+	_parameterize("MATCH (n) WITH n.v = 1 AS x RETURN x", NULL);
+	_parameterize("MATCH (n) RETURN n ORDER BY n.v = 1 SKIP 1 LIMIT 10", NULL);
+
+	// WHERE nested in a projection
+	_parameterize("MATCH (n) RETURN [(n)-->(m) WHERE m.v = 1 | m]", NULL);
+
+	// procedure arguments and subqueries
+	_parameterize("CALL db.idx.fulltext.createNodeIndex({label: 'L'}, 'v')",
+			NULL);
+	_parameterize("CALL { MATCH (n) WHERE n.v = 1 RETURN n } RETURN n", NULL);
+
+	// variable length ranges, lists and negative numbers
+	_parameterize("MATCH (a)-[*1..3]->(b) RETURN b", NULL);
+	_parameterize("MATCH (n) WHERE n.v IN [1, 2] AND n.x = -1 RETURN n", NULL);
+
+	// literals nested within expressions
+	_parameterize("MATCH (n) WHERE n.v = 1 + 2 AND n.x = toUpper('a') RETURN n",
+			NULL);
+
+	// index statements
+	_parameterize("CREATE VECTOR INDEX FOR (n:L) ON (n.v) OPTIONS {dimension: 3}",
+			NULL);
+
+	// literals in comments
+	_parameterize("MATCH (n) // WHERE n.v = 1\nRETURN n", NULL);
+	_parameterize("MATCH (n) /* WHERE n.v = 1 */ RETURN n", NULL);
+
+	// unbalanced brackets and unterminated strings are left to the parser
+	_parameterize("MATCH (n)) WHERE n.v = 1", NULL);
+	_parameterize("MATCH (n) WHERE n.v = 1 AND n.s = 'a", NULL);
+}
+
+void test_parameterizeClauses() {
+	// WHERE following a projection
+	SIValue *lits = _parameterize(
+			"MATCH (n) WITH n WHERE n.v = 1 RETURN n",
+			"MATCH (n) WITH n WHERE n.v = $__lit0 RETURN n");
+	_free_literals(lits);
+
+	// STARTS WITH isn't a projection
+	lits = _parameterize(
+			"MATCH (n) WHERE n.s STARTS WITH 'a' AND n.v = 1 RETURN n",
+			"MATCH (n) WHERE n.s STARTS WITH 'a' AND n.v = $__lit0 RETURN n");
+	_free_literals(lits);
+
+	// a projection nested in WHERE ends with its bracket
+	lits = _parameterize(
+			"MATCH (n) WHERE EXISTS { MATCH (n)-->(m) RETURN m } AND n.v = 1 RETURN n",
+			"MATCH (n) WHERE EXISTS { MATCH (n)-->(m) RETURN m } AND n.v = $__lit0 RETURN n");
+	_free_literals(lits);
+
+	// keywords used as property keys, labels and map keys
+	lits = _parameterize(
+			"MATCH (n:Return {with: 1}) WHERE n.return = 2 RETURN n",
+			"MATCH (n:Return {with: $__lit0}) WHERE n.return = $__lit1 RETURN n");
+	_free_literals(lits);
+
+	// planner hints
+	lits = _parameterize(
+			"MATCH (n:L) USING INDEX n:L(v) WHERE n.v = 1 RETURN n",
+			"MATCH (n:L) USING INDEX n:L(v) WHERE n.v = $__lit0 RETURN n");
+	_free_literals(lits);
+
+	// arrows aren't comparisons
+	_parameterize("MATCH (a)<-[:R]-(b) RETURN a", NULL);
+
+	// comparison chains
+	lits = _parameterize(
+			"MATCH (n) WHERE 1 < n.v <= 5 RETURN n",
+			"MATCH (n) WHERE $__lit0 < n.v <= $__lit1 RETURN n");
+	TEST_ASSERT(array_len(lits) == 2);
+	_free_literals(lits);
+}
+
+void test_parameterizeValues() {
+	// hex numbers and escaped strings are parsed to their values
+	SIValue *lits = _parameterize(
+			"MATCH (n) WHERE n.v = 0x1F AND n.s = 'a\\'b' RETURN n",
+			"MATCH (n) WHERE n.v = $__lit0 AND n.s = $__lit1 RETURN n");
+
+	TEST_ASSERT(array_len(lits) == 2);
+	TEST_ASSERT(SI_TYPE(lits[0]) == T_INT64 && lits[0].longval == 31);
+	TEST_ASSERT(SI_TYPE(lits[1]) == T_STRING &&
+			strcmp(lits[1].stringval, "a'b") == 0);
+
+	_free_literals(lits);
+
+	// out of range numbers are left to the query's evaluation
+	_parameterize("MATCH (n) WHERE n.v = 99999999999999999999 RETURN n", NULL);
+}
+
+TEST_LIST = {
+	{"parameterizeComparisons", test_parameterizeComparisons},
+	{"parameterizeMaps", test_parameterizeMaps},
+	{"parameterizeRetained", test_parameterizeRetained},
+	{"parameterizeClauses", test_parameterizeClauses},
+	{"parameterizeValues", test_parameterizeValues},
+	{NULL, NULL}
+};
@@ -0,0 +1,110 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/configuration/config.h"
+#include "src/queries_log/queries_log.h"
+
+void setup() {
+	Alloc_Reset();
+	Config_Option_set(Config_CMD_INFO_MAX_QUERY_COUNT, "100", NULL);
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// log a successful execution of query
+static void _log
+(
+	QueriesLog log,      // queries log
+	const char *query,   // query string
+	double runtime,      // execution time, milliseconds
+	bool cached,         // utilized cache
+	bool write           // write query
+) {
+	QueriesLog_AddQuery(log, 0, 0, runtime, 0, false, cached, write, false,
+			query);
+}
+
+void test_cheapRead() {
+	QueriesLog log = QueriesLog_New();
+	const char *q = "MATCH (n) WHERE ID(n) = 1 RETURN n";
+
+	// unknown query
+	TEST_ASSERT(!QueriesLog_CheapRead(log, q, 0.1));
+
+	// not enough executions
+	_log(log, q, 0.01, true, false);
+	_log(log, q, 0.01, true, false);
+	TEST_ASSERT(!QueriesLog_CheapRead(log, q, 0.1));
+
+	_log(log, q, 0.01, true, false);
+	TEST_ASSERT(QueriesLog_CheapRead(log, q, 0.1));
+
+	// too slow for the given threshold
+	TEST_ASSERT(!QueriesLog_CheapRead(log, q, 0.001));
+
+	// a cache miss disqualifies the query
+	_log(log, q, 0.01, false, false);
+	TEST_ASSERT(!QueriesLog_CheapRead(log, q, 0.1));
+
+	_log(log, q, 0.01, true, false);
+	TEST_ASSERT(QueriesLog_CheapRead(log, q, 0.1));
+
+	// slow executions raise the query's average runtime
+	for(int i = 0; i < 10; i++) _log(log, q, 5, true, false);
+	TEST_ASSERT(!QueriesLog_CheapRead(log, q, 0.1));
+
+	QueriesLog_Free(log);
+}
+
+void test_cheapReadWrite() {
+	QueriesLog log = QueriesLog_New();
+	const char *q = "CREATE ()";
+
+	for(int i = 0; i < 5; i++) _log(log, q, 0.01, true, true);
+	TEST_ASSERT(!QueriesLog_CheapRead(log, q, 0.1));
+
+	QueriesLog_Free(log);
+}
+
+void test_cheapReadParameters() {
+	QueriesLog log = QueriesLog_New();
+
+	// executions differing only by parameter values share runtime stats
+	_log(log, "CYPHER id=1 MATCH (n) WHERE ID(n) = $id RETURN n", 0.01, true,
+			false);
+	_log(log, "CYPHER id=2 MATCH (n) WHERE ID(n) = $id RETURN n", 0.01, true,
+			false);
+	_log(log, "CYPHER id=3 MATCH (n) WHERE ID(n) = $id RETURN n", 0.01, true,
+			false);
+
+	TEST_ASSERT(QueriesLog_CheapRead(log,
+			"CYPHER id=4 MATCH (n) WHERE ID(n) = $id RETURN n", 0.1));
+
+	// parameter values containing white spaces
+	const char *queries[3] = {
+		"CYPHER v='a b' m={x: [1, 2]} RETURN $v, $m",
+		"CYPHER v=\"c \\\" d\" m={x: [3]} RETURN $v, $m",
+		"CYPHER v='' m={} RETURN $v, $m",
+	};
+	for(int i = 0; i < 3; i++) _log(log, queries[i], 0.01, true, false);
+
+	TEST_ASSERT(QueriesLog_CheapRead(log,
+			"CYPHER v='e' m={y: 'f g'} RETURN $v, $m", 0.1));
+
+	// a different query body
+	TEST_ASSERT(!QueriesLog_CheapRead(log,
+			"CYPHER id=4 MATCH (n) WHERE ID(n) = $id RETURN n.v", 0.1));
+
+	QueriesLog_Free(log);
+}
+
+TEST_LIST = {
+	{"cheapRead", test_cheapRead},
+	{"cheapReadWrite", test_cheapReadWrite},
+	{"cheapReadParameters", test_cheapReadParameters},
+	{NULL, NULL}
+};
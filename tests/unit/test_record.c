@@ -52,8 +52,45 @@ void test_recordToString() {
 	raxFree(_rax);
 }
 
+void test_recordNodeID() {
+	rax *_rax = raxNew();
+
+	for(int i = 0; i < 4; i++) {
+		char buf[2] = {(char)i, '\0'};
+		raxInsert(_rax, (unsigned char *)buf, 2, NULL, NULL);
+	}
+
+	Record r = Record_New(_rax);
+
+	// node added by ID
+	Record_AddNodeID(r, 0, 7);
+	TEST_ASSERT(Record_GetType(r, 0) == REC_TYPE_NODE);
+	TEST_ASSERT(Record_GetNodeID(r, 0) == 7);
+
+	// fully populated node
+	Node n = GE_NEW_NODE();
+	n.id = 3;
+	Record_AddNode(r, 1, n);
+	TEST_ASSERT(Record_GetNodeID(r, 1) == 3);
+
+	// missing and null entries have no ID
+	Record_AddScalar(r, 2, SI_NullVal());
+	TEST_ASSERT(Record_GetNodeID(r, 2) == INVALID_ENTITY_ID);
+	TEST_ASSERT(Record_GetNodeID(r, 3) == INVALID_ENTITY_ID);
+
+	// cloned entries keep the node's ID
+	Record clone = Record_New(_rax);
+	Record_Clone(r, clone);
+	TEST_ASSERT(Record_GetNodeID(clone, 0) == 7);
+
+	Record_Free(clone);
+	Record_Free(r);
+	raxFree(_rax);
+}
+
 TEST_LIST = {
 	{ "recordToString", test_recordToString },
+	{ "recordNodeID", test_recordNodeID },
 	{ NULL, NULL }
 };
 
@@ -0,0 +1,85 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/util/tdigest.h"
+
+#include <math.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+void test_tdigestEmpty() {
+	TDigest td = TDigest_New(TDIGEST_DEFAULT_COMPRESSION);
+
+	TEST_ASSERT(TDigest_Count(td) == 0);
+	TEST_ASSERT(isnan(TDigest_Quantile(td, 0.5)));
+
+	// NaN values are ignored
+	TDigest_Add(td, NAN);
+	TEST_ASSERT(TDigest_Count(td) == 0);
+
+	TDigest_Free(&td);
+	TEST_ASSERT(td == NULL);
+}
+
+void test_tdigestQuantile() {
+	TDigest td = TDigest_New(TDIGEST_DEFAULT_COMPRESSION);
+
+	// add 0..n-1 in a scrambled order
+	uint64_t n = 100000;
+	for(uint64_t i = 0; i < n; i++) {
+		TDigest_Add(td, (double)((i * 7919) % n));
+	}
+	TEST_ASSERT(TDigest_Count(td) == n);
+
+	// extremes are exact
+	TEST_ASSERT(TDigest_Quantile(td, 0) == 0);
+	TEST_ASSERT(TDigest_Quantile(td, 1) == n - 1);
+
+	// estimations are within 1% of the value range
+	double qs[] = {0.001, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999};
+	for(int i = 0; i < sizeof(qs) / sizeof(qs[0]); i++) {
+		double expected = qs[i] * (n - 1);
+		double actual   = TDigest_Quantile(td, qs[i]);
+		TEST_ASSERT(fabs(actual - expected) <= n * 0.01);
+	}
+
+	TDigest_Free(&td);
+}
+
+void test_tdigestMerge() {
+	TDigest a = TDigest_New(TDIGEST_DEFAULT_COMPRESSION);
+	TDigest b = TDigest_New(TDIGEST_DEFAULT_COMPRESSION);
+
+	// split 0..n-1 between two digests
+	uint64_t n = 50000;
+	for(uint64_t i = 0; i < n; i++) {
+		TDigest_Add((i % 2 == 0) ? a : b, (double)i);
+	}
+
+	TDigest_Merge(a, b);
+	TEST_ASSERT(TDigest_Count(a) == n);
+	TEST_ASSERT(TDigest_Quantile(a, 0) == 0);
+	TEST_ASSERT(TDigest_Quantile(a, 1) == n - 1);
+
+	double median = TDigest_Quantile(a, 0.5);
+	TEST_ASSERT(fabs(median - (n - 1) / 2.0) <= n * 0.01);
+
+	TDigest_Free(&a);
+	TDigest_Free(&b);
+}
+
+TEST_LIST = {
+	{"tdigestEmpty", test_tdigestEmpty},
+	{"tdigestQuantile", test_tdigestQuantile},
+	{"tdigestMerge", test_tdigestMerge},
+	{NULL, NULL}
+};
+
@@ -8,7 +8,12 @@
 #include "src/util/thpool/pools.h"
 #include "src/configuration/config.h"
 
+#include <time.h>
+#include <sched.h>
+#include <stdio.h>
 #include <assert.h>
+#include <stdlib.h>
+#include <stdatomic.h>
 
 #define READER_COUNT 4
 #define WRITER_COUNT 1
@@ -74,8 +79,242 @@ void test_threadPools_threadID() {
 	}
 }
 
+static atomic_int _completed = 0;
+static void _query(void *arg) {
+	atomic_fetch_add(&_completed, 1);
+}
+
+void test_threadPools_queryScheduling() {
+	ThreadPools_CreatePools(READER_COUNT, WRITER_COUNT, UINT64_MAX);
+
+	// queries of several graphs and priority classes
+	int n = 300;
+	const char *graphs[3] = {"g1", "g2", "g3"};
+	for(int i = 0; i < n; i++) {
+		TEST_ASSERT(ThreadPools_AddQueryReader(_query, NULL, graphs[i % 3],
+					i % TASK_PRIORITY_COUNT, false) == 0);
+	}
+
+	while(atomic_load(&_completed) != n) { sched_yield(); }
+
+	// wait is recorded for each query, once it's done
+	uint64_t count;
+	double q = 0.5;
+	double wait;
+	do {
+		count = 0;
+		for(int i = 0; i < TASK_PRIORITY_COUNT; i++) {
+			count += ThreadPools_QueueWait(i, &q, &wait, 1);
+			TEST_ASSERT(wait >= 0);
+		}
+	} while(count != n);
+
+	ThreadPools_Destroy();
+}
+
+void test_threadPools_maxPendingQueries() {
+	ThreadPools_CreatePools(1, 1, 0);
+
+	// no room for pending queries
+	TEST_ASSERT(ThreadPools_AddQueryReader(_query, NULL, "g",
+				TASK_PRIORITY_NORMAL, false) == THPOOL_QUEUE_FULL);
+
+	// forced queries are always added
+	TEST_ASSERT(ThreadPools_AddQueryReader(_query, NULL, "g",
+				TASK_PRIORITY_NORMAL, true) == 0);
+	while(atomic_load(&_completed) != 1) { sched_yield(); }
+
+	ThreadPools_Destroy();
+}
+
+static atomic_bool _gate = false;
+
+// occupies a reader until the gate opens
+static void _gated(void *arg) {
+	while(!atomic_load(&_gate)) { sched_yield(); }
+	atomic_fetch_add(&_completed, 1);
+}
+
+static void _collected(void *arg) {
+	(*(int *)arg)++;
+}
+
+void test_threadPools_scheduledTasks() {
+	ThreadPools_CreatePools(1, 1, UINT64_MAX);
+
+	// the first query occupies the only reader, the rest either wait
+	// in the readers queue or in the fair queue
+	int matched[5] = {0};
+	for(int i = 0; i < 5; i++) {
+		TEST_ASSERT(ThreadPools_AddQueryReader(_gated, matched + i, "g",
+					TASK_PRIORITY_NORMAL, false) == 0);
+	}
+
+	// every waiting query is collected exactly once
+	uint32_t n;
+	void **tasks = ThreadPools_GetTasksByHandler(_gated, _collected, &n);
+	TEST_ASSERT(n >= 4);
+	for(int i = 1; i < 5; i++) {
+		TEST_ASSERT(matched[i] == 1);
+	}
+	free(tasks);
+
+	atomic_store(&_gate, true);
+	while(atomic_load(&_completed) != 5) { sched_yield(); }
+
+	ThreadPools_Destroy();
+}
+
+static atomic_bool _hold    = false;
+static atomic_bool _blocked = false;
+static atomic_int  _writes  = 0;
+static atomic_int  _others  = 0;
+
+// occupies the writer thread until released
+static void _block(void *arg) {
+	atomic_store(&_blocked, true);
+	while(atomic_load(&_hold)) { sched_yield(); }
+}
+
+static void _write(void *arg) {
+	atomic_fetch_add(&_writes, 1);
+}
+
+static void _other(void *arg) {
+	atomic_fetch_add(&_others, 1);
+}
+
+// takes writes to graph 'pdata', skips writes to graph 2
+// stops at writes to any other graph
+static TaskFilterResult _filter(void *task, void *pdata) {
+	int graph = *(int *)task;
+	if(graph == *(int *)pdata) return TASK_TAKE;
+	if(graph == 2) return TASK_SKIP;
+	return TASK_STOP;
+}
+
+void test_threadPools_takeWriterTasks() {
+	ThreadPools_CreatePools(1, 1, UINT64_MAX);
+
+	atomic_store(&_hold, true);
+	TEST_ASSERT(ThreadPools_AddWorkWriter(_block, NULL, 0) == 0);
+	while(!atomic_load(&_blocked)) { sched_yield(); }
+
+	// writes queued behind the blocking task
+	int graphs[7] = {1, 2, 1, 3, 1, 0, 1};
+	for(int i = 0; i < 5; i++) {
+		TEST_ASSERT(ThreadPools_AddWorkWriter(_write, graphs + i, 0) == 0);
+	}
+	TEST_ASSERT(ThreadPools_AddWorkWriter(_other, NULL, 0) == 0);
+	TEST_ASSERT(ThreadPools_AddWorkWriter(_write, graphs + 6, 0) == 0);
+
+	int graph = 1;
+	void *tasks[8];
+
+	// capped by n
+	uint32_t n = ThreadPools_TakeWriterTasks(tasks, 1, _write, _filter,
+			&graph);
+	TEST_ASSERT(n == 1);
+	TEST_ASSERT(tasks[0] == graphs + 0);
+
+	// skips graph 2, stops at graph 3
+	n = ThreadPools_TakeWriterTasks(tasks, 8, _write, _filter, &graph);
+	TEST_ASSERT(n == 1);
+	TEST_ASSERT(tasks[0] == graphs + 2);
+
+	// skips graph 2, stops at graph 1
+	graph = 3;
+	n = ThreadPools_TakeWriterTasks(tasks, 8, _write, _filter, &graph);
+	TEST_ASSERT(n == 1);
+	TEST_ASSERT(tasks[0] == graphs + 3);
+
+	// scanning stops at a task of a different handler
+	graph = 1;
+	n = ThreadPools_TakeWriterTasks(tasks, 8, _write, _filter, &graph);
+	TEST_ASSERT(n == 1);
+	TEST_ASSERT(tasks[0] == graphs + 4);
+
+	// remaining tasks execute in order
+	atomic_store(&_hold, false);
+	while(atomic_load(&_writes) != 2 || atomic_load(&_others) != 1) {
+		sched_yield();
+	}
+
+	ThreadPools_Destroy();
+}
+
+//------------------------------------------------------------------------------
+// benchmark
+//------------------------------------------------------------------------------
+
+static uint64_t _now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static _Atomic uint64_t _latency = 0;
+
+// records the time passed since the query was dispatched
+static void _dispatched(void *arg) {
+	uint64_t dispatched_at = (uint64_t)arg;
+	atomic_fetch_add(&_latency, _now_ns() - dispatched_at);
+	atomic_fetch_add(&_completed, 1);
+}
+
+// average dispatch latency of bursts of queries
+// unscheduled reads are handed straight to the readers pool
+// while queries go through the fair queue scheduler
+// only runs when the BENCHMARK environment variable is set
+// e.g. BENCHMARK=1 ./test_thread_pools threadPoolsBenchmark
+void benchmark_dispatch() {
+	if(getenv("BENCHMARK") == NULL) return;
+
+	int threads = 64;
+	int bursts  = 1000;
+	int burst   = 64;
+	uint64_t n  = (uint64_t)bursts * burst;
+	const char *graphs[4] = {"g1", "g2", "g3", "g4"};
+
+	ThreadPools_CreatePools(threads, 1, UINT64_MAX);
+
+	// unscheduled reads
+	atomic_store(&_completed, 0);
+	atomic_store(&_latency, 0);
+	for(int i = 0; i < bursts; i++) {
+		for(int j = 0; j < burst; j++) {
+			ThreadPools_AddWorkReader(_dispatched, (void *)_now_ns(), false);
+		}
+		while(atomic_load(&_completed) != (i + 1) * burst) { sched_yield(); }
+	}
+	double read_latency = (double)atomic_load(&_latency) / n;
+
+	// scheduled queries
+	atomic_store(&_completed, 0);
+	atomic_store(&_latency, 0);
+	for(int i = 0; i < bursts; i++) {
+		for(int j = 0; j < burst; j++) {
+			ThreadPools_AddQueryReader(_dispatched, (void *)_now_ns(),
+					graphs[j % 4], j % TASK_PRIORITY_COUNT, false);
+		}
+		while(atomic_load(&_completed) != (i + 1) * burst) { sched_yield(); }
+	}
+	double query_latency = (double)atomic_load(&_latency) / n;
+
+	ThreadPools_Destroy();
+
+	printf("\n%d threads, %d bursts of %d jobs\n", threads, bursts, burst);
+	printf("AddWorkReader avg dispatch latency: %.0f ns\n", read_latency);
+	printf("AddQueryReader avg dispatch latency: %.0f ns\n", query_latency);
+}
+
 TEST_LIST = {
 	{"threadPools_threadID", test_threadPools_threadID},
+	{"threadPools_queryScheduling", test_threadPools_queryScheduling},
+	{"threadPools_maxPendingQueries", test_threadPools_maxPendingQueries},
+	{"threadPools_scheduledTasks", test_threadPools_scheduledTasks},
+	{"threadPools_takeWriterTasks", test_threadPools_takeWriterTasks},
+	{"threadPoolsBenchmark", benchmark_dispatch},
 	{NULL, NULL}
 };
 
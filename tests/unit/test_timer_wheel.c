@@ -0,0 +1,120 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/util/timer_wheel.h"
+
+#include <stdint.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+// number of timers in list
+static int _count
+(
+	const WheelTimer *t
+) {
+	int n = 0;
+	for(; t != NULL; t = t->next) n++;
+	return n;
+}
+
+void test_timerWheelExpire() {
+	TimerWheel *wheel = TimerWheel_New(1000);
+
+	WheelTimer a = {.due = 1005};
+	WheelTimer b = {.due = 1005};
+	WheelTimer c = {.due = 1010};
+	TimerWheel_Add(wheel, &a);
+	TimerWheel_Add(wheel, &b);
+	TimerWheel_Add(wheel, &c);
+	TEST_ASSERT(TimerWheel_NextTick(wheel) == 1005);
+
+	// nothing due yet
+	TEST_ASSERT(TimerWheel_Advance(wheel, 1004) == NULL);
+
+	WheelTimer *expired = TimerWheel_Advance(wheel, 1005);
+	TEST_ASSERT(_count(expired) == 2);
+	TEST_ASSERT(TimerWheel_NextTick(wheel) == 1010);
+
+	expired = TimerWheel_Advance(wheel, 2000);
+	TEST_ASSERT(expired == &c && c.next == NULL);
+	TEST_ASSERT(TimerWheel_NextTick(wheel) == UINT64_MAX);
+
+	TimerWheel_Free(wheel);
+}
+
+void test_timerWheelCascade() {
+	// timers spread across every level
+	uint64_t deltas[] = {1, 63, 64, 100, 4095, 4096, 300000, 20000000};
+	int n = sizeof(deltas) / sizeof(deltas[0]);
+	WheelTimer timers[n];
+
+	TimerWheel *wheel = TimerWheel_New(7);
+	for(int i = 0; i < n; i++) {
+		timers[i].due = 7 + deltas[i];
+		TimerWheel_Add(wheel, timers + i);
+	}
+
+	// each timer expires exactly at its due tick
+	for(int i = 0; i < n; i++) {
+		uint64_t due = timers[i].due;
+		TEST_ASSERT(TimerWheel_Advance(wheel, due - 1) == NULL);
+		TEST_MSG("timer %d expired early", i);
+
+		WheelTimer *expired = TimerWheel_Advance(wheel, due);
+		TEST_ASSERT(expired == timers + i);
+		TEST_MSG("timer %d didn't expire on time", i);
+	}
+
+	TEST_ASSERT(TimerWheel_NextTick(wheel) == UINT64_MAX);
+	TimerWheel_Free(wheel);
+}
+
+void test_timerWheelLateAdd() {
+	TimerWheel *wheel = TimerWheel_New(100);
+
+	// timer already due expires on next advance
+	WheelTimer a = {.due = 50};
+	TimerWheel_Add(wheel, &a);
+	TEST_ASSERT(TimerWheel_NextTick(wheel) == 100);
+	TEST_ASSERT(TimerWheel_Advance(wheel, 100) == &a);
+
+	// wheel jumps ahead while empty
+	TimerWheel_Advance(wheel, 5000);
+	WheelTimer b = {.due = 5001};
+	TimerWheel_Add(wheel, &b);
+	TEST_ASSERT(TimerWheel_Advance(wheel, 5001) == &b);
+
+	TimerWheel_Free(wheel);
+}
+
+void test_timerWheelClear() {
+	TimerWheel *wheel = TimerWheel_New(0);
+
+	WheelTimer timers[100];
+	for(int i = 0; i < 100; i++) {
+		timers[i].due = i * 1000;
+		TimerWheel_Add(wheel, timers + i);
+	}
+
+	TEST_ASSERT(_count(TimerWheel_Clear(wheel)) == 100);
+	TEST_ASSERT(TimerWheel_NextTick(wheel) == UINT64_MAX);
+	TEST_ASSERT(TimerWheel_Advance(wheel, 1000000) == NULL);
+
+	TimerWheel_Free(wheel);
+}
+
+TEST_LIST = {
+	{"timerWheelExpire", test_timerWheelExpire},
+	{"timerWheelCascade", test_timerWheelCascade},
+	{"timerWheelLateAdd", test_timerWheelLateAdd},
+	{"timerWheelClear", test_timerWheelClear},
+	{NULL, NULL}
+};
@@ -62,6 +62,49 @@ void test_strings() {
 	SIValue_Free(v);
 }
 
+void test_sharedStrings() {
+	SIValue v = SI_DuplicateStringVal("shared");
+	TEST_ASSERT(v.allocation == (M_SELF | M_SHARED));
+	TEST_ASSERT(SI_ALLOCATION(&v) == M_SELF);
+
+	// clones share the string's buffer
+	SIValue clone = SI_CloneValue(v);
+	TEST_ASSERT(clone.stringval == v.stringval);
+	TEST_ASSERT(SI_ALLOCATION(&clone) == M_SELF);
+
+	// persisting a volatile view takes a reference rather than a copy
+	SIValue persisted = SI_ShareValue(v);
+	TEST_ASSERT(SI_ALLOCATION(&persisted) == M_VOLATILE);
+	SIValue_Persist(&persisted);
+	TEST_ASSERT(persisted.stringval == v.stringval);
+	TEST_ASSERT(SI_ALLOCATION(&persisted) == M_SELF);
+
+	// const views are not persisted
+	SIValue view = SI_ConstValue(&v);
+	TEST_ASSERT(SI_ALLOCATION(&view) == M_CONST);
+	TEST_ASSERT(SI_ShallowCloneValue(view).stringval == v.stringval);
+
+	// the string remains valid until its last reference is freed
+	SIValue_Free(v);
+	SIValue_Free(persisted);
+	TEST_ASSERT(strcmp(clone.stringval, "shared") == 0);
+	TEST_ASSERT(strcmp(view.stringval, "shared") == 0);
+	SIValue_Free(clone);
+
+	// cloning a string which isn't shared copies it into a shared string
+	v = SI_TransferStringVal(rm_strdup("owned"));
+	clone = SI_CloneValue(v);
+	TEST_ASSERT(clone.stringval != v.stringval);
+	TEST_ASSERT(clone.allocation & M_SHARED);
+	SIValue_Free(v);
+
+	SIValue dup = SI_CloneValue(clone);
+	TEST_ASSERT(dup.stringval == clone.stringval);
+	SIValue_Free(clone);
+	TEST_ASSERT(strcmp(dup.stringval, "owned") == 0);
+	SIValue_Free(dup);
+}
+
 // idempotence and correctness tests for:
 // null, bool, long, double, edge, node, array.
 void test_null() {
@@ -451,6 +494,7 @@ void test_path() {
 TEST_LIST = {
 	{"numerics", test_numerics},
 	{"strings", test_strings},
+	{"sharedStrings", test_sharedStrings},
 	{"null", test_null},
 	{"hashBool", test_hashBool},
 	{"hashLong", test_hashLong},
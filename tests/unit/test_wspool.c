@@ -0,0 +1,200 @@
+/*
+ * Copyright FalkorDB Ltd. 2023 - present
+ * Licensed under the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/util/thpool/thpool.h"
+#include "src/util/thpool/wspool.h"
+
+#include <time.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+void setup() {
+	Alloc_Reset();
+}
+
+#define TEST_INIT setup();
+#include "acutest.h"
+
+static wspool _pool = NULL;
+static _Atomic uint64_t _counter = 0;
+
+static void _increment(void *arg) {
+	atomic_fetch_add(&_counter, 1);
+}
+
+static void _wait_for(uint64_t n) {
+	while(atomic_load(&_counter) != n) sched_yield();
+}
+
+void test_wspoolRunsAllJobs() {
+	atomic_store(&_counter, 0);
+	_pool = wspool_init(4, "test");
+
+	// more jobs than the injection queue holds, some spill over
+	uint64_t n = 20000;
+	for(uint64_t i = 0; i < n; i++) {
+		TEST_ASSERT(wspool_add_work(_pool, _increment, NULL) == 0);
+	}
+
+	_wait_for(n);
+	TEST_ASSERT(wspool_get_jobqueue_len(_pool) == 0);
+
+	wspool_destroy(_pool);
+}
+
+// spawns two child jobs until depth reaches 0
+static void _spawn(void *arg) {
+	intptr_t depth = (intptr_t)arg;
+	atomic_fetch_add(&_counter, 1);
+
+	if(depth == 0) return;
+
+	wspool_add_work(_pool, _spawn, (void *)(depth - 1));
+	wspool_add_work(_pool, _spawn, (void *)(depth - 1));
+}
+
+void test_wspoolNestedJobs() {
+	atomic_store(&_counter, 0);
+	_pool = wspool_init(8, "test");
+
+	// jobs spawned by workers are pushed onto their own deques
+	// and stolen by idle workers
+	intptr_t depth = 14;
+	TEST_ASSERT(wspool_add_work(_pool, _spawn, (void *)depth) == 0);
+
+	// a full binary tree
+	_wait_for((1 << (depth + 1)) - 1);
+
+	wspool_destroy(_pool);
+}
+
+static _Atomic bool _blocked  = false;
+static _Atomic bool _released = false;
+
+static void _block(void *arg) {
+	atomic_store(&_blocked, true);
+	while(!atomic_load(&_released)) sched_yield();
+}
+
+static void _other(void *arg) {
+	atomic_fetch_add(&_counter, 1);
+}
+
+static _Atomic int _matched = 0;
+static void _match(void *arg) {
+	atomic_fetch_add(&_matched, 1);
+}
+
+void test_wspoolGetTasks() {
+	atomic_store(&_counter, 0);
+	_pool = wspool_init(1, "test");
+
+	// occupy the only worker
+	wspool_add_work(_pool, _block, NULL);
+	while(!atomic_load(&_blocked)) sched_yield();
+
+	for(intptr_t i = 0; i < 5; i++) wspool_add_work(_pool, _increment, (void *)i);
+	for(intptr_t i = 0; i < 3; i++) wspool_add_work(_pool, _other, NULL);
+
+	TEST_ASSERT(wspool_get_jobqueue_len(_pool) == 8);
+
+	// cap queue
+	wspool_set_jobqueue_cap(_pool, 8);
+	TEST_ASSERT(wspool_queue_full(_pool));
+	wspool_set_jobqueue_cap(_pool, UINT64_MAX);
+	TEST_ASSERT(!wspool_queue_full(_pool));
+
+	void *tasks[8];
+	uint32_t n = 8;
+	wspool_get_tasks(_pool, tasks, &n, _increment, _match);
+	TEST_ASSERT(n == 5);
+	TEST_ASSERT(atomic_load(&_matched) == 5);
+
+	// tasks are collected in queue order
+	for(intptr_t i = 0; i < 5; i++) TEST_ASSERT(tasks[i] == (void *)i);
+
+	// number of collected tasks is capped
+	n = 2;
+	wspool_get_tasks(_pool, tasks, &n, _increment, NULL);
+	TEST_ASSERT(n == 2);
+
+	atomic_store(&_released, true);
+	_wait_for(8);
+
+	wspool_destroy(_pool);
+}
+
+//------------------------------------------------------------------------------
+// benchmark
+//------------------------------------------------------------------------------
+
+static uint64_t _now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static _Atomic uint64_t _latency = 0;
+
+// records the time passed since the job was dispatched
+static void _dispatched(void *arg) {
+	uint64_t dispatched_at = (uint64_t)arg;
+	atomic_fetch_add(&_latency, _now_ns() - dispatched_at);
+	atomic_fetch_add(&_counter, 1);
+}
+
+// average dispatch latency of bursts of jobs
+// a job's latency is the time from being added until it starts running
+// only runs when the BENCHMARK environment variable is set
+// e.g. BENCHMARK=1 ./test_wspool wspoolBenchmark
+void benchmark_dispatch() {
+	if(getenv("BENCHMARK") == NULL) return;
+
+	int threads = 64;
+	int bursts  = 1000;
+	int burst   = 64;
+	uint64_t n  = (uint64_t)bursts * burst;
+
+	// baseline, locked job queue
+	atomic_store(&_counter, 0);
+	atomic_store(&_latency, 0);
+	threadpool thpool = thpool_init(threads, "bench");
+	for(int i = 0; i < bursts; i++) {
+		for(int j = 0; j < burst; j++) {
+			thpool_add_work(thpool, _dispatched, (void *)_now_ns());
+		}
+		_wait_for((uint64_t)(i + 1) * burst);
+	}
+	double thpool_latency = (double)atomic_load(&_latency) / n;
+	thpool_destroy(thpool);
+
+	// work-stealing pool
+	atomic_store(&_counter, 0);
+	atomic_store(&_latency, 0);
+	_pool = wspool_init(threads, "bench");
+	for(int i = 0; i < bursts; i++) {
+		for(int j = 0; j < burst; j++) {
+			wspool_add_work(_pool, _dispatched, (void *)_now_ns());
+		}
+		_wait_for((uint64_t)(i + 1) * burst);
+	}
+	double wspool_latency = (double)atomic_load(&_latency) / n;
+	wspool_destroy(_pool);
+
+	printf("\n%d threads, %d bursts of %d jobs\n", threads, bursts, burst);
+	printf("thpool avg dispatch latency: %.0f ns\n", thpool_latency);
+	printf("wspool avg dispatch latency: %.0f ns\n", wspool_latency);
+}
+
+TEST_LIST = {
+	{"wspoolRunsAllJobs", test_wspoolRunsAllJobs},
+	{"wspoolNestedJobs", test_wspoolNestedJobs},
+	{"wspoolGetTasks", test_wspoolGetTasks},
+	{"wspoolBenchmark", benchmark_dispatch},
+	{NULL, NULL}
+};